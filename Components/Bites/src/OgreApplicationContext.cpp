@@ -277,19 +277,9 @@ void ApplicationContext::destroyDummyScene()
 
 void ApplicationContext::enableShaderCache() const
 {
-    Ogre::GpuProgramManager::getSingleton().setSaveMicrocodesToCache(true);
-
-    // Load for a package version of the shaders.
+    // the GpuProgramManager takes care of loading, invalidating and writing back the cache
     Ogre::String path = mFSLayer->getWritablePath(SHADER_CACHE_FILENAME);
-    std::ifstream inFile(path.c_str(), std::ios::binary);
-    if (!inFile.is_open())
-    {
-        Ogre::LogManager::getSingleton().logWarning("Could not open '"+path+"'");
-        return;
-    }
-    Ogre::LogManager::getSingleton().logMessage("Loading shader cache from '"+path+"'");
-    Ogre::DataStreamPtr istream(new Ogre::FileStreamDataStream(path, &inFile, false));
-    Ogre::GpuProgramManager::getSingleton().loadMicrocodeCache(istream);
+    Ogre::GpuProgramManager::getSingleton().setMicrocodeCachePath(path);
 }
 
 void ApplicationContext::addInputListener(NativeWindowType* win, InputListener* lis)
@@ -708,21 +698,7 @@ void ApplicationContext::reconfigure(const Ogre::String &renderer, Ogre::NameVal
 
 void ApplicationContext::shutdown()
 {
-    const auto& gpuMgr = Ogre::GpuProgramManager::getSingleton();
-    if (gpuMgr.getSaveMicrocodesToCache() && gpuMgr.isCacheDirty())
-    {
-        Ogre::String path = mFSLayer->getWritablePath(SHADER_CACHE_FILENAME);
-        std::fstream outFile(path.c_str(), std::ios::out | std::ios::binary);
-
-        if (outFile.is_open())
-        {
-            Ogre::LogManager::getSingleton().logMessage("Writing shader cache to "+path);
-            Ogre::DataStreamPtr ostream(new Ogre::FileStreamDataStream(path, &outFile, false));
-            gpuMgr.saveMicrocodeCache(ostream);
-        }
-        else
-            Ogre::LogManager::getSingleton().logWarning("Cannot open shader cache for writing "+path);
-    }
+    Ogre::GpuProgramManager::getSingleton().flushMicrocodeCache();
 
 #ifdef OGRE_BUILD_COMPONENT_RTSHADERSYSTEM
     // Destroy the RT Shader System.
@@ -29,6 +29,7 @@ Ogre::Technique *SGTechniqueResolverListener::handleSchemeNotFound(unsigned shor
     // Case technique registration succeeded.
 
     // Force creating the shaders for the generated technique.
+    // With asynchronous generation the technique is not available before a later frame.
     mShaderGenerator->validateMaterial(schemeName, originalMaterial->getName(), originalMaterial->getGroup());
 
     // Grab the generated technique.
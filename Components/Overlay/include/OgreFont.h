@@ -107,6 +107,20 @@ namespace Ogre
             String doGet(const void* target) const;
             void doSet(void* target, const String& val);
         };
+        /// Command object for Font - see ParamCommand 
+        class _OgreOverlayExport CmdDynamic : public ParamCommand
+        {
+        public:
+            String doGet(const void* target) const;
+            void doSet(void* target, const String& val);
+        };
+        /// Command object for Font - see ParamCommand 
+        class _OgreOverlayExport CmdMaxAtlasSize : public ParamCommand
+        {
+        public:
+            String doGet(const void* target) const;
+            void doSet(void* target, const String& val);
+        };
 
         // Command object for setting / getting parameters
         static CmdType msTypeCmd;
@@ -115,6 +129,8 @@ namespace Ogre
         static CmdSize msSizeCmd;
         static CmdResolution msResolutionCmd;
         static CmdCodePoints msCodePointsCmd;
+        static CmdDynamic msDynamicCmd;
+        static CmdMaxAtlasSize msMaxAtlasSizeCmd;
 
         /// The type of font
         FontType mType;
@@ -132,6 +148,10 @@ namespace Ogre
         uint mTtfResolution;
         /// Max distance to baseline of this (truetype) font
         int mTtfMaxBearingY;
+        /// Whether glyphs are rasterised on first use (truetype only)
+        bool mDynamic;
+        /// Largest width and height of the texture of a dynamic font
+        uint32 mMaxAtlasSize;
 
 
     public:
@@ -156,7 +176,14 @@ namespace Ogre
     protected:
         /// Map from unicode code point to texture coordinates
         typedef std::map<CodePoint, GlyphInfo> CodePointMap;
-        CodePointMap mCodePointMap;
+        /// Grows on lookups of dynamic fonts
+        mutable CodePointMap mCodePointMap;
+
+        /// The FreeType face and texture contents of a dynamic font
+        struct GlyphAtlas;
+        GlyphAtlas* mGlyphAtlas;
+        /// See _getGlyphGeneration
+        mutable uint32 mGlyphGeneration;
 
         /// The material which is generated for this font
         MaterialPtr mMaterial;
@@ -172,6 +199,12 @@ namespace Ogre
 
         /// Internal method for loading from ttf
         void createTextureFromFont(void);
+        /// Internal method for loading the texture of a dynamic font
+        void loadDynamicTexture(Texture* tex);
+        /// Find a glyph, rasterising it first for dynamic fonts
+        const GlyphInfo* findGlyph(CodePoint id) const;
+        /// Rasterise a glyph into the atlas of a dynamic font, NULL if the face lacks it
+        const GlyphInfo* rasteriseGlyph(CodePoint id) const;
 
         /// @copydoc Resource::loadImpl
         virtual void loadImpl();
@@ -264,6 +297,54 @@ namespace Ogre
         */
         int getTrueTypeMaxBearingY() const;
 
+        /** Sets whether glyphs are rasterised when they are first used (truetype only).
+        @remarks
+            By default all glyphs of the code point ranges are rasterised into a
+            texture when the font is loaded, which gets slow and wastes memory for
+            large ranges. A dynamic font ignores the code point ranges and adds any
+            glyph the truetype font provides to its texture on first use instead. The
+            texture starts small and grows up to the maximum atlas size; once full,
+            the least recently used glyphs are replaced.
+        @note
+            Must be set before loading.
+        */
+        void setDynamic(bool dynamic);
+        /// Gets whether glyphs are rasterised when they are first used
+        bool isDynamic(void) const;
+
+        /** Sets the largest width and height of the texture of a dynamic font.
+        @param size The size in pixels, the default is 2048
+        */
+        void setMaxAtlasSize(uint32 size);
+        /// Gets the largest width and height of the texture of a dynamic font
+        uint32 getMaxAtlasSize(void) const;
+
+        /** Gets a counter which changes whenever the texture coordinates of glyphs
+            already handed out have changed.
+        @remarks
+            This happens when the texture of a dynamic font grows or glyphs are
+            replaced, geometry built from the glyphs has to be updated then.
+        */
+        uint32 _getGlyphGeneration(void) const;
+
+        /** Uploads the glyphs rasterised since the last call to the texture.
+        @remarks
+            Only the changed part of the texture is uploaded. Does nothing for fonts
+            which are not dynamic.
+        */
+        void _updateTexture(void);
+
+        /** Keeps the glyphs looked up from now on in the texture of a dynamic font,
+            until _unpinGlyphs is called.
+        @remarks
+            Used while laying out a caption, so its glyphs do not replace each other
+            once the texture is full. A glyph which only fits by replacing a pinned
+            one is treated as missing and a warning is logged.
+        */
+        void _pinGlyphs(void);
+        /// Allows the glyphs pinned by _pinGlyphs to be replaced again
+        void _unpinGlyphs(void);
+
 
         /** Returns the texture coordinates of the associated glyph. 
             @remarks Parameter is a short to allow both ASCII and wide chars.
@@ -273,10 +354,9 @@ namespace Ogre
         */
         inline const UVRect& getGlyphTexCoords(CodePoint id) const
         {
-            CodePointMap::const_iterator i = mCodePointMap.find(id);
-            if (i != mCodePointMap.end())
+            if (const GlyphInfo* glyph = findGlyph(id))
             {
-                return i->second.uvRect;
+                return glyph->uvRect;
             }
             else
             {
@@ -315,10 +395,9 @@ namespace Ogre
         /** Gets the aspect ratio (width / height) of this character. */
         inline Real getGlyphAspectRatio(CodePoint id) const
         {
-            CodePointMap::const_iterator i = mCodePointMap.find(id);
-            if (i != mCodePointMap.end())
+            if (const GlyphInfo* glyph = findGlyph(id))
             {
-                return i->second.aspectRatio;
+                return glyph->aspectRatio;
             }
             else
             {
@@ -37,6 +37,7 @@ THE SOFTWARE.
 namespace Ogre {
     class OverlayContainer;
     class OverlayElement;
+    class OverlayBatcher;
 
     /** \addtogroup Optional
     *  @{
@@ -99,6 +100,8 @@ namespace Ogre {
         bool mVisible;
         bool mInitialised;
         String mOrigin;
+        /// Merges the 2D elements into batches, NULL if batching is disabled
+        OverlayBatcher* mBatcher;
         /** Internal lazy update method. */
         void updateTransform(void) const;
         /** Internal method for initialising an overlay */
@@ -251,6 +254,44 @@ namespace Ogre {
         /** Internal method to put the overlay contents onto the render queue. */
         void _findVisibleObjects(Camera* cam, RenderQueue* queue, Viewport* vp);
 
+        /** Sets whether 2D elements sharing a material are rendered together.
+        @remarks
+            With batching enabled the vertices of the 2D elements are copied into shared
+            vertex buffers, one per material, so a HUD of many panels and text areas
+            takes a handful of draw calls instead of one per element. Elements are only
+            merged when this does not change the result, i.e. when no element drawn in
+            between overlaps them. Only the vertices of elements whose geometry changed
+            are copied again.
+        @par
+            The vertices are read back from shadow buffers, which panels and text areas
+            only keep while batching is enabled, so changing this recreates their vertex
+            buffers. Elements using indexed geometry, more than one set of texture
+            coordinates or vertex buffers which can not be read back are rendered on their
+            own, as are the borders of BorderPanelOverlayElement. Such elements are assumed to
+            stay within their area. Batching is disabled by default.
+        */
+        void setBatchingEnabled(bool enabled);
+
+        /** Gets whether 2D elements sharing a material are rendered together. */
+        bool isBatchingEnabled(void) const { return mBatcher != 0; }
+
+        /** Gets the number of batches which were rendered in the last frame.
+        @remarks
+            Elements which were rendered on their own are not counted.
+        */
+        size_t getNumBatches(void) const;
+
+        /** Internal method to put a 2D element onto the render queue.
+        @remarks
+            With batching enabled the element is merged with others where possible.
+        */
+        void _queueElement(OverlayElement* elem, RenderQueue* queue);
+
+        /** Internal method to put a renderable of a 2D element onto the render queue
+            which must not be merged with others.
+        */
+        void _queueRenderable(Renderable* rend, OverlayElement* elem, RenderQueue* queue);
+
         /** This returns a OverlayElement at position x,y. */
         virtual OverlayElement* findElementAt(Real x, Real y);
 
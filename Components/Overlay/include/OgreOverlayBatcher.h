@@ -0,0 +1,196 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __OverlayBatcher_H__
+#define __OverlayBatcher_H__
+
+#include "OgreOverlayPrerequisites.h"
+#include "OgreRenderable.h"
+#include "OgreRenderOperation.h"
+#include "OgreHardwareVertexBuffer.h"
+#include "OgreCommon.h"
+
+namespace Ogre {
+    class Overlay;
+    class OverlayElement;
+
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Overlays
+    *  @{
+    */
+    /** Renders several 2D elements of one material with a single draw call.
+    @remarks
+        The vertices of the members are copied from their shadow buffers into
+        one triangle list. Only the members whose geometry changed since the
+        last frame are copied again, unless the members themselves changed.
+    @note
+        Internal class of OverlayBatcher.
+    */
+    class _OgreOverlayExport OverlayBatch : public Renderable, public OverlayAlloc
+    {
+    public:
+        /// The vertex layout of a batchable element
+        struct Format
+        {
+            bool hasTexCoord;
+            bool hasColour;
+            VertexElementType colourType;
+
+            bool operator==(const Format& rhs) const
+            {
+                return hasTexCoord == rhs.hasTexCoord && hasColour == rhs.hasColour &&
+                    (!hasColour || colourType == rhs.colourType);
+            }
+        };
+
+        /// A 2D element which can be batched, as found while queuing the overlay
+        struct Source
+        {
+            OverlayElement* element;
+            RenderOperation op;
+            const VertexElement* position;
+            const VertexElement* texCoord;
+            const VertexElement* colour;
+            Format format;
+            /// Number of vertices as a triangle list
+            size_t vertexCount;
+        };
+        typedef std::vector<Source> SourceList;
+        typedef std::vector<size_t> IndexList;
+
+        OverlayBatch(const Overlay* overlay);
+        ~OverlayBatch();
+
+        /** Gets the vertices of a 2D element, or false if it can not be batched. */
+        static bool getSource(OverlayElement* elem, Source& src);
+
+        /** Gets the screen area covered by the vertices of a 2D element. */
+        static RealRect getBounds(const Source& src);
+
+        /** Sets the members of the batch and updates the vertex data. */
+        void update(const SourceList& sources, const IndexList& members);
+
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+        void getRenderOperation(RenderOperation& op) { op = mRenderOp; }
+        void getWorldTransforms(Matrix4* xform) const;
+        Real getSquaredViewDepth(const Camera* cam) const { return 10000.0f - (Real)mZOrder; }
+        const LightList& getLights(void) const;
+
+        ushort getZOrder(void) const { return mZOrder; }
+
+    private:
+        struct Member
+        {
+            OverlayElement* element;
+            uint32 revision;
+            size_t vertexStart;
+            size_t vertexCount;
+        };
+        typedef std::vector<Member> MemberList;
+
+        const Overlay* mOverlay;
+        MaterialPtr mMaterial;
+        RenderOperation mRenderOp;
+        HardwareVertexBufferSharedPtr mBuffer;
+        Format mFormat;
+        MemberList mMembers;
+        ushort mZOrder;
+
+        void setFormat(const Format& format);
+        static void copyVertices(const Source& src, uchar* dest, size_t vertexSize);
+    };
+
+    /** Collects the 2D elements of an overlay while queuing it and merges them into batches.
+    @remarks
+        Elements are drawn in the order they are queued, which follows their Z-order.
+        An element is moved back to an earlier batch of the same material and vertex
+        layout as long as nothing drawn in between overlaps it, so the result looks
+        the same as drawing every element on its own.
+    @note
+        Internal class of Overlay, see Overlay::setBatchingEnabled.
+    */
+    class _OgreOverlayExport OverlayBatcher : public OverlayAlloc
+    {
+    public:
+        OverlayBatcher(const Overlay* overlay);
+        ~OverlayBatcher();
+
+        /** Starts collecting the elements of a frame. */
+        void begin(void);
+
+        /** Adds an element, returns false if it has to be rendered on its own. */
+        bool addElement(OverlayElement* elem);
+
+        /** Adds a renderable of the element which is queued on its own. */
+        void addBarrier(OverlayElement* elem);
+
+        /** Puts the batches onto the render queue. */
+        void end(RenderQueue* queue);
+
+        /** Gets the number of batches which were queued by the last call to end. */
+        size_t getNumBatches(void) const { return mNumBatches; }
+
+    private:
+        /// A batch, or renderables queued on their own if it has no members
+        struct Group
+        {
+            const Material* material;
+            OverlayBatch::Format format;
+            RealRect bounds;
+            OverlayBatch::IndexList members;
+        };
+        typedef std::vector<Group> GroupList;
+
+        struct CachedBounds
+        {
+            uint32 revision;
+            uint32 frame;
+            RealRect bounds;
+        };
+        typedef std::map<const OverlayElement*, CachedBounds> BoundsMap;
+
+        const Overlay* mOverlay;
+        OverlayBatch::SourceList mSources;
+        GroupList mGroups;
+        std::vector<OverlayBatch*> mBatches;
+        size_t mNumBatches;
+        /// Reading the vertices back is only needed when the geometry changed
+        BoundsMap mBounds;
+        uint32 mFrame;
+
+        const RealRect& getBounds(const OverlayBatch::Source& src);
+
+        static bool overlaps(const RealRect& a, const RealRect& b);
+    };
+    /** @} */
+    /** @} */
+}
+
+#endif
@@ -179,6 +179,12 @@ namespace Ogre {
         /// Used to see if this element is created from a Template
         OverlayElement* mSourceTemplate ;
 
+        /// Changes whenever the vertex data of the element was rewritten
+        uint32 mGeometryRevision;
+
+        /// Whether vertex buffers are created with shadow buffers, only the batching of Overlay reads them
+        bool mShadowBuffers;
+
         /** Internal method which is triggered when the positions of the element get updated,
         meaning the element should be rebuilding it's mesh positions. Abstract since
         subclasses must implement this.
@@ -190,6 +196,9 @@ namespace Ogre {
         */
         virtual void updateTextureGeometry(void) = 0;
 
+        /** Internal method to call when the vertex data of the element was rewritten. */
+        void _notifyGeometryChanged(void);
+
         /** Internal method for setting up the basic parameter definitions for a subclass. 
         @remarks
         Because StringInterface holds a dictionary of parameters per class, subclasses need to
@@ -468,6 +477,12 @@ namespace Ogre {
         OverlayContainer* getParent() ;
         void _setParent(OverlayContainer* parent) { mParent = parent; }
 
+        /** Gets a number which changes whenever the vertex data of the element was rewritten.
+        @remarks
+            The numbers are unique over all elements, used by the batching of Overlay.
+        */
+        uint32 _getGeometryRevision(void) const { return mGeometryRevision; }
+
         /**
         * Returns the zOrder of the element
         */
@@ -245,6 +245,8 @@ namespace Ogre
         ushort mPixelSpaceWidth;
         size_t mAllocSize;
         Real mViewportAspectCoef;
+        /// Font::_getGlyphGeneration when the geometry was updated
+        uint32 mGlyphGeneration;
 
         /// Colours to use for the vertices
         ColourValue mColourBottom;
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreBorderPanelOverlayElement.h"
 #include "OgreMaterialManager.h"
 #include "OgreOverlayManager.h"
+#include "OgreOverlay.h"
 #include "OgreHardwareBufferManager.h"
 #include "OgreHardwareVertexBuffer.h"
 #include "OgreException.h"
@@ -618,7 +619,10 @@ namespace Ogre {
         {
 
             // Add outer
-            queue->addRenderable(mBorderRenderable, RENDER_QUEUE_OVERLAY, mZOrder);
+            if (mOverlay)
+                mOverlay->_queueRenderable(mBorderRenderable, this, queue);
+            else
+                queue->addRenderable(mBorderRenderable, RENDER_QUEUE_OVERLAY, mZOrder);
 
             // do inner last so the border artifacts don't overwrite the children
             // Add inner
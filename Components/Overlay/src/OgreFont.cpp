@@ -34,6 +34,7 @@ THE SOFTWARE
 #include "OgreTextureUnitState.h"
 #include "OgreTechnique.h"
 #include "OgreBitwise.h"
+#include "OgreHardwarePixelBuffer.h"
 
 #define generic _generic    // keyword for C++/CX
 #include <ft2build.h>
@@ -52,12 +53,67 @@ namespace Ogre
     Font::CmdSize Font::msSizeCmd;
     Font::CmdResolution Font::msResolutionCmd;
     Font::CmdCodePoints Font::msCodePointsCmd;
+    Font::CmdDynamic Font::msDynamicCmd;
+    Font::CmdMaxAtlasSize Font::msMaxAtlasSizeCmd;
+
+    //---------------------------------------------------------------------
+    struct Font::GlyphAtlas
+    {
+        FT_Library library;
+        FT_Face face;
+        /// The ttf file, FreeType reads from it as long as the face exists
+        DataStreamPtr ttfData;
+        /// Copy of the texture contents
+        Image image;
+        /// Size of the glyphs in pixels
+        uint32 glyphWidth;
+        uint32 glyphHeight;
+        /// Size of the cells the texture is divided into, including the character spacer
+        uint32 cellWidth;
+        uint32 cellHeight;
+        uint32 numColumns;
+        /// The code point held by each cell in use
+        std::vector<CodePoint> cells;
+
+        /// Code points from least to most recently used
+        typedef std::list<CodePoint> UsageList;
+        UsageList usage;
+        struct Slot
+        {
+            uint32 cell;
+            UsageList::iterator usage;
+            /// The value of pinnedLayout when the glyph was last looked up
+            uint32 layout;
+        };
+        typedef std::unordered_map<CodePoint, Slot> SlotMap;
+        SlotMap slots;
+        /// Code points the face has no glyph for
+        std::set<CodePoint> missing;
+
+        /// Part of image which has not been uploaded yet
+        Box dirtyBox;
+        bool dirty;
+
+        /// Counts the calls to _pinGlyphs, glyphs with this layout are pinned
+        uint32 pinnedLayout;
+        bool pinning;
+        /// The last layout a glyph was skipped for
+        uint32 warnedLayout;
+
+        GlyphAtlas()
+            : library(0), face(0), dirty(false), pinnedLayout(0), pinning(false), warnedLayout(0)
+        {
+        }
+
+        bool isPinned(const Slot& slot) const { return pinning && slot.layout == pinnedLayout; }
+    };
 
     //---------------------------------------------------------------------
     Font::Font(ResourceManager* creator, const String& name, ResourceHandle handle,
         const String& group, bool isManual, ManualResourceLoader* loader)
         :Resource (creator, name, handle, group, isManual, loader),
-        mType(FT_TRUETYPE), mCharacterSpacer(5), mTtfSize(0), mTtfResolution(0), mTtfMaxBearingY(0), mAntialiasColour(false)
+        mType(FT_TRUETYPE), mCharacterSpacer(5), mTtfSize(0), mTtfResolution(0), mTtfMaxBearingY(0),
+        mDynamic(false), mMaxAtlasSize(2048), mGlyphAtlas(0), mGlyphGeneration(0), mAntialiasColour(false)
     {
 
         if (createParamDictionary("Font"))
@@ -81,6 +137,12 @@ namespace Ogre
             dict->addParameter(
                 ParameterDef("code_points", "Add a range of code points", PT_STRING),
                 &msCodePointsCmd);
+            dict->addParameter(
+                ParameterDef("dynamic", "Rasterise glyphs on first use", PT_BOOL),
+                &msDynamicCmd);
+            dict->addParameter(
+                ParameterDef("max_atlas_size", "Maximum texture size of a dynamic font", PT_UNSIGNED_INT),
+                &msMaxAtlasSizeCmd);
         }
 
     }
@@ -147,16 +209,220 @@ namespace Ogre
         return mTtfMaxBearingY;
     }
     //---------------------------------------------------------------------
+    void Font::setDynamic(bool dynamic)
+    {
+        mDynamic = dynamic;
+    }
+    //---------------------------------------------------------------------
+    bool Font::isDynamic(void) const
+    {
+        return mDynamic;
+    }
+    //---------------------------------------------------------------------
+    void Font::setMaxAtlasSize(uint32 size)
+    {
+        mMaxAtlasSize = size;
+    }
+    //---------------------------------------------------------------------
+    uint32 Font::getMaxAtlasSize(void) const
+    {
+        return mMaxAtlasSize;
+    }
+    //---------------------------------------------------------------------
+    uint32 Font::_getGlyphGeneration(void) const
+    {
+        return mGlyphGeneration;
+    }
+    //---------------------------------------------------------------------
     const Font::GlyphInfo& Font::getGlyphInfo(CodePoint id) const
     {
-        CodePointMap::const_iterator i = mCodePointMap.find(id);
-        if (i == mCodePointMap.end())
+        const GlyphInfo* glyph = findGlyph(id);
+        if (!glyph)
         {
             OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, 
                 "Code point " + StringConverter::toString(id) + " not found in font "
                 + mName, "Font::getGlyphInfo");
         }
-        return i->second;
+        return *glyph;
+    }
+    //---------------------------------------------------------------------
+    const Font::GlyphInfo* Font::findGlyph(CodePoint id) const
+    {
+        CodePointMap::const_iterator i = mCodePointMap.find(id);
+        if (i == mCodePointMap.end())
+        {
+            return mGlyphAtlas ? rasteriseGlyph(id) : NULL;
+        }
+
+        if (mGlyphAtlas)
+        {
+            // mark as most recently used
+            GlyphAtlas::Slot& slot = mGlyphAtlas->slots[id];
+            GlyphAtlas::UsageList& usage = mGlyphAtlas->usage;
+            usage.splice(usage.end(), usage, slot.usage);
+            slot.layout = mGlyphAtlas->pinnedLayout;
+        }
+        return &i->second;
+    }
+    //---------------------------------------------------------------------
+    const Font::GlyphInfo* Font::rasteriseGlyph(CodePoint id) const
+    {
+        GlyphAtlas* atlas = mGlyphAtlas;
+        if (atlas->missing.count(id))
+            return NULL;
+
+        FT_Face face = atlas->face;
+        if (!FT_Get_Char_Index(face, id) || FT_Load_Char(face, id, FT_LOAD_RENDER))
+        {
+            atlas->missing.insert(id);
+            return NULL;
+        }
+
+        uint32 width = atlas->image.getWidth();
+        uint32 height = atlas->image.getHeight();
+        uint32 cell;
+        if (atlas->cells.size() < atlas->numColumns * (height / atlas->cellHeight))
+        {
+            cell = static_cast<uint32>(atlas->cells.size());
+            atlas->cells.push_back(id);
+        }
+        else if (height * 2 <= mMaxAtlasSize)
+        {
+            // Grow downwards, so the contents stay in place
+            const size_t pixel_bytes = 2;
+            size_t oldSize = atlas->image.getSize();
+            uchar* data = OGRE_ALLOC_T(uchar, oldSize * 2, MEMCATEGORY_GENERAL);
+            memcpy(data, atlas->image.getData(), oldSize);
+            for (size_t i = oldSize; i < oldSize * 2; i += pixel_bytes)
+            {
+                data[i + 0] = 0xFF; // luminance
+                data[i + 1] = 0x00; // alpha
+            }
+            atlas->image.loadDynamicImage(data, width, height * 2, 1, PF_BYTE_LA, true);
+
+            for (CodePointMap::iterator i = mCodePointMap.begin(); i != mCodePointMap.end(); ++i)
+            {
+                i->second.uvRect.top *= 0.5f;
+                i->second.uvRect.bottom *= 0.5f;
+            }
+            height *= 2;
+            ++mGlyphGeneration;
+
+            cell = static_cast<uint32>(atlas->cells.size());
+            atlas->cells.push_back(id);
+        }
+        else
+        {
+            // Replace the least recently used glyph. If that one is pinned, so are all
+            // others, as they were used later.
+            CodePoint old = atlas->usage.front();
+            GlyphAtlas::SlotMap::iterator slot = atlas->slots.find(old);
+            if (atlas->isPinned(slot->second))
+            {
+                if (atlas->warnedLayout != atlas->pinnedLayout)
+                {
+                    LogManager::getSingleton().logWarning(
+                        "Font " + mName + ": the glyphs in use do not fit into max_atlas_size " +
+                        StringConverter::toString(mMaxAtlasSize) + ", skipping code point " +
+                        StringConverter::toString(id) + " and others");
+                    atlas->warnedLayout = atlas->pinnedLayout;
+                }
+                return NULL;
+            }
+            atlas->usage.pop_front();
+            cell = slot->second.cell;
+            atlas->slots.erase(slot);
+            mCodePointMap.erase(old);
+            atlas->cells[cell] = id;
+            ++mGlyphGeneration;
+        }
+
+        uint32 left = (cell % atlas->numColumns) * atlas->cellWidth;
+        uint32 top = (cell / atlas->numColumns) * atlas->cellHeight;
+
+        // Copy the glyph into its cell, clipped to the cell and white where transparent
+        PixelBox dst = atlas->image.getPixelBox();
+        FT_Pos y_bearing = ( mTtfMaxBearingY >> 6 ) - ( face->glyph->metrics.horiBearingY >> 6 );
+        FT_Pos x_bearing = face->glyph->metrics.horiBearingX >> 6;
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        for (uint32 y = 0; y < atlas->glyphHeight; ++y)
+        {
+            uchar* pDest = dst.data + ((top + y) * dst.rowPitch + left) * 2;
+            FT_Pos row = y - y_bearing;
+            for (uint32 x = 0; x < atlas->glyphWidth; ++x)
+            {
+                FT_Pos col = x - x_bearing;
+                uchar value = 0;
+                if (bitmap.buffer && row >= 0 && row < (FT_Pos)bitmap.rows && col >= 0 &&
+                    col < (FT_Pos)bitmap.width)
+                {
+                    value = bitmap.buffer[row * bitmap.pitch + col];
+                }
+                // see loadResource
+                *pDest++ = mAntialiasColour ? value : 0xFF;
+                *pDest++ = value;
+            }
+        }
+
+        Box box(left, top, left + atlas->glyphWidth, top + atlas->glyphHeight);
+        if (atlas->dirty)
+        {
+            Box& dirty = atlas->dirtyBox;
+            dirty.left = std::min(dirty.left, box.left);
+            dirty.top = std::min(dirty.top, box.top);
+            dirty.right = std::max(dirty.right, box.right);
+            dirty.bottom = std::max(dirty.bottom, box.bottom);
+        }
+        else
+        {
+            atlas->dirtyBox = box;
+            atlas->dirty = true;
+        }
+
+        GlyphAtlas::Slot& slot = atlas->slots[id];
+        slot.cell = cell;
+        slot.usage = atlas->usage.insert(atlas->usage.end(), id);
+        slot.layout = atlas->pinnedLayout;
+
+        FT_Pos advance = std::min<FT_Pos>(face->glyph->advance.x >> 6, atlas->glyphWidth);
+        UVRect uvRect((Real)left / width, (Real)top / height, (Real)(left + advance) / width,
+                      (Real)box.bottom / height);
+        return &mCodePointMap.insert(CodePointMap::value_type(
+            id, GlyphInfo(id, uvRect, (Real)advance / atlas->glyphHeight))).first->second;
+    }
+    //---------------------------------------------------------------------
+    void Font::_updateTexture(void)
+    {
+        if (!mGlyphAtlas || !mTexture)
+            return;
+
+        const Image& image = mGlyphAtlas->image;
+        if (mTexture->getHeight() != image.getHeight())
+        {
+            // The atlas has grown, recreating the texture uploads all of it
+            mTexture->unload();
+            mTexture->load();
+        }
+        else if (mGlyphAtlas->dirty)
+        {
+            const Box& box = mGlyphAtlas->dirtyBox;
+            mTexture->getBuffer()->blitFromMemory(image.getPixelBox().getSubVolume(box), box);
+        }
+        mGlyphAtlas->dirty = false;
+    }
+    //---------------------------------------------------------------------
+    void Font::_pinGlyphs(void)
+    {
+        if (!mGlyphAtlas)
+            return;
+        ++mGlyphAtlas->pinnedLayout;
+        mGlyphAtlas->pinning = true;
+    }
+    //---------------------------------------------------------------------
+    void Font::_unpinGlyphs(void)
+    {
+        if (mGlyphAtlas)
+            mGlyphAtlas->pinning = false;
     }
     //---------------------------------------------------------------------
     void Font::loadImpl()
@@ -210,6 +476,17 @@ namespace Ogre
     //---------------------------------------------------------------------
     void Font::unloadImpl()
     {
+        if (mGlyphAtlas)
+        {
+            FT_Done_Face(mGlyphAtlas->face);
+            FT_Done_FreeType(mGlyphAtlas->library);
+            OGRE_DELETE_T(mGlyphAtlas, GlyphAtlas, MEMCATEGORY_GENERAL);
+            mGlyphAtlas = 0;
+            // the glyphs were only in the texture
+            mCodePointMap.clear();
+            ++mGlyphGeneration;
+        }
+
         if (mMaterial)
         {
             MaterialManager::getSingleton().remove(mMaterial->getHandle());
@@ -242,8 +519,81 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    void Font::loadDynamicTexture(Texture* tex)
+    {
+        if (!mGlyphAtlas)
+        {
+            GlyphAtlas* atlas = OGRE_NEW_T(GlyphAtlas, MEMCATEGORY_GENERAL)();
+            if( FT_Init_FreeType( &atlas->library ) )
+            {
+                OGRE_DELETE_T(atlas, GlyphAtlas, MEMCATEGORY_GENERAL);
+                OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR, "Could not init FreeType library!",
+                    "Font::loadDynamicTexture");
+            }
+            mGlyphAtlas = atlas;
+
+            // The face is kept for rasterising glyphs later on, so is its memory
+            DataStreamPtr dataStreamPtr =
+                ResourceGroupManager::getSingleton().openResource(mSource, mGroup, this);
+            atlas->ttfData.reset(OGRE_NEW MemoryDataStream(dataStreamPtr));
+            MemoryDataStream* ttfchunk = static_cast<MemoryDataStream*>(atlas->ttfData.get());
+
+            if( FT_New_Memory_Face( atlas->library, ttfchunk->getPtr(), (FT_Long)ttfchunk->size(), 0,
+                                    &atlas->face ) )
+                OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR,
+                "Could not open font face!", "Font::loadDynamicTexture" );
+
+            FT_F26Dot6 ftSize = (FT_F26Dot6)(mTtfSize * (1 << 6));
+            if( FT_Set_Char_Size( atlas->face, ftSize, 0, mTtfResolution, mTtfResolution ) )
+                OGRE_EXCEPT( Exception::ERR_INTERNAL_ERROR,
+                "Could not set char size!", "Font::loadDynamicTexture" );
+
+            // Glyphs are not known up front, so the cells are sized by the face metrics
+            const FT_Size_Metrics& metrics = atlas->face->size->metrics;
+            mTtfMaxBearingY = static_cast<int>(metrics.ascender);
+            atlas->glyphHeight = static_cast<uint32>((metrics.ascender - metrics.descender + 63) >> 6);
+            atlas->glyphWidth = static_cast<uint32>((metrics.max_advance + 63) >> 6);
+            atlas->cellWidth = atlas->glyphWidth + mCharacterSpacer;
+            atlas->cellHeight = atlas->glyphHeight + mCharacterSpacer;
+
+            uint32 width = std::min(mMaxAtlasSize, Bitwise::firstPO2From(atlas->cellWidth * 16));
+            uint32 height = std::min(mMaxAtlasSize, Bitwise::firstPO2From(atlas->cellHeight * 2));
+            if (width < atlas->cellWidth || height < atlas->cellHeight)
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                    "Maximum atlas size of font " + mName + " is too small for its glyphs",
+                    "Font::loadDynamicTexture");
+            atlas->numColumns = width / atlas->cellWidth;
+
+            const size_t pixel_bytes = 2;
+            size_t data_size = width * height * pixel_bytes;
+            uchar* data = OGRE_ALLOC_T(uchar, data_size, MEMCATEGORY_GENERAL);
+            // White, transparent
+            for (size_t i = 0; i < data_size; i += pixel_bytes)
+            {
+                data[i + 0] = 0xFF; // luminance
+                data[i + 1] = 0x00; // alpha
+            }
+            atlas->image.loadDynamicImage(data, width, height, 1, PF_BYTE_LA, true);
+
+            LogManager::getSingleton().logMessage("Font " + mName + " using dynamic texture size " +
+                StringConverter::toString(width) + "x" + StringConverter::toString(height));
+        }
+
+        // (Re)load the texture with all glyphs rasterised so far
+        ConstImagePtrList imagePtrs;
+        imagePtrs.push_back(&mGlyphAtlas->image);
+        tex->_loadImages( imagePtrs );
+        mGlyphAtlas->dirty = false;
+    }
+    //---------------------------------------------------------------------
     void Font::loadResource(Resource* res)
     {
+        if (mDynamic)
+        {
+            loadDynamicTexture(static_cast<Texture*>(res));
+            return;
+        }
+
         // ManualResourceLoader implementation - load the texture
         FT_Library ftLibrary;
         // Init freetype
@@ -533,6 +883,28 @@ namespace Ogre
             }
         }
     }
+    //-----------------------------------------------------------------------
+    String Font::CmdDynamic::doGet(const void* target) const
+    {
+        const Font* f = static_cast<const Font*>(target);
+        return StringConverter::toString(f->isDynamic());
+    }
+    void Font::CmdDynamic::doSet(void* target, const String& val)
+    {
+        Font* f = static_cast<Font*>(target);
+        f->setDynamic(StringConverter::parseBool(val));
+    }
+    //-----------------------------------------------------------------------
+    String Font::CmdMaxAtlasSize::doGet(const void* target) const
+    {
+        const Font* f = static_cast<const Font*>(target);
+        return StringConverter::toString(f->getMaxAtlasSize());
+    }
+    void Font::CmdMaxAtlasSize::doSet(void* target, const String& val)
+    {
+        Font* f = static_cast<Font*>(target);
+        f->setMaxAtlasSize(StringConverter::parseUnsignedInt(val));
+    }
 
 
 }
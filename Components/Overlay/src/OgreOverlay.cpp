@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreSceneNode.h"
 #include "OgreRenderQueue.h"
 #include "OgreCamera.h"
+#include "OgreOverlayBatcher.h"
 
 namespace Ogre {
 
@@ -44,7 +45,7 @@ namespace Ogre {
         mScaleX(1.0f), mScaleY(1.0f),
         mLastViewportWidth(0), mLastViewportHeight(0),
         mTransformOutOfDate(true), mTransformUpdated(true), 
-        mZOrder(100), mVisible(false), mInitialised(false)
+        mZOrder(100), mVisible(false), mInitialised(false), mBatcher(0)
 
     {
         mRootNode = OGRE_NEW SceneNode(NULL);
@@ -56,6 +57,7 @@ namespace Ogre {
         // remove children
 
         OGRE_DELETE mRootNode;
+        OGRE_DELETE mBatcher;
         
         for (OverlayContainerList::iterator i = m2DElements.begin(); 
              i != m2DElements.end(); ++i)
@@ -301,6 +303,8 @@ namespace Ogre {
             queue->setDefaultQueueGroup(oldgrp);
             queue->setDefaultRenderablePriority(oldPriority);
             // Add 2D elements
+            if (mBatcher)
+                mBatcher->begin();
             iend = m2DElements.end();
             for (i = m2DElements.begin(); i != iend; ++i)
             {
@@ -308,9 +312,53 @@ namespace Ogre {
 
                 (*i)->_updateRenderQueue(queue);
             }
+            if (mBatcher)
+                mBatcher->end(queue);
         }
     }
     //---------------------------------------------------------------------
+    void Overlay::setBatchingEnabled(bool enabled)
+    {
+        if (enabled && !mBatcher)
+        {
+            mBatcher = OGRE_NEW OverlayBatcher(this);
+        }
+        else if (!enabled && mBatcher)
+        {
+            OGRE_DELETE mBatcher;
+            mBatcher = 0;
+        }
+        else
+        {
+            return;
+        }
+
+        // Let the elements create their vertex buffers with or without shadow buffers
+        OverlayContainerList::iterator i, iend = m2DElements.end();
+        for (i = m2DElements.begin(); i != iend; ++i)
+        {
+            (*i)->_notifyParent(0, this);
+        }
+    }
+    //---------------------------------------------------------------------
+    size_t Overlay::getNumBatches(void) const
+    {
+        return mBatcher ? mBatcher->getNumBatches() : 0;
+    }
+    //---------------------------------------------------------------------
+    void Overlay::_queueElement(OverlayElement* elem, RenderQueue* queue)
+    {
+        if (!mBatcher || !mBatcher->addElement(elem))
+            _queueRenderable(elem, elem, queue);
+    }
+    //---------------------------------------------------------------------
+    void Overlay::_queueRenderable(Renderable* rend, OverlayElement* elem, RenderQueue* queue)
+    {
+        queue->addRenderable(rend, RENDER_QUEUE_OVERLAY, elem->getZOrder());
+        if (mBatcher)
+            mBatcher->addBarrier(elem);
+    }
+    //---------------------------------------------------------------------
     void Overlay::updateTransform(void) const
     {
         // Ordering:
@@ -0,0 +1,436 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreOverlayBatcher.h"
+#include "OgreOverlay.h"
+#include "OgreOverlayElement.h"
+#include "OgreRenderQueue.h"
+#include "OgreHardwareBufferManager.h"
+#include "OgreMaterial.h"
+
+namespace Ogre {
+    //---------------------------------------------------------------------
+    OverlayBatch::OverlayBatch(const Overlay* overlay) : mOverlay(overlay), mZOrder(0)
+    {
+        mFormat.hasTexCoord = false;
+        mFormat.hasColour = false;
+        mFormat.colourType = VET_COLOUR;
+
+        mRenderOp.vertexData = OGRE_NEW VertexData();
+        mRenderOp.vertexData->vertexStart = 0;
+        mRenderOp.vertexData->vertexCount = 0;
+        mRenderOp.operationType = RenderOperation::OT_TRIANGLE_LIST;
+        mRenderOp.useIndexes = false;
+        mRenderOp.srcRenderable = this;
+
+        mPolygonModeOverrideable = false;
+        mUseIdentityProjection = true;
+        mUseIdentityView = true;
+    }
+    //---------------------------------------------------------------------
+    OverlayBatch::~OverlayBatch()
+    {
+        OGRE_DELETE mRenderOp.vertexData;
+    }
+    //---------------------------------------------------------------------
+    void OverlayBatch::getWorldTransforms(Matrix4* xform) const
+    {
+        mOverlay->_getWorldTransforms(xform);
+    }
+    //---------------------------------------------------------------------
+    const LightList& OverlayBatch::getLights(void) const
+    {
+        static LightList ll;
+        return ll;
+    }
+    //---------------------------------------------------------------------
+    bool OverlayBatch::getSource(OverlayElement* elem, Source& src)
+    {
+        if (!elem->getMaterial())
+            return false;
+
+        elem->getRenderOperation(src.op);
+        if (src.op.useIndexes || !src.op.vertexData ||
+            (src.op.operationType != RenderOperation::OT_TRIANGLE_LIST &&
+             src.op.operationType != RenderOperation::OT_TRIANGLE_STRIP))
+            return false;
+
+        src.element = elem;
+        src.position = src.texCoord = src.colour = 0;
+        src.format.hasTexCoord = src.format.hasColour = false;
+        src.format.colourType = VET_COLOUR;
+
+        const VertexDeclaration::VertexElementList& elems =
+            src.op.vertexData->vertexDeclaration->getElements();
+        VertexDeclaration::VertexElementList::const_iterator i, iend = elems.end();
+        for (i = elems.begin(); i != iend; ++i)
+        {
+            if (i->getSemantic() == VES_POSITION && i->getType() == VET_FLOAT3)
+                src.position = &*i;
+            else if (i->getSemantic() == VES_TEXTURE_COORDINATES && i->getIndex() == 0 &&
+                     i->getType() == VET_FLOAT2)
+                src.texCoord = &*i;
+            else if (i->getSemantic() == VES_DIFFUSE && VertexElement::getTypeCount(i->getType()) == 4 &&
+                     VertexElement::getTypeSize(i->getType()) == sizeof(RGBA))
+                src.colour = &*i;
+            else
+                return false;
+
+            // the vertices are read back from the shadow copy, unless the buffer is in system memory
+            const HardwareVertexBufferSharedPtr& vbuf = src.op.vertexData->vertexBufferBinding->getBuffer(i->getSource());
+            if (!vbuf->hasShadowBuffer() && !vbuf->isSystemMemory())
+                return false;
+        }
+
+        if (!src.position)
+            return false;
+
+        src.format.hasTexCoord = src.texCoord != 0;
+        src.format.hasColour = src.colour != 0;
+        if (src.colour)
+            src.format.colourType = src.colour->getType();
+
+        size_t count = src.op.vertexData->vertexCount;
+        if (src.op.operationType == RenderOperation::OT_TRIANGLE_STRIP)
+            src.vertexCount = count > 2 ? (count - 2) * 3 : 0;
+        else
+            src.vertexCount = count - count % 3;
+
+        return true;
+    }
+    //---------------------------------------------------------------------
+    RealRect OverlayBatch::getBounds(const Source& src)
+    {
+        const VertexData* vertexData = src.op.vertexData;
+        HardwareVertexBufferSharedPtr vbuf =
+            vertexData->vertexBufferBinding->getBuffer(src.position->getSource());
+        HardwareBufferLockGuard lock(vbuf, HardwareBuffer::HBL_READ_ONLY);
+
+        RealRect bounds(Math::POS_INFINITY, Math::POS_INFINITY, Math::NEG_INFINITY, Math::NEG_INFINITY);
+        const uchar* pVert = static_cast<const uchar*>(lock.pData) +
+            vertexData->vertexStart * vbuf->getVertexSize() + src.position->getOffset();
+        for (size_t v = 0; v < vertexData->vertexCount; ++v, pVert += vbuf->getVertexSize())
+        {
+            const float* pos = reinterpret_cast<const float*>(pVert);
+            bounds.left = std::min(bounds.left, (Real)pos[0]);
+            bounds.right = std::max(bounds.right, (Real)pos[0]);
+            bounds.top = std::min(bounds.top, (Real)pos[1]);
+            bounds.bottom = std::max(bounds.bottom, (Real)pos[1]);
+        }
+        return bounds;
+    }
+    //---------------------------------------------------------------------
+    void OverlayBatch::copyVertices(const Source& src, uchar* dest, size_t vertexSize)
+    {
+        const VertexElement* elems[3] = { src.position, src.texCoord, src.colour };
+        const size_t sizes[3] = { 3 * sizeof(float), 2 * sizeof(float), sizeof(RGBA) };
+        const uchar* data[3] = { 0, 0, 0 };
+        size_t strides[3] = { 0, 0, 0 };
+
+        // Lock every buffer once, an element may keep several attributes in one
+        VertexBufferBinding* bind = src.op.vertexData->vertexBufferBinding;
+        HardwareVertexBufferSharedPtr buffers[3];
+        const uchar* locked[3] = { 0, 0, 0 };
+        for (int e = 0; e < 3; ++e)
+        {
+            if (!elems[e])
+                continue;
+
+            buffers[e] = bind->getBuffer(elems[e]->getSource());
+            for (int prev = 0; prev < e; ++prev)
+            {
+                if (locked[prev] && buffers[prev] == buffers[e])
+                {
+                    data[e] = locked[prev];
+                    break;
+                }
+            }
+            if (!data[e])
+            {
+                locked[e] = static_cast<const uchar*>(buffers[e]->lock(HardwareBuffer::HBL_READ_ONLY));
+                data[e] = locked[e];
+            }
+            strides[e] = buffers[e]->getVertexSize();
+            data[e] += src.op.vertexData->vertexStart * strides[e] + elems[e]->getOffset();
+        }
+
+        bool strip = src.op.operationType == RenderOperation::OT_TRIANGLE_STRIP;
+        for (size_t i = 0; i < src.vertexCount; ++i)
+        {
+            // Strips are turned into lists, every second triangle is flipped to keep the winding
+            size_t v = i;
+            if (strip)
+            {
+                size_t tri = i / 3, corner = i % 3;
+                v = (tri & 1) && corner < 2 ? tri + 1 - corner : tri + corner;
+            }
+
+            uchar* pDest = dest + i * vertexSize;
+            for (int e = 0; e < 3; ++e)
+            {
+                if (!elems[e])
+                    continue;
+                memcpy(pDest, data[e] + v * strides[e], sizes[e]);
+                pDest += sizes[e];
+            }
+        }
+
+        for (int e = 0; e < 3; ++e)
+        {
+            if (locked[e])
+                buffers[e]->unlock();
+        }
+    }
+    //---------------------------------------------------------------------
+    void OverlayBatch::setFormat(const Format& format)
+    {
+        mFormat = format;
+
+        VertexDeclaration* decl = mRenderOp.vertexData->vertexDeclaration;
+        decl->removeAllElements();
+        size_t offset = 0;
+        offset += decl->addElement(0, offset, VET_FLOAT3, VES_POSITION).getSize();
+        if (format.hasTexCoord)
+            offset += decl->addElement(0, offset, VET_FLOAT2, VES_TEXTURE_COORDINATES, 0).getSize();
+        if (format.hasColour)
+            decl->addElement(0, offset, format.colourType, VES_DIFFUSE);
+
+        // The vertex size changed, so the buffer has to be created again
+        mRenderOp.vertexData->vertexBufferBinding->unsetAllBindings();
+        mBuffer.reset();
+        mMembers.clear();
+    }
+    //---------------------------------------------------------------------
+    void OverlayBatch::update(const SourceList& sources, const IndexList& members)
+    {
+        const Source& first = sources[members.front()];
+        mMaterial = first.element->getMaterial();
+        mZOrder = first.element->getZOrder();
+
+        if (!(first.format == mFormat) || !mBuffer)
+            setFormat(first.format);
+
+        bool layoutChanged = members.size() != mMembers.size();
+        size_t vertexCount = 0, dirtyCount = 0;
+        for (size_t i = 0; i < members.size(); ++i)
+        {
+            const Source& src = sources[members[i]];
+            vertexCount += src.vertexCount;
+
+            if (layoutChanged)
+                continue;
+            if (mMembers[i].element != src.element || mMembers[i].vertexCount != src.vertexCount)
+                layoutChanged = true;
+            else if (mMembers[i].revision != src.element->_getGeometryRevision())
+                dirtyCount += src.vertexCount;
+        }
+
+        size_t vertexSize = mRenderOp.vertexData->vertexDeclaration->getVertexSize(0);
+        if (!mBuffer || mBuffer->getNumVertices() < vertexCount)
+        {
+            // Grow by doubling, the batches of a HUD seldom change their size much
+            size_t capacity = mBuffer ? mBuffer->getNumVertices() * 2 : 0;
+            mBuffer = HardwareBufferManager::getSingleton().createVertexBuffer(
+                vertexSize, std::max(capacity, vertexCount), HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+            mRenderOp.vertexData->vertexBufferBinding->setBinding(0, mBuffer);
+            layoutChanged = true;
+        }
+        mRenderOp.vertexData->vertexCount = vertexCount;
+
+        if (layoutChanged || dirtyCount * 2 > vertexCount)
+        {
+            // Rewrite everything
+            mMembers.resize(members.size());
+            HardwareBufferLockGuard lock(mBuffer, 0, vertexCount * vertexSize, HardwareBuffer::HBL_DISCARD);
+            size_t vertexStart = 0;
+            for (size_t i = 0; i < members.size(); ++i)
+            {
+                const Source& src = sources[members[i]];
+                copyVertices(src, static_cast<uchar*>(lock.pData) + vertexStart * vertexSize, vertexSize);
+
+                Member& member = mMembers[i];
+                member.element = src.element;
+                member.revision = src.element->_getGeometryRevision();
+                member.vertexStart = vertexStart;
+                member.vertexCount = src.vertexCount;
+                vertexStart += src.vertexCount;
+            }
+        }
+        else if (dirtyCount)
+        {
+            // Only rewrite the members which changed
+            for (size_t i = 0; i < members.size(); ++i)
+            {
+                Member& member = mMembers[i];
+                if (member.revision == member.element->_getGeometryRevision())
+                    continue;
+
+                if (member.vertexCount)
+                {
+                    HardwareBufferLockGuard lock(mBuffer, member.vertexStart * vertexSize,
+                                                 member.vertexCount * vertexSize, HardwareBuffer::HBL_NORMAL);
+                    copyVertices(sources[members[i]], static_cast<uchar*>(lock.pData), vertexSize);
+                }
+                member.revision = member.element->_getGeometryRevision();
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    OverlayBatcher::OverlayBatcher(const Overlay* overlay) : mOverlay(overlay), mNumBatches(0), mFrame(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    OverlayBatcher::~OverlayBatcher()
+    {
+        for (size_t i = 0; i < mBatches.size(); ++i)
+            OGRE_DELETE mBatches[i];
+    }
+    //---------------------------------------------------------------------
+    void OverlayBatcher::begin(void)
+    {
+        mSources.clear();
+        mGroups.clear();
+    }
+    //---------------------------------------------------------------------
+    bool OverlayBatcher::addElement(OverlayElement* elem)
+    {
+        mSources.push_back(OverlayBatch::Source());
+        OverlayBatch::Source& src = mSources.back();
+        if (!OverlayBatch::getSource(elem, src))
+        {
+            mSources.pop_back();
+            return false;
+        }
+        if (!src.vertexCount)
+        {
+            // nothing to draw
+            mSources.pop_back();
+            return true;
+        }
+
+        RealRect bounds = getBounds(src);
+
+        // Find the last batch it can join without changing the result
+        for (size_t g = mGroups.size(); g-- > 0;)
+        {
+            Group& group = mGroups[g];
+            if (group.members.size() && group.material == elem->getMaterial().get() &&
+                group.format == src.format)
+            {
+                group.members.push_back(mSources.size() - 1);
+                group.bounds.merge(bounds);
+                return true;
+            }
+            if (overlaps(group.bounds, bounds))
+                break;
+        }
+
+        mGroups.push_back(Group());
+        Group& group = mGroups.back();
+        group.material = elem->getMaterial().get();
+        group.format = src.format;
+        group.bounds = bounds;
+        group.members.push_back(mSources.size() - 1);
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void OverlayBatcher::addBarrier(OverlayElement* elem)
+    {
+        // Assume the renderable stays within the area of the element
+        Real left = elem->_getDerivedLeft() * 2 - 1;
+        Real top = -(elem->_getDerivedTop() * 2 - 1);
+        RealRect bounds(left, top - elem->getHeight() * 2, left + elem->getWidth() * 2, top);
+
+        if (mGroups.size() && mGroups.back().members.empty())
+        {
+            mGroups.back().bounds.merge(bounds);
+            return;
+        }
+        mGroups.push_back(Group());
+        mGroups.back().material = 0;
+        mGroups.back().bounds = bounds;
+    }
+    //---------------------------------------------------------------------
+    void OverlayBatcher::end(RenderQueue* queue)
+    {
+        mNumBatches = 0;
+        for (size_t g = 0; g < mGroups.size(); ++g)
+        {
+            const Group& group = mGroups[g];
+            if (group.members.empty())
+                continue;
+
+            if (group.members.size() == 1)
+            {
+                OverlayElement* elem = mSources[group.members.front()].element;
+                queue->addRenderable(elem, RENDER_QUEUE_OVERLAY, elem->getZOrder());
+                continue;
+            }
+
+            if (mNumBatches == mBatches.size())
+                mBatches.push_back(OGRE_NEW OverlayBatch(mOverlay));
+            OverlayBatch* batch = mBatches[mNumBatches++];
+            batch->update(mSources, group.members);
+            queue->addRenderable(batch, RENDER_QUEUE_OVERLAY, batch->getZOrder());
+        }
+
+        // Forget the bounds of elements which were not seen this frame
+        for (BoundsMap::iterator i = mBounds.begin(); i != mBounds.end();)
+        {
+            if (i->second.frame != mFrame)
+                mBounds.erase(i++);
+            else
+                ++i;
+        }
+        ++mFrame;
+    }
+    //---------------------------------------------------------------------
+    const RealRect& OverlayBatcher::getBounds(const OverlayBatch::Source& src)
+    {
+        uint32 revision = src.element->_getGeometryRevision();
+        BoundsMap::iterator i = mBounds.find(src.element);
+        if (i == mBounds.end())
+        {
+            i = mBounds.insert(BoundsMap::value_type(src.element, CachedBounds())).first;
+            i->second.revision = revision;
+            i->second.bounds = OverlayBatch::getBounds(src);
+        }
+        else if (i->second.revision != revision)
+        {
+            i->second.revision = revision;
+            i->second.bounds = OverlayBatch::getBounds(src);
+        }
+        i->second.frame = mFrame;
+        return i->second.bounds;
+    }
+    //---------------------------------------------------------------------
+    bool OverlayBatcher::overlaps(const RealRect& a, const RealRect& b)
+    {
+        return a.left < b.right && b.left < a.right && a.top < b.bottom && b.top < a.bottom;
+    }
+}
@@ -81,6 +81,8 @@ namespace Ogre {
       , mEnabled(true)
       , mInitialised(false)
       , mSourceTemplate(0)
+      , mGeometryRevision(0)
+      , mShadowBuffers(false)
     {
         // default overlays to preserve their own detail level
         mPolygonModeOverrideable = false;
@@ -415,6 +417,7 @@ namespace Ogre {
         if (mGeomPositionsOutOfDate && mInitialised)
         {
             updatePositionGeometry();
+            _notifyGeometryChanged();
 
             // Within updatePositionGeometry() of TextOverlayElements,
             // the needed pixel width is calculated and as a result a new 
@@ -431,10 +434,19 @@ namespace Ogre {
         if (mGeomUVsOutOfDate && mInitialised)
         {
             updateTextureGeometry();
+            _notifyGeometryChanged();
             mGeomUVsOutOfDate = false;
         } 
     }
     //---------------------------------------------------------------------
+    void OverlayElement::_notifyGeometryChanged(void)
+    {
+        // Unique over all elements, so a deleted element is never mistaken
+        // for a new one created at the same address
+        static uint32 revisionCounter = 0;
+        mGeometryRevision = ++revisionCounter;
+    }
+    //---------------------------------------------------------------------
     void OverlayElement::_updateFromParent(void)
     {
         Real parentLeft = 0, parentTop = 0, parentBottom = 0, parentRight = 0;
@@ -526,6 +538,18 @@ namespace Ogre {
         mParent = parent;
         mOverlay = overlay;
 
+        // The batching reads the vertices back, so it needs shadow buffers. Keep
+        // them when the element is only removed from the overlay.
+        if (mOverlay && mOverlay->isBatchingEnabled() != mShadowBuffers)
+        {
+            mShadowBuffers = mOverlay->isBatchingEnabled();
+            if (mInitialised)
+            {
+                _releaseManualHardwareResources();
+                _restoreManualHardwareResources();
+            }
+        }
+
         if (mOverlay && mOverlay->isInitialised() && !mInitialised)
         {
             initialise();
@@ -633,7 +657,10 @@ namespace Ogre {
     {
         if (mVisible)
         {
-            queue->addRenderable(this, RENDER_QUEUE_OVERLAY, mZOrder);
+            if (mOverlay)
+                mOverlay->_queueElement(this, queue);
+            else
+                queue->addRenderable(this, RENDER_QUEUE_OVERLAY, mZOrder);
         }      
     }
     //---------------------------------------------------------------------
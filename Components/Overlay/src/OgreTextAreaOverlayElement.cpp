@@ -73,6 +73,7 @@ namespace Ogre {
         mSpaceWidth = 0;
         mPixelSpaceWidth = 0;
         mViewportAspectCoef = 1;
+        mGlyphGeneration = 0;
 
         if (createParamDictionary("TextAreaOverlayElement"))
         {
@@ -142,7 +143,7 @@ namespace Ogre {
                 createVertexBuffer(
                     decl->getVertexSize(POS_TEX_BINDING), 
                     allocatedVertexCount,
-                    HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+                    HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY, mShadowBuffers);
         bind->setBinding(POS_TEX_BINDING, vbuf);
 
         // colours
@@ -150,7 +151,7 @@ namespace Ogre {
                 createVertexBuffer(
                     decl->getVertexSize(COLOUR_BINDING), 
                     allocatedVertexCount,
-                    HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY);
+                    HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY, mShadowBuffers);
         bind->setBinding(COLOUR_BINDING, vbuf);
 
         // Buffers are restored, but with trash within
@@ -182,6 +183,17 @@ namespace Ogre {
         size_t charlen = mCaption.size();
         checkMemoryAllocation( charlen );
 
+        // Keep the glyphs of the caption in the texture until the geometry is built
+        mFont->_pinGlyphs();
+        if (mFont->isDynamic())
+        {
+            // Adding glyphs to the texture may move the others, so do it before
+            // any texture coordinates are used
+            for (DisplayString::iterator i = mCaption.begin(); i != mCaption.end(); ++i)
+                mFont->getGlyphAspectRatio(OGRE_DEREF_DISPLAYSTRING_ITERATOR(i));
+        }
+        mGlyphGeneration = mFont->_getGlyphGeneration();
+
         mRenderOp.vertexData->vertexCount = charlen * 6;
         // Get position / texcoord buffer
         const HardwareVertexBufferSharedPtr& vbuf = 
@@ -356,6 +368,9 @@ namespace Ogre {
 
         if (getWidth() < largestWidth)
             setWidth(largestWidth);
+
+        mFont->_unpinGlyphs();
+        mFont->_updateTexture();
     }
 
     void TextAreaOverlayElement::updateTextureGeometry()
@@ -631,11 +646,16 @@ namespace Ogre {
             break;
         }
 
+        // glyphs of dynamic fonts may have moved in the texture
+        if (mFont && mFont->_getGlyphGeneration() != mGlyphGeneration)
+            mGeomPositionsOutOfDate = true;
+
         OverlayElement::_update();
 
         if (mColoursChanged && mInitialised)
         {
             updateColours();
+            _notifyGeometryChanged();
             mColoursChanged = false;
         }
     }
@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include "OgrePagingPrerequisites.h"
 #include "OgrePageStrategy.h"
+#include "OgrePagePrefetcher.h"
 #include "OgreVector2.h"
 #include "OgreVector3.h"
 
@@ -136,6 +137,8 @@ namespace Ogre
         int32 mMinCellY;
         int32 mMaxCellX;
         int32 mMaxCellY;
+        /// Velocity aware loading, disabled by default
+        PagePrefetcher mPrefetcher;
 
         void updateDerivedMetrics();
 
@@ -192,6 +195,14 @@ namespace Ogre
         /// get the index range of all cells (values outside this will be ignored)
         virtual int32 getCellRangeMaxY() const { return mMaxCellY; }
 
+        /** Get the settings and state of loading pages ahead of moving cameras.
+        @remarks
+            When prefetching is enabled, pages are loaded within a circle of the load
+            radius stretched along the direction of travel instead of the square
+            region used otherwise.
+        */
+        PagePrefetcher& getPrefetcher() { return mPrefetcher; }
+
         /// Load this data from a stream (returns true if successful)
         bool load(StreamSerialiser& stream);
         /// Save this data to a stream
@@ -234,11 +245,15 @@ namespace Ogre
         ~Grid2DPageStrategy();
 
         // Overridden members
+        void frameStart(Real timeSinceLastFrame, PagedWorldSection* section);
         void notifyCamera(Camera* cam, PagedWorldSection* section);
         PageStrategyData* createData();
         void destroyData(PageStrategyData* d);
         void updateDebugDisplay(Page* p, SceneNode* sn);
         PageID getPageID(const Vector3& worldPos, PagedWorldSection* section);
+    protected:
+        /// notifyCamera when prefetching is enabled
+        void prefetchPages(Camera* cam, PagedWorldSection* section);
     };
 
     /** @} */
@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include "OgrePagingPrerequisites.h"
 #include "OgrePageStrategy.h"
+#include "OgrePagePrefetcher.h"
 #include "OgreVector3.h"
 
 namespace Ogre
@@ -120,6 +121,8 @@ namespace Ogre
         int32 mMaxCellX;
         int32 mMaxCellY;
         int32 mMaxCellZ;
+        /// Velocity aware loading, disabled by default
+        PagePrefetcher mPrefetcher;
 
     public:
         static const uint32 CHUNK_ID;
@@ -172,6 +175,14 @@ namespace Ogre
         /// get the index range of all cells (values outside this will be ignored)
         virtual int32 getCellRangeMaxZ() const { return mMaxCellZ; }
 
+        /** Get the settings and state of loading pages ahead of moving cameras.
+        @remarks
+            When prefetching is enabled, pages are loaded within a sphere of the load
+            radius stretched along the direction of travel, whether they are visible
+            or not. Pages behind the camera are loaded only when visible.
+        */
+        PagePrefetcher& getPrefetcher() { return mPrefetcher; }
+
         /// Load this data from a stream (returns true if successful)
         bool load(StreamSerialiser& stream);
         /// Save this data to a stream
@@ -208,11 +219,15 @@ namespace Ogre
         ~Grid3DPageStrategy();
 
         // Overridden members
+        void frameStart(Real timeSinceLastFrame, PagedWorldSection* section);
         void notifyCamera(Camera* cam, PagedWorldSection* section);
         PageStrategyData* createData();
         void destroyData(PageStrategyData* d);
         void updateDebugDisplay(Page* p, SceneNode* sn);
         PageID getPageID(const Vector3& worldPos, PagedWorldSection* section);
+    protected:
+        /// notifyCamera when prefetching is enabled
+        void prefetchPages(Camera* cam, PagedWorldSection* section);
     };
 
     /*@}*/
@@ -59,6 +59,12 @@ namespace Ogre
         uint16 mWorkQueueChannel;
         bool mDeferredProcessInProgress;
         bool mModified;
+        /// Time of the pending load request, in microseconds
+        unsigned long mRequestTime;
+        /// The pending load request
+        WorkQueue::RequestID mRequestID;
+        Real mLoadPriority;
+        Real mLoadLatency;
 
         SceneNode* mDebugNode;
         void updateDebugDisplay();
@@ -126,6 +132,19 @@ namespace Ogre
         @param synchronous Whether to force this to happen synchronously.
         */
         virtual void load(bool synchronous);
+
+        /** Set the priority of loading this page in the background.
+        @remarks
+            Pages with a higher priority are prepared first. The priority of a 
+            page which is already waiting to be prepared is updated, so the
+            order can follow the camera. A page that is unloaded while it 
+            is still waiting is taken off the WorkQueue.
+        */
+        void setLoadPriority(Real priority);
+        /// Get the priority of loading this page in the background
+        Real getLoadPriority() const { return mLoadPriority; }
+        /// Get the time from the last load request to its completion, in seconds
+        Real getLoadLatency() const { return mLoadLatency; }
         /** Unload this page. 
         */
         virtual void unload();
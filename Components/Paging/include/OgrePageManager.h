@@ -432,6 +432,67 @@ namespace Ogre
         /** Get whether paging operations are currently allowed to happen. */
         bool getPagingOperationsEnabled() const { return mPagingEnabled; }
 
+        /** Set the number of pages which are prepared in the background at the same time.
+        @remarks
+            Pages over this number wait in the WorkQueue, ordered by their priority
+            (see PagedWorldSection::requestPage), and are dropped from it when they
+            are unloaded before their turn came. This keeps the workers free for
+            other requests and leaves pages which are not needed anymore unprepared.
+            The limit applies to the pages of all PageManagers.
+        @param count The number of pages, 0 for no limit (the default)
+        */
+        void setMaxConcurrentLoads(size_t count);
+        /// Get the number of pages which are prepared in the background at the same time
+        size_t getMaxConcurrentLoads() const;
+
+        /// Counters of the paging activity of all worlds, see getStatistics
+        struct Statistics
+        {
+            /// Pages requested to load
+            size_t pagesRequested;
+            /// Pages whose loading has completed
+            size_t pagesLoaded;
+            /** Pages unloaded before their loading completed, or requested again 
+                within the thrash window after being unloaded */
+            size_t pagesThrashed;
+            /// Sum of the time from request to completion of the loaded pages, in seconds
+            Real totalLoadLatency;
+            /// Longest time from request to completion of a page, in seconds
+            Real maxLoadLatency;
+
+            Statistics()
+                : pagesRequested(0), pagesLoaded(0), pagesThrashed(0)
+                , totalLoadLatency(0), maxLoadLatency(0) {}
+
+            /// Average time from request to completion of a page, in seconds
+            Real getAverageLoadLatency() const
+            { return pagesLoaded ? totalLoadLatency / pagesLoaded : 0; }
+        };
+
+        /** Get the counters of the paging activity.
+        @remarks
+            These help to tune the load and hold radius and the prefetching of
+            the strategies: a high latency means pages are requested too late,
+            thrashing means they are released too early.
+        */
+        const Statistics& getStatistics() const { return mStatistics; }
+        /// Reset the counters of the paging activity
+        void resetStatistics() { mStatistics = Statistics(); }
+
+        /** Set the time after unloading a page in which loading it again counts as thrashing.
+        @param seconds The time, 5 by default
+        */
+        void setThrashWindow(Real seconds) { mThrashWindow = seconds; }
+        /// Get the time after unloading a page in which loading it again counts as thrashing
+        Real getThrashWindow() const { return mThrashWindow; }
+
+        /// Internal method to notify that a page load was requested
+        void _notifyPageRequested() { ++mStatistics.pagesRequested; }
+        /// Internal method to notify that a page load has completed
+        void _notifyPageLoaded(Real latency);
+        /// Internal method to notify that a page was thrashed
+        void _notifyPageThrashed() { ++mStatistics.pagesThrashed; }
+
 
     protected:
 
@@ -466,6 +527,8 @@ namespace Ogre
         EventRouter mEventRouter;
         uint8 mDebugDisplayLvl;
         bool mPagingEnabled;
+        Statistics mStatistics;
+        Real mThrashWindow;
 
         Grid2DPageStrategy* mGrid2DPageStrategy;
         Grid3DPageStrategy* mGrid3DPageStrategy;
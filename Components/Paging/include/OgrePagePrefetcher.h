@@ -0,0 +1,126 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __Ogre_PagePrefetcher_H__
+#define __Ogre_PagePrefetcher_H__
+
+#include "OgrePagingPrerequisites.h"
+#include "OgreVector3.h"
+
+namespace Ogre
+{
+    /** \addtogroup Optional
+    *  @{
+    */
+    /** \addtogroup Paging
+    *  Some details on paging component
+    *  @{
+    */
+
+    /** Helper for page strategies which load pages ahead of the cameras.
+    @remarks
+        The velocity of each camera is estimated from its positions in successive
+        frames. Pages are then selected by a distance which is stretched along the
+        path the camera will travel during the look-ahead time, and shrunk behind it, 
+        so fast cameras load pages before they reach them and release the pages they
+        left behind earlier. Load requests are issued in order of the actual distance
+        plus the stretched one, so pages on the path ahead come first, in the order
+        the camera will reach them.
+    @par
+        Each PagedWorldSection has its own instance, held by the PageStrategyData of
+        the grid strategies. Prefetching is disabled until a look-ahead time is set.
+        These settings are not saved with the section.
+    */
+    class _OgrePagingExport PagePrefetcher : public PageAlloc
+    {
+    public:
+        PagePrefetcher();
+
+        /** Set the time ahead of the camera that pages are loaded for.
+        @param seconds The look-ahead time, 0 disables prefetching
+        */
+        void setLookAheadTime(Real seconds) { mLookAheadTime = seconds; }
+        /// Get the time ahead of the camera that pages are loaded for
+        Real getLookAheadTime() const { return mLookAheadTime; }
+        /// Whether prefetching is enabled
+        bool isEnabled() const { return mLookAheadTime > 0; }
+
+        /** Set how much the load and hold radius shrink directly behind a moving camera.
+        @param scale Factor applied to the radius, between 0 (exclusive) and 1
+        */
+        void setTrailingScale(Real scale);
+        /// Get how much the load and hold radius shrink behind a moving camera
+        Real getTrailingScale() const { return mTrailingScale; }
+
+        /// Advance the clock of this section, to be called from PageStrategy::frameStart
+        void frameStart(Real timeSinceLastFrame);
+
+        /** Update the motion of a camera.
+        @param cam The camera, only used to identify it
+        @param position The position of the camera, in the space of the strategy
+        @return The distance the camera travels in the look-ahead time
+        */
+        const Vector3& updateCamera(const Camera* cam, const Vector3& position);
+
+        /** Get the distance used to select and order pages.
+        @param offset The position of the page relative to the camera
+        @param lookAhead The travel returned by updateCamera
+        */
+        Real getPrefetchDistance(const Vector3& offset, const Vector3& lookAhead) const;
+
+        /** Queue a page to be loaded by issueRequests
+        @param pageID The page to load
+        @param order The order of the request, lower values are loaded first
+        */
+        void addRequest(PageID pageID, Real order);
+        /// Request the queued pages, with a priority which follows their order
+        void issueRequests(PagedWorldSection* section);
+
+    protected:
+        struct CameraMotion
+        {
+            Vector3 position;
+            Vector3 velocity;
+            Vector3 lookAhead;
+            Real time;
+        };
+        typedef std::map<const Camera*, CameraMotion> CameraMotionMap;
+        CameraMotionMap mCameras;
+        typedef std::vector<std::pair<Real, PageID> > RequestList;
+        RequestList mRequests;
+        Real mLookAheadTime;
+        Real mTrailingScale;
+        /// Time elapsed in this section
+        Real mTime;
+    };
+
+    /** @} */
+    /** @} */
+}
+
+#endif
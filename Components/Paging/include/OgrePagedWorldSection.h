@@ -79,6 +79,14 @@ namespace Ogre
         PageMap mPages;
         PageProvider* mPageProvider;
         SceneManager* mSceneMgr;
+        /// Time elapsed in this section
+        Real mTime;
+        typedef std::map<PageID, Real> UnloadTimeMap;
+        /// When pages were unloaded within the thrash window of the PageManager
+        UnloadTimeMap mRecentlyUnloaded;
+
+        /// Create a page which is not loaded yet and start loading it
+        void createPage(PageID pageID, bool forceSynchronous, Real priority);
 
         /// Load data specific to a subtype of this class (if any)
         virtual void loadSubtypeData(StreamSerialiser& ser) {}
@@ -177,6 +185,16 @@ namespace Ogre
         */
         virtual void loadPage(PageID pageID, bool forceSynchronous = false);
 
+        /** Ask for a page to be loaded in the background, ahead of pages with a lower priority.
+        @remarks
+            This is like loadPage, except that the priority of a page which is
+            still waiting to be loaded is updated. Strategies call this every frame
+            for the pages they need, so the loading order follows the camera.
+        @param pageID The page ID to load
+        @param priority Pages with a higher priority are loaded first, see Page::setLoadPriority
+        */
+        virtual void requestPage(PageID pageID, Real priority);
+
         /** Ask for a page to be unloaded with the given (section-relative) PageID
         @remarks
             You would not normally call this manually, the PageStrategy is in 
@@ -290,11 +290,22 @@ namespace Ogre
     Grid2DPageStrategy::~Grid2DPageStrategy()
     {
 
+    }
+    //---------------------------------------------------------------------
+    void Grid2DPageStrategy::frameStart(Real timeSinceLastFrame, PagedWorldSection* section)
+    {
+        Grid2DPageStrategyData* stratData = static_cast<Grid2DPageStrategyData*>(section->getStrategyData());
+        stratData->getPrefetcher().frameStart(timeSinceLastFrame);
     }
     //---------------------------------------------------------------------
     void Grid2DPageStrategy::notifyCamera(Camera* cam, PagedWorldSection* section)
     {
         Grid2DPageStrategyData* stratData = static_cast<Grid2DPageStrategyData*>(section->getStrategyData());
+        if (stratData->getPrefetcher().isEnabled())
+        {
+            prefetchPages(cam, section);
+            return;
+        }
 
         const Vector3& pos = cam->getDerivedPosition();
         Vector2 gridpos;
@@ -338,8 +349,8 @@ namespace Ogre
                 PageID pageID = stratData->calculatePageID(cx, cy);
                 if (cx >= loadxmin && cx <= loadxmax && cy >= loadymin && cy <= loadymax)
                 {
-                    // in the 'load' range, request it
-                    section->loadPage(pageID);
+                    // in the 'load' range, request it, the nearest pages first
+                    section->requestPage(pageID, -Real((cx - x) * (cx - x) + (cy - y) * (cy - y)));
                 }
                 else
                 {
@@ -352,6 +363,57 @@ namespace Ogre
         
 
 
+    }
+    //---------------------------------------------------------------------
+    void Grid2DPageStrategy::prefetchPages(Camera* cam, PagedWorldSection* section)
+    {
+        Grid2DPageStrategyData* stratData = static_cast<Grid2DPageStrategyData*>(section->getStrategyData());
+        PagePrefetcher& prefetcher = stratData->getPrefetcher();
+
+        Vector2 gridpos;
+        stratData->convertWorldToGridSpace(cam->getDerivedPosition(), gridpos);
+        Vector3 lookAhead = prefetcher.updateCamera(cam, Vector3(gridpos.x, gridpos.y, 0));
+
+        Real cellSize = stratData->getCellSize();
+        Real loadRadius = stratData->getLoadRadius();
+        Real holdRadius = stratData->getHoldRadius();
+        // distances are measured to the nearest corner a cell could have
+        Real halfDiagonal = cellSize * 0.7071068f;
+
+        // scan the hold range around the camera and the end of its travel
+        Vector2 travelEnd(gridpos.x + lookAhead.x, gridpos.y + lookAhead.y);
+        Vector2 lo(std::min(gridpos.x, travelEnd.x), std::min(gridpos.y, travelEnd.y));
+        Vector2 hi(std::max(gridpos.x, travelEnd.x), std::max(gridpos.y, travelEnd.y));
+        lo -= Vector2(holdRadius + cellSize, holdRadius + cellSize);
+        hi += Vector2(holdRadius + cellSize, holdRadius + cellSize);
+
+        int32 xmin, ymin, xmax, ymax;
+        stratData->determineGridLocation(lo, &xmin, &ymin);
+        stratData->determineGridLocation(hi, &xmax, &ymax);
+        xmin = std::max(xmin, stratData->getCellRangeMinX());
+        ymin = std::max(ymin, stratData->getCellRangeMinY());
+        xmax = std::min(xmax, stratData->getCellRangeMaxX());
+        ymax = std::min(ymax, stratData->getCellRangeMaxY());
+
+        for (int32 cy = ymin; cy <= ymax; ++cy)
+        {
+            for (int32 cx = xmin; cx <= xmax; ++cx)
+            {
+                Vector2 mid;
+                stratData->getMidPointGridSpace(cx, cy, mid);
+                Vector3 offset(mid.x - gridpos.x, mid.y - gridpos.y, 0);
+                Real dist = std::max(Real(0), prefetcher.getPrefetchDistance(offset, lookAhead) - halfDiagonal);
+
+                PageID pageID = stratData->calculatePageID(cx, cy);
+                if (dist <= loadRadius)
+                    prefetcher.addRequest(pageID, offset.length() + dist);
+                else if (dist <= holdRadius)
+                    section->holdPage(pageID);
+                // other pages will by inference be marked for unloading
+            }
+        }
+
+        prefetcher.issueRequests(section);
     }
     //---------------------------------------------------------------------
     PageStrategyData* Grid2DPageStrategy::createData()
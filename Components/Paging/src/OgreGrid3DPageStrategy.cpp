@@ -241,11 +241,22 @@ namespace Ogre
     Grid3DPageStrategy::~Grid3DPageStrategy()
     {
 
+    }
+    //---------------------------------------------------------------------
+    void Grid3DPageStrategy::frameStart(Real timeSinceLastFrame, PagedWorldSection* section)
+    {
+        Grid3DPageStrategyData* stratData = static_cast<Grid3DPageStrategyData*>(section->getStrategyData());
+        stratData->getPrefetcher().frameStart(timeSinceLastFrame);
     }
     //---------------------------------------------------------------------
     void Grid3DPageStrategy::notifyCamera(Camera* cam, PagedWorldSection* section)
     {
         Grid3DPageStrategyData* stratData = static_cast<Grid3DPageStrategyData*>(section->getStrategyData());
+        if (stratData->getPrefetcher().isEnabled())
+        {
+            prefetchPages(cam, section);
+            return;
+        }
 
         const Vector3& pos = cam->getDerivedPosition();
         int32 x, y, z;
@@ -306,8 +317,9 @@ namespace Ogre
                         stratData->getBottomLeftGridSpace(cx, cy, cz, bl);
                         Ogre::AxisAlignedBox bbox(bl, bl+stratData->getCellSize());
 
+                        // request visible pages, the nearest first
                         if( cam->isVisible(bbox) )
-                            section->loadPage(pageID);
+                            section->requestPage(pageID, -Real((cx - x) * (cx - x) + (cy - y) * (cy - y) + (cz - z) * (cz - z)));
                         else
                             section->holdPage(pageID);
                     }
@@ -322,6 +334,72 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
+    void Grid3DPageStrategy::prefetchPages(Camera* cam, PagedWorldSection* section)
+    {
+        Grid3DPageStrategyData* stratData = static_cast<Grid3DPageStrategyData*>(section->getStrategyData());
+        PagePrefetcher& prefetcher = stratData->getPrefetcher();
+
+        const Vector3& pos = cam->getDerivedPosition();
+        Vector3 lookAhead = prefetcher.updateCamera(cam, pos);
+
+        Vector3 cellSize = stratData->getCellSize();
+        Real loadRadius = stratData->getLoadRadius();
+        Real holdRadius = stratData->getHoldRadius();
+        // distances are measured to the nearest corner a cell could have
+        Real halfDiagonal = cellSize.length() * 0.5f;
+
+        // scan the hold range around the camera and the end of its travel
+        Vector3 lo = pos;
+        lo.makeFloor(pos + lookAhead);
+        Vector3 hi = pos;
+        hi.makeCeil(pos + lookAhead);
+        lo -= cellSize + Vector3(holdRadius);
+        hi += cellSize + Vector3(holdRadius);
+
+        int32 xmin, ymin, zmin, xmax, ymax, zmax;
+        stratData->determineGridLocation(lo, &xmin, &ymin, &zmin);
+        stratData->determineGridLocation(hi, &xmax, &ymax, &zmax);
+        xmin = std::max(xmin, stratData->getCellRangeMinX());
+        ymin = std::max(ymin, stratData->getCellRangeMinY());
+        zmin = std::max(zmin, stratData->getCellRangeMinZ());
+        xmax = std::min(xmax, stratData->getCellRangeMaxX());
+        ymax = std::min(ymax, stratData->getCellRangeMaxY());
+        zmax = std::min(zmax, stratData->getCellRangeMaxZ());
+
+        for (int32 cz = zmin; cz <= zmax; ++cz)
+        {
+            for (int32 cy = ymin; cy <= ymax; ++cy)
+            {
+                for (int32 cx = xmin; cx <= xmax; ++cx)
+                {
+                    Vector3 mid;
+                    stratData->getMidPointGridSpace(cx, cy, cz, mid);
+                    Vector3 offset = mid - pos;
+                    Real dist = std::max(Real(0), prefetcher.getPrefetchDistance(offset, lookAhead) - halfDiagonal);
+
+                    PageID pageID = stratData->calculatePageID(cx, cy, cz);
+                    if (dist <= loadRadius)
+                    {
+                        // pages on the path ahead are needed soon, even when not in view yet
+                        Vector3 bl;
+                        stratData->getBottomLeftGridSpace(cx, cy, cz, bl);
+                        if (offset.dotProduct(lookAhead) > 0 || cam->isVisible(AxisAlignedBox(bl, bl + cellSize)))
+                            prefetcher.addRequest(pageID, offset.length() + dist);
+                        else
+                            section->holdPage(pageID);
+                    }
+                    else if (dist <= holdRadius)
+                    {
+                        section->holdPage(pageID);
+                    }
+                    // other pages will by inference be marked for unloading
+                }
+            }
+        }
+
+        prefetcher.issueRequests(section);
+    }
+    //---------------------------------------------------------------------
     PageStrategyData* Grid3DPageStrategy::createData()
     {
         return OGRE_NEW Grid3DPageStrategyData();
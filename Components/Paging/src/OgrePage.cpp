@@ -38,6 +38,7 @@ THE SOFTWARE.
 #include "OgrePageContentCollection.h"
 #include "OgreLogManager.h"
 #include "OgreFileSystemLayer.h"
+#include "OgreTimer.h"
 #include <iomanip>
 
 namespace Ogre
@@ -55,6 +56,10 @@ namespace Ogre
         , mParent(parent)
         , mDeferredProcessInProgress(false)
         , mModified(false)
+        , mRequestTime(0)
+        , mRequestID(0)
+        , mLoadPriority(0)
+        , mLoadLatency(0)
         , mDebugNode(0)
     {
         WorkQueue* wq = Root::getSingleton().getWorkQueue();
@@ -67,6 +72,9 @@ namespace Ogre
     Page::~Page()
     {
         WorkQueue* wq = Root::getSingleton().getWorkQueue();
+        // don't prepare what nobody is waiting for
+        if (mDeferredProcessInProgress)
+            wq->abortRequest(mRequestID);
         wq->removeRequestHandler(mWorkQueueChannel, this);
         wq->removeResponseHandler(mWorkQueueChannel, this);
 
@@ -184,12 +192,24 @@ namespace Ogre
             destroyAllContentCollections();
             PageRequest req(this);
             mDeferredProcessInProgress = true;
-            Root::getSingleton().getWorkQueue()->addRequest(mWorkQueueChannel, WORKQUEUE_PREPARE_REQUEST, 
-                Any(req), 0, synchronous);
+            mRequestTime = Root::getSingleton().getTimer()->getMicroseconds();
+            getManager()->_notifyPageRequested();
+            mRequestID = Root::getSingleton().getWorkQueue()->addRequestWithPriority(mWorkQueueChannel,
+                WORKQUEUE_PREPARE_REQUEST, Any(req), mLoadPriority, 0, synchronous);
         }
 
     }
     //---------------------------------------------------------------------
+    void Page::setLoadPriority(Real priority)
+    {
+        if (priority == mLoadPriority)
+            return;
+
+        mLoadPriority = priority;
+        if (mDeferredProcessInProgress)
+            Root::getSingleton().getWorkQueue()->setRequestPriority(mRequestID, priority);
+    }
+    //---------------------------------------------------------------------
     void Page::unload()
     {
         destroyAllContentCollections();
@@ -269,6 +289,10 @@ namespace Ogre
 
         mDeferredProcessInProgress = false;
 
+        unsigned long now = Root::getSingleton().getTimer()->getMicroseconds();
+        mLoadLatency = (now - mRequestTime) * 0.000001f;
+        getManager()->_notifyPageLoaded(mLoadLatency);
+
     }
     //---------------------------------------------------------------------
     bool Page::prepareImpl(PageData* dataToPopulate)
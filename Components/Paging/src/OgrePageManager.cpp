@@ -37,6 +37,7 @@ THE SOFTWARE.
 #include "OgreSimplePageContentCollection.h"
 #include "OgreStreamSerialiser.h"
 #include "OgreRoot.h"
+#include "OgreWorkQueue.h"
 #include "OgrePageContent.h"
 
 namespace Ogre
@@ -48,6 +49,7 @@ namespace Ogre
         , mPageResourceGroup(ResourceGroupManager::DEFAULT_RESOURCE_GROUP_NAME)
         , mDebugDisplayLvl(0)
         , mPagingEnabled(true)
+        , mThrashWindow(5)
         , mGrid2DPageStrategy(0)
         , mGrid3DPageStrategy(0)
         , mSimpleCollectionFactory(0)
@@ -505,6 +507,25 @@ namespace Ogre
         return mCameraList;
     }
     //---------------------------------------------------------------------
+    void PageManager::setMaxConcurrentLoads(size_t count)
+    {
+        WorkQueue* wq = Root::getSingleton().getWorkQueue();
+        wq->setMaxConcurrentRequests(wq->getChannel("Ogre/Page"), count);
+    }
+    //---------------------------------------------------------------------
+    size_t PageManager::getMaxConcurrentLoads() const
+    {
+        WorkQueue* wq = Root::getSingleton().getWorkQueue();
+        return wq->getMaxConcurrentRequests(wq->getChannel("Ogre/Page"));
+    }
+    //---------------------------------------------------------------------
+    void PageManager::_notifyPageLoaded(Real latency)
+    {
+        ++mStatistics.pagesLoaded;
+        mStatistics.totalLoadLatency += latency;
+        mStatistics.maxLoadLatency = std::max(mStatistics.maxLoadLatency, latency);
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     void PageManager::EventRouter::cameraPreRenderScene(Camera* cam)
     {
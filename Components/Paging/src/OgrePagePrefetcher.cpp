@@ -0,0 +1,132 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgrePagePrefetcher.h"
+#include "OgrePagedWorldSection.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Time over which the velocity estimate follows the camera
+        const Real VELOCITY_SMOOTHING_TIME = 0.25f;
+        /// Cameras not seen for longer than this start over from rest, and are eventually forgotten
+        const Real CAMERA_TIMEOUT = 1.0f;
+    }
+    //---------------------------------------------------------------------
+    PagePrefetcher::PagePrefetcher()
+        : mLookAheadTime(0)
+        , mTrailingScale(0.5f)
+        , mTime(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    void PagePrefetcher::setTrailingScale(Real scale)
+    {
+        mTrailingScale = Math::Clamp<Real>(scale, 0.01f, 1);
+    }
+    //---------------------------------------------------------------------
+    void PagePrefetcher::frameStart(Real timeSinceLastFrame)
+    {
+        mTime += timeSinceLastFrame;
+
+        for (CameraMotionMap::iterator i = mCameras.begin(); i != mCameras.end(); )
+        {
+            // cameras may be destroyed without notice
+            if (mTime - i->second.time > CAMERA_TIMEOUT * 10)
+                mCameras.erase(i++);
+            else
+                ++i;
+        }
+    }
+    //---------------------------------------------------------------------
+    const Vector3& PagePrefetcher::updateCamera(const Camera* cam, const Vector3& position)
+    {
+        CameraMotionMap::iterator i = mCameras.find(cam);
+        if (i == mCameras.end())
+        {
+            CameraMotion motion;
+            motion.position = position;
+            motion.velocity = Vector3::ZERO;
+            motion.lookAhead = Vector3::ZERO;
+            motion.time = mTime;
+            return mCameras.insert(CameraMotionMap::value_type(cam, motion)).first->second.lookAhead;
+        }
+
+        CameraMotion& motion = i->second;
+        Real elapsed = mTime - motion.time;
+        if (elapsed > CAMERA_TIMEOUT)
+        {
+            motion.velocity = Vector3::ZERO;
+        }
+        else if (elapsed > 0)
+        {
+            // several viewports may notify the same camera within a frame, only
+            // the first one moves it
+            Vector3 velocity = (position - motion.position) / elapsed;
+            Real blend = std::min(Real(1), elapsed / VELOCITY_SMOOTHING_TIME);
+            motion.velocity += (velocity - motion.velocity) * blend;
+        }
+        motion.position = position;
+        motion.time = mTime;
+        motion.lookAhead = motion.velocity * mLookAheadTime;
+        return motion.lookAhead;
+    }
+    //---------------------------------------------------------------------
+    Real PagePrefetcher::getPrefetchDistance(const Vector3& offset, const Vector3& lookAhead) const
+    {
+        Real lookAheadSq = lookAhead.squaredLength();
+        if (lookAheadSq < 1e-6f)
+            return offset.length();
+
+        // Distance to the path travelled in the look-ahead time
+        Real along = offset.dotProduct(lookAhead);
+        if (along >= 0)
+        {
+            Real t = std::min(Real(1), along / lookAheadSq);
+            return (offset - lookAhead * t).length();
+        }
+
+        // Behind the camera, the radius shrinks to the trailing scale right behind it
+        Real dist = offset.length();
+        Real cosAngle = -along / (dist * Math::Sqrt(lookAheadSq));
+        return dist / (1 - (1 - mTrailingScale) * cosAngle);
+    }
+    //---------------------------------------------------------------------
+    void PagePrefetcher::addRequest(PageID pageID, Real order)
+    {
+        mRequests.push_back(RequestList::value_type(order, pageID));
+    }
+    //---------------------------------------------------------------------
+    void PagePrefetcher::issueRequests(PagedWorldSection* section)
+    {
+        std::sort(mRequests.begin(), mRequests.end());
+        for (RequestList::iterator i = mRequests.begin(); i != mRequests.end(); ++i)
+            section->requestPage(i->second, -i->first);
+        mRequests.clear();
+    }
+}
@@ -42,6 +42,7 @@ namespace Ogre
     //---------------------------------------------------------------------
     PagedWorldSection::PagedWorldSection(const String& name, PagedWorld* parent, SceneManager* sm)
         : mName(name), mParent(parent), mStrategy(0), mStrategyData(0), mPageProvider(0), mSceneMgr(sm)
+        , mTime(0)
     {
     }
     //---------------------------------------------------------------------
@@ -202,26 +203,52 @@ namespace Ogre
 
         PageMap::iterator i = mPages.find(pageID);
         if (i == mPages.end())
+            createPage(pageID, sync, 0);
+        else
+            i->second->touch();
+    }
+    //---------------------------------------------------------------------
+    void PagedWorldSection::requestPage(PageID pageID, Real priority)
+    {
+        if (!mParent->getManager()->getPagingOperationsEnabled())
+            return;
+
+        PageMap::iterator i = mPages.find(pageID);
+        if (i == mPages.end())
+            createPage(pageID, false, priority);
+        else
+        {
+            i->second->setLoadPriority(priority);
+            i->second->touch();
+        }
+    }
+    //---------------------------------------------------------------------
+    void PagedWorldSection::createPage(PageID pageID, bool sync, Real priority)
+    {
+        UnloadTimeMap::iterator u = mRecentlyUnloaded.find(pageID);
+        if (u != mRecentlyUnloaded.end())
         {
-            Page* page = OGRE_NEW Page(pageID, this);
-            // try to insert
-            std::pair<PageMap::iterator, bool> ret = mPages.insert(
-                PageMap::value_type(page->getID(), page));
+            getManager()->_notifyPageThrashed();
+            mRecentlyUnloaded.erase(u);
+        }
 
-            if (!ret.second)
+        Page* page = OGRE_NEW Page(pageID, this);
+        // try to insert
+        std::pair<PageMap::iterator, bool> ret = mPages.insert(
+            PageMap::value_type(page->getID(), page));
+
+        if (!ret.second)
+        {
+            // page with this ID already in map
+            if (ret.first->second != page)
             {
-                // page with this ID already in map
-                if (ret.first->second != page)
-                {
-                    // replacing a page, delete the old one
-                    OGRE_DELETE ret.first->second;
-                    ret.first->second = page;
-                }
+                // replacing a page, delete the old one
+                OGRE_DELETE ret.first->second;
+                ret.first->second = page;
             }
-            page->load(sync);
         }
-        else
-            i->second->touch();
+        page->setLoadPriority(priority);
+        page->load(sync);
     }
     //---------------------------------------------------------------------
     void PagedWorldSection::unloadPage(PageID pageID, bool sync)
@@ -235,6 +262,12 @@ namespace Ogre
             Page* page = i->second;
             mPages.erase(i);
 
+            // the work of loading it was wasted
+            if (page->isDeferredProcessInProgress())
+                getManager()->_notifyPageThrashed();
+            else
+                mRecentlyUnloaded[pageID] = mTime;
+
             page->unload();
 
             OGRE_DELETE page;
@@ -322,6 +355,7 @@ namespace Ogre
     //---------------------------------------------------------------------
     void PagedWorldSection::frameStart(Real timeSinceLastFrame)
     {
+        mTime += timeSinceLastFrame;
         mStrategy->frameStart(timeSinceLastFrame, this);
 
         for (PageMap::iterator i = mPages.begin(); i != mPages.end(); ++i)
@@ -344,6 +378,15 @@ namespace Ogre
                 p->frameEnd(timeElapsed);
         }
 
+        Real thrashWindow = getManager()->getThrashWindow();
+        for (UnloadTimeMap::iterator i = mRecentlyUnloaded.begin(); i != mRecentlyUnloaded.end(); )
+        {
+            if (mTime - i->second > thrashWindow)
+                mRecentlyUnloaded.erase(i++);
+            else
+                ++i;
+        }
+
     }
     //---------------------------------------------------------------------
     void PagedWorldSection::notifyCamera(Camera* cam)
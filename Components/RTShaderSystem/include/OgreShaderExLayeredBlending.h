@@ -150,6 +150,11 @@ public:
     */
     virtual void copyFrom(const SubRenderState& rhs);
 
+    /** 
+    @see SubRenderState::updateSignature.
+    */
+    virtual bool updateSignature(String& signature) const;
+
     static String Type;
 
 // Protected methods
@@ -47,6 +47,9 @@ A factory that enables creation of LayeredBlending instances.
 	UniformParameterPtr mPSAlphaRef;
 	UniformParameterPtr mPSAlphaFunc;
 	ParameterPtr mPSOutDiffuse;
+	// Alpha rejection settings of the source pass.
+	CompareFunction mAlphaFunc;
+	unsigned char mAlphaRef;
  
 
 
@@ -68,6 +71,7 @@ A factory that enables creation of LayeredBlending instances.
     virtual bool addFunctionInvocations(ProgramSet* programSet);
 
 public:
+	FFPAlphaTest() : mAlphaFunc(CMPF_ALWAYS_PASS), mAlphaRef(0) {}
     
 	/// The type.
 	static String Type;
@@ -86,6 +90,11 @@ public:
     */
     virtual bool preAddToRenderState (const RenderState* renderState, Pass* srcPass, Pass* dstPass);
 
+    /** 
+    @see SubRenderState::updateSignature.
+    */
+    virtual bool updateSignature(String& signature) const;
+
     /** 
     @see SubRenderState::copyFrom.
     */
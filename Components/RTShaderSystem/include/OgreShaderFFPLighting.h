@@ -82,6 +82,11 @@ public:
     */
     virtual bool preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass);
 
+    /** 
+    @see SubRenderState::updateSignature.
+    */
+    virtual bool updateSignature(String& signature) const;
+
     /** normalise the blinn-phong reflection model to make it energy conserving
      *
      * see [this for details](http://www.rorydriscoll.com/2009/01/25/energy-conservation-in-games/)
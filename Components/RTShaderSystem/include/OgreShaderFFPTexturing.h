@@ -83,6 +83,11 @@ public:
     @see SubRenderState::preAddToRenderState.
     */
     virtual bool preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass);
+
+    /** 
+    @see SubRenderState::updateSignature.
+    */
+    virtual bool updateSignature(String& signature) const;
     
     static String Type;
 
@@ -203,7 +208,7 @@ protected:
     /** 
     Determines if the given texture unit state need to use texture transformation matrix.
     */
-    bool needsTextureMatrix(TextureUnitState* textureUnitState);
+    static bool needsTextureMatrix(TextureUnitState* textureUnitState);
 
     /** 
     Determines whether a given texture unit needs to be processed by this srs
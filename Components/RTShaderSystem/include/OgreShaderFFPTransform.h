@@ -71,8 +71,18 @@ public:
     */
     virtual bool createCpuSubPrograms(ProgramSet* programSet);
 
+    /** 
+    @see SubRenderState::createCpuSubProgramParameters.
+    */
+    virtual bool createCpuSubProgramParameters(ProgramSet* programSet);
+
     bool preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass);
 
+    /** 
+    @see SubRenderState::updateSignature.
+    */
+    virtual bool updateSignature(String& signature) const;
+
     static String Type;
 protected:
     bool mSetPointSize;
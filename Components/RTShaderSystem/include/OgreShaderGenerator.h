@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "OgreShaderRenderState.h"
 #include "OgreScriptTranslator.h"
 #include "OgreShaderScriptTranslator.h"
+#include "OgreWorkQueue.h"
 
 
 namespace Ogre {
@@ -52,7 +53,8 @@ namespace RTShader {
 /** Shader generator system main interface. This singleton based class
 enables automatic generation of shader code based on existing material techniques.
 */
-class _OgreRTSSExport ShaderGenerator : public Singleton<ShaderGenerator>, public RTShaderSystemAlloc
+class _OgreRTSSExport ShaderGenerator : public Singleton<ShaderGenerator>,
+    public WorkQueue::RequestHandler, public WorkQueue::ResponseHandler, public RTShaderSystemAlloc
 {
 // Interface.
 public:
@@ -376,6 +378,46 @@ public:
 	*/
 	bool validateMaterialIlluminationPasses(const String& schemeName, const String& materialName, const String& groupName OGRE_RESOURCE_GROUP_INIT);
 
+    /** 
+    Sets whether validateMaterial generates the shader programs asynchronously.
+    @remarks
+    When enabled, the CPU programs and the shader source code of the validated technique are
+    generated by the WorkQueue worker threads. The GPU programs are created on the render thread
+    when the work queue responses are processed, after which the technique is published to its
+    scheme. Until then the material keeps rendering with its original technique.
+    A worker thread holds the generator lock while generating, so calls into the generator
+    wait for the technique being generated. When the asynchronous generation fails, the error
+    is logged and the programs are generated synchronously when the response is processed.
+    validateScheme always generates the shader programs synchronously.
+    The default is false.
+    */
+    void setAsyncTechniqueGeneration(bool enable) { mAsyncTechniqueGeneration = enable; }
+
+    /** 
+    Returns whether validateMaterial generates the shader programs asynchronously.
+    @see setAsyncTechniqueGeneration
+    */
+    bool getAsyncTechniqueGeneration() const { return mAsyncTechniqueGeneration; }
+
+    /** Returns the number of techniques whose shader programs are still being generated asynchronously. */
+    size_t getPendingTechniqueCount() const;
+
+    /** Returns the number of techniques published after asynchronous generation. */
+    size_t getAsyncGeneratedTechniqueCount() const { return mAsyncGeneratedTechniqueCount; }
+
+    /** Returns the accumulated time in microseconds the worker threads spent generating techniques. */
+    uint64 getAsyncGenerationTime() const { return mAsyncGenerationTime; }
+
+    /** Returns the accumulated time in microseconds the render thread spent creating the GPU programs
+    of asynchronously generated techniques.
+    */
+    uint64 getAsyncCompletionTime() const { return mAsyncCompletionTime; }
+
+    /// WorkQueue::RequestHandler override
+    WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
+    /// WorkQueue::ResponseHandler override
+    void handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ);
+
     /** 
     Return custom material Serializer of the shader generator.
     This is useful when you'd like to export certain material that contains shader generator effects.
@@ -465,6 +507,21 @@ protected:
     typedef SGSchemeMap::iterator                   SGSchemeIterator;
     typedef SGSchemeMap::const_iterator             SGSchemeConstIterator;
 
+    /** State shared between a technique and the worker thread generating its programs. */
+    struct SGProgramsRequest
+    {
+        SGProgramsRequest(SGTechnique* techEntry) : technique(techEntry), generationTime(0) {}
+
+        // Held by the worker thread while generating. A work queue mutex, as OGRE_MUTEX
+        // is empty unless resources are loaded in the background.
+        OGRE_WQ_MUTEX(mutex);
+        // The technique to generate, NULL once the request was cancelled.
+        SGTechnique* technique;
+        // Time spent on the worker thread in microseconds.
+        uint64 generationTime;
+    };
+    typedef SharedPtr<SGProgramsRequest>           SGProgramsRequestPtr;
+
     typedef std::map<uint32, ScriptTranslator*>        SGScriptTranslatorMap;
     typedef SGScriptTranslatorMap::iterator         SGScriptTranslatorIterator;
     typedef SGScriptTranslatorMap::const_iterator   SGScriptTranslatorConstIterator;
@@ -484,6 +541,9 @@ protected:
         /** Acquire the CPU/GPU programs for this pass. */
         void acquirePrograms();
 
+        /** Generate the CPU programs and shader source code for this pass. */
+        void preparePrograms();
+
         /** Release the CPU/GPU programs of this pass. */
         void releasePrograms();
 
@@ -560,6 +620,27 @@ protected:
         /** Acquire the CPU/GPU programs for this technique. */
         void acquirePrograms();
 
+        /** Request the CPU/GPU programs of this technique from the work queue.
+        The destination technique is hidden from its scheme until the programs are acquired.
+        */
+        void requestPrograms();
+
+        /** Generate the CPU programs and shader source code of all passes.
+        Called by the worker thread processing the request.
+        */
+        void preparePrograms();
+
+        /** Publish the destination technique and create the GPU programs generated by preparePrograms.
+        Passes without prepared programs are generated synchronously.
+        */
+        void acquirePreparedPrograms();
+
+        /** Cancel a pending programs request, waiting for the worker thread processing it. */
+        void cancelProgramsRequest();
+
+        /** Tells if the programs of this technique are being generated asynchronously. */
+        bool isProgramsRequestPending() const { return mProgramsRequest != NULL; }
+
 		/** Build the render state for illumination passes. */
 		void buildIlluminationTargetRenderState();
 
@@ -620,6 +701,9 @@ protected:
         // Scheme name of destination technique.
         String mDstTechniqueSchemeName;
         bool mOverProgrammable;
+        // Pending asynchronous programs request.
+        SGProgramsRequestPtr mProgramsRequest;
+        WorkQueue::RequestID mProgramsRequestID;
     };
 
     
@@ -998,6 +1082,16 @@ protected:
     bool mCreateShaderOverProgrammablePass;
     // A flag to indicate finalizing
     bool mIsFinalizing;
+    // Work queue channel used for asynchronous technique generation.
+    uint16 mWorkQueueChannel;
+    // Tells whether validateMaterial generates the programs asynchronously.
+    bool mAsyncTechniqueGeneration;
+    // Number of techniques published after asynchronous generation.
+    size_t mAsyncGeneratedTechniqueCount;
+    // Accumulated worker thread time spent on asynchronous generation in microseconds.
+    uint64 mAsyncGenerationTime;
+    // Accumulated render thread time spent on asynchronous generation in microseconds.
+    uint64 mAsyncCompletionTime;
 
     uint32 ID_RT_SHADER_SYSTEM;
 private:
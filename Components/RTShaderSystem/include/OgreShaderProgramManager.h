@@ -84,6 +84,15 @@ public:
     */
     void acquirePrograms(Pass* pass, TargetRenderState* renderState);
 
+    /** Generate the CPU programs and the GPU program source code of the given render state.
+    @remarks
+    This step does not access the render system, so it may run on a worker thread.
+    A subsequent acquirePrograms call creates the GPU programs from the generated source
+    and binds them to the pass, which has to happen on the render thread.
+    @param renderState The render state that describes the program that need to be generated.
+    */
+    void prepareGpuPrograms(TargetRenderState* renderState);
+
     /** Release CPU/GPU programs set associated with the given render state and pass.
     @param pass The pass to release the programs from.
     @param renderState The render state holds the programs.
@@ -94,6 +103,11 @@ public:
     */
     void flushGpuProgramsCache();
 
+    /** Return the number of programs whose source code was reused from the program manifest.
+    @see SubRenderState::updateSignature
+    */
+    size_t getReusedProgramCount() const { return mProgramManifestHits; }
+
 protected:
 
     //-----------------------------------------------------------------------------
@@ -114,6 +128,14 @@ protected:
     typedef ProgramProcessorMap::const_iterator         ProgramProcessorConstIterator;
     typedef std::vector<ProgramProcessor*>             ProgramProcessorList;
 
+    //-----------------------------------------------------------------------------
+    /// A program that was generated for a render state signature.
+    struct ProgramManifestEntry
+    {
+        String name;
+        String source;
+    };
+    typedef std::map<String, ProgramManifestEntry>     ProgramManifest;
     
 protected:
     /** Create default program processors. */
@@ -141,9 +163,29 @@ protected:
     */
     void destroyCpuProgram(Program* shaderProgram);
 
-    /** Create GPU programs for the given program set based on the CPU programs it contains.
+    /** Generate the GPU program source code for the given program set based on the CPU programs it contains.
     @param programSet The program set container.
     */
+    bool generateGpuPrograms(ProgramSet* programSet);
+
+    /** Hash a render state signature together with the target language and profiles.
+    @param signature The signature of the render state, may be empty.
+    @return The hash, or an empty string if the signature is empty.
+    @see TargetRenderState::getSignature
+    */
+    String getSignatureHash(const String& signature);
+
+    /** Find the programs generated for a render state signature before, possibly in a previous run.
+    @param signatureHash The hashed signature of the render state.
+    @param entries Receives the vertex and the fragment program.
+    @return true if both programs were found, so their CPU programs need no function invocations.
+    */
+    bool findManifestPrograms(const String& signatureHash, ProgramManifestEntry* entries);
+
+    /** Create GPU programs for the given program set from its generated source code.
+    @param programSet The program set container.
+    @see generateGpuPrograms
+    */
     bool createGpuPrograms(ProgramSet* programSet);
         
     /** 
@@ -154,20 +196,49 @@ protected:
     */
     static String generateHash(const String& programString, const String& defines);
 
-    /** Create GPU program based on the give CPU program.
+    /** Write the source code of the given CPU program.
     @param shaderProgram The CPU program instance.
     @param programWriter The program writer instance.
     @param language The target shader language.
-    @param profiles The profiles string for program compilation.
-    @param profilesList The profiles string for program compilation as string list.
     @param cachePath The output path to write the program into.
+    @param programName Receives the unique name of the program.
+    @param source Receives the source code of the program.
+    @return false if the program could not be written to the cache path.
     */
-    GpuProgramPtr createGpuProgram(Program* shaderProgram, 
+    bool writeSourceCode(Program* shaderProgram,
         ProgramWriter* programWriter,
         const String& language,
+        const String& cachePath,
+        String& programName,
+        String& source);
+
+    /** Create GPU program from already generated source code.
+    @param shaderProgram The CPU program instance.
+    @param programName The unique name of the program.
+    @param source The source code of the program.
+    @param language The target shader language.
+    @param profiles The profiles string for program compilation.
+    @param profilesList The profiles string for program compilation as string list.
+    */
+    GpuProgramPtr createGpuProgram(Program* shaderProgram,
+        const String& programName,
+        const String& source,
+        const String& language,
         const String& profiles,
-        const StringVector& profilesList,
-        const String& cachePath);
+        const StringVector& profilesList);
+
+    /** Load the program manifest stored in the given shader cache path.
+    @remarks The manifest maps render state signatures to the programs generated for them,
+    so they can be reused across runs. It is discarded if it was written for a different
+    render system, device or driver.
+    */
+    void loadProgramManifest(const String& cachePath);
+
+    /** Write the program manifest back to the shader cache path, if it changed. */
+    void saveProgramManifest();
+
+    /** Return the identity of the render system the generated code depends on. */
+    static String getProgramManifestIdentity();
 
     /** 
     Add program processor instance to this manager.
@@ -202,9 +273,8 @@ protected:
 
 
 protected:
-    
-
-protected:
+    // Guards the program writers and processors which are used from work queue threads.
+    OGRE_WQ_MUTEX(mMutex);
     // CPU programs list.                   
     ProgramList mCpuProgramsList;
     // Map between target language and shader program writer.                   
@@ -219,6 +289,14 @@ protected:
     GpuProgramsMap mFragmentShaderMap;
     // The default program processors.
     ProgramProcessorList mDefaultProgramProcessors;
+    // The programs generated per render state signature.
+    ProgramManifest mProgramManifest;
+    // The shader cache path the manifest belongs to.
+    String mProgramManifestPath;
+    // Tells if the manifest has to be written back.
+    bool mProgramManifestDirty;
+    // Number of programs that were found in the manifest.
+    size_t mProgramManifestHits;
 
 private:
     friend class ProgramSet;
@@ -87,6 +87,14 @@ protected:
     GpuProgramPtr mVSGpuProgram;
     // Fragment shader CPU program.
     GpuProgramPtr mPSGpuProgram;
+    // Name and source code of the generated vertex shader.
+    String mVSName;
+    String mVSSource;
+    // Name and source code of the generated fragment shader.
+    String mPSName;
+    String mPSSource;
+    // Hashed render state signature the source code was generated for, if any.
+    String mSignatureHash;
 
 private:
     friend class ProgramManager;
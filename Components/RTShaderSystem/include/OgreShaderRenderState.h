@@ -162,6 +162,13 @@ public:
     @param pLightList The light list used for the current rendering operation.
     */
     void updateGpuProgramsParams(Renderable* rend, Pass* pass, const AutoParamDataSource* source, const LightList* pLightList);
+
+    /** Build the signature of the code generated for this render state.
+    @param signature Receives the concatenated signatures of all sub render states.
+    @return false if any of the sub render states does not support signatures.
+    @see SubRenderState::updateSignature
+    */
+    bool getSignature(String& signature);
     
 // Protected methods
 protected:
@@ -170,8 +177,10 @@ protected:
     void sortSubRenderStates();
     
     /** Create CPU programs that represent this render state.   
+    @param parametersOnly Only resolve the parameters and dependencies, without function invocations.
+    This is enough to bind the parameters of programs whose source code is reused.
     */
-    bool createCpuPrograms();
+    bool createCpuPrograms(bool parametersOnly = false);
 
     /** Create the program set of this render state.
     */
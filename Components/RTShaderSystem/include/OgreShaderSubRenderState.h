@@ -94,6 +94,14 @@ public:
     */
     virtual bool createCpuSubPrograms(ProgramSet* programSet);
 
+    /** Create only the parameters and dependencies of the sub programs, without function invocations.
+    Used instead of createCpuSubPrograms when the source code of the programs is reused, so only
+    the parameters bound to the GPU programs and updated per object are needed.
+    @param programSet container class of CPU and GPU programs that this sub state will affect on.
+    @see updateSignature
+    */
+    virtual bool createCpuSubProgramParameters(ProgramSet* programSet);
+
     /** Update GPU programs parameters before a rendering operation occurs.
     This method is called in the context of SceneManager::renderSingle object via the RenderObjectListener interface and
     lets this sub render state instance opportunity to update custom GPU program parameters before the rendering action occurs.
@@ -114,6 +122,17 @@ public:
     */
     virtual bool preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass) { return true; }
 
+    /** Append everything that influences the code generated by this sub render state to a signature.
+    The signature of a render state identifies its programs across runs, so the program source
+    does not have to be written and hashed again. Implementations must cover all the properties
+    createCpuSubPrograms depends on. Sub render states overriding createCpuSubPrograms also have
+    to override createCpuSubProgramParameters.
+    @param signature The binary signature to append to.
+    @return false if this sub render state can not describe its code, which disables caching of
+    any render state containing it. This is the default.
+    */
+    virtual bool updateSignature(String& signature) const { return false; }
+
     /** Return the accessor object to this sub render state.
     @see SubRenderStateAccessor.
     */
@@ -126,6 +145,12 @@ public:
 
 // Protected methods
 protected:
+    /** Append a plain value to a signature. @see updateSignature */
+    template <typename T> static void addToSignature(String& signature, const T& value)
+    {
+        signature.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
 
     /** Resolve parameters that this sub render state requires. 
     @param programSet container class of CPU and GPU programs that this sub state will affect on.
@@ -159,6 +159,22 @@ void LayeredBlending::copyFrom(const SubRenderState& rhs)
     mTextureBlends = rhsTexture.mTextureBlends; 
 }
 
+//-----------------------------------------------------------------------
+bool LayeredBlending::updateSignature(String& signature) const
+{
+    if (!FFPTexturing::updateSignature(signature))
+        return false;
+
+    for (size_t i = 0; i < mTextureBlends.size(); ++i)
+    {
+        addToSignature(signature, mTextureBlends[i].blendMode);
+        addToSignature(signature, mTextureBlends[i].sourceModifier);
+        addToSignature(signature, mTextureBlends[i].customNum);
+    }
+
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void LayeredBlending::addPSBlendInvocations(Function* psMain, 
                                          ParameterPtr arg1,
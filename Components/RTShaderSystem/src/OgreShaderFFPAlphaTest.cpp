@@ -69,7 +69,9 @@ namespace Ogre {
 	
 		void FFPAlphaTest::copyFrom( const SubRenderState& rhs )
 		{
-
+			const FFPAlphaTest& rhsAlphaTest = static_cast<const FFPAlphaTest&>(rhs);
+			mAlphaFunc = rhsAlphaTest.mAlphaFunc;
+			mAlphaRef = rhsAlphaTest.mAlphaRef;
 		}
 
 		bool FFPAlphaTest::addFunctionInvocations( ProgramSet* programSet )
@@ -90,7 +92,16 @@ namespace Ogre {
 
 		bool FFPAlphaTest::preAddToRenderState( const RenderState* renderState, Pass* srcPass, Pass* dstPass )
 		{
-			return srcPass->getAlphaRejectFunction() != CMPF_ALWAYS_PASS;
+			mAlphaFunc = srcPass->getAlphaRejectFunction();
+			mAlphaRef = srcPass->getAlphaRejectValue();
+			return mAlphaFunc != CMPF_ALWAYS_PASS;
+		}
+
+		bool FFPAlphaTest::updateSignature( String& signature ) const
+		{
+			addToSignature(signature, mAlphaFunc);
+			addToSignature(signature, mAlphaRef);
+			return true;
 		}
 
 		void FFPAlphaTest::updateGpuProgramsParams( Renderable* rend, Pass* pass, const AutoParamDataSource* source, const LightList* pLightList )
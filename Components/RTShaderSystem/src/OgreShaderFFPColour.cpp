@@ -224,6 +224,13 @@ void FFPColour::copyFrom(const SubRenderState& rhs)
     setResolveStageFlags(rhsColour.mResolveStageFlags);
 }
 
+//-----------------------------------------------------------------------
+bool FFPColour::updateSignature(String& signature) const
+{
+    addToSignature(signature, mResolveStageFlags);
+    return true;
+}
+
 //-----------------------------------------------------------------------
 bool FFPColour::preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass)
 {
@@ -259,6 +259,15 @@ void FFPFog::copyFrom(const SubRenderState& rhs)
     setCalcMode(rhsFog.mCalcMode);
 }
 
+//-----------------------------------------------------------------------
+bool FFPFog::updateSignature(String& signature) const
+{
+    // colour and parameters are uniforms and do not affect the code
+    addToSignature(signature, mFogMode);
+    addToSignature(signature, mCalcMode);
+    return true;
+}
+
 //-----------------------------------------------------------------------
 bool FFPFog::preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass)
 {   
@@ -515,6 +515,19 @@ void FFPLighting::copyFrom(const SubRenderState& rhs)
 	mNormalisedEnable = rhsLighting.mNormalisedEnable;
 }
 
+//-----------------------------------------------------------------------
+bool FFPLighting::updateSignature(String& signature) const
+{
+    addToSignature(signature, mTrackVertexColourType);
+    addToSignature(signature, mSpecularEnable);
+    addToSignature(signature, mNormalisedEnable);
+
+    for (unsigned int i=0; i < mLightParamsList.size(); ++i)
+        addToSignature(signature, mLightParamsList[i].mType);
+
+    return true;
+}
+
 //-----------------------------------------------------------------------
 bool FFPLighting::preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass)
 {
@@ -625,6 +625,43 @@ void FFPTexturing::copyFrom(const SubRenderState& rhs)
     }       
 }
 
+//-----------------------------------------------------------------------
+bool FFPTexturing::updateSignature(String& signature) const
+{
+    addToSignature(signature, mIsPointSprite);
+
+    for (unsigned int i=0; i < mTextureUnitParamsList.size(); ++i)
+    {
+        const TextureUnitParams& curParams = mTextureUnitParamsList[i];
+        TextureUnitState* texUnitState = curParams.mTextureUnitState;
+        if (texUnitState == NULL)
+            return false;
+
+        addToSignature(signature, curParams.mTextureSamplerIndex);
+        addToSignature(signature, curParams.mTextureSamplerType);
+        addToSignature(signature, curParams.mVSInTextureCoordinateType);
+        addToSignature(signature, curParams.mVSOutTextureCoordinateType);
+        addToSignature(signature, curParams.mTexCoordCalcMethod);
+        addToSignature(signature, needsTextureMatrix(texUnitState));
+        addToSignature(signature, texUnitState->getTextureCoordSet());
+
+        // manual blend sources are written as constants
+        for (const LayerBlendModeEx* blend : {&texUnitState->getColourBlendMode(), &texUnitState->getAlphaBlendMode()})
+        {
+            addToSignature(signature, blend->operation);
+            addToSignature(signature, blend->source1);
+            addToSignature(signature, blend->source2);
+            addToSignature(signature, blend->colourArg1);
+            addToSignature(signature, blend->colourArg2);
+            addToSignature(signature, blend->alphaArg1);
+            addToSignature(signature, blend->alphaArg2);
+            addToSignature(signature, blend->factor);
+        }
+    }
+
+    return true;
+}
+
 //-----------------------------------------------------------------------
 bool FFPTexturing::preAddToRenderState(const RenderState* renderState, Pass* srcPass, Pass* dstPass)
 {
@@ -97,6 +97,20 @@ bool FFPTransform::createCpuSubPrograms(ProgramSet* programSet)
     return true;
 }
 
+//-----------------------------------------------------------------------
+bool FFPTransform::createCpuSubProgramParameters(ProgramSet* programSet)
+{
+    Program* vsProgram = programSet->getCpuProgram(GPT_VERTEX_PROGRAM);
+
+    // Same uniforms and dependency as createCpuSubPrograms.
+    vsProgram->resolveParameter(GpuProgramParameters::ACT_WORLDVIEWPROJ_MATRIX);
+    vsProgram->addDependency(FFP_LIB_TRANSFORM);
+
+    if (mSetPointSize && ShaderGenerator::getSingleton().getTargetLanguage() != "hlsl")
+        vsProgram->resolveParameter(GpuProgramParameters::ACT_POINT_PARAMS);
+
+    return true;
+}
 
 //-----------------------------------------------------------------------
 void FFPTransform::copyFrom(const SubRenderState& rhs)
@@ -105,6 +119,13 @@ void FFPTransform::copyFrom(const SubRenderState& rhs)
     mSetPointSize = rhsTransform.mSetPointSize;
 }
 
+//-----------------------------------------------------------------------
+bool FFPTransform::updateSignature(String& signature) const
+{
+    addToSignature(signature, mSetPointSize);
+    return true;
+}
+
 //-----------------------------------------------------------------------
 const String& FFPTransformFactory::getType() const
 {
@@ -25,6 +25,7 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreShaderPrecompiledHeaders.h"
+#include "OgreTimer.h"
 
 namespace Ogre {
 
@@ -38,6 +39,9 @@ String ShaderGenerator::DEFAULT_SCHEME_NAME     = "ShaderGeneratorDefaultScheme"
 String ShaderGenerator::SGPass::UserKey         = "SGPass";
 String ShaderGenerator::SGTechnique::UserKey    = "SGTechnique";
 
+// Scheme of destination techniques whose programs are still being generated.
+static const String PENDING_SCHEME_NAME        = "ShaderGeneratorPendingScheme";
+
 //-----------------------------------------------------------------------
 ShaderGenerator* ShaderGenerator::getSingletonPtr()
 {
@@ -56,7 +60,9 @@ ShaderGenerator::ShaderGenerator() :
     mActiveSceneMgr(NULL), mRenderObjectListener(NULL), mSceneManagerListener(NULL), mScriptTranslatorManager(NULL),
     mMaterialSerializerListener(NULL), mShaderLanguage(""), mProgramManager(NULL), mProgramWriterManager(NULL),
     mFSLayer(0), mFFPRenderStateBuilder(NULL),mActiveViewportValid(false), mVSOutputCompactPolicy(VSOCP_LOW),
-    mCreateShaderOverProgrammablePass(false), mIsFinalizing(false)
+    mCreateShaderOverProgrammablePass(false), mIsFinalizing(false), mWorkQueueChannel(0),
+    mAsyncTechniqueGeneration(false), mAsyncGeneratedTechniqueCount(0), mAsyncGenerationTime(0),
+    mAsyncCompletionTime(0)
 {
     mLightCount[0]              = 0;
     mLightCount[1]              = 0;
@@ -149,6 +155,11 @@ bool ShaderGenerator::_initialize()
 	mResourceGroupListener = new SGResourceGroupListener(this);
 	ResourceGroupManager::getSingleton().addResourceGroupListener(mResourceGroupListener);
 
+    WorkQueue* wq = Root::getSingleton().getWorkQueue();
+    mWorkQueueChannel = wq->getChannel("Ogre/RTShaderSystem");
+    wq->addRequestHandler(mWorkQueueChannel, this);
+    wq->addResponseHandler(mWorkQueueChannel, this);
+
     return true;
 }
 
@@ -225,6 +236,11 @@ void ShaderGenerator::_destroy()
     }
     mTechniqueEntriesMap.clear();
 
+    // All programs requests were cancelled along with their techniques.
+    WorkQueue* wq = Root::getSingleton().getWorkQueue();
+    wq->removeRequestHandler(mWorkQueueChannel, this);
+    wq->removeResponseHandler(mWorkQueueChannel, this);
+
     // Delete material entries.
     for (SGMaterialIterator itMat = mMaterialEntriesMap.begin(); itMat != mMaterialEntriesMap.end(); ++itMat)
     {       
@@ -1154,6 +1170,89 @@ bool ShaderGenerator::validateMaterialIlluminationPasses(const String& schemeNam
 	return itScheme->second->validateIlluminationPasses(materialName, groupName);
 }
 
+//-----------------------------------------------------------------------------
+size_t ShaderGenerator::getPendingTechniqueCount() const
+{
+    OGRE_LOCK_AUTO_MUTEX;
+
+    size_t count = 0;
+    for (SGTechniqueMap::const_iterator itTech = mTechniqueEntriesMap.begin(); itTech != mTechniqueEntriesMap.end(); ++itTech)
+    {
+        if (itTech->second->isProgramsRequestPending())
+            count++;
+    }
+
+    return count;
+}
+
+//-----------------------------------------------------------------------------
+WorkQueue::Response* ShaderGenerator::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+{
+    // Background thread
+    SGProgramsRequestPtr request = any_cast<SGProgramsRequestPtr>(req->getData());
+
+    // The generation reads the scheme and technique maps and the pass state, which the main thread
+    // modifies under the same lock. Taken before the request mutex like on the main thread.
+    OGRE_LOCK_AUTO_MUTEX;
+
+    // Keeps the technique alive while generating, see SGTechnique::cancelProgramsRequest.
+    OGRE_WQ_LOCK_MUTEX(request->mutex);
+
+    if (request->technique == NULL)
+        return OGRE_NEW WorkQueue::Response(req, false, Any(), "Request was cancelled");
+
+    Timer timer;
+    try
+    {
+        request->technique->preparePrograms();
+    }
+    catch (const Exception& e)
+    {
+        return OGRE_NEW WorkQueue::Response(req, false, Any(), e.getDescription());
+    }
+    request->generationTime = timer.getMicroseconds();
+
+    return OGRE_NEW WorkQueue::Response(req, true, Any());
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
+{
+    // Main thread
+    OGRE_LOCK_AUTO_MUTEX;
+
+    SGProgramsRequestPtr request = any_cast<SGProgramsRequestPtr>(res->getRequest()->getData());
+    SGTechnique* techEntry = request->technique;
+
+    // The technique was removed or rebuilt in the meantime.
+    if (techEntry == NULL || mTechniqueEntriesMap.find(techEntry) == mTechniqueEntriesMap.end())
+        return;
+
+    mAsyncGenerationTime += request->generationTime;
+
+    const String& materialName = techEntry->getParent()->getMaterialName();
+    if (!res->succeeded())
+    {
+        // The passes without prepared programs are generated again synchronously below.
+        LogManager::getSingleton().logError("RTShader::ShaderGenerator: could not generate technique of material '" +
+                                            materialName + "' asynchronously: " + res->getMessages());
+    }
+
+    Timer timer;
+    try
+    {
+        techEntry->acquirePreparedPrograms();
+        if (res->succeeded())
+            mAsyncGeneratedTechniqueCount++;
+    }
+    catch (const Exception& e)
+    {
+        LogManager::getSingleton().logError("RTShader::ShaderGenerator: could not generate technique of material '" +
+                                            materialName + "': " + e.getDescription());
+    }
+    mAsyncCompletionTime += timer.getMicroseconds();
+}
+
 //-----------------------------------------------------------------------------
 SGMaterialSerializerListener* ShaderGenerator::getMaterialSerializerListener()
 {
@@ -1497,6 +1596,13 @@ void ShaderGenerator::SGPass::acquirePrograms()
     ProgramManager::getSingleton().acquirePrograms(mDstPass, mTargetRenderState);
 }
 
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGPass::preparePrograms()
+{
+    if(!mTargetRenderState) return;
+    ProgramManager::getSingleton().prepareGpuPrograms(mTargetRenderState);
+}
+
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGPass::releasePrograms()
 {
@@ -1562,7 +1668,7 @@ ShaderGenerator::SGTechnique::SGTechnique(SGMaterial* parent, const Technique* s
                                           const String& dstTechniqueSchemeName,
                                           bool overProgrammable)
     : mParent(parent), mSrcTechnique(srcTechnique), mDstTechnique(NULL), mBuildDstTechnique(true),
-      mDstTechniqueSchemeName(dstTechniqueSchemeName), mOverProgrammable(overProgrammable)
+      mDstTechniqueSchemeName(dstTechniqueSchemeName), mOverProgrammable(overProgrammable), mProgramsRequestID(0)
 {
 }
 
@@ -1633,6 +1739,8 @@ ShaderGenerator::SGTechnique::~SGTechnique()
     const String& materialName = mParent->getMaterialName();
     const String& groupName = mParent->getGroupName();
 
+    cancelProgramsRequest();
+
     // Release CPU/GPU programs that associated with this technique passes.
     // Needs the parent technique to still exist
     for (SGPassIterator itPass = mPassEntries.begin(); itPass != mPassEntries.end(); ++itPass)
@@ -1695,6 +1803,8 @@ void ShaderGenerator::SGTechnique::destroySGPasses()
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGTechnique::buildTargetRenderState()
 {
+    cancelProgramsRequest();
+
     // Remove existing destination technique and passes
     // in order to build it again from scratch.
     if (mDstTechnique != NULL)
@@ -1736,6 +1846,57 @@ void ShaderGenerator::SGTechnique::acquirePrograms()
 			(*itPass)->acquirePrograms();
 }
 
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGTechnique::requestPrograms()
+{
+    assert(mDstTechnique != NULL && !mProgramsRequest);
+
+    // Hide the destination technique, the material uses its other techniques until it is published.
+    mDstTechnique->setSchemeName(PENDING_SCHEME_NAME);
+
+    mProgramsRequest.reset(OGRE_NEW_T(SGProgramsRequest, MEMCATEGORY_GENERAL)(this), SPFM_DELETE_T);
+    ShaderGenerator& shaderGenerator = ShaderGenerator::getSingleton();
+    mProgramsRequestID = Root::getSingleton().getWorkQueue()->addRequest(
+        shaderGenerator.mWorkQueueChannel, 0, Any(mProgramsRequest));
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGTechnique::preparePrograms()
+{
+    for(SGPassIterator itPass = mPassEntries.begin(); itPass != mPassEntries.end(); ++itPass)
+        if(!(*itPass)->isIlluminationPass())
+            (*itPass)->preparePrograms();
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGTechnique::acquirePreparedPrograms()
+{
+    mProgramsRequest.reset();
+
+    // Publish the destination technique, also when acquiring the programs fails below,
+    // like the synchronous generation leaves it.
+    mDstTechnique->setSchemeName(mDstTechniqueSchemeName);
+
+    // Creates the GPU programs from the prepared source code.
+    acquirePrograms();
+}
+
+//-----------------------------------------------------------------------------
+void ShaderGenerator::SGTechnique::cancelProgramsRequest()
+{
+    if (!mProgramsRequest)
+        return;
+
+    {
+        // Wait for a worker thread that is currently generating this technique.
+        OGRE_WQ_LOCK_MUTEX(mProgramsRequest->mutex);
+        mProgramsRequest->technique = NULL;
+    }
+
+    Root::getSingleton().getWorkQueue()->abortRequest(mProgramsRequestID);
+    mProgramsRequest.reset();
+}
+
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGTechnique::buildIlluminationTargetRenderState()
 {
@@ -1764,6 +1925,8 @@ void ShaderGenerator::SGTechnique::acquireIlluminationPrograms()
 //-----------------------------------------------------------------------------
 void ShaderGenerator::SGTechnique::releasePrograms()
 {
+    cancelProgramsRequest();
+
     // Remove destination technique.
     if (mDstTechnique != NULL)
     {
@@ -2002,7 +2165,10 @@ bool ShaderGenerator::SGScheme::validate(const String& materialName, const Strin
             curTechEntry->buildTargetRenderState();
 
             // Acquire the CPU/GPU programs.
-            curTechEntry->acquirePrograms();
+            if (ShaderGenerator::getSingleton().getAsyncTechniqueGeneration())
+                curTechEntry->requestPrograms();
+            else
+                curTechEntry->acquirePrograms();
 
             // Turn off the build destination technique flag.
             curTechEntry->setBuildDestinationTechnique(false);
@@ -25,6 +25,7 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreShaderPrecompiledHeaders.h"
+#include "OgreStreamSerialiser.h"
 
 namespace Ogre {
 
@@ -34,6 +35,8 @@ RTShader::ProgramManager* Singleton<RTShader::ProgramManager>::msSingleton = 0;
 
 namespace RTShader {
 
+static uint32 MANIFEST_CHUNK_ID = StreamSerialiser::makeIdentifier("RTSM"); // RTSS program manifest
+static const char* MANIFEST_FILENAME = "RTShaderManifest.bin";
 
 //-----------------------------------------------------------------------
 ProgramManager* ProgramManager::getSingletonPtr()
@@ -51,6 +54,8 @@ ProgramManager& ProgramManager::getSingleton()
 //-----------------------------------------------------------------------------
 ProgramManager::ProgramManager()
 {
+    mProgramManifestDirty = false;
+    mProgramManifestHits = 0;
     createDefaultProgramProcessors();
     createDefaultProgramWriterFactories();
 }
@@ -58,6 +63,14 @@ ProgramManager::ProgramManager()
 //-----------------------------------------------------------------------------
 ProgramManager::~ProgramManager()
 {
+    try
+    {
+        saveProgramManifest();
+    }
+    catch (const Exception& e)
+    {
+        LogManager::getSingleton().logError("RTShader::ProgramManager: " + e.getDescription());
+    }
     flushGpuProgramsCache();
     destroyDefaultProgramWriterFactories();
     destroyDefaultProgramProcessors();  
@@ -67,16 +80,15 @@ ProgramManager::~ProgramManager()
 //-----------------------------------------------------------------------------
 void ProgramManager::acquirePrograms(Pass* pass, TargetRenderState* renderState)
 {
-    // Create the CPU programs.
-    if (false == renderState->createCpuPrograms())
-    {
-        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
-            "Could not apply render state ", 
-            "ProgramManager::acquireGpuPrograms" ); 
-    }   
-
     ProgramSet* programSet = renderState->getProgramSet();
 
+    // Generate the programs unless this was already done by prepareGpuPrograms.
+    if (programSet == NULL || programSet->mVSName.empty())
+    {
+        prepareGpuPrograms(renderState);
+        programSet = renderState->getProgramSet();
+    }
+
     // Create the GPU programs.
     if (false == createGpuPrograms(programSet))
     {
@@ -95,6 +107,47 @@ void ProgramManager::acquirePrograms(Pass* pass, TargetRenderState* renderState)
 
 }
 
+//-----------------------------------------------------------------------------
+void ProgramManager::prepareGpuPrograms(TargetRenderState* renderState)
+{
+    // Render states seen before - possibly in a previous run - reuse their programs.
+    String signature;
+    if (false == renderState->getSignature(signature))
+        signature.clear();
+
+    const String signatureHash = getSignatureHash(signature);
+    ProgramManifestEntry reused[2];
+    const bool isReused = findManifestPrograms(signatureHash, reused);
+
+    // Create the CPU programs. Reused programs only need the parameters to bind.
+    if (false == renderState->createCpuPrograms(isReused))
+    {
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
+            "Could not apply render state ", 
+            "ProgramManager::prepareGpuPrograms" ); 
+    }   
+
+    ProgramSet* programSet = renderState->getProgramSet();
+    programSet->mSignatureHash = signatureHash;
+
+    if (isReused)
+    {
+        programSet->mVSName = reused[0].name;
+        programSet->mVSSource = reused[0].source;
+        programSet->mPSName = reused[1].name;
+        programSet->mPSSource = reused[1].source;
+        return;
+    }
+
+    // Generate the GPU programs source code.
+    if (false == generateGpuPrograms(programSet))
+    {
+        OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, 
+            "Could not generate gpu programs from render state ", 
+                        "ProgramManager::prepareGpuPrograms" );
+    }   
+}
+
 //-----------------------------------------------------------------------------
 void ProgramManager::releasePrograms(Pass* pass, TargetRenderState* renderState)
 {
@@ -239,6 +292,8 @@ void ProgramManager::destroyProgramWriters()
 //-----------------------------------------------------------------------------
 Program* ProgramManager::createCpuProgram(GpuProgramType type)
 {
+    OGRE_WQ_LOCK_MUTEX(mMutex);
+
     Program* shaderProgram = OGRE_NEW Program(type);
 
     mCpuProgramsList.insert(shaderProgram);
@@ -250,6 +305,8 @@ Program* ProgramManager::createCpuProgram(GpuProgramType type)
 //-----------------------------------------------------------------------------
 void ProgramManager::destroyCpuProgram(Program* shaderProgram)
 {
+    OGRE_WQ_LOCK_MUTEX(mMutex);
+
     ProgramListIterator it    = mCpuProgramsList.find(shaderProgram);
     
     if (it != mCpuProgramsList.end())
@@ -260,8 +317,10 @@ void ProgramManager::destroyCpuProgram(Program* shaderProgram)
 }
 
 //-----------------------------------------------------------------------------
-bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
+bool ProgramManager::generateGpuPrograms(ProgramSet* programSet)
 {
+    OGRE_WQ_LOCK_MUTEX(mMutex);
+
     // Before we start we need to make sure that the pixel shader input
     //  parameters are the same as the vertex output, this required by 
     //  shader models 4 and 5.
@@ -296,7 +355,7 @@ bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
     {
         OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM,
             "Could not find processor for language '" + language,
-            "ProgramManager::createGpuPrograms");       
+            "ProgramManager::generateGpuPrograms");       
     }
 
     programProcessor = itProcessor->second;
@@ -308,25 +367,116 @@ bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
     if (success == false)   
         return false;   
     
+    const String& cachePath = ShaderGenerator::getSingleton().getShaderCachePath();
+
+    // Generate the shader programs source code
+    for(auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
+    {
+        const bool isVertex = type == GPT_VERTEX_PROGRAM;
+        String& programName = isVertex ? programSet->mVSName : programSet->mPSName;
+        String& source = isVertex ? programSet->mVSSource : programSet->mPSSource;
+
+        if (!writeSourceCode(programSet->getCpuProgram(type), programWriter, language, cachePath,
+                             programName, source))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+String ProgramManager::getSignatureHash(const String& signature)
+{
+    if (signature.empty())
+        return BLANKSTRING;
+
+    // The generated code also depends on the target language and profiles.
+    StringStream target;
+    target << ShaderGenerator::getSingleton().getTargetLanguage()
+           << GpuProgramManager::getSingleton().isSyntaxSupported("vs_4_0_level_9_1");
+    for(auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
+        target << ShaderGenerator::getSingleton().getShaderProfiles(type);
+
+    return generateHash(signature, target.str());
+}
+
+//-----------------------------------------------------------------------------
+bool ProgramManager::findManifestPrograms(const String& signatureHash, ProgramManifestEntry* entries)
+{
+    if (signatureHash.empty())
+        return false;
+
+    OGRE_WQ_LOCK_MUTEX(mMutex);
+
+    const String& cachePath = ShaderGenerator::getSingleton().getShaderCachePath();
+    if (cachePath != mProgramManifestPath)
+        loadProgramManifest(cachePath);
+
+    ProgramManifest::const_iterator itVS = mProgramManifest.find(signatureHash + "_VS");
+    ProgramManifest::const_iterator itFS = mProgramManifest.find(signatureHash + "_FS");
+    if (itVS == mProgramManifest.end() || itFS == mProgramManifest.end())
+        return false;
+
+    entries[0] = itVS->second;
+    entries[1] = itFS->second;
+    mProgramManifestHits += 2;
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+bool ProgramManager::createGpuPrograms(ProgramSet* programSet)
+{
+    const String& language = ShaderGenerator::getSingleton().getTargetLanguage();
+
     // Create the shader programs
     for(auto type : {GPT_VERTEX_PROGRAM, GPT_FRAGMENT_PROGRAM})
     {
-        auto gpuProgram = createGpuProgram(programSet->getCpuProgram(type), programWriter, language,
-                                           ShaderGenerator::getSingleton().getShaderProfiles(type),
-                                           ShaderGenerator::getSingleton().getShaderProfilesList(type),
-                                           ShaderGenerator::getSingleton().getShaderCachePath());
+        const bool isVertex = type == GPT_VERTEX_PROGRAM;
+        ProgramManifestEntry entry;
+        entry.name = isVertex ? programSet->mVSName : programSet->mPSName;
+        entry.source = isVertex ? programSet->mVSSource : programSet->mPSSource;
+
+        GpuProgramPtr gpuProgram = createGpuProgram(programSet->getCpuProgram(type), entry.name, entry.source,
+                                                    language,
+                                                    ShaderGenerator::getSingleton().getShaderProfiles(type),
+                                                    ShaderGenerator::getSingleton().getShaderProfilesList(type));
         if(!gpuProgram)
             return false;
 
         programSet->setGpuProgram(gpuProgram, type);
+
+        // Remember the program for the render state signature.
+        if (!programSet->mSignatureHash.empty())
+        {
+            OGRE_WQ_LOCK_MUTEX(mMutex);
+            String manifestKey = programSet->mSignatureHash + (isVertex ? "_VS" : "_FS");
+            if (mProgramManifest.insert(ProgramManifest::value_type(manifestKey, entry)).second)
+                mProgramManifestDirty = true;
+        }
     }
 
+    // The source is no longer needed.
+    programSet->mVSSource.clear();
+    programSet->mPSSource.clear();
+
     //update flags
     programSet->getGpuProgram(GPT_VERTEX_PROGRAM)->setSkeletalAnimationIncluded(
         programSet->getCpuProgram(GPT_VERTEX_PROGRAM)->getSkeletalAnimationIncluded());
 
+    OGRE_WQ_LOCK_MUTEX(mMutex);
+    ProgramProcessorIterator itProcessor = mProgramProcessorsMap.find(language);
+
+    if (itProcessor == mProgramProcessorsMap.end())
+    {
+        OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM,
+            "Could not find processor for language '" + language,
+            "ProgramManager::createGpuPrograms");       
+    }
+
     // Call the post creation of GPU programs method.
-    return programProcessor->postCreateGpuPrograms(programSet);
+    return itProcessor->second->postCreateGpuPrograms(programSet);
 }
 
 
@@ -347,21 +497,21 @@ void ProgramManager::bindUniformParameters(Program* pCpuProgram, const GpuProgra
 }
 
 //-----------------------------------------------------------------------------
-GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram, 
-                                               ProgramWriter* programWriter,
-                                               const String& language,
-                                               const String& profiles,
-                                               const StringVector& profilesList,
-                                               const String& cachePath)
+bool ProgramManager::writeSourceCode(Program* shaderProgram,
+                                     ProgramWriter* programWriter,
+                                     const String& language,
+                                     const String& cachePath,
+                                     String& programName,
+                                     String& source)
 {
     stringstream sourceCodeStringStream;
 
     // Generate source code.
     programWriter->writeSourceCode(sourceCodeStringStream, shaderProgram);
-    String source = sourceCodeStringStream.str();
+    source = sourceCodeStringStream.str();
 
     // Generate program name.
-    String programName = generateHash(source, shaderProgram->getPreprocessorDefines());
+    programName = generateHash(source, shaderProgram->getPreprocessorDefines());
 
     if (shaderProgram->getType() == GPT_VERTEX_PROGRAM)
     {
@@ -372,20 +522,6 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
         programName += "_FS";
     }
 
-    // Try to get program by name.
-    HighLevelGpuProgramPtr pGpuProgram =
-        HighLevelGpuProgramManager::getSingleton().getByName(
-            programName, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
-
-    if(pGpuProgram) {
-        return static_pointer_cast<GpuProgram>(pGpuProgram);
-    }
-
-    // Case the program doesn't exist yet.
-    // Create new GPU program.
-    pGpuProgram = HighLevelGpuProgramManager::getSingleton().createProgram(programName,
-        ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, language, shaderProgram->getType());
-
     // Case cache directory specified -> create program from file.
     if (!cachePath.empty())
     {
@@ -402,7 +538,7 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
             std::ofstream outFile(programFileName.c_str());
 
             if (!outFile)
-                return GpuProgramPtr();
+                return false;
 
             outFile << source;
             outFile.close();
@@ -416,6 +552,31 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
         }
     }
 
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
+                                               const String& programName,
+                                               const String& source,
+                                               const String& language,
+                                               const String& profiles,
+                                               const StringVector& profilesList)
+{
+    // Try to get program by name.
+    HighLevelGpuProgramPtr pGpuProgram =
+        HighLevelGpuProgramManager::getSingleton().getByName(
+            programName, ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME);
+
+    if(pGpuProgram) {
+        return static_pointer_cast<GpuProgram>(pGpuProgram);
+    }
+
+    // Case the program doesn't exist yet.
+    // Create new GPU program.
+    pGpuProgram = HighLevelGpuProgramManager::getSingleton().createProgram(programName,
+        ResourceGroupManager::INTERNAL_RESOURCE_GROUP_NAME, language, shaderProgram->getType());
+
     pGpuProgram->setSource(source);
     pGpuProgram->setPreprocessorDefines(shaderProgram->getPreprocessorDefines());
     pGpuProgram->setParameter("entry_point", shaderProgram->getEntryPointFunction()->getName());
@@ -465,6 +626,118 @@ GpuProgramPtr ProgramManager::createGpuProgram(Program* shaderProgram,
 }
 
 
+//-----------------------------------------------------------------------------
+String ProgramManager::getProgramManifestIdentity()
+{
+    RenderSystem* rs = Root::getSingleton().getRenderSystem();
+
+    StringStream identity;
+    identity << rs->getName() << "|" << rs->getCapabilities()->getDeviceName() << "|"
+             << rs->getDriverVersion().toString() << "|" << rs->getNativeShadingLanguageVersion() << "|"
+             << OGRE_VERSION_MAJOR << "." << OGRE_VERSION_MINOR << "." << OGRE_VERSION_PATCH;
+    return identity.str();
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::loadProgramManifest(const String& cachePath)
+{
+    saveProgramManifest();
+
+    mProgramManifest.clear();
+    mProgramManifestPath = cachePath;
+
+    if (cachePath.empty())
+        return;
+
+    const String fileName = cachePath + MANIFEST_FILENAME;
+    std::ifstream* inFile = OGRE_NEW_T(std::ifstream, MEMCATEGORY_GENERAL)(fileName.c_str(), std::ios::binary);
+    if (!*inFile)
+    {
+        OGRE_DELETE_T(inFile, basic_ifstream, MEMCATEGORY_GENERAL);
+        return;
+    }
+
+    StreamSerialiser serialiser(DataStreamPtr(OGRE_NEW FileStreamDataStream(fileName, inFile)));
+    uint32 count = 0;
+
+    try
+    {
+        if (!serialiser.readChunkBegin(MANIFEST_CHUNK_ID, 1))
+            return;
+
+        String identity;
+        serialiser.read(&identity);
+
+        if (identity != getProgramManifestIdentity())
+        {
+            LogManager::getSingleton().logMessage("RTShader::ProgramManager: discarding outdated " + fileName);
+            serialiser.readChunkEnd(MANIFEST_CHUNK_ID);
+            return;
+        }
+
+        serialiser.read(&count);
+
+        for (uint32 i = 0; i < count; ++i)
+        {
+            String key;
+            ProgramManifestEntry entry;
+            serialiser.read(&key);
+            serialiser.read(&entry.name);
+            serialiser.read(&entry.source);
+            mProgramManifest[key] = entry;
+        }
+        serialiser.readChunkEnd(MANIFEST_CHUNK_ID);
+    }
+    catch (const Exception& e)
+    {
+        LogManager::getSingleton().logWarning("RTShader::ProgramManager: invalid manifest " + e.getDescription());
+        mProgramManifest.clear();
+        return;
+    }
+
+    LogManager::getSingleton().stream()
+        << "RTShader::ProgramManager: " << count << " programs in manifest " << fileName;
+}
+
+//-----------------------------------------------------------------------------
+void ProgramManager::saveProgramManifest()
+{
+    if (mProgramManifestPath.empty() || !mProgramManifestDirty)
+        return;
+
+    const String fileName = mProgramManifestPath + MANIFEST_FILENAME;
+    std::fstream* outFile = OGRE_NEW_T(std::fstream, MEMCATEGORY_GENERAL);
+    outFile->open(fileName.c_str(), std::ios::out | std::ios::binary);
+    if (!*outFile)
+    {
+        OGRE_DELETE_T(outFile, basic_fstream, MEMCATEGORY_GENERAL);
+        OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE, "Can't open " + fileName + " for writing");
+    }
+
+    StreamSerialiser serialiser(DataStreamPtr(OGRE_NEW FileStreamDataStream(fileName, outFile)));
+    serialiser.writeChunkBegin(MANIFEST_CHUNK_ID, 1);
+
+    String identity = getProgramManifestIdentity();
+    serialiser.write(&identity);
+
+    uint32 count = static_cast<uint32>(mProgramManifest.size());
+    serialiser.write(&count);
+
+    for (ProgramManifest::const_iterator it = mProgramManifest.begin(); it != mProgramManifest.end(); ++it)
+    {
+        serialiser.write(&it->first);
+        serialiser.write(&it->second.name);
+        serialiser.write(&it->second.source);
+    }
+    serialiser.writeChunkEnd(MANIFEST_CHUNK_ID);
+
+    mProgramManifestDirty = false;
+
+    LogManager::getSingleton().stream()
+        << "RTShader::ProgramManager: wrote " << count << " programs to manifest " << fileName
+        << " (" << mProgramManifestHits << " reused)";
+}
+
 //-----------------------------------------------------------------------------
 String ProgramManager::generateHash(const String& programString, const String& defines)
 {
@@ -153,7 +153,7 @@ void TargetRenderState::removeSubRenderStateInstance(SubRenderState* subRenderSt
 }
 
 //-----------------------------------------------------------------------
-bool TargetRenderState::createCpuPrograms()
+bool TargetRenderState::createCpuPrograms(bool parametersOnly)
 {
     sortSubRenderStates();
 
@@ -177,7 +177,9 @@ bool TargetRenderState::createCpuPrograms()
     {
         SubRenderState* srcSubRenderState = *it;
 
-        if (false == srcSubRenderState->createCpuSubPrograms(programSet))
+        bool success = parametersOnly ? srcSubRenderState->createCpuSubProgramParameters(programSet)
+                                      : srcSubRenderState->createCpuSubPrograms(programSet);
+        if (false == success)
         {
             LogManager::getSingleton().stream() << "RTShader::TargetRenderState : Could not generate sub render program of type: " << srcSubRenderState->getType();
             return false;
@@ -218,6 +220,23 @@ void TargetRenderState::updateGpuProgramsParams(Renderable* rend, Pass* pass, co
     }
 }
 
+//-----------------------------------------------------------------------
+bool TargetRenderState::getSignature(String& signature)
+{
+    sortSubRenderStates();
+
+    for (SubRenderStateListIterator it=mSubRenderStateList.begin(); it != mSubRenderStateList.end(); ++it)
+    {
+        const String& type = (*it)->getType();
+        signature.append(type.c_str(), type.size() + 1);
+
+        if (false == (*it)->updateSignature(signature))
+            return false;
+    }
+
+    return true;
+}
+
 //-----------------------------------------------------------------------
 void TargetRenderState::link(const RenderState& rhs, Pass* srcPass, Pass* dstPass)
 {   
@@ -145,6 +145,12 @@ bool SubRenderState::createCpuSubPrograms(ProgramSet* programSet)
     return true;
 }
 
+//-----------------------------------------------------------------------
+bool SubRenderState::createCpuSubProgramParameters(ProgramSet* programSet)
+{
+    return resolveParameters(programSet) && resolveDependencies(programSet);
+}
+
 //-----------------------------------------------------------------------
 bool SubRenderState::resolveParameters(ProgramSet* programSet)
 {
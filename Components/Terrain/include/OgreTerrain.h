@@ -275,6 +275,8 @@ namespace Ogre
         static const uint16 TERRAIN_CHUNK_VERSION;
         static const uint16 TERRAIN_MAX_BATCH_SIZE;
         static const uint64 TERRAIN_GENERATE_MATERIAL_INTERVAL_MS;
+        /// Number of separate areas of the composite map rendered again, more are merged
+        static const size_t COMPOSITE_MAP_MAX_DIRTY_RECTS;
 
         static const uint32 TERRAINLAYERDECLARATION_CHUNK_ID;
         static const uint16 TERRAINLAYERDECLARATION_CHUNK_VERSION;
@@ -288,6 +290,8 @@ namespace Ogre
         static const uint16 TERRAINDERIVEDDATA_CHUNK_VERSION;
         static const uint32 TERRAINGENERALINFO_CHUNK_ID;
         static const uint16 TERRAINGENERALINFO_CHUNK_VERSION;
+        static const uint32 TERRAINCOREDATA_CHUNK_ID;
+        static const uint16 TERRAINCOREDATA_CHUNK_VERSION;
 
         static const size_t LOD_MORPH_CUSTOM_PARAM;
 
@@ -1089,7 +1093,9 @@ namespace Ogre
         /** Mark a region of the terrain composite map as dirty. 
         @remarks
             You don't usually need to call this directly, it is inferred from 
-            changing the other data on the terrain.
+            changing the other data on the terrain. Regions which don't overlap
+            are rendered separately by updateCompositeMap, up to 
+            COMPOSITE_MAP_MAX_DIRTY_RECTS of them.
         */
         void _dirtyCompositeMapRect(const Rect& rect);
 
@@ -1424,6 +1430,39 @@ namespace Ogre
         */
         const TexturePtr& getLayerBlendTexture(uint8 index) const;
 
+        /** Internal method to get the CPU copy of a blend texture.
+        @remarks
+            The copy is read back from the texture once and then kept up to date
+            by the TerrainLayerBlendMap instances, which upload only their dirty
+            area from it. The data is in the format of the texture buffer.
+        @par
+            Each copy costs as much memory as its texture, 4 bytes per texel of
+            the blend map size, so 4MB for a blend map size of 1024. The copies
+            are kept until freeTemporaryResources is called, the layers change
+            or the GPU resources are freed.
+        @param index The blend texture index
+        */
+        uint8* _getLayerBlendTextureShadow(uint8 index);
+
+        /** Internal method to upload a changed area of a layer blend map.
+        @remarks
+            The blend values of the area are copied and converted into the CPU
+            copy of the blend texture by the work queue. The area is uploaded and
+            marked dirty in the composite map when the response is processed in
+            the main thread.
+        @param layerIndex The layer index (1 or higher)
+        @param channelOffset The byte offset of the layer within a texel
+        @param box The changed area in image space
+        @param data The blend values of the whole layer
+        @param compositeMapRect The changed area in terrain space
+        @param synchronous Whether to upload the area before returning
+        */
+        void _updateLayerBlendTexture(uint8 layerIndex, uint8 channelOffset, const Box& box,
+            const float* data, const Rect& compositeMapRect, bool synchronous);
+
+        /// Internal method to wait until the changed areas of the layer blend maps are uploaded
+        void _waitForLayerBlendTextureUpdates();
+
         /** Get the texture index and colour channel of the blend information for 
             a given layer. 
         @param layerIndex The index of the layer (1 or higher, layer 0 has no blend data)
@@ -1510,6 +1549,7 @@ namespace Ogre
 
         static const uint16 WORKQUEUE_DERIVED_DATA_REQUEST;
         static const uint16 WORKQUEUE_GENERATE_MATERIAL_REQUEST;
+        static const uint16 WORKQUEUE_BLEND_MAP_REQUEST;
 
         /// Utility method, get the first LOD Level at which this vertex is no longer included
         uint16 getLODLevelWhenVertexEliminated(long x, long y) const;
@@ -1595,6 +1635,20 @@ namespace Ogre
         /** Query whether a derived data update is in progress or not. */
         bool isDerivedDataUpdateInProgress() const { return mDerivedDataUpdateInProgress; }
 
+        /** Query whether images of the terrain file have not been read yet.
+        @remarks
+            The blend maps, normal map, lightmap and colour map are only used close
+            to the terrain, further away the composite map replaces them. When the
+            terrain was prepared from a file and has a composite map, these images
+            are left in the file until the camera comes close or the terrain is
+            edited, see loadImageData.
+        */
+        bool isImageDataPending() const;
+        /** Read the images which prepare() left in the file, if any.
+        @param synchronous Wait for the images, otherwise they are read in the background
+        */
+        void loadImageData(bool synchronous = false);
+
 
         /// Utility method to convert axes from world space to terrain space (xy terrain, z up)
         static void convertWorldToTerrainAxes(Alignment align, const Vector3& worldVec, Vector3* terrainVec);
@@ -1642,6 +1696,13 @@ namespace Ogre
         void createOrDestroyGPULightmap();
         void createOrDestroyGPUCompositeMap();
         void waitForDerivedProcesses();
+        /// Read the image chunks of a file, leaving the ones only needed close by in the file if possible
+        void prepareImageData(StreamSerialiser& stream);
+        /// Use an image read from file, takes ownership of its data
+        void setImageData(TerrainLodManager::ImageData& image);
+        /// Write an image from CPU data if there is some, otherwise from the texture
+        void saveImageData(StreamSerialiser& stream, const String& name, uint16 size, PixelFormat format,
+            uint8* cpuData, const TexturePtr& tex);
         void convertSpace(Space inSpace, const Vector3& inVec, Space outSpace, Vector3& outVec, bool translation) const;
         Vector3 convertWorldToTerrainAxes(const Vector3& inVec) const;
         Vector3 convertTerrainToWorldAxes(const Vector3& inVec) const;
@@ -1668,6 +1729,8 @@ namespace Ogre
         void copyBlendTextureChannel(uint8 srcIndex, uint8 srcChannel, uint8 destIndex, uint8 destChannel );
         /// Reset a blend channel back to full black
         void clearGPUBlendChannel(uint8 index, uint channel);
+        /// Drop the CPU copies of the blend textures after changing the textures directly
+        void freeLayerBlendTextureShadows();
 
         void copyGlobalOptions();
         void checkLayers(bool includeGPUResources);
@@ -1734,6 +1797,8 @@ namespace Ogre
         bool mGenerateMaterialInProgress;
         /// Don't release Height/DeltaData when preparing
         mutable bool mPrepareInProgress;
+        /// Whether the file being prepared stays open, so images can be read from it later
+        bool mDeferImageData;
         /// A data holder for communicating with the background derived data update
         struct DerivedDataRequest
         {
@@ -1765,6 +1830,32 @@ namespace Ogre
             { return o; }       
         };
 
+        /// A data holder for converting a changed area of a layer blend map in the background
+        struct BlendMapRequest
+        {
+            Terrain* terrain;
+            uint8 textureIndex;
+            /// The CPU copy of the blend texture
+            uint8* shadow;
+            uint32 shadowWidth;
+            uint8 texelSize;
+            uint8 channelOffset;
+            /// The changed area in image space and its blend values, owned by the request
+            Box box;
+            float* data;
+            Rect compositeMapRect;
+            _OgreTerrainExport friend std::ostream& operator<<(std::ostream& o, const BlendMapRequest& r)
+            { return o; }       
+        };
+        /// Convert the blend values of a changed area into the CPU copy of its blend texture
+        void convertLayerBlendArea(const BlendMapRequest& req);
+        /// Upload a changed area from the CPU copy of its blend texture
+        void uploadLayerBlendArea(const BlendMapRequest& req);
+        /// Number of blend map requests whose response was not processed yet
+        size_t mBlendMapUpdatesInProgress;
+        /// Locked while converting into or uploading from the CPU copies of the blend textures
+        OGRE_MUTEX(mBlendTextureShadowMutex);
+
         enum GenerateMaterialStage{
             GEN_MATERIAL,
             GEN_COMPOSITE_MAP_MATERIAL
@@ -1794,6 +1885,8 @@ namespace Ogre
         BytePointerList mCpuBlendMapStorage;
         typedef std::vector<TexturePtr> TexturePtrList;
         TexturePtrList mBlendTextureList;
+        /// CPU copies of the blend textures, created on demand
+        BytePointerList mBlendTextureShadows;
         TerrainLayerBlendMapList mLayerBlendMapList;
 
         uint16 mGlobalColourMapSize;
@@ -1811,6 +1904,9 @@ namespace Ogre
         TexturePtr mCompositeMap;
         uint8* mCpuCompositeMapStorage;
         Rect mCompositeMapDirtyRect;
+        typedef std::vector<Rect> RectList;
+        /// Separate areas changed by the layer blend maps, only these are rendered again
+        RectList mCompositeMapDirtyBlendRects;
         unsigned long mCompositeMapUpdateCountdown;
         unsigned long mLastMillis;
         /// True if the updates included lightmap changes (widen)
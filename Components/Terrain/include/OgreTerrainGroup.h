@@ -255,8 +255,27 @@ namespace Ogre
         @param x, y The coordinates of the terrain slot relative to the centre slot (signed).
         @param synchronous Whether we should force this to happen entirely in the
             primary thread (default false, operations are threaded if possible)
+        @param priority The priority of the background load, higher is loaded first
         */
-        virtual void loadTerrain(long x, long y, bool synchronous = false);
+        virtual void loadTerrain(long x, long y, bool synchronous = false, Real priority = 0);
+
+        /** Change the priority of a terrain slot which is waiting to be loaded.
+        @param x, y The coordinates of the terrain slot relative to the centre slot (signed).
+        @param priority The new priority, higher is loaded first
+        @return true if the load was still waiting and has been reprioritised
+        */
+        bool setTerrainLoadPriority(long x, long y, Real priority);
+
+        /** Set the number of terrains which may be prepared at the same time.
+        @remarks
+            Without a limit, all worker threads may be busy preparing terrains while
+            other background work waits. The limit applies to the work queue channel
+            shared by all terrain groups.
+        @param maxLoads The maximum number of concurrent loads, 0 for no limit
+        */
+        void setMaxConcurrentLoads(size_t maxLoads);
+        /// Get the number of terrains which may be prepared at the same time
+        size_t getMaxConcurrentLoads() const;
         
         /** Load a terrain.cfg as used by the terrain scene manager into a single terrain slot
          *
@@ -559,7 +578,7 @@ namespace Ogre
         void freeTerrainSlotInstance(TerrainSlot* slot);
         void connectNeighbour(TerrainSlot* slot, long offsetx, long offsety);
 
-        void loadTerrainImpl(TerrainSlot* slot, bool synchronous);
+        void loadTerrainImpl(TerrainSlot* slot, bool synchronous, Real priority = 0);
 
         /// Structure for holding the load request
         struct LoadRequest
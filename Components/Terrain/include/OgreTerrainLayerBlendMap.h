@@ -177,10 +177,16 @@ namespace Ogre
         void loadImage(const String& filename, const String& groupName);
 
         /** Publish any changes you made to the blend data back to the blend map. 
+        @remarks
+            Only the area marked with dirtyRect is converted and uploaded, the
+            texture is never read back from the GPU. The area is converted by
+            the work queue and uploaded when its response is processed, after
+            which it is rendered again into the composite map.
+        @param synchronous Whether to upload the area before returning
         @note
             Can only be called in the main render thread.
         */
-        void update();
+        void update(bool synchronous = false);
 
 
     };
@@ -31,6 +31,7 @@ THE SOFTWARE.
 
 #include "OgreTerrainPrerequisites.h"
 #include "OgreWorkQueue.h"
+#include "OgreStreamSerialiser.h"
 
 
 namespace Ogre
@@ -74,6 +75,38 @@ namespace Ogre
             { return o; }
         };
 
+        /// An image of the terrain file, such as a blend map or the normal map
+        struct ImageData
+        {
+            ImageData() : size(0), dataSize(0), data(0) {}
+            String name;
+            uint16 size;
+            uint32 dataSize;
+            /// The pixels, if they were read
+            uint8* data;
+        };
+        typedef std::vector<ImageData> ImageDataList;
+
+        struct LoadImageRequest
+        {
+            LoadImageRequest( TerrainLodManager* r, size_t offset )
+                : requestee(r)
+                , streamOffset(offset)
+            {
+            }
+            TerrainLodManager* requestee;
+            size_t streamOffset;
+            _OgreTerrainExport friend std::ostream& operator<<(std::ostream& o, const LoadImageRequest& r)
+            { return o; }
+        };
+
+        struct LoadImageResponse
+        {
+            ImageDataList images;
+            _OgreTerrainExport friend std::ostream& operator<<(std::ostream& o, const LoadImageResponse& r)
+            { return o; }
+        };
+
         struct LodInfo
         {
             uint treeStart;
@@ -92,6 +125,7 @@ namespace Ogre
         bool isOpen() const;
 
         static const uint16 WORKQUEUE_LOAD_LOD_DATA_REQUEST;
+        static const uint16 WORKQUEUE_LOAD_IMAGE_DATA_REQUEST;
         virtual bool canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
         virtual bool canHandleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ);
         virtual WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ);
@@ -117,6 +151,28 @@ namespace Ogre
         void readLodData(uint16 lowerLodBound, uint16 higherLodBound);
         void waitForDerivedProcesses();
 
+        /// Save an image in a chunk of its own, compressed separately so it can be read on its own
+        static void saveImageData(StreamSerialiser& stream, const ImageData& image);
+        /** Read an image saved by saveImageData
+          @param stream The stream positioned at the chunk of the image
+          @param image The image to fill in
+          @param readData Whether to read the pixels, otherwise only the name and size are read
+          @returns The offset of the chunk in the stream
+          */
+        static size_t readImageData(StreamSerialiser& stream, ImageData& image, bool readData);
+        /** Remember the images prepare() left in the file
+          @param offset The offset of the first image which was not read, 0 if all were read
+          @param count The number of images which were not read
+          @param endian The endian mode of the file
+          */
+        void _setPendingImageData(size_t offset, uint16 count, StreamSerialiser::Endian endian);
+        /// Whether images were left in the file which were not read yet
+        bool isImageDataPending() const { return mImageDataOffset != 0; }
+        /** Read the images prepare() left in the file and hand them to the terrain
+          @param synchronous Wait for the images, otherwise they are read in the background
+          */
+        void loadImageData(bool synchronous = false);
+
         int getHighestLodPrepared(){ return mHighestLodPrepared; }
         int getHighestLodLoaded(){ return mHighestLodLoaded; }
         int getTargetLodLevel(){ return mTargetLodLevel; }
@@ -149,6 +205,9 @@ namespace Ogre
                 0: 01 03 05 06 07 08 09 11 13 15 16 17 18 19 21 23
           */
         static void separateData(float* data, uint16 size, uint16 numLodLevels, LodsData& lods );
+        /// Read the pending images from file, in the background
+        void readPendingImageData(size_t offset, ImageDataList& images);
+        static void freeImageData(ImageDataList& images);
     private:
         Terrain* mTerrain;
         DataStreamPtr mDataStream;
@@ -162,6 +221,14 @@ namespace Ogre
 
         bool mIncreaseLodLevelInProgress;  /// Is increaseLodLevel() running?
         bool mLastRequestSynchronous;
+
+        size_t mImageDataOffset;  /// Where the images not read by prepare() start, 0 if there are none
+        uint16 mImageDataCount;
+        StreamSerialiser::Endian mImageDataEndian;
+        bool mLoadImageDataInProgress;
+
+        /// Both LOD and image requests read from mDataStream, possibly on worker threads
+        OGRE_WQ_MUTEX(mStreamMutex);
     };
     /** @} */
     /** @} */
@@ -146,6 +146,8 @@ namespace Ogre
         /// Overridden from PagedWorldSection
         void loadPage(PageID pageID, bool forceSynchronous = false);
         /// Overridden from PagedWorldSection
+        void requestPage(PageID pageID, Real priority);
+        /// Overridden from PagedWorldSection
         void unloadPage(PageID pageID, bool forceSynchronous = false);
 
         /// WorkQueue::RequestHandler override
@@ -175,7 +177,9 @@ namespace Ogre
     protected:
         TerrainGroup* mTerrainGroup;
         TerrainDefiner* mTerrainDefiner;
+        /// Pages waiting for their terrain to be loaded
         std::list<PageID> mPagesInLoading;
+        /// Whether the terrain of a page is being loaded
         bool mHasRunningTasks;
         uint16 mWorkQueueChannel;
         unsigned long mNextLoadingTime;
@@ -187,6 +191,11 @@ namespace Ogre
 
         virtual void syncSettings();
 
+        /// Queue the terrain of a page to be loaded
+        void queuePage(PageID pageID, bool forceSynchronous);
+        /// Start loading the terrain of the waiting page with the highest priority
+        void loadNextPage(bool forceSynchronous);
+
     };
 
 
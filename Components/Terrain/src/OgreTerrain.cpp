@@ -58,7 +58,7 @@ namespace Ogre
 {
     //---------------------------------------------------------------------
     const uint32 Terrain::TERRAIN_CHUNK_ID = StreamSerialiser::makeIdentifier("TERR");
-    const uint16 Terrain::TERRAIN_CHUNK_VERSION = 2;
+    const uint16 Terrain::TERRAIN_CHUNK_VERSION = 3;
     const uint32 Terrain::TERRAINGENERALINFO_CHUNK_ID = StreamSerialiser::makeIdentifier("TGIN");
     const uint16 Terrain::TERRAINGENERALINFO_CHUNK_VERSION = 1;
     const uint32 Terrain::TERRAINLAYERDECLARATION_CHUNK_ID = StreamSerialiser::makeIdentifier("TDCL");
@@ -70,12 +70,16 @@ namespace Ogre
     const uint32 Terrain::TERRAINLAYERINSTANCE_CHUNK_ID = StreamSerialiser::makeIdentifier("TLIN");
     const uint16 Terrain::TERRAINLAYERINSTANCE_CHUNK_VERSION = 1;
     const uint32 Terrain::TERRAINDERIVEDDATA_CHUNK_ID = StreamSerialiser::makeIdentifier("TDDA");
-    const uint16 Terrain::TERRAINDERIVEDDATA_CHUNK_VERSION = 1;
+    const uint16 Terrain::TERRAINDERIVEDDATA_CHUNK_VERSION = 2;
+    const uint32 Terrain::TERRAINCOREDATA_CHUNK_ID = StreamSerialiser::makeIdentifier("TCOR");
+    const uint16 Terrain::TERRAINCOREDATA_CHUNK_VERSION = 1;
     // since 129^2 is the greatest power we can address in 16-bit index
     const uint16 Terrain::TERRAIN_MAX_BATCH_SIZE = 129; 
     const uint16 Terrain::WORKQUEUE_DERIVED_DATA_REQUEST = 1;
     const uint64 Terrain::TERRAIN_GENERATE_MATERIAL_INTERVAL_MS = 400;
     const uint16 Terrain::WORKQUEUE_GENERATE_MATERIAL_REQUEST = 2;
+    const uint16 Terrain::WORKQUEUE_BLEND_MAP_REQUEST = 3;
+    const size_t Terrain::COMPOSITE_MAP_MAX_DIRTY_RECTS = 8;
     const size_t Terrain::LOD_MORPH_CUSTOM_PARAM = 1001;
     const uint8 Terrain::DERIVED_DATA_DELTAS = 1;
     const uint8 Terrain::DERIVED_DATA_NORMALS = 2;
@@ -168,6 +172,8 @@ namespace Ogre
         , mDerivedUpdatePendingMask(0)
         , mGenerateMaterialInProgress(false)
         , mPrepareInProgress(false)
+        , mDeferImageData(false)
+        , mBlendMapUpdatesInProgress(0)
         , mMaterialGenerationCount(0)
         , mMaterialDirty(false)
         , mMaterialParamsDirty(false)
@@ -284,6 +290,8 @@ namespace Ogre
     {
         // force to load highest lod, or quadTree may contain hole
         load(0,true);
+        // the images not read yet come from the file we are about to overwrite
+        loadImageData(true);
 
         bool wasOpen = false;
 
@@ -320,6 +328,7 @@ namespace Ogre
     {
         // wait for any queued processes to finish
         waitForDerivedProcesses();
+        loadImageData(true);
 
         if (mHeightDataModified)
         {
@@ -349,6 +358,7 @@ namespace Ogre
 
         TerrainLodManager::saveLodData(stream,this);
 
+        stream.writeChunkBegin(TERRAINCOREDATA_CHUNK_ID, TERRAINCOREDATA_CHUNK_VERSION);
         // start compressing
         stream.startDeflate();
 
@@ -359,148 +369,85 @@ namespace Ogre
         uint8 numLayers = (uint8)mLayers.size();
         writeLayerInstanceList(mLayers, stream);
 
-        // Packed layer blend data
-        if(!mCpuBlendMapStorage.empty())
+        // save from CPU data if it's there, it means GPU data was never created
+        bool cpuBlendMaps = !mCpuBlendMapStorage.empty();
+        uint16 blendMapSize = cpuBlendMaps ? mLayerBlendMapSize : mLayerBlendMapSizeActual;
+        if (blendMapSize != mLayerBlendMapSize)
         {
-            // save from CPU data if it's there, it means GPU data was never created
-            stream.write(&mLayerBlendMapSize);
+            LogManager::getSingleton().logWarning(
+                "blend maps were requested at a size larger than was supported "
+                "on this hardware, which means the quality has been degraded");
+        }
+        stream.write(&blendMapSize);
 
-            // load packed CPU data
-            int numBlendTex = getBlendTextureCount(numLayers);
-            for (int i = 0; i < numBlendTex; ++i)
-            {
-                PixelFormat fmt = getBlendTextureFormat(i, numLayers);
-                size_t channels = PixelUtil::getNumElemBytes(fmt);
-                size_t dataSz = channels * mLayerBlendMapSize * mLayerBlendMapSize;
-                uint8* pData = mCpuBlendMapStorage[i];
-                stream.write(pData, dataSz);
-            }
+        // write the quadtree
+        mQuadTree->save(stream);
+
+        // stop compressing
+        stream.stopDeflate();
+        stream.writeChunkEnd(TERRAINCOREDATA_CHUNK_ID);
+
+        // The images are compressed one by one, so the ones only needed close
+        // to the terrain can be skipped by prepare() and read later on.
+        // The composite map goes first, which tells prepare() the others can wait.
+        if (mCompositeMapRequired)
+        {
+            // composite map is 4 channel, 3x diffuse, 1x specular mask
+            saveImageData(stream, "compositemap", mCompositeMapSize, PF_BYTE_RGBA,
+                mCpuCompositeMapStorage, mCompositeMap);
         }
-        else
+
+        if (mNormalMapRequired)
         {
-            if (mLayerBlendMapSize != mLayerBlendMapSizeActual)
-            {
-                LogManager::getSingleton().logWarning(
-                    "blend maps were requested at a size larger than was supported "
-                    "on this hardware, which means the quality has been degraded");
-            }
-            stream.write(&mLayerBlendMapSizeActual);
-            uint8* tmpData = (uint8*)OGRE_MALLOC(mLayerBlendMapSizeActual * mLayerBlendMapSizeActual * 4, MEMCATEGORY_GENERAL);
-            uint8 texIndex = 0;
-            for (TexturePtrList::iterator i = mBlendTextureList.begin(); i != mBlendTextureList.end(); ++i, ++texIndex)
-            {
-                // Must blit back in CPU format!
-                PixelFormat cpuFormat = getBlendTextureFormat(texIndex, getLayerCount());
-                PixelBox dst(mLayerBlendMapSizeActual, mLayerBlendMapSizeActual, 1, cpuFormat, tmpData);
-                (*i)->getBuffer()->blitToMemory(dst);
-                size_t dataSz = PixelUtil::getNumElemBytes((*i)->getFormat()) * 
-                    mLayerBlendMapSizeActual * mLayerBlendMapSizeActual;
-                stream.write(tmpData, dataSz);
-            }
-            OGRE_FREE(tmpData, MEMCATEGORY_GENERAL);
-        }
-
-        // other data
-        // normals
-		if (mNormalMapRequired)
-		{
-			stream.writeChunkBegin(TERRAINDERIVEDDATA_CHUNK_ID, TERRAINDERIVEDDATA_CHUNK_VERSION);
-			String normalDataType("normalmap");
-			stream.write(&normalDataType);
-			stream.write(&mSize);
-			if (mCpuTerrainNormalMap)
-			{
-				// save from CPU data if it's there, it means GPU data was never created
-				stream.write((uint8*)mCpuTerrainNormalMap->data, mSize * mSize * 3);
-			}
-			else
-			{
-				uint8* tmpData = (uint8*)OGRE_MALLOC(mSize * mSize * 3, MEMCATEGORY_GENERAL);
-				PixelBox dst(mSize, mSize, 1, PF_BYTE_RGB, tmpData);
-				mTerrainNormalMap->getBuffer()->blitToMemory(dst);
-				stream.write(tmpData, mSize * mSize * 3);
-				OGRE_FREE(tmpData, MEMCATEGORY_GENERAL);
-			}
-			stream.writeChunkEnd(TERRAINDERIVEDDATA_CHUNK_ID);
-		}
-
-        // colourmap
+            saveImageData(stream, "normalmap", mSize, PF_BYTE_RGB,
+                mCpuTerrainNormalMap ? (uint8*)mCpuTerrainNormalMap->data : 0, mTerrainNormalMap);
+        }
+
         if (mGlobalColourMapEnabled)
         {
-            stream.writeChunkBegin(TERRAINDERIVEDDATA_CHUNK_ID, TERRAINDERIVEDDATA_CHUNK_VERSION);
-            String colourDataType("colourmap");
-            stream.write(&colourDataType);
-            stream.write(&mGlobalColourMapSize);
-            if (mCpuColourMapStorage)
-            {
-                // save from CPU data if it's there, it means GPU data was never created
-                stream.write(mCpuColourMapStorage, mGlobalColourMapSize * mGlobalColourMapSize * 3);
-            }
-            else
-            {
-                uint8* tmpData = (uint8*)OGRE_MALLOC(mGlobalColourMapSize * mGlobalColourMapSize * 3, MEMCATEGORY_GENERAL);
-                PixelBox dst(mGlobalColourMapSize, mGlobalColourMapSize, 1, PF_BYTE_RGB, tmpData);
-                mColourMap->getBuffer()->blitToMemory(dst);
-                stream.write(tmpData, mGlobalColourMapSize * mGlobalColourMapSize * 3);
-                OGRE_FREE(tmpData, MEMCATEGORY_GENERAL);
-            }
-            stream.writeChunkEnd(TERRAINDERIVEDDATA_CHUNK_ID);
-
+            saveImageData(stream, "colourmap", mGlobalColourMapSize, PF_BYTE_RGB,
+                mCpuColourMapStorage, mColourMap);
         }
 
-        // lightmap
         if (mLightMapRequired)
         {
-            stream.writeChunkBegin(TERRAINDERIVEDDATA_CHUNK_ID, TERRAINDERIVEDDATA_CHUNK_VERSION);
-            String lightmapDataType("lightmap");
-            stream.write(&lightmapDataType);
-            stream.write(&mLightmapSize);
-            if (mCpuLightmapStorage)
-            {
-                // save from CPU data if it's there, it means GPU data was never created
-                stream.write(mCpuLightmapStorage, mLightmapSize * mLightmapSize);
-            }
-            else
-            {
-                uint8* tmpData = (uint8*)OGRE_MALLOC(mLightmapSize * mLightmapSize, MEMCATEGORY_GENERAL);
-                PixelBox dst(mLightmapSize, mLightmapSize, 1, PF_L8, tmpData);
-                mLightmap->getBuffer()->blitToMemory(dst);
-                stream.write(tmpData, mLightmapSize * mLightmapSize);
-                OGRE_FREE(tmpData, MEMCATEGORY_GENERAL);
-            }
-            stream.writeChunkEnd(TERRAINDERIVEDDATA_CHUNK_ID);
+            saveImageData(stream, "lightmap", mLightmapSize, PF_L8, mCpuLightmapStorage, mLightmap);
         }
 
-        // composite map
-        if (mCompositeMapRequired)
+        // Packed layer blend data
+        size_t numBlendTex = cpuBlendMaps ? mCpuBlendMapStorage.size() : mBlendTextureList.size();
+        for (uint8 texIndex = 0; texIndex < numBlendTex; ++texIndex)
         {
-            stream.writeChunkBegin(TERRAINDERIVEDDATA_CHUNK_ID, TERRAINDERIVEDDATA_CHUNK_VERSION);
-            String compositeMapDataType("compositemap");
-            stream.write(&compositeMapDataType);
-            stream.write(&mCompositeMapSize);
-            if (mCpuCompositeMapStorage)
-            {
-                // save from CPU data if it's there, it means GPU data was never created
-                stream.write(mCpuCompositeMapStorage, mCompositeMapSize * mCompositeMapSize * 4);
-            }
+            if (cpuBlendMaps && !mCpuBlendMapStorage[texIndex])
+                continue;
+
+            TerrainLodManager::ImageData image;
+            image.name = "blendmap" + StringConverter::toString(texIndex);
+            image.size = blendMapSize;
+            // Must save in CPU format!
+            PixelFormat cpuFormat = getBlendTextureFormat(texIndex, numLayers);
+            image.dataSize = (uint32)PixelUtil::getMemorySize(blendMapSize, blendMapSize, 1, cpuFormat);
+            if (cpuBlendMaps)
+                image.data = mCpuBlendMapStorage[texIndex];
             else
             {
-                // composite map is 4 channel, 3x diffuse, 1x specular mask
-                uint8* tmpData = (uint8*)OGRE_MALLOC(mCompositeMapSize * mCompositeMapSize * 4, MEMCATEGORY_GENERAL);
-                PixelBox dst(mCompositeMapSize, mCompositeMapSize, 1, PF_BYTE_RGBA, tmpData);
-                mCompositeMap->getBuffer()->blitToMemory(dst);
-                stream.write(tmpData, mCompositeMapSize * mCompositeMapSize * 4);
-                OGRE_FREE(tmpData, MEMCATEGORY_GENERAL);
+                image.data = (uint8*)OGRE_MALLOC(image.dataSize, MEMCATEGORY_GENERAL);
+                PixelBox dst(blendMapSize, blendMapSize, 1, cpuFormat, image.data);
+                HardwarePixelBufferSharedPtr buf = mBlendTextureList[texIndex]->getBuffer();
+                if (texIndex < mBlendTextureShadows.size() && mBlendTextureShadows[texIndex])
+                {
+                    // no need to read the texture back
+                    PixelUtil::bulkPixelConversion(PixelBox(buf->getWidth(), buf->getHeight(), 1,
+                        buf->getFormat(), mBlendTextureShadows[texIndex]), dst);
+                }
+                else
+                    buf->blitToMemory(dst);
             }
-            stream.writeChunkEnd(TERRAINDERIVEDDATA_CHUNK_ID);
+            TerrainLodManager::saveImageData(stream, image);
+            if (!cpuBlendMaps)
+                OGRE_FREE(image.data, MEMCATEGORY_GENERAL);
         }
 
-        // write the quadtree
-        mQuadTree->save(stream);
-
-        // stop compressing
-        stream.stopDeflate();
-
         stream.writeChunkEnd(TERRAIN_CHUNK_ID);
 
         mModified = false;
@@ -508,6 +455,27 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
+    void Terrain::saveImageData(StreamSerialiser& stream, const String& name, uint16 size,
+        PixelFormat format, uint8* cpuData, const TexturePtr& tex)
+    {
+        TerrainLodManager::ImageData image;
+        image.name = name;
+        image.size = size;
+        image.dataSize = (uint32)PixelUtil::getMemorySize(size, size, 1, format);
+        image.data = cpuData;
+        if (!cpuData)
+        {
+            image.data = (uint8*)OGRE_MALLOC(image.dataSize, MEMCATEGORY_GENERAL);
+            PixelBox dst(size, size, 1, format, image.data);
+            tex->getBuffer()->blitToMemory(dst);
+        }
+
+        TerrainLodManager::saveImageData(stream, image);
+
+        if (!cpuData)
+            OGRE_FREE(image.data, MEMCATEGORY_GENERAL);
+    }
+    //---------------------------------------------------------------------
     void Terrain::writeLayerDeclaration(const TerrainLayerDeclaration& decl, StreamSerialiser& stream)
     {
         // Layer declaration
@@ -644,7 +612,11 @@ namespace Ogre
         freeLodData();
         mLodManager = OGRE_NEW TerrainLodManager( this, stream );
         StreamSerialiser ser(stream);
-        return prepare(ser);
+        // the LOD manager keeps the stream open, so images can be read later
+        mDeferImageData = true;
+        bool ret = prepare(ser);
+        mDeferImageData = false;
+        return ret;
     }
     //---------------------------------------------------------------------
     bool Terrain::prepare(StreamSerialiser& stream)
@@ -658,6 +630,7 @@ namespace Ogre
         {
             mLodManager = OGRE_NEW TerrainLodManager( this );
         }
+        mLodManager->_setPendingImageData(0, 0, StreamSerialiser::ENDIAN_AUTO);
 
         copyGlobalOptions();
 
@@ -700,7 +673,16 @@ namespace Ogre
             }
 
             // start uncompressing
-            stream.startDeflate( mainChunk->length - stream.getOffsetFromChunkStart() );
+            if(mainChunk->version > 2)
+            {
+                const StreamSerialiser::Chunk* coreChunk =
+                    stream.readChunkBegin(TERRAINCOREDATA_CHUNK_ID, TERRAINCOREDATA_CHUNK_VERSION);
+                if (!coreChunk)
+                    return false;
+                stream.startDeflate(coreChunk->length);
+            }
+            else
+                stream.startDeflate( mainChunk->length - stream.getOffsetFromChunkStart() );
         }
         else
         {
@@ -722,8 +704,8 @@ namespace Ogre
         uint8 numLayers = (uint8)mLayers.size();
         stream.read(&mLayerBlendMapSize);
         mLayerBlendMapSizeActual = mLayerBlendMapSize; // for now, until we check
-        // load packed CPU data
-        int numBlendTex = getBlendTextureCount(numLayers);
+        // load packed CPU data, images have chunks of their own since version 3
+        int numBlendTex = mainChunk->version > 2 ? 0 : getBlendTextureCount(numLayers);
         for (int i = 0; i < numBlendTex; ++i)
         {
             PixelFormat fmt = getBlendTextureFormat(i, numLayers);
@@ -735,7 +717,7 @@ namespace Ogre
         }
 
         // derived data
-        while (!stream.isEndOfChunk(TERRAIN_CHUNK_ID) && 
+        while (mainChunk->version < 3 && !stream.isEndOfChunk(TERRAIN_CHUNK_ID) &&
             stream.peekNextChunkID() == TERRAINDERIVEDDATA_CHUNK_ID)
         {
             stream.readChunkBegin(TERRAINDERIVEDDATA_CHUNK_ID, TERRAINDERIVEDDATA_CHUNK_VERSION);
@@ -795,6 +777,12 @@ namespace Ogre
         if(mainChunk->version > 1)
             stream.stopDeflate();
 
+        if(mainChunk->version > 2)
+        {
+            stream.readChunkEnd(TERRAINCOREDATA_CHUNK_ID);
+            prepareImageData(stream);
+        }
+
         stream.readChunkEnd(TERRAIN_CHUNK_ID);
 
         mModified = false;
@@ -805,6 +793,148 @@ namespace Ogre
         return true;
     }
     //---------------------------------------------------------------------
+    void Terrain::prepareImageData(StreamSerialiser& stream)
+    {
+        bool haveCompositeMap = false;
+        size_t pendingOffset = 0;
+        uint16 numPending = 0;
+        while (!stream.isEndOfChunk(TERRAIN_CHUNK_ID) &&
+            stream.peekNextChunkID() == TERRAINDERIVEDDATA_CHUNK_ID)
+        {
+            // The composite map comes first. If there is one, it stands in for the
+            // other images until the camera comes close, so they can stay in the file
+            bool defer = mDeferImageData && haveCompositeMap;
+            TerrainLodManager::ImageData image;
+            size_t offset = TerrainLodManager::readImageData(stream, image, !defer);
+            if (defer && !numPending++)
+                pendingOffset = offset;
+
+            if (image.name == "normalmap")
+            {
+                mNormalMapRequired = true;
+            }
+            else if (image.name == "colourmap")
+            {
+                mGlobalColourMapEnabled = true;
+                mGlobalColourMapSize = image.size;
+            }
+            else if (image.name == "lightmap")
+            {
+                mLightMapRequired = true;
+                mLightmapSize = image.size;
+            }
+            else if (image.name == "compositemap")
+            {
+                mCompositeMapRequired = true;
+                mCompositeMapSize = image.size;
+                haveCompositeMap = true;
+            }
+
+            if (image.data)
+                setImageData(image);
+        }
+
+        mLodManager->_setPendingImageData(pendingOffset, numPending, stream.getEndian());
+    }
+    //---------------------------------------------------------------------
+    void Terrain::setImageData(TerrainLodManager::ImageData& image)
+    {
+        // Upload to the texture if there is one already, otherwise keep the
+        // data until it is created. Images no longer wanted are dropped.
+        if (image.name == "normalmap" && mNormalMapRequired)
+        {
+            if (mTerrainNormalMap)
+            {
+                PixelBox src(image.size, image.size, 1, PF_BYTE_RGB, image.data);
+                mTerrainNormalMap->getBuffer()->blitFromMemory(src);
+            }
+            else if (image.size == mSize)
+            {
+                if (mCpuTerrainNormalMap)
+                {
+                    OGRE_FREE(mCpuTerrainNormalMap->data, MEMCATEGORY_GENERAL);
+                    OGRE_DELETE mCpuTerrainNormalMap;
+                }
+                mCpuTerrainNormalMap = OGRE_NEW PixelBox(image.size, image.size, 1, PF_BYTE_RGB, image.data);
+                image.data = 0;
+            }
+        }
+        else if (image.name == "colourmap" && mGlobalColourMapEnabled)
+        {
+            if (mColourMap)
+            {
+                PixelBox src(image.size, image.size, 1, PF_BYTE_RGB, image.data);
+                mColourMap->getBuffer()->blitFromMemory(src);
+            }
+            else if (image.size == mGlobalColourMapSize)
+            {
+                OGRE_FREE(mCpuColourMapStorage, MEMCATEGORY_GENERAL);
+                mCpuColourMapStorage = image.data;
+                image.data = 0;
+            }
+        }
+        else if (image.name == "lightmap" && mLightMapRequired)
+        {
+            if (mLightmap)
+            {
+                PixelBox src(image.size, image.size, 1, PF_L8, image.data);
+                mLightmap->getBuffer()->blitFromMemory(src);
+            }
+            else if (image.size == mLightmapSize)
+            {
+                OGRE_FREE(mCpuLightmapStorage, MEMCATEGORY_GENERAL);
+                mCpuLightmapStorage = image.data;
+                image.data = 0;
+            }
+        }
+        else if (image.name == "compositemap" && mCompositeMapRequired)
+        {
+            if (mCompositeMap)
+            {
+                PixelBox src(image.size, image.size, 1, PF_BYTE_RGBA, image.data);
+                mCompositeMap->getBuffer()->blitFromMemory(src);
+            }
+            else if (image.size == mCompositeMapSize)
+            {
+                OGRE_FREE(mCpuCompositeMapStorage, MEMCATEGORY_GENERAL);
+                mCpuCompositeMapStorage = image.data;
+                image.data = 0;
+            }
+        }
+        else if (StringUtil::startsWith(image.name, "blendmap", false))
+        {
+            uint8 index = (uint8)StringConverter::parseUnsignedInt(image.name.substr(8));
+            if (index < mBlendTextureList.size())
+            {
+                freeLayerBlendTextureShadows();
+                PixelBox src(image.size, image.size, 1, getBlendTextureFormat(index, getLayerCount()), image.data);
+                mBlendTextureList[index]->getBuffer()->blitFromMemory(src);
+            }
+            else if (image.size == mLayerBlendMapSize)
+            {
+                if (mCpuBlendMapStorage.size() <= index)
+                    mCpuBlendMapStorage.resize(index + 1, 0);
+                OGRE_FREE(mCpuBlendMapStorage[index], MEMCATEGORY_RESOURCE);
+                mCpuBlendMapStorage[index] = image.data;
+                image.data = 0;
+            }
+        }
+
+        OGRE_FREE(image.data, MEMCATEGORY_GENERAL);
+        image.data = 0;
+    }
+    //---------------------------------------------------------------------
+    bool Terrain::isImageDataPending() const
+    {
+        return mLodManager && mLodManager->isImageDataPending();
+    }
+    //---------------------------------------------------------------------
+    void Terrain::loadImageData(bool synchronous)
+    {
+        if (mLodManager)
+            mLodManager->loadImageData(synchronous);
+    }
+    //---------------------------------------------------------------------
     bool Terrain::prepare(const ImportData& importData)
     {
         mPrepareInProgress = true;
@@ -1890,7 +2020,27 @@ namespace Ogre
     //---------------------------------------------------------------------
     void Terrain::_dirtyCompositeMapRect(const Rect& rect)
     {
-        mCompositeMapDirtyRect.merge(rect);
+        // Keep separate strokes apart, so only they are rendered again. Areas
+        // which overlap are merged, too many are merged into one.
+        Rect merged = rect;
+        for (RectList::iterator i = mCompositeMapDirtyBlendRects.begin(); i != mCompositeMapDirtyBlendRects.end();)
+        {
+            if (!i->intersect(merged).isNull())
+            {
+                merged.merge(*i);
+                mCompositeMapDirtyBlendRects.erase(i);
+                i = mCompositeMapDirtyBlendRects.begin();
+            }
+            else
+                ++i;
+        }
+        if (mCompositeMapDirtyBlendRects.size() >= COMPOSITE_MAP_MAX_DIRTY_RECTS)
+        {
+            for (RectList::iterator i = mCompositeMapDirtyBlendRects.begin(); i != mCompositeMapDirtyBlendRects.end(); ++i)
+                merged.merge(*i);
+            mCompositeMapDirtyBlendRects.clear();
+        }
+        mCompositeMapDirtyBlendRects.push_back(merged);
         mModified = true;
     }
     //---------------------------------------------------------------------
@@ -1941,6 +2091,8 @@ namespace Ogre
     {
         if (!mDirtyDerivedDataRect.isNull() || !mDirtyLightmapFromNeighboursRect.isNull())
         {
+            // images read later would overwrite the update
+            loadImageData(true);
             mModified = true;
             if (mDerivedDataUpdateInProgress)
             {
@@ -1991,7 +2143,8 @@ namespace Ogre
     //---------------------------------------------------------------------
     void Terrain::waitForDerivedProcesses()
     {
-        while (mDerivedDataUpdateInProgress || mGenerateMaterialInProgress || mPrepareInProgress)
+        while (mDerivedDataUpdateInProgress || mGenerateMaterialInProgress || mPrepareInProgress ||
+               mBlendMapUpdatesInProgress)
         {
             // we need to wait for this to finish
             OGRE_THREAD_SLEEP(50);
@@ -2030,6 +2183,8 @@ namespace Ogre
     //---------------------------------------------------------------------
     void Terrain::freeGPUResources()
     {
+        freeLayerBlendTextureShadows();
+
         // remove textures
         TextureManager* tmgr = TextureManager::getSingletonPtr();
         if (tmgr)
@@ -2307,6 +2462,12 @@ namespace Ogre
             mLastLODFrame = frameNum;
             mLastViewportHeight = vpHeight;
             calculateCurrentLod(v);
+
+            // Read the images used close by in time for the camera to get there
+            if (isImageDataPending() &&
+                getWorldAABB().distance(lodCamera->getDerivedPosition()) <
+                TerrainGlobalOptions::getSingleton().getCompositeMapDistance() * 1.2f)
+                loadImageData();
         }
     }
     //---------------------------------------------------------------------
@@ -2618,6 +2779,9 @@ namespace Ogre
     {
         if (getLayerCount() > 0)
         {
+            // the blend maps are about to change
+            loadImageData(true);
+
             if (index >= getLayerCount())
                 index = getLayerCount() - 1;
 
@@ -2662,6 +2826,9 @@ namespace Ogre
         if (!worldSize)
             worldSize = TerrainGlobalOptions::getSingleton().getDefaultLayerTextureWorldSize();
 
+        // the blend maps are about to change
+        loadImageData(true);
+
         uint8 blendIndex = std::max(index-1,0); 
         if (index >= getLayerCount())
         {
@@ -2711,6 +2878,9 @@ namespace Ogre
     {
         if (index < mLayers.size())
         {
+            // the blend maps are about to change
+            loadImageData(true);
+
             uint8 blendIndex = std::max(index-1,0); 
 
             // Shift all GPU texture channels down one
@@ -2759,6 +2929,9 @@ namespace Ogre
         uint8 idx = layerIndex - 1;
         if (!mLayerBlendMapList[idx])
         {
+            // edits must start from the saved blend data
+            loadImageData(true);
+
             if (mBlendTextureList.size() < static_cast<size_t>(idx / 4))
                 checkLayers(true);
 
@@ -2852,6 +3025,8 @@ namespace Ogre
         unsigned char rgbaShift[4];
         Box box(0, 0, destBuffer->getWidth(), destBuffer->getHeight());
 
+        freeLayerBlendTextureShadows();
+
         uint8* pDestBase = destBuffer->lock(box, HardwareBuffer::HBL_NORMAL).data;
         PixelUtil::getBitShifts(destBuffer->getFormat(), rgbaShift);
         uint8* pDest = pDestBase + rgbaShift[destChannel] / 8;
@@ -2895,6 +3070,8 @@ namespace Ogre
         unsigned char rgbaShift[4];
         Box box(0, 0, buffer->getWidth(), buffer->getHeight());
 
+        freeLayerBlendTextureShadows();
+
         uint8* pData = buffer->lock(box, HardwareBuffer::HBL_NORMAL).data;
         PixelUtil::getBitShifts(buffer->getFormat(), rgbaShift);
         pData += rgbaShift[channel] / 8;
@@ -2911,6 +3088,109 @@ namespace Ogre
         buffer->unlock();
     }
     //---------------------------------------------------------------------
+    void Terrain::freeLayerBlendTextureShadows()
+    {
+        _waitForLayerBlendTextureUpdates();
+        for (BytePointerList::iterator i = mBlendTextureShadows.begin(); i != mBlendTextureShadows.end(); ++i)
+            OGRE_FREE(*i, MEMCATEGORY_RESOURCE);
+        mBlendTextureShadows.clear();
+    }
+    //---------------------------------------------------------------------
+    uint8* Terrain::_getLayerBlendTextureShadow(uint8 index)
+    {
+        const TexturePtr& tex = getLayerBlendTexture(index);
+        if (mBlendTextureShadows.size() <= index)
+            mBlendTextureShadows.resize(index + 1, 0);
+
+        if (!mBlendTextureShadows[index])
+        {
+            // Read the texture back once, from now on only the changes are uploaded
+            HardwarePixelBufferSharedPtr buf = tex->getBuffer();
+            size_t sz = PixelUtil::getMemorySize(buf->getWidth(), buf->getHeight(), 1, buf->getFormat());
+            mBlendTextureShadows[index] = static_cast<uint8*>(OGRE_MALLOC(sz, MEMCATEGORY_RESOURCE));
+            buf->blitToMemory(PixelBox(buf->getWidth(), buf->getHeight(), 1, buf->getFormat(),
+                                       mBlendTextureShadows[index]));
+        }
+        return mBlendTextureShadows[index];
+    }
+    //---------------------------------------------------------------------
+    void Terrain::_updateLayerBlendTexture(uint8 layerIndex, uint8 channelOffset, const Box& box,
+        const float* data, const Rect& compositeMapRect, bool synchronous)
+    {
+        BlendMapRequest req;
+        req.terrain = this;
+        req.textureIndex = getLayerBlendTextureIndex(layerIndex).first;
+        req.shadow = _getLayerBlendTextureShadow(req.textureIndex);
+        HardwarePixelBufferSharedPtr buf = getLayerBlendTexture(req.textureIndex)->getBuffer();
+        req.shadowWidth = buf->getWidth();
+        req.texelSize = (uint8)PixelUtil::getNumElemBytes(buf->getFormat());
+        req.channelOffset = channelOffset;
+        req.box = box;
+        req.compositeMapRect = compositeMapRect;
+
+        // copy the area, the caller goes on editing the blend values
+        req.data = OGRE_ALLOC_T(float, box.getWidth() * box.getHeight(), MEMCATEGORY_RESOURCE);
+        for (uint32 y = 0; y < box.getHeight(); ++y)
+        {
+            memcpy(req.data + y * box.getWidth(), data + (box.top + y) * req.shadowWidth + box.left,
+                box.getWidth() * sizeof(float));
+        }
+
+        ++mBlendMapUpdatesInProgress;
+        if (!Root::getSingleton().getWorkQueue()->addRequest(
+            mWorkQueueChannel, WORKQUEUE_BLEND_MAP_REQUEST, Any(req), 0, synchronous))
+        {
+            // the work queue is shutting down
+            convertLayerBlendArea(req);
+            uploadLayerBlendArea(req);
+        }
+    }
+    //---------------------------------------------------------------------
+    void Terrain::_waitForLayerBlendTextureUpdates()
+    {
+        while (mBlendMapUpdatesInProgress)
+        {
+            OGRE_THREAD_SLEEP(1);
+            Root::getSingleton().getWorkQueue()->processResponses();
+        }
+    }
+    //---------------------------------------------------------------------
+    void Terrain::convertLayerBlendArea(const BlendMapRequest& req)
+    {
+        // Background thread (maybe)
+        OGRE_LOCK_MUTEX(mBlendTextureShadowMutex);
+
+        const float* pSrc = req.data;
+        uint8* pDstBase = req.shadow + (req.box.top * req.shadowWidth + req.box.left) * req.texelSize +
+            req.channelOffset;
+        for (size_t y = 0; y < req.box.getHeight(); ++y)
+        {
+            uint8* pDst = pDstBase + y * req.shadowWidth * req.texelSize;
+            for (size_t x = 0; x < req.box.getWidth(); ++x)
+            {
+                *pDst = static_cast<uint8>(*pSrc++ * 255);
+                pDst += req.texelSize;
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void Terrain::uploadLayerBlendArea(const BlendMapRequest& req)
+    {
+        // Main thread
+        {
+            OGRE_LOCK_MUTEX(mBlendTextureShadowMutex);
+            HardwarePixelBufferSharedPtr buf = mBlendTextureList[req.textureIndex]->getBuffer();
+            PixelBox shadow(buf->getWidth(), buf->getHeight(), 1, buf->getFormat(), req.shadow);
+            buf->blitFromMemory(shadow.getSubVolume(req.box), req.box);
+        }
+        OGRE_FREE(req.data, MEMCATEGORY_RESOURCE);
+        --mBlendMapUpdatesInProgress;
+
+        // make sure composite map is updated
+        _dirtyCompositeMapRect(req.compositeMapRect);
+        updateCompositeMapWithDelay();
+    }
+    //---------------------------------------------------------------------
     void Terrain::createGPUBlendTextures()
     {
         // Create enough RGBA/RGB textures to cope with blend layers
@@ -2925,6 +3205,13 @@ namespace Ogre
             tmgr->remove(mBlendTextureList.back()->getHandle());            
             mBlendTextureList.pop_back();
         }
+        if (mBlendTextureShadows.size() > numTex)
+            _waitForLayerBlendTextureUpdates();
+        while (mBlendTextureShadows.size() > numTex)
+        {
+            OGRE_FREE(mBlendTextureShadows.back(), MEMCATEGORY_RESOURCE);
+            mBlendTextureShadows.pop_back();
+        }
 
         uint8 currentTex = (uint8)mBlendTextureList.size();
         mBlendTextureList.resize(numTex);
@@ -2941,7 +3228,7 @@ namespace Ogre
 
             mLayerBlendMapSizeActual = mBlendTextureList[i]->getWidth();
 
-            if (mCpuBlendMapStorage.size() > i)
+            if (mCpuBlendMapStorage.size() > i && mCpuBlendMapStorage[i])
             {
                 // Load blend data
                 PixelBox src(mLayerBlendMapSize, mLayerBlendMapSize, 1, fmt, mCpuBlendMapStorage[i]);
@@ -3019,6 +3306,8 @@ namespace Ogre
 
         // Editable structures for blend layers (not needed at runtime,  only blend textures are)
         deleteBlendMaps(0); 
+        // CPU copies of the blend textures, which only serve the editable structures
+        freeLayerBlendTextureShadows();
     }
     //---------------------------------------------------------------------
     void Terrain::deleteBlendMaps(uint8 lowIndex)
@@ -3140,6 +3429,11 @@ namespace Ogre
             if (gmreq.terrain != this)
                 return false;
         }
+        else if(req->getType()==WORKQUEUE_BLEND_MAP_REQUEST)
+        {
+            if (any_cast<BlendMapRequest>(req->getData()).terrain != this)
+                return false;
+        }
 
             return RequestHandler::canHandleRequest(req, srcQ);
 
@@ -3161,6 +3455,11 @@ namespace Ogre
             GenerateMaterialRequest gmreq = any_cast<GenerateMaterialRequest>(req->getData());
             if (gmreq.terrain != this)
                 return false;
+        }
+        else if(req->getType()==WORKQUEUE_BLEND_MAP_REQUEST)
+        {
+            if (any_cast<BlendMapRequest>(req->getData()).terrain != this)
+                return false;
         }
             return true;
     }
@@ -3172,6 +3471,11 @@ namespace Ogre
         {
             return OGRE_NEW WorkQueue::Response(req, true, Any());
         }
+        if(req->getType()==WORKQUEUE_BLEND_MAP_REQUEST)
+        {
+            convertLayerBlendArea(any_cast<BlendMapRequest>(req->getData()));
+            return OGRE_NEW WorkQueue::Response(req, true, Any());
+        }
 
         DerivedDataRequest ddr = any_cast<DerivedDataRequest>(req->getData());
         DerivedDataResponse ddres;
@@ -3210,6 +3514,11 @@ namespace Ogre
             handleGenerateMaterialResponse(res,srcQ);
             return;
         }
+        if(res->getRequest()->getType()==WORKQUEUE_BLEND_MAP_REQUEST)
+        {
+            uploadLayerBlendArea(any_cast<BlendMapRequest>(res->getRequest()->getData()));
+            return;
+        }
 
         DerivedDataResponse ddres = any_cast<DerivedDataResponse>(res->getData());
         DerivedDataRequest ddreq = any_cast<DerivedDataRequest>(res->getRequest()->getData());
@@ -3610,10 +3919,13 @@ namespace Ogre
     void Terrain::updateCompositeMap()
     {
         // All done in the render thread
-        if (mCompositeMapRequired && !mCompositeMapDirtyRect.isNull())
+        if (mCompositeMapRequired && (!mCompositeMapDirtyRect.isNull() || !mCompositeMapDirtyBlendRects.empty()))
         {
+            // the composite map is rendered from the blend maps and the lightmap
+            loadImageData(true);
             mModified = true;
             createOrDestroyGPUCompositeMap();
+            Rect renderedRect = mCompositeMapDirtyRect;
             if (mCompositeMapDirtyRectLightmapUpdate &&
                 (mCompositeMapDirtyRect.width() < mSize || mCompositeMapDirtyRect.height() < mSize))
             {
@@ -3625,15 +3937,22 @@ namespace Ogre
                 widenedRect.top = std::max(widenedRect.top, 0L);
                 widenedRect.right = std::min(widenedRect.right, (long)mSize);
                 widenedRect.bottom = std::min(widenedRect.bottom, (long)mSize);
-                mMaterialGenerator->updateCompositeMap(this, widenedRect);  
+                renderedRect = widenedRect;
+            }
+            if (!renderedRect.isNull())
+                mMaterialGenerator->updateCompositeMap(this, renderedRect);
+
+            // the areas changed by the blend maps one by one, unless they were just rendered
+            for (RectList::iterator i = mCompositeMapDirtyBlendRects.begin(); i != mCompositeMapDirtyBlendRects.end(); ++i)
+            {
+                Rect covered = renderedRect.intersect(*i);
+                if (covered.width() != i->width() || covered.height() != i->height())
+                    mMaterialGenerator->updateCompositeMap(this, *i);
             }
-            else
-                mMaterialGenerator->updateCompositeMap(this, mCompositeMapDirtyRect);
 
             mCompositeMapDirtyRectLightmapUpdate = false;
             mCompositeMapDirtyRect.setNull();
-
-
+            mCompositeMapDirtyBlendRects.clear();
         }
     }
     //---------------------------------------------------------------------
@@ -4560,6 +4879,7 @@ namespace Ogre
             waitForDerivedProcesses();
             // load full HeightData
             load(0,true);
+            loadImageData(true);
 
             size_t numVertices = newSize * newSize;
 
@@ -286,15 +286,38 @@ namespace Ogre
 
     }
     //---------------------------------------------------------------------
-    void TerrainGroup::loadTerrain(long x, long y, bool synchronous /*= false*/)
+    void TerrainGroup::loadTerrain(long x, long y, bool synchronous /*= false*/, Real priority /*= 0*/)
     {
         TerrainSlot* slot = getTerrainSlot(x, y, false);
         if (slot)
         {
-            loadTerrainImpl(slot, synchronous);
+            loadTerrainImpl(slot, synchronous, priority);
         }
 
     }
+    //---------------------------------------------------------------------
+    bool TerrainGroup::setTerrainLoadPriority(long x, long y, Real priority)
+    {
+        TerrainSlot* slot = getTerrainSlot(x, y, false);
+        if (!slot)
+            return false;
+
+        TerrainPrepareRequestMap::iterator it = mTerrainPrepareRequests.find(slot);
+        if (it == mTerrainPrepareRequests.end())
+            return false;
+
+        return Root::getSingleton().getWorkQueue()->setRequestPriority(it->second, priority);
+    }
+    //---------------------------------------------------------------------
+    void TerrainGroup::setMaxConcurrentLoads(size_t maxLoads)
+    {
+        Root::getSingleton().getWorkQueue()->setMaxConcurrentRequests(mWorkQueueChannel, maxLoads);
+    }
+    //---------------------------------------------------------------------
+    size_t TerrainGroup::getMaxConcurrentLoads() const
+    {
+        return Root::getSingleton().getWorkQueue()->getMaxConcurrentRequests(mWorkQueueChannel);
+    }
 
     void TerrainGroup::loadLegacyTerrain(const String& cfgFilename, long x, long y, bool synchronous)
     {
@@ -362,7 +385,7 @@ namespace Ogre
     }
 
     //---------------------------------------------------------------------
-    void TerrainGroup::loadTerrainImpl(TerrainSlot* slot, bool synchronous)
+    void TerrainGroup::loadTerrainImpl(TerrainSlot* slot, bool synchronous, Real priority)
     {
         if (!slot->instance && 
             (!slot->def.filename.empty() || slot->def.importData))
@@ -380,9 +403,9 @@ namespace Ogre
                 mTerrainPrepareRequests.insert(TerrainPrepareRequestMap::value_type(slot, 0));
             assert(ret.second == true);
             WorkQueue::RequestID id =
-                Root::getSingleton().getWorkQueue()->addRequest(
+                Root::getSingleton().getWorkQueue()->addRequestWithPriority(
                     mWorkQueueChannel, WORKQUEUE_LOAD_REQUEST,
-                    Any(req), 0, synchronous);
+                    Any(req), priority, 0, synchronous);
             if (!synchronous)
                 ret.first->second = id;
         }
@@ -71,10 +71,13 @@ namespace Ogre
     //---------------------------------------------------------------------
     void TerrainLayerBlendMap::download()
     {
+        // areas still being converted by the work queue reach the CPU copy first
+        mParent->_waitForLayerBlendTextureUpdates();
+
         float* pDst = mData;
-        // Download data
+        // Read from the CPU copy of the texture, which is shared by the layers in it
         Box box(0, 0, mBuffer->getWidth(), mBuffer->getHeight());
-        uint8* pSrc = mBuffer->lock(box, HardwareBuffer::HBL_READ_ONLY).data;
+        const uint8* pSrc = mParent->_getLayerBlendTextureShadow(mParent->getLayerBlendTextureIndex(mLayerIdx).first);
         pSrc += mChannelOffset;
         size_t srcInc = PixelUtil::getNumElemBytes(mBuffer->getFormat());
         for (size_t y = box.top; y < box.bottom; ++y)
@@ -85,7 +88,6 @@ namespace Ogre
                 pSrc += srcInc;
             }
         }
-        mBuffer->unlock();
 
     }
     //---------------------------------------------------------------------
@@ -170,40 +172,24 @@ namespace Ogre
         }
     }
     //---------------------------------------------------------------------
-    void TerrainLayerBlendMap::update()
+    void TerrainLayerBlendMap::update(bool synchronous)
     {
         if (mData && mDirty)
         {
-            // Upload data
-            float* pSrcBase = mData + mDirtyBox.top * mBuffer->getWidth() + mDirtyBox.left;
-            uint8* pDstBase = mBuffer->lock(mDirtyBox, HardwarePixelBuffer::HBL_NORMAL).data;
-            pDstBase += mChannelOffset;
-            size_t dstInc = PixelUtil::getNumElemBytes(mBuffer->getFormat());
-            for (size_t y = 0; y < mDirtyBox.getHeight(); ++y)
-            {
-                float* pSrc = pSrcBase + y * mBuffer->getWidth();
-                uint8* pDst = pDstBase + y * mBuffer->getWidth() * dstInc;
-                for (size_t x = 0; x < mDirtyBox.getWidth(); ++x)
-                {
-                    *pDst = static_cast<uint8>(*pSrc++ * 255);
-                    pDst += dstInc;
-                }
-            }
-            mBuffer->unlock();
-
-            mDirty = false;
-
-            // make sure composite map is updated
-            // mDirtyBox is in image space, convert to terrain units
+            // mDirtyBox is in image space, convert to terrain units for the composite map
             Rect compositeMapRect;
             float blendToTerrain = (float)mParent->getSize() / (float)mBuffer->getWidth();
             compositeMapRect.left = (long)(mDirtyBox.left * blendToTerrain);
             compositeMapRect.right = (long)(mDirtyBox.right * blendToTerrain + 1);
             compositeMapRect.top = (long)((mBuffer->getHeight() - mDirtyBox.bottom) * blendToTerrain);
             compositeMapRect.bottom = (long)((mBuffer->getHeight() - mDirtyBox.top) * blendToTerrain + 1);
-            mParent->_dirtyCompositeMapRect(compositeMapRect);
-            mParent->updateCompositeMapWithDelay();
 
+            // Our channel is written into the CPU copy of the texture by the work queue
+            // and only the dirty area is uploaded, locking the buffer would read it all back
+            mParent->_updateLayerBlendTexture(mLayerIdx, mChannelOffset, mDirtyBox, mData,
+                compositeMapRect, synchronous);
+
+            mDirty = false;
         }
     }
     //---------------------------------------------------------------------
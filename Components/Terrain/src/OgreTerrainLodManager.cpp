@@ -35,6 +35,7 @@ THE SOFTWARE.
 namespace Ogre
 {
     const uint16 TerrainLodManager::WORKQUEUE_LOAD_LOD_DATA_REQUEST = 1;
+    const uint16 TerrainLodManager::WORKQUEUE_LOAD_IMAGE_DATA_REQUEST = 2;
     const uint32 TerrainLodManager::TERRAINLODDATA_CHUNK_ID = StreamSerialiser::makeIdentifier("TLDA");
     const uint16 TerrainLodManager::TERRAINLODDATA_CHUNK_VERSION = 1;
 
@@ -77,6 +78,10 @@ namespace Ogre
         mIncreaseLodLevelInProgress = false;
         mLastRequestSynchronous = false;
         mLodInfoTable = 0;
+        mImageDataOffset = 0;
+        mImageDataCount = 0;
+        mImageDataEndian = StreamSerialiser::ENDIAN_AUTO;
+        mLoadImageDataInProgress = false;
 
         WorkQueue* wq = Root::getSingleton().getWorkQueue();
         mWorkQueueChannel = wq->getChannel("Ogre/TerrainLodManager");
@@ -86,6 +91,8 @@ namespace Ogre
 
     TerrainLodManager::~TerrainLodManager()
     {
+        // images still on the way are dropped
+        mImageDataOffset = 0;
         waitForDerivedProcesses();
         WorkQueue* wq = Root::getSingleton().getWorkQueue();
         wq->removeRequestHandler(mWorkQueueChannel, this);
@@ -97,20 +104,38 @@ namespace Ogre
 
     bool TerrainLodManager::canHandleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
     {
-        LoadLodRequest lreq = any_cast<LoadLodRequest>(req->getData());
-        if (lreq.requestee != this)
+        TerrainLodManager* requestee = req->getType() == WORKQUEUE_LOAD_IMAGE_DATA_REQUEST ?
+            any_cast<LoadImageRequest>(req->getData()).requestee :
+            any_cast<LoadLodRequest>(req->getData()).requestee;
+        if (requestee != this)
             return false;
         return RequestHandler::canHandleRequest(req, srcQ);
     }
     //---------------------------------------------------------------------
     bool TerrainLodManager::canHandleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
     {
-        LoadLodRequest lreq = any_cast<LoadLodRequest>(res->getRequest()->getData());
-        return (lreq.requestee == this);
+        const WorkQueue::Request* req = res->getRequest();
+        TerrainLodManager* requestee = req->getType() == WORKQUEUE_LOAD_IMAGE_DATA_REQUEST ?
+            any_cast<LoadImageRequest>(req->getData()).requestee :
+            any_cast<LoadLodRequest>(req->getData()).requestee;
+        return (requestee == this);
     }
 
     WorkQueue::Response* TerrainLodManager::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
     {
+        if (req->getType() == WORKQUEUE_LOAD_IMAGE_DATA_REQUEST)
+        {
+            LoadImageRequest ireq = any_cast<LoadImageRequest>(req->getData());
+            LoadImageResponse ires;
+            try {
+                readPendingImageData(ireq.streamOffset, ires.images);
+            } catch (Exception& e) {
+                freeImageData(ires.images);
+                return OGRE_NEW WorkQueue::Response(req, false, Any(), e.getFullDescription());
+            }
+            return OGRE_NEW WorkQueue::Response(req, true, Any(ires));
+        }
+
         LoadLodRequest lreq = any_cast<LoadLodRequest>(req->getData());
         // read data from file into temporary height & delta buffer
         try {
@@ -138,6 +163,30 @@ namespace Ogre
     void TerrainLodManager::handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
     {
         const WorkQueue::Request* req = res->getRequest();
+        if (req->getType() == WORKQUEUE_LOAD_IMAGE_DATA_REQUEST)
+        {
+            LoadImageRequest ireq = any_cast<LoadImageRequest>(req->getData());
+            mLoadImageDataInProgress = false;
+
+            ImageDataList images;
+            if (res->succeeded())
+                images = any_cast<LoadImageResponse>(res->getData()).images;
+            else
+                LogManager::getSingleton().stream(LML_CRITICAL) << "Failed to load terrain images: " << res->getMessages();
+
+            // the terrain may have been prepared again in the meantime
+            if (ireq.streamOffset == mImageDataOffset)
+            {
+                // don't retry after a failure either
+                mImageDataOffset = 0;
+                for (ImageDataList::iterator i = images.begin(); i != images.end(); ++i)
+                    mTerrain->setImageData(*i);
+            }
+            else
+                freeImageData(images);
+            return;
+        }
+
         // No response data, just request
         LoadLodRequest lreq = any_cast<LoadLodRequest>(req->getData());
 
@@ -327,6 +376,7 @@ namespace Ogre
         if(!mDataStream) // No file to read from
             return;
 
+        OGRE_WQ_LOCK_MUTEX(mStreamMutex);
         uint16 numLodLevels = mTerrain->getNumLodLevels();
         mDataStream->seek(mStreamOffset);
         StreamSerialiser stream(mDataStream);
@@ -405,5 +455,100 @@ namespace Ogre
             OGRE_THREAD_SLEEP(50);
             Root::getSingleton().getWorkQueue()->processResponses();
         }
+        while (mLoadImageDataInProgress)
+        {
+            OGRE_THREAD_SLEEP(50);
+            Root::getSingleton().getWorkQueue()->processResponses();
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::saveImageData(StreamSerialiser& stream, const ImageData& image)
+    {
+        stream.writeChunkBegin(Terrain::TERRAINDERIVEDDATA_CHUNK_ID, Terrain::TERRAINDERIVEDDATA_CHUNK_VERSION);
+        stream.write(&image.name);
+        stream.write(&image.size);
+        stream.write(&image.dataSize);
+        stream.startDeflate();
+        stream.write(image.data, image.dataSize);
+        stream.stopDeflate();
+        stream.writeChunkEnd(Terrain::TERRAINDERIVEDDATA_CHUNK_ID);
+    }
+    //---------------------------------------------------------------------
+    size_t TerrainLodManager::readImageData(StreamSerialiser& stream, ImageData& image, bool readData)
+    {
+        const StreamSerialiser::Chunk* c = stream.readChunkBegin(Terrain::TERRAINDERIVEDDATA_CHUNK_ID,
+                Terrain::TERRAINDERIVEDDATA_CHUNK_VERSION);
+        if (!c)
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "Terrain image data is missing",
+                "TerrainLodManager::readImageData");
+
+        size_t offset = c->offset;
+        stream.read(&image.name);
+        stream.read(&image.size);
+        stream.read(&image.dataSize);
+        if (readData)
+        {
+            image.data = static_cast<uint8*>(OGRE_MALLOC(image.dataSize, MEMCATEGORY_GENERAL));
+            stream.startDeflate(c->length - stream.getOffsetFromChunkStart());
+            stream.read(image.data, image.dataSize);
+            stream.stopDeflate();
+        }
+        // skips the pixels if they were not read
+        stream.readChunkEnd(Terrain::TERRAINDERIVEDDATA_CHUNK_ID);
+        return offset;
+    }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::_setPendingImageData(size_t offset, uint16 count, StreamSerialiser::Endian endian)
+    {
+        mImageDataOffset = count ? offset : 0;
+        mImageDataCount = count;
+        mImageDataEndian = endian;
+    }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::loadImageData(bool synchronous)
+    {
+        if (!mImageDataOffset)
+            return;
+
+        if (!mLoadImageDataInProgress)
+        {
+            mLoadImageDataInProgress = true;
+            LoadImageRequest req(this, mImageDataOffset);
+            Root::getSingleton().getWorkQueue()->addRequest(
+                mWorkQueueChannel, WORKQUEUE_LOAD_IMAGE_DATA_REQUEST,
+                Any(req), 0, synchronous);
+        }
+        else if (synchronous)
+        {
+            while (mLoadImageDataInProgress)
+            {
+                OGRE_THREAD_SLEEP(50);
+                Root::getSingleton().getWorkQueue()->processResponses();
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::readPendingImageData(size_t offset, ImageDataList& images)
+    {
+        OGRE_WQ_LOCK_MUTEX(mStreamMutex);
+        if (!mDataStream)
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "The terrain file is no longer open",
+                "TerrainLodManager::readPendingImageData");
+
+        // the header of the file was read by prepare() already
+        mDataStream->seek(offset);
+        StreamSerialiser stream(mDataStream, mImageDataEndian, false);
+        for (uint16 i = 0; i < mImageDataCount; ++i)
+        {
+            images.push_back(ImageData());
+            readImageData(stream, images.back(), true);
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainLodManager::freeImageData(ImageDataList& images)
+    {
+        for (ImageDataList::iterator i = images.begin(); i != images.end(); ++i)
+            OGRE_FREE(i->data, MEMCATEGORY_GENERAL);
+        images.clear();
     }
 }
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreTerrainPagedWorldSection.h"
 #include "OgreTerrainGroup.h"
 #include "OgreGrid2DPageStrategy.h"
+#include "OgrePage.h"
 #include "OgrePagedWorld.h"
 #include "OgrePageManager.h"
 #include "OgreRoot.h"
@@ -58,11 +59,10 @@ namespace Ogre
     //---------------------------------------------------------------------
     TerrainPagedWorldSection::~TerrainPagedWorldSection()
     {
-        //remove the pending tasks, but keep the front one, as it may have been in running
-        if(!mPagesInLoading.empty())
-            mPagesInLoading.erase( ++mPagesInLoading.begin(), mPagesInLoading.end() );
+        //remove the pending tasks, but wait for the running one
+        mPagesInLoading.clear();
 
-        while(!mPagesInLoading.empty())
+        while(mHasRunningTasks)
         {
             OGRE_THREAD_SLEEP(50);
             Root::getSingleton().getWorkQueue()->processResponses();
@@ -230,26 +230,62 @@ namespace Ogre
         if (!mParent->getManager()->getPagingOperationsEnabled())
             return;
 
-        PageMap::iterator i = mPages.find(pageID);
-        if (i == mPages.end())
+        bool newPage = mPages.find(pageID) == mPages.end();
+        PagedWorldSection::loadPage(pageID, forceSynchronous);
+        if (newPage)
+            queuePage(pageID, forceSynchronous);
+    }
+    //---------------------------------------------------------------------
+    void TerrainPagedWorldSection::requestPage(PageID pageID, Real priority)
+    {
+        if (!mParent->getManager()->getPagingOperationsEnabled())
+            return;
+
+        // the priority of waiting pages is kept by the page itself
+        bool newPage = mPages.find(pageID) == mPages.end();
+        PagedWorldSection::requestPage(pageID, priority);
+        if (newPage)
+            queuePage(pageID, false);
+        else
         {
-            std::list<PageID>::iterator it = find( mPagesInLoading.begin(), mPagesInLoading.end(), pageID);
-            if(it==mPagesInLoading.end())
-            {
-                mPagesInLoading.push_back(pageID);
-                mHasRunningTasks = true;
-            }
-            
-            // no running tasks, start the new one
-            if(mPagesInLoading.size()==1)
+            // the terrain may be waiting to be prepared already
+            long x, y;
+            mTerrainGroup->unpackIndex(pageID, &x, &y);
+            mTerrainGroup->setTerrainLoadPriority(x, y, priority);
+        }
+    }
+    //---------------------------------------------------------------------
+    void TerrainPagedWorldSection::queuePage(PageID pageID, bool forceSynchronous)
+    {
+        if (find(mPagesInLoading.begin(), mPagesInLoading.end(), pageID) == mPagesInLoading.end())
+            mPagesInLoading.push_back(pageID);
+
+        // no running tasks, start the new one
+        if (!mHasRunningTasks)
+            loadNextPage(forceSynchronous);
+    }
+    //---------------------------------------------------------------------
+    void TerrainPagedWorldSection::loadNextPage(bool forceSynchronous)
+    {
+        std::list<PageID>::iterator next = mPagesInLoading.begin();
+        Real nextPriority = -std::numeric_limits<Real>::max();
+        for (std::list<PageID>::iterator it = mPagesInLoading.begin(); it != mPagesInLoading.end(); ++it)
+        {
+            Page* page = getPage(*it);
+            Real priority = page ? page->getLoadPriority() : 0;
+            if (priority > nextPriority)
             {
-                Root::getSingleton().getWorkQueue()->addRequest(
-                    mWorkQueueChannel, WORKQUEUE_LOAD_TERRAIN_PAGE_REQUEST, 
-                    Any(), 0, forceSynchronous);
+                next = it;
+                nextPriority = priority;
             }
         }
 
-        PagedWorldSection::loadPage(pageID, forceSynchronous);
+        PageID pageID = *next;
+        mPagesInLoading.erase(next);
+        mHasRunningTasks = true;
+        Root::getSingleton().getWorkQueue()->addRequest(
+            mWorkQueueChannel, WORKQUEUE_LOAD_TERRAIN_PAGE_REQUEST, 
+            Any(pageID), 0, forceSynchronous);
     }
     //---------------------------------------------------------------------
     void TerrainPagedWorldSection::unloadPage(PageID pageID, bool forceSynchronous)
@@ -267,7 +303,8 @@ namespace Ogre
         }
         else
         {
-            // trigger terrain unload
+            // trigger terrain unload, a page which is being defined right now
+            // is not loaded by handleResponse anymore
             long x, y;
             // pageID is the same as a packed index
             mTerrainGroup->unpackIndex(pageID, &x, &y);
@@ -277,13 +314,6 @@ namespace Ogre
     //---------------------------------------------------------------------
     WorkQueue::Response* TerrainPagedWorldSection::handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
     {
-        if(mPagesInLoading.empty())
-        {
-            mHasRunningTasks = false;
-            req->abortRequest();
-            return OGRE_NEW WorkQueue::Response(req, true, Any());
-        }
-
         unsigned long currentTime = Root::getSingletonPtr()->getTimer()->getMilliseconds();
         if(currentTime < mNextLoadingTime)
         {
@@ -291,7 +321,7 @@ namespace Ogre
             OGRE_THREAD_SLEEP(mNextLoadingTime - currentTime);
         }
 
-        PageID pageID = mPagesInLoading.front();
+        PageID pageID = any_cast<PageID>(req->getData());
 
         // call the TerrainDefiner from the background thread
         long x, y;
@@ -309,25 +339,25 @@ namespace Ogre
     //---------------------------------------------------------------------
     void TerrainPagedWorldSection::handleResponse(const WorkQueue::Response* res, const WorkQueue* srcQ)
     {
-        if(!mPagesInLoading.empty())
-        {
-            PageID pageID = mPagesInLoading.front();
+        PageID pageID = any_cast<PageID>(res->getRequest()->getData());
 
+        // the page may have been unloaded while its terrain was defined
+        PageMap::iterator i = mPages.find(pageID);
+        if (i != mPages.end())
+        {
             // trigger terrain load
             long x, y;
             // pageID is the same as a packed index
             mTerrainGroup->unpackIndex(pageID, &x, &y);
-            mTerrainGroup->loadTerrain(x, y, false);
-            mPagesInLoading.pop_front();
+            mTerrainGroup->loadTerrain(x, y, false, i->second->getLoadPriority());
+        }
 
-            unsigned long currentTime = Root::getSingletonPtr()->getTimer()->getMilliseconds();
-            mNextLoadingTime = currentTime + mLoadingIntervalMs;
+        unsigned long currentTime = Root::getSingletonPtr()->getTimer()->getMilliseconds();
+        mNextLoadingTime = currentTime + mLoadingIntervalMs;
 
-            // Continue loading other pages
-            Root::getSingleton().getWorkQueue()->addRequest(
-                    mWorkQueueChannel, WORKQUEUE_LOAD_TERRAIN_PAGE_REQUEST, 
-                    Any(), 0, false);
-        }
+        // Continue loading other pages, the most urgent first
+        if (!mPagesInLoading.empty())
+            loadNextPage(false);
         else
             mHasRunningTasks = false;
     }
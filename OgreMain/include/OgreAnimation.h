@@ -45,6 +45,7 @@ namespace Ogre {
     */
 
     class Animation;
+    class CompressedAnimationClip;
     
     /** An animation container interface, which allows generic access to sibling animations.
      @remarks
@@ -446,6 +447,23 @@ namespace Ogre {
             object.
         */
         Animation* clone(const String& newName) const OGRE_NODISCARD;
+
+        /** Replace the node tracks of this animation with a CompressedAnimationClip.
+        @remarks
+            The clip keeps far fewer keys in much less memory and is used by
+            apply(Skeleton*, ...) from now on. Node tracks can no longer be edited
+            afterwards, and applying the animation to plain nodes or merging it into
+            another skeleton requires the node tracks to be kept.
+        @param tolerance The largest error allowed per key component
+        @param destroyNodeTracks Whether the original node tracks are destroyed
+        */
+        void compressNodeTracks(Real tolerance = 1e-3, bool destroyNodeTracks = true);
+
+        /// The compressed version of the node tracks, if any
+        const CompressedAnimationClip* getCompressedClip(void) const { return mCompressedClip; }
+
+        /// Internal method to set the compressed node tracks, takes ownership of the clip
+        void _setCompressedClip(CompressedAnimationClip* clip);
         
         /** Internal method used to tell the animation that keyframe list has been
             changed, which may cause it to rebuild some internal data */
@@ -500,6 +518,12 @@ namespace Ogre {
         
         /// Internal method to adjust keyframes relative to a base keyframe (@see setUseBaseKeyFrame) */
         void _applyBaseKeyFrame();
+
+        /** Internal method to build the data apply otherwise builds on first use.
+        @remarks
+            Call this before applying the animation from several threads at once.
+        */
+        void _prepareForApply(void);
         
         void _notifyContainer(AnimationContainer* c);
         /** Retrieve the container of this animation. */
@@ -532,6 +556,8 @@ namespace Ogre {
         Real mBaseKeyFrameTime;
         String mBaseKeyFrameAnimationName;
         AnimationContainer* mContainer;
+        /// Compressed node tracks, used instead of mNodeTrackList when set
+        CompressedAnimationClip* mCompressedClip;
 
         void optimiseNodeTracks(bool discardIdentityTracks);
         void optimiseVertexTracks(void);
@@ -124,7 +124,15 @@ namespace Ogre {
         const VisibleObjectsBoundsInfo* mMainCamBoundsInfo;
         const Pass* mCurrentPass;
 
+        /// Versions of the data behind the GPV_GLOBAL, GPV_PER_OBJECT and GPV_LIGHTS autos
+        uint64 mGlobalVersion;
+        uint64 mObjectVersion;
+        uint64 mLightsVersion;
+
         Light mBlankLight;
+
+        /// Mark values of the given variability as changed
+        void notifyChanged(uint16 variability);
     public:
         AutoParamDataSource();
         /** Updates the current renderable */
@@ -263,6 +271,15 @@ namespace Ogre {
         int getPassNumber(void) const;
         void setPassNumber(const int passNumber);
         void incPassNumber(void);
+        /** Get a stamp identifying the state of all values of the given variability.
+        @remarks
+            The stamp changes whenever one of the setters changes data the values may be
+            derived from, and is never repeated across sources, so GpuProgramParameters
+            can skip rewriting autos it already wrote for the same stamp. Returns 0 for
+            values that can not be tracked, which must always be updated.
+        @param variability Combination of GpuParamVariability flags
+        */
+        uint64 getVersion(uint16 variability) const;
         void updateLightCustomGpuParameter(const GpuProgramParameters::AutoConstantEntry& constantEntry, GpuProgramParameters *params) const;
     };
     /** @} */
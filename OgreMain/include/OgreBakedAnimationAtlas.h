@@ -0,0 +1,164 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __BakedAnimationAtlas_H__
+#define __BakedAnimationAtlas_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreSerializer.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Bone matrices of skeletal animations, sampled at a fixed rate.
+    @remarks
+        Every frame of every baked clip holds the 3x4 transform of each bone, in bone
+        handle order, as Skeleton::_getBoneMatrices would compute it. The frames of all
+        clips are numbered consecutively, so a single index identifies a pose.
+    @par
+        InstanceManager::setBakedAnimations uploads the frames to a vertex texture
+        shared by all batches, instances then only select the frame to render.
+        Baking can also be done offline and saved with BakedAnimationSerializer
+        next to the .skeleton, see getDefaultFileName.
+    */
+    class _OgreExport BakedAnimationAtlas : public AnimationAlloc
+    {
+    public:
+        /// A baked animation
+        struct Clip
+        {
+            String name;
+            /// The length of the source animation
+            Real length;
+            /// Index of the first frame in the atlas
+            size_t firstFrame;
+            size_t numFrames;
+        };
+        typedef std::vector<Clip> ClipList;
+
+        /// The most frames an atlas can hold, instances select them with a 16 bit lookup number
+        static const size_t MAX_FRAMES;
+
+        BakedAnimationAtlas();
+
+        /** Sample animations of a skeleton, replacing the current contents.
+        @remarks
+            Each animation is sampled from time 0 at the given rate, the last frame is
+            the last sample before the end of the animation.
+        @param skeleton The skeleton, it is loaded if needed but its state is left untouched
+        @param animations The names of the animations to bake
+        @param framesPerSecond The sampling rate
+        @throws Exception(ERR_INVALIDPARAMS) if the animations need more than MAX_FRAMES frames
+        */
+        void bake(const SkeletonPtr& skeleton, const StringVector& animations, Real framesPerSecond);
+
+        /// Whether all the given animations were baked at the given rate
+        bool hasClips(const StringVector& animations, Real framesPerSecond) const;
+
+        /// The index of a clip, raises an exception if it was not baked
+        size_t getClipIndex(const String& name) const;
+        const Clip& getClip(size_t clipIndex) const { return mClips.at(clipIndex); }
+        size_t getNumClips(void) const { return mClips.size(); }
+
+        /** The atlas frame of a frame of a clip.
+        @param clipIndex The clip
+        @param frame The frame within the clip, wrapped to the clip length
+        */
+        size_t getFrameIndex(size_t clipIndex, size_t frame) const;
+
+        /** The atlas frame closest to a time position of a clip.
+        @param clipIndex The clip
+        @param timePos The time position
+        @param loop Whether times past the end wrap around like a looping AnimationState
+        */
+        size_t getFrameIndexAtTime(size_t clipIndex, Real timePos, bool loop = true) const;
+
+        /// The number of frames of all clips
+        size_t getNumFrames(void) const { return mNumBones ? mFrames.size() / (mNumBones * 12) : 0; }
+        unsigned short getNumBones(void) const { return mNumBones; }
+        Real getFramesPerSecond(void) const { return mFramesPerSecond; }
+        /// The name of the skeleton the clips were baked from
+        const String& getSkeletonName(void) const { return mSkeletonName; }
+
+        /// The 3x4 row major bone matrices of a frame, 12 floats per bone
+        const float* getFrameData(size_t frameIndex) const
+        { return &mFrames[frameIndex * mNumBones * 12]; }
+
+        /// The file the atlas of a skeleton is looked up in, e.g. robot.bakedanim for robot.skeleton
+        static String getDefaultFileName(const String& skeletonName);
+
+    private:
+        friend class BakedAnimationSerializer;
+
+        String mSkeletonName;
+        Real mFramesPerSecond;
+        unsigned short mNumBones;
+        ClipList mClips;
+        std::vector<float> mFrames;
+    };
+
+    /** Reads and writes BakedAnimationAtlas files.
+    @remarks
+        The file holds the skeleton name, bone count and rate, the clip table and
+        then the frames as floats.
+    */
+    class _OgreExport BakedAnimationSerializer : public Serializer
+    {
+    public:
+        BakedAnimationSerializer();
+
+        /** Write an atlas to a file.
+        @param atlas The atlas
+        @param filename The file to create
+        @param endianMode The endian mode to write in
+        */
+        void exportAtlas(const BakedAnimationAtlas* atlas, const String& filename,
+                         Endian endianMode = ENDIAN_NATIVE);
+
+        /// @copydoc exportAtlas
+        void exportAtlas(const BakedAnimationAtlas* atlas, DataStreamPtr stream,
+                         Endian endianMode = ENDIAN_NATIVE);
+
+        /** Read an atlas, replacing its contents.
+        @param stream The stream to read from
+        @param atlas The atlas to fill
+        */
+        void importAtlas(DataStreamPtr& stream, BakedAnimationAtlas* atlas);
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
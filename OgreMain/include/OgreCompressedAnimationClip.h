@@ -0,0 +1,142 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __CompressedAnimationClip_H__
+#define __CompressedAnimationClip_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAnimationState.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Compact, read only version of the node tracks of a skeletal Animation.
+    @remarks
+        Each channel (translation, rotation and scale) of each track is fitted with as
+        few linearly interpolated keys as the tolerance allows. Key times and values are
+        quantised to 16 bits, rotations are stored as their smallest three components.
+        The keys of all tracks live in a few shared arrays, so sampling a skeleton walks
+        memory linearly instead of visiting one heap allocated KeyFrame per key and track.
+    @par
+        Clips are created by Animation::compressNodeTracks, Skeleton::compressAllAnimations
+        or when loading a .skeleton file that contains them.
+    */
+    class _OgreExport CompressedAnimationClip : public AnimationAlloc
+    {
+    public:
+        /// The channels of a track
+        enum Channel
+        {
+            CH_TRANSLATE,
+            CH_ROTATE,
+            CH_SCALE,
+            CH_COUNT
+        };
+
+        CompressedAnimationClip();
+
+        /** Fit and quantise the node tracks of an animation.
+        @remarks
+            The tracks are sampled with the interpolation modes of the animation, so
+            spline interpolated animations are approximated by linear segments.
+            Channels that stay at identity take no keys at all.
+        @param anim The animation to convert, its base keyframe must have been applied
+        @param tolerance The largest error allowed per component, in units for
+            translation and scale and in quaternion components for rotation
+        */
+        void build(const Animation* anim, Real tolerance);
+
+        /** Sample all tracks at once.
+        @param timePos The time position, wrapped like Animation::apply does
+        @param translates, rotations, scales Output arrays with getNumTracks() entries
+        */
+        void sample(Real timePos, Vector3* translates, Quaternion* rotations, Vector3* scales) const;
+
+        /** Apply the clip to a skeleton, same as Animation::apply would with the node tracks.
+        @param skeleton The skeleton to apply to
+        @param timePos The time position
+        @param weight The influence of the animation
+        @param blendMask Optional per bone weights, indexed by bone handle
+        @param scale Scale to apply to translation and scaling
+        */
+        void apply(Skeleton* skeleton, Real timePos, Real weight,
+                   const AnimationState::BoneBlendMask* blendMask, Real scale) const;
+
+        /// The length of the source animation
+        Real getLength(void) const { return mLength; }
+        /** Change the length the key times are relative to.
+        @remarks
+            The keys stay at their time positions, like keyframes do when the length
+            of an animation changes. Keys past the new length are moved to its end.
+        */
+        void setLength(Real length);
+        /// The number of tracks
+        size_t getNumTracks(void) const { return mHandles.size(); }
+        /// The bone handle a track applies to
+        unsigned short getTrackHandle(size_t track) const { return mHandles[track]; }
+        /// The number of keys kept for a channel of a track
+        size_t getNumKeys(size_t track, Channel channel) const;
+        /// The memory used by the keys and track data
+        size_t getMemoryUsage(void) const;
+
+    private:
+        friend class SkeletonSerializer;
+
+        Real mLength;
+        /// Whether rotations are interpolated with Slerp instead of nlerp
+        bool mSphericalRotation;
+        /// Bone handle of each track
+        std::vector<unsigned short> mHandles;
+        /// First key of each channel, at track * CH_COUNT + channel, followed by the key count
+        std::vector<uint32> mKeyStart;
+        /// Quantisation range of each channel, 3 offsets followed by 3 steps
+        std::vector<float> mRanges;
+        /// Key times of all channels, quantised to the animation length
+        std::vector<uint16> mKeyTimes;
+        /// 3 quantised components per key
+        std::vector<uint16> mKeyValues;
+
+        /// Convert a time position to the quantised time line
+        Real toKeyTime(Real timePos) const;
+        /// Find the keys around a time and the position between them, false if there are none
+        bool findKeys(size_t channel, Real keyTime, uint32& key1, uint32& key2, Real& t) const;
+        void sampleTrack(size_t track, Real keyTime, Vector3& translate, Quaternion& rotate,
+                         Vector3& scale) const;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
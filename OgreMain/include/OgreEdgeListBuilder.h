@@ -132,6 +132,9 @@ namespace Ogre {
         EdgeGroupList edgeGroups;
         /** Flag indicate the mesh is manifold. */
         bool isClosed;
+        /** Changes whenever the face normals are updated, so silhouettes calculated
+            from them can be cached. Unique across all edge lists. */
+        uint32 faceNormalsVersion;
 
 
         /** Calculate the light facing state of the triangles in this edge list
@@ -230,18 +233,6 @@ namespace Ogre {
                 return a.indexSet < b.indexSet;
             }
         };
-        /** Comparator for unique vertex list */
-        struct vectorLess {
-            bool operator()(const Vector3& a, const Vector3& b) const
-            {
-                if (a.x < b.x) return true;
-                if (a.x > b.x) return false;
-                if (a.y < b.y) return true;
-                if (a.y > b.y) return false;
-                return a.z < b.z;
-            }
-        };
-
         typedef std::vector<const VertexData*> VertexDataList;
         typedef std::vector<Geometry> GeometryList;
         typedef std::vector<CommonVertex> CommonVertexList;
@@ -250,23 +241,64 @@ namespace Ogre {
         VertexDataList mVertexDataList;
         CommonVertexList mVertices;
         EdgeData* mEdgeData;
-        /// Map for identifying common vertices
-        typedef std::map<Vector3, size_t, vectorLess> CommonVertexMap;
-        CommonVertexMap mCommonVertexMap;
-        /** Edge map, used to connect edges. Note we allow many triangles on an edge,
-        after connected an existing edge, we will remove it and never used again.
+        /** Hash table identifying common vertices by position, using open addressing
+            with linear probing. Slots hold an index into mVertices, or ~0 when empty.
         */
-        typedef std::multimap< std::pair<size_t, size_t>, std::pair<size_t, size_t> > EdgeMap;
-        EdgeMap mEdgeMap;
+        std::vector<size_t> mCommonVertexTable;
+
+        /** Edges waiting to be connected to a second triangle, with the same shared
+            vertices. Note we allow many triangles on an edge, the edges are connected
+            in the order they were created and never used again afterwards.
+        */
+        struct PendingEdgeList {
+            size_t sharedVertIndex[2];  /// The key, sharedVertIndex[0] is ~0 for unused slots
+            size_t first;               /// First pending edge
+            size_t last;                /// Last pending edge
+        };
+        /** An edge in a PendingEdgeList */
+        struct PendingEdge {
+            size_t vertexSet;           /// The edge group of the edge
+            size_t edgeIndex;           /// The edge in its edge group
+            size_t next;                /// Next pending edge with the same key, ~0 for none
+        };
+        /** Hash table of the pending edges by shared vertices, using open addressing
+            with linear probing. Keys are removed once all their edges are connected,
+            so the table only holds the open border of the mesh built so far.
+        */
+        std::vector<PendingEdgeList> mEdgeTable;
+        std::vector<PendingEdge> mPendingEdges;
+        size_t mNumEdgeKeys;
+        size_t mNumPendingEdges;
+
+        /** A triangle read from the index and vertex buffers, before welding */
+        struct RawTriangle {
+            uint32 index[3];
+            Vector3 position[3];
+            uint32 hash[3];
+            Vector4 faceNormal;
+        };
+        typedef std::vector<RawTriangle> RawTriangleList;
+        /// Scratch list, reused for all geometries
+        RawTriangleList mRawTriangles;
 
         void buildTrianglesEdges(const Geometry &geometry);
 
+        /// Reads the triangles of a geometry into mRawTriangles, in parallel
+        void readTriangles(const Geometry &geometry, size_t numTriangles);
+
         /// Finds an existing common vertex, or inserts a new one
-        size_t findOrCreateCommonVertex(const Vector3& vec, size_t vertexSet, 
+        size_t findOrCreateCommonVertex(const Vector3& vec, uint32 hash, size_t vertexSet,
             size_t indexSet, size_t originalIndex);
         /// Connect existing edge or create a new edge - utility method during building
         void connectOrCreateEdge(size_t vertexSet, size_t triangleIndex, size_t vertIndex0, size_t vertIndex1, 
             size_t sharedVertIndex0, size_t sharedVertIndex1);
+        /// Finds the slot of an edge key in mEdgeTable, or the empty slot to insert it in
+        size_t findEdgeSlot(size_t sharedVertIndex0, size_t sharedVertIndex1) const;
+        /// Empties a slot of mEdgeTable, moving back the entries probed past it
+        void eraseEdgeSlot(size_t slot);
+        /// Doubles the size of a hash table once it is half full
+        void growCommonVertexTable(void);
+        void growEdgeTable(void);
     };
     /** @} */
     /** @} */
@@ -0,0 +1,176 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __FrameAllocator_H__
+#define __FrameAllocator_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreSingleton.h"
+
+#include <thread>
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Linear arena for memory that only lives during the current frame.
+    @remarks
+        Allocating is a pointer increment and freeing does nothing, except for the
+        most recent allocation which is given back right away. All memory is reclaimed
+        at once by reset(), which Root calls when the frame has ended. The chunks used
+        during a frame are merged into a single one at that point, so once the arena
+        has seen the largest frame it no longer touches the heap.
+    @par
+        The arena is meant for temporary containers of the render loop, see
+        FrameAllocator. It is not thread safe, only the thread that renders the
+        frames may use it.
+    */
+    class _OgreExport FrameMemory : public Singleton<FrameMemory>, public GeneralAllocatedObject
+    {
+    public:
+        /** Constructor
+        @param initialSize The size of the first chunk in bytes
+        */
+        explicit FrameMemory(size_t initialSize = 64 * 1024);
+        ~FrameMemory();
+
+        /** Allocate memory that stays valid until the next reset.
+        @param size The size in bytes
+        @param alignment The alignment of the result, must be a power of two
+        */
+        void* allocate(size_t size, size_t alignment = OGRE_SIMD_ALIGNMENT);
+
+        /** Release memory allocated by this arena.
+        @remarks
+            Only the last allocation is reclaimed, everything else waits for reset().
+        */
+        void deallocate(void* p, size_t size);
+
+        /** Reclaim all allocations at once.
+        @note
+            No memory allocated before may be used afterwards.
+        */
+        void reset(void);
+
+        /// Whether the calling thread may use the arena
+        bool isOwnerThread(void) const { return std::this_thread::get_id() == mOwnerThread; }
+        /// The bytes handed out since the last reset
+        size_t getUsedSize(void) const { return mUsed + (mTop - mChunkStart); }
+        /// The largest getUsedSize() seen at a reset
+        size_t getPeakSize(void) const { return mPeak; }
+        /// The bytes reserved from the heap
+        size_t getCapacity(void) const { return mCapacity; }
+
+        /// @copydoc Singleton::getSingleton()
+        static FrameMemory& getSingleton(void);
+        /// @copydoc Singleton::getSingleton()
+        static FrameMemory* getSingletonPtr(void);
+    private:
+        struct Chunk
+        {
+            Chunk* prev;
+            size_t size;
+        };
+
+        /// The chunk allocations come from, older ones are linked through Chunk::prev
+        Chunk* mChunk;
+        uchar* mChunkStart;
+        uchar* mChunkEnd;
+        uchar* mTop;
+        /// Start of the last allocation, so it can be given back
+        uchar* mLast;
+        /// Bytes used in the older chunks
+        size_t mUsed;
+        size_t mPeak;
+        size_t mCapacity;
+        std::thread::id mOwnerThread;
+
+        void addChunk(size_t minSize);
+        void freeChunks(void);
+    };
+
+    /** STL compatible wrapper for @ref FrameMemory
+    @remarks
+        Containers using it must not outlive the frame they were created in. Containers
+        created without a FrameMemory or outside of the render thread use the heap.
+    */
+    template<typename T>
+    struct FrameAllocator
+    {
+        typedef T value_type;
+
+        FrameMemory* memory;
+
+        FrameAllocator()
+        {
+            memory = FrameMemory::getSingletonPtr();
+            if (memory && !memory->isOwnerThread())
+                memory = NULL;
+        }
+
+        template <class U>
+        FrameAllocator(const FrameAllocator<U>& other) : memory(other.memory) {}
+
+        template<class Other>
+        struct rebind { using other = FrameAllocator<Other>; };
+
+        T* allocate(size_t n) {
+            if (memory)
+                return static_cast<T*>(memory->allocate(n * sizeof(T), alignof(T)));
+            return static_cast<T*>(OGRE_MALLOC(n * sizeof(T), MEMCATEGORY_GENERAL));
+        }
+
+        void deallocate(T* p, size_t n) {
+            if (memory)
+                memory->deallocate(p, n * sizeof(T));
+            else
+                OGRE_FREE(p, MEMCATEGORY_GENERAL);
+        }
+
+        template <class U>
+        bool operator==(const FrameAllocator<U>& other) const { return memory == other.memory; }
+        template <class U>
+        bool operator!=(const FrameAllocator<U>& other) const { return memory != other.memory; }
+    };
+
+    /// A vector for the current frame only, see FrameAllocator
+    template <typename T>
+    using frame_vector = std::vector<T, FrameAllocator<T>>;
+    /** @} */
+    /** @} */
+
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
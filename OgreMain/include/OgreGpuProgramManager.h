@@ -61,10 +61,38 @@ namespace Ogre {
     protected:
 
         SharedParametersMap mSharedParametersMap;
-        std::map<uint32, Microcode> mMicrocodeCache;
+        mutable std::map<uint32, Microcode> mMicrocodeCache;
         bool mSaveMicrocodesToCache;
         bool mCacheDirty;           // When this is true the cache is 'dirty' and should be resaved to disk.
-            
+
+        /// Location of a microcode in the managed cache file
+        struct MicrocodeFileEntry
+        {
+            uint32 offset;   ///< offset of the blob in the data chunk, only valid until it is resident
+            uint32 size;     ///< size of the blob in bytes
+            uint32 lastUsed; ///< cache generation in which the entry was last hit or added
+        };
+        typedef std::map<uint32, MicrocodeFileEntry> MicrocodeFileIndex;
+
+        String mMicrocodeCachePath;
+        /// identity of render system, device and driver the managed cache was created with
+        String mMicrocodeCacheIdentity;
+        /// index of the managed cache file. Blobs are read into mMicrocodeCache on first use
+        mutable MicrocodeFileIndex mMicrocodeFileIndex;
+        mutable DataStreamPtr mMicrocodeCacheFile;
+        size_t mMicrocodeDataStart;
+        uint32 mMicrocodeCacheGeneration;
+        uint32 mMicrocodeCacheMaxAge;
+        mutable size_t mMicrocodeCacheHits;
+        mutable size_t mMicrocodeCacheMisses;
+
+        /// reads the header and index of a managed cache file, leaving the stream at the data chunk
+        bool readMicrocodeCacheIndex(const DataStreamPtr& stream, MicrocodeFileIndex& index,
+                                     size_t& dataStart, uint32& generation) const;
+        /// reads a single blob of a managed cache file
+        static Microcode readMicrocodeBlob(const DataStreamPtr& stream, size_t dataStart,
+                                           const MicrocodeFileEntry& entry);
+
         static String addRenderSystemToName( const String &  name );
 
         /// Specialised create method with specific parameters
@@ -268,6 +296,53 @@ namespace Ogre {
         @param stream The source stream
         */
         void loadMicrocodeCache( DataStreamPtr stream );
+
+        /** Enables a persistent microcode cache that is managed by the GpuProgramManager.
+        @remarks
+            In contrast to saveMicrocodeCache / loadMicrocodeCache the application does not
+            have to deal with streams or invalidation. Entries are keyed by
+            GpuProgram::_getHash, which covers the source, the preprocessor defines and the
+            syntax code. The file is tagged with the active render system, device and driver
+            version and is discarded if any of these changed.
+        @par
+            Only the index is read here; the microcode itself is read from disk the first time
+            a program asks for it. The cache is written back by flushMicrocodeCache or when
+            the manager is destroyed. Entries written meanwhile by other processes are merged
+            and the file is replaced atomically, so several processes can share one cache file.
+        @note
+            Must be called after the render system was initialised.
+        @param path file system path of the cache file. An empty string disables the managed cache.
+        */
+        void setMicrocodeCachePath(const String& path);
+
+        /** Enables the managed microcode cache, tagged with the given identity instead of
+            the active render system.
+        @remarks
+            Unlike the other overload this does not check whether the render system can
+            retrieve compiled shaders, nor enable setSaveMicrocodesToCache.
+        @param path file system path of the cache file. An empty string disables the managed cache.
+        @param identity the file is discarded if it was written with a different one
+        */
+        void setMicrocodeCachePath(const String& path, const String& identity);
+        /// Get the path of the managed microcode cache
+        const String& getMicrocodeCachePath() const { return mMicrocodeCachePath; }
+
+        /** Writes the managed microcode cache back to disk, if it changed.
+        @see setMicrocodeCachePath
+        */
+        void flushMicrocodeCache();
+
+        /** Sets after how many rewrites of the managed cache without being used an entry is evicted.
+        @param age number of cache generations. 0 disables eviction. Default: 16
+        */
+        void setMicrocodeCacheMaxAge(uint32 age) { mMicrocodeCacheMaxAge = age; }
+        /// @copydoc setMicrocodeCacheMaxAge
+        uint32 getMicrocodeCacheMaxAge() const { return mMicrocodeCacheMaxAge; }
+
+        /// Number of programs that were served from the microcode cache
+        size_t getMicrocodeCacheHits() const { return mMicrocodeCacheHits; }
+        /// Number of programs that had to be compiled as they were not found in the microcode cache
+        size_t getMicrocodeCacheMisses() const { return mMicrocodeCacheMisses; }
         
 
 
@@ -1366,6 +1366,27 @@ namespace Ogre {
         /// physical index for active pass iteration parameter real constant entry;
         size_t mActivePassIterationIndex;
 
+        /// Range of auto constants sharing one variability, updated together
+        struct AutoConstantGroup
+        {
+            uint16 variability;
+            /// Range of the group in mAutoConstantOrder
+            size_t begin;
+            size_t end;
+            /// AutoParamDataSource::getVersion the group was last written for
+            uint64 version;
+        };
+        typedef std::vector<AutoConstantGroup> AutoConstantGroupList;
+        /// Update program for _updateAutoParams
+        AutoConstantGroupList mAutoConstantGroups;
+        /// Indices into mAutoConstants, ordered by group
+        std::vector<size_t> mAutoConstantOrder;
+        /// Whether mAutoConstants changed since the groups were built
+        bool mAutoConstantGroupsDirty;
+
+        /// Group the auto constants by variability
+        void buildAutoConstantGroups(void);
+
         /// Return the variability for an auto constant
         static uint16 deriveVariability(AutoConstantType act);
 
@@ -1853,6 +1874,10 @@ namespace Ogre {
         const AutoConstantEntry* _findRawAutoConstantEntryBool(size_t physicalIndex) const;
 
         /** Update automatic parameters.
+            @remarks
+                Autos are updated per variability group and only when the source data
+                they derive from changed since they were last written, see
+                AutoParamDataSource::getVersion.
             @param source The source of the parameters
             @param variabilityMask A mask of GpuParamVariability which identifies which autos will need updating
         */
@@ -161,6 +161,19 @@ namespace Ogre
 
         void updateVisibility(void);
 
+        /// Number of instances per range when per instance work is split over the ThreadPool
+        static const size_t PARALLEL_RANGE_SIZE = 1024;
+
+        /** Updates the animation of all instances, large batches are updated in parallel.
+            Sets mDirtyAnimation if any instance changed.
+        */
+        void updateAnimations(void);
+
+        /** Updates the lazily computed camera data used by findVisible and
+            makeMatrixCameraRelative3x4, so they can be called from several threads.
+        */
+        void prepareParallelUpdate( Camera *camera );
+
         /** @see _defragmentBatch */
         void defragmentBatchNoCull( InstancedEntityVec &usedEntities, CustomParamsVec &usedParams );
 
@@ -179,6 +192,8 @@ namespace Ogre
 
         MeshPtr& _getMeshRef() { return mMeshReference; }
 
+        InstanceManager* _getCreator() const { return mCreator; }
+
         /** Raises an exception if trying to change it after being built
         */
         void _setInstancesPerBatch( size_t instancesPerBatch );
@@ -62,6 +62,10 @@ namespace Ogre
     {
         bool    mKeepStatic;
 
+        /// Visibility of each instance and first visible instance of each range, see updateVertexBuffer
+        std::vector<uint8>  mInstanceVisible;
+        std::vector<size_t> mRangeOffsets;
+
         void setupVertices( const SubMesh* baseSubMesh );
         void setupIndices( const SubMesh* baseSubMesh );
 
@@ -102,6 +102,9 @@ namespace Ogre
         bool mForceOneWeight;
         bool mUseOneWeight;
 
+        /// Frames sampled at load time, shared by the batches of the manager
+        const BakedAnimationAtlas* mBakedAnimations;
+
         /** Clones the base material so it can have it's own vertex texture, and also
             clones it's shadow caster materials, if it has any
         */
@@ -125,6 +128,9 @@ namespace Ogre
         /** Creates the vertex texture */
         void createVertexTexture( const SubMesh* baseSubMesh );
 
+        /** Writes all frames of the baked animations to the vertex texture */
+        void fillBakedAnimationTexture( const SubMesh* baseSubMesh );
+
         /** Creates 2 TEXCOORD semantics that will be used to sample the vertex texture */
         virtual void createVertexSemantics( VertexData *thisVertexData, VertexData *baseVertexData,
                                     const HWBoneIdxVec &hwBoneIdx, const HWBoneWgtVec &hwBoneWgt) = 0;
@@ -194,6 +200,20 @@ namespace Ogre
 
         bool useOneWeight() const { return mUseOneWeight; }
 
+        /** Renders the instances with animation frames baked at load time.
+        @remarks
+            The frames are uploaded once to a vertex texture shared by all batches of
+            the creator, instances pick their pose with InstancedEntity::setBakedAnimationFrame
+            and are not skeletally animated on the CPU. Implies bone matrix lookup.
+            This value needs to be set before adding any instanced entities.
+            Only supported by InstanceBatchHW_VTF.
+        @param atlas The frames, must outlive the batch
+        */
+        void setBakedAnimationAtlas( const BakedAnimationAtlas* atlas );
+
+        /** The baked frames, null if the instances are animated on the CPU */
+        const BakedAnimationAtlas* getBakedAnimationAtlas() const { return mBakedAnimations; }
+
         /** @see InstanceBatch::useBoneWorldMatrices()  */
         virtual bool useBoneWorldMatrices() const { return !mUseBoneMatrixLookup; }
 
@@ -120,6 +120,8 @@ namespace Ogre
         size_t                  mMaxLookupTableInstances;
         unsigned char           mNumCustomParams;       //Number of custom params per instance.
 
+        BakedAnimationAtlas*    mBakedAnimations;       ///< @see setBakedAnimations
+
         /** Finds a batch with at least one free instanced entity we can use.
             If none found, creates one.
         */
@@ -203,6 +205,28 @@ namespace Ogre
         unsigned char getNumCustomParams() const
         { return mNumCustomParams; }
 
+        /** Renders the instances with skeletal animations baked at load time.
+        @remarks
+            The given animations of the mesh's skeleton are sampled once and uploaded to a
+            vertex texture shared by all batches, so there is no animation or matrix upload
+            cost per frame. Instances select their pose with
+            InstancedEntity::setBakedAnimationFrame and have no AnimationStates.
+        @par
+            The frames are read from the file BakedAnimationAtlas::getDefaultFileName names in
+            the mesh's resource group when it holds all the animations at this rate, e.g. when
+            baked offline and saved with BakedAnimationSerializer. Otherwise they are baked now.
+        @par
+            Only supported by HWInstancingVTF. Raises an exception if called after the first
+            batch has been created.
+        @param animations Names of the skeleton animations to bake
+        @param framesPerSecond The sampling rate
+        */
+        void setBakedAnimations( const StringVector &animations, Real framesPerSecond = 30 );
+
+        /** The baked frames, null unless setBakedAnimations was called */
+        const BakedAnimationAtlas* getBakedAnimationAtlas() const
+        { return mBakedAnimations; }
+
         /** @return Instancing technique this manager was created for. Can't be changed after creation */
         InstancingTechnique getInstancingTechnique() const
         { return mInstancingTechnique; }
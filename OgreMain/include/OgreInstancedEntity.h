@@ -228,6 +228,13 @@ namespace Ogre
         /** Sets the transformation look up number */
         void setTransformLookupNumber(uint16 num) { mTransformLookupNumber = num;}
 
+        /** Selects the pose of an instance whose manager renders baked animations.
+        @see InstanceManager::setBakedAnimations
+        @param clipIndex The clip, @see BakedAnimationAtlas::getClipIndex
+        @param frame The frame within the clip, wrapped to the clip length
+        */
+        void setBakedAnimationFrame(size_t clipIndex, size_t frame);
+
         /** Retrieve the position */
         const Vector3& getPosition() const { return mPosition; }
         /** Set the position or the offset from the parent node if a parent node exists */ 
@@ -107,6 +107,15 @@ namespace Ogre {
 
         typedef std::vector<LogListener*> mtLogListener;
         mtLogListener mListeners;
+
+        /// Messages of at least this level are flushed before logMessage returns
+        LogMessageLevel mFlushLevel;
+        /// Queues and background thread of the asynchronous mode, null when synchronous
+        struct AsyncWriter;
+        AsyncWriter* mAsyncWriter;
+
+        /// Write a message to the debugger and the log file, without flushing
+        void writeMessage(const String& message, LogMessageLevel lml, bool maskDebug, time_t time);
     public:
 
         class Stream;
@@ -159,6 +168,33 @@ namespace Ogre {
         /** Gets the level of the log detail.
         */
         LoggingLevel getLogDetail() const { return mLogLevel; }
+
+        /** Enable or disable asynchronous writing.
+        @remarks
+            In asynchronous mode logMessage calls the listeners as usual, then queues the
+            message in a lock free ring buffer of the calling thread and returns. A
+            background thread writes the queued messages of all threads to the debugger
+            and the file in batches, ordered as they were logged, and only flushes the
+            file for messages at or above the flush level.
+        @par
+            Must not be called while other threads are logging. Has no effect without
+            thread support.
+        */
+        void setAsynchronous(bool async);
+        /// Get whether messages are written by a background thread
+        bool isAsynchronous() const { return mAsyncWriter != 0; }
+        /** Sets the level from which messages are flushed to the file before logMessage
+            returns, so they survive a crash. Only used in asynchronous mode, otherwise
+            every message is flushed. Defaults to LML_CRITICAL.
+        */
+        void setFlushLevel(LogMessageLevel lml) { mFlushLevel = lml; }
+        /// Gets the level from which messages are flushed before logMessage returns
+        LogMessageLevel getFlushLevel() const { return mFlushLevel; }
+        /** Waits until all messages queued so far are written and flushed.
+        @remarks
+            Nothing to do in synchronous mode, where every message is flushed.
+        */
+        void flush();
         /**
         @remarks
             Register a listener to this log
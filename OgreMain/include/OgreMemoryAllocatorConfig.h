@@ -77,11 +77,38 @@ namespace Ogre
 
 }
 
+#include "OgreMemoryTracker.h"
+
 namespace Ogre
 {
     class AllocPolicy {};
+#if OGRE_MEMORY_TRACKER
+    /** Base class of objects created with OGRE_NEW, counting their memory against a category
+        in the MemoryTracker
+    */
+    template<int Category = MEMCATEGORY_GENERAL> class AllocatedObject
+    {
+    public:
+        static void* operator new(size_t sz)
+        {
+            return MemoryTracker::allocate(sz, static_cast<MemoryCategory>(Category));
+        }
+        static void* operator new[](size_t sz)
+        {
+            return MemoryTracker::allocate(sz, static_cast<MemoryCategory>(Category));
+        }
+        /// placement operator new
+        static void* operator new(size_t sz, void* ptr) { return ptr; }
+
+        static void operator delete(void* ptr) { MemoryTracker::deallocate(ptr); }
+        static void operator delete[](void* ptr) { MemoryTracker::deallocate(ptr); }
+        /// only called if there is an exception in the corresponding placement new
+        static void operator delete(void* ptr, void*) {}
+    };
+#else
     // this is a template, mainly so swig does not pick it up
     template<int Category = MEMCATEGORY_GENERAL> class AllocatedObject {};
+#endif
 
     // Useful shortcuts
     typedef AllocPolicy GeneralAllocPolicy;
@@ -94,6 +121,16 @@ namespace Ogre
     typedef AllocPolicy RenderSysAllocPolicy;
 
     // Now define all the base classes for each allocation
+#if OGRE_MEMORY_TRACKER
+    typedef AllocatedObject<MEMCATEGORY_GENERAL> GeneralAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_GEOMETRY> GeometryAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_ANIMATION> AnimationAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_SCENE_CONTROL> SceneCtlAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_SCENE_OBJECTS> SceneObjAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_RESOURCE> ResourceAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_SCRIPTING> ScriptingAllocatedObject;
+    typedef AllocatedObject<MEMCATEGORY_RENDERSYS> RenderSysAllocatedObject;
+#else
     typedef AllocatedObject<> GeneralAllocatedObject;
     typedef AllocatedObject<> GeometryAllocatedObject;
     typedef AllocatedObject<> AnimationAllocatedObject;
@@ -102,6 +139,7 @@ namespace Ogre
     typedef AllocatedObject<> ResourceAllocatedObject;
     typedef AllocatedObject<> ScriptingAllocatedObject;
     typedef AllocatedObject<> RenderSysAllocatedObject;
+#endif
 
 
     // Per-class allocators defined here
@@ -175,6 +213,32 @@ namespace Ogre
 *  @{
 */
 
+#if OGRE_MEMORY_TRACKER
+
+/// Allocate a block of raw memory, and indicate the category of usage
+#   define OGRE_MALLOC(bytes, category) ::Ogre::MemoryTracker::allocate(bytes, category)
+/// Allocate a block of memory for a primitive type, and indicate the category of usage
+#   define OGRE_ALLOC_T(T, count, category) static_cast<T*>(::Ogre::MemoryTracker::allocate(sizeof(T)*(count), category))
+/// Free the memory allocated with OGRE_MALLOC or OGRE_ALLOC_T. Category is required to be restated to ensure the matching policy is used
+#   define OGRE_FREE(ptr, category) ::Ogre::MemoryTracker::deallocate((void*)ptr)
+
+/// Allocate space for one primitive type, external type or non-virtual type with constructor parameters
+#   define OGRE_NEW_T(T, category) new (::Ogre::MemoryTracker::allocate(sizeof(T), category)) T
+/// Allocate a block of memory for 'count' primitive types - do not use for classes that inherit from AllocatedObject
+#   define OGRE_NEW_ARRAY_T(T, count, category) ::Ogre::constructN(static_cast<T*>(::Ogre::MemoryTracker::allocate(sizeof(T)*(count), category)), count)
+/// Free the memory allocated with OGRE_NEW_T. Category is required to be restated to ensure the matching policy is used
+#   define OGRE_DELETE_T(ptr, T, category) do { if(ptr) { (ptr)->~T(); ::Ogre::MemoryTracker::deallocate(ptr); } } while (0)
+/// Free the memory allocated with OGRE_NEW_ARRAY_T. Category is required to be restated to ensure the matching policy is used, count and type to call destructor
+#   define OGRE_DELETE_ARRAY_T(ptr, T, count, category) do { if(ptr) { for (size_t b = 0; b < count; ++b) { (ptr)[b].~T(); } ::Ogre::MemoryTracker::deallocate(ptr); } } while (0)
+
+// aligned allocation
+/// Allocate a block of raw memory aligned to SIMD boundaries, and indicate the category of usage
+#   define OGRE_MALLOC_SIMD(bytes, category) ::Ogre::MemoryTracker::allocateAligned(bytes, category)
+/// Free the memory allocated with either OGRE_MALLOC_SIMD or OGRE_ALLOC_T_SIMD. Category is required to be restated to ensure the matching policy is used
+#   define OGRE_FREE_SIMD(ptr, category) ::Ogre::MemoryTracker::deallocateAligned((void*)ptr)
+
+#else
+
 /// Allocate a block of raw memory, and indicate the category of usage
 #   define OGRE_MALLOC(bytes, category) (void*)new char[bytes]
 /// Allocate a block of memory for a primitive type, and indicate the category of usage
@@ -197,6 +261,8 @@ namespace Ogre
 /// Free the memory allocated with either OGRE_MALLOC_SIMD or OGRE_ALLOC_T_SIMD. Category is required to be restated to ensure the matching policy is used
 #   define OGRE_FREE_SIMD(ptr, category) ::Ogre::AlignedMemory::deallocate((void*)ptr)
 
+#endif
+
 // new / delete for classes deriving from AllocatedObject (alignment determined by per-class policy)
 #   define OGRE_NEW new 
 #   define OGRE_DELETE delete
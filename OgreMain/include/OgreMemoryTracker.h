@@ -0,0 +1,134 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#ifndef __MemoryTracker_H__
+#define __MemoryTracker_H__
+
+#include "OgrePlatform.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+
+    /** Counts the memory allocated through the OGRE_MALLOC and OGRE_NEW family of macros,
+        per MemoryCategory and per thread.
+    @remarks
+        The macros only go through the tracker if OGRE_MEMORY_TRACKER is set in the
+        build settings. Each allocation is prefixed with a small header remembering its
+        size and category. The counters of a category are shared by all threads, while
+        those of a thread are only written by that thread, so they need no locking.
+    @par
+        Memory may be freed by another thread than the one which allocated it, so the
+        live bytes of a thread can become negative. Only the sums over all threads, as
+        returned by getCategoryStats, are the memory actually in use.
+    */
+    class _OgreExport MemoryTracker
+    {
+    public:
+        /// Counters of a category or of a category within a thread
+        struct Stats
+        {
+            /// Bytes allocated and not freed yet
+            int64 liveBytes;
+            /// Highest liveBytes since the start or resetPeaks
+            int64 peakBytes;
+            /// Number of allocations
+            uint64 numAllocations;
+            /// Number of frees
+            uint64 numFrees;
+        };
+
+        /// Counters of a thread
+        struct ThreadStats
+        {
+            /// Index of the thread, in the order threads first allocated memory
+            uint32 threadIndex;
+            Stats categories[MEMCATEGORY_COUNT];
+        };
+        typedef std::vector<ThreadStats> ThreadStatsList;
+
+        /** Allocates memory and counts it against a category
+        @remarks
+            Throws std::bad_alloc on failure, like operator new.
+        */
+        static DECL_MALLOC void* allocate(size_t bytes, MemoryCategory category);
+        /// Frees memory from allocate, nothing happens for null pointers
+        static void deallocate(void* ptr);
+        /// Like allocate, aligned like AlignedMemory::allocate
+        static DECL_MALLOC void* allocateAligned(size_t bytes, MemoryCategory category);
+        /// Frees memory from allocateAligned, nothing happens for null pointers
+        static void deallocateAligned(void* ptr);
+
+        /// Gets the counters of a category, summed over all threads
+        static Stats getCategoryStats(MemoryCategory category);
+        /** Gets the counters of all threads that allocated or freed tracked memory
+        @remarks
+            A free is counted against the thread that frees the block, not the one
+            that allocated it. So memory handed between threads, e.g. by the work
+            queue, shows up as live bytes of the allocating thread and negative
+            live bytes of the freeing one. The sums in getCategoryStats are exact.
+        */
+        static void getThreadStats(ThreadStatsList& stats);
+        /// Sets the peaks to the current live bytes
+        static void resetPeaks();
+        /// Gets a readable name of a category
+        static const char* getCategoryName(MemoryCategory category);
+
+        /// Writes the counters of all categories to the default log
+        static void logStatistics();
+        /** Sets how often Root logs the statistics
+        @param frames Log every this many frames, 0 to never log them
+        */
+        static void setLogInterval(uint32 frames);
+        /// Gets how often Root logs the statistics
+        static uint32 getLogInterval();
+        /// Called by Root at the end of each frame
+        static void _notifyFrameEnded();
+    };
+
+    /// Default constructs count objects in raw memory, for OGRE_NEW_ARRAY_T
+    template<typename T> T* constructN(T* basePtr, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            new ((void*)(basePtr+i)) T();
+        }
+        return basePtr;
+    }
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
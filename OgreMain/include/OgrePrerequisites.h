@@ -82,6 +82,7 @@ namespace Ogre {
     class AutoParamDataSource;
     class AxisAlignedBox;
     class AxisAlignedBoxSceneQuery;
+    class BakedAnimationAtlas;
     class Billboard;
     class BillboardChain;
     class BillboardSet;
@@ -107,6 +108,7 @@ namespace Ogre {
     class Factory;
     struct FrameEvent;
     class FrameListener;
+    class FrameMemory;
     class Frustum;
     struct GpuLogicalBufferStruct;
     struct GpuNamedConstants;
@@ -245,6 +247,7 @@ namespace Ogre {
     class TextureManager;
     class TransformKeyFrame;
     class Timer;
+    class ThreadPool;
     class UserObjectBindings;
     template <int dims, typename T> class Vector;
     typedef Vector<2, Real> Vector2;
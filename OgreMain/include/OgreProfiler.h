@@ -43,15 +43,26 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 
 #include "OgrePrerequisites.h"
 #include "OgreSingleton.h"
+#include "OgreAtomicScalar.h"
+#include "Threading/OgreThreadHeaders.h"
 #include "OgreHeaderPrefix.h"
 
 #if OGRE_PROFILING == 1
+/// The zone of a string literal profile name, looked up once per call site
+#   define OGRE_PROFILE_STATIC_ZONE( a ) ([]() -> const Ogre::ProfileZone& { \
+        static const Ogre::ProfileZone& _OgreProfileZone = Ogre::Profiler::getZone( "" a ); \
+        return _OgreProfileZone; }())
 #   define OgreProfile( a ) Ogre::Profile _OgreProfileInstance( (a) )
 #   define OgreProfileBegin( a ) Ogre::Profiler::getSingleton().beginProfile( (a) )
 #   define OgreProfileEnd( a ) Ogre::Profiler::getSingleton().endProfile( (a) )
 #   define OgreProfileGroup( a, g ) Ogre::Profile _OgreProfileInstance( (a), (g) )
 #   define OgreProfileBeginGroup( a, g ) Ogre::Profiler::getSingleton().beginProfile( (a), (g) )
 #   define OgreProfileEndGroup( a, g ) Ogre::Profiler::getSingleton().endProfile( (a), (g) )
+#   define OgreProfileStatic( a ) Ogre::Profile _OgreProfileInstance( OGRE_PROFILE_STATIC_ZONE(a) )
+#   define OgreProfileStaticGroup( a, g ) Ogre::Profile _OgreProfileInstance( OGRE_PROFILE_STATIC_ZONE(a), (g) )
+#   define OgreProfileStaticBeginGroup( a, g ) Ogre::Profiler::getSingleton().beginProfile( OGRE_PROFILE_STATIC_ZONE(a), (g) )
+#   define OgreProfileStaticEndGroup( a, g ) Ogre::Profiler::getSingleton().endProfile( OGRE_PROFILE_STATIC_ZONE(a), (g) )
+#   define OgreProfileMarkFrame() Ogre::Profiler::getSingleton().markFrame()
 #   define OgreProfileBeginGPUEvent( g ) Ogre::Profiler::getSingleton().beginGPUEvent(g)
 #   define OgreProfileEndGPUEvent( g ) Ogre::Profiler::getSingleton().endGPUEvent(g)
 #   define OgreProfileMarkGPUEvent( e ) Ogre::Profiler::getSingleton().markGPUEvent(e)
@@ -62,6 +73,11 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #   define OgreProfileGroup( a, g ) 
 #   define OgreProfileBeginGroup( a, g ) 
 #   define OgreProfileEndGroup( a, g ) 
+#   define OgreProfileStatic( a )
+#   define OgreProfileStaticGroup( a, g )
+#   define OgreProfileStaticBeginGroup( a, g )
+#   define OgreProfileStaticEndGroup( a, g )
+#   define OgreProfileMarkFrame()
 #   define OgreProfileBeginGPUEvent( e )
 #   define OgreProfileEndGPUEvent( e )
 #   define OgreProfileMarkGPUEvent( e )
@@ -90,9 +106,55 @@ namespace Ogre {
         OGREPROF_RENDERING = 0x20000000
     };
 
+    /// Identifies a profile name, see Profiler::getZone
+    typedef uint32 ProfileZoneId;
+
+    /** A profile name interned by the Profiler
+        @remarks
+            Zones are never destroyed, so the profile macros look their name up once and keep
+            the zone in a static. Profiles are then told apart without comparing strings.
+    */
+    struct ProfileZone
+    {
+        /// The name of the profile
+        String name;
+        /// Index of the zone, valid for the lifetime of the process
+        ProfileZoneId id;
+        /// Set by Profiler::disableProfile
+        AtomicScalar<bool> disabled;
+
+        ProfileZone(const String& n, ProfileZoneId i) : name(n), id(i), disabled(false) {}
+    };
+
+    /** A profile begin or end, or the start of a frame, recorded in trace mode
+        @see Profiler::setTraceEnabled
+    */
+    struct ProfileTraceEvent
+    {
+        enum Type
+        {
+            TE_BEGIN,
+            TE_END,
+            /// A frame starts, the zone is unused
+            TE_FRAME
+        };
+
+        /// The profiler timer in microseconds
+        uint64 time;
+        /// The zone of the profile
+        ProfileZoneId zone;
+        /// Index of the thread that recorded the event, in the order threads first did so
+        uint16 thread;
+        /// One of Type
+        uint8 type;
+    };
+    typedef std::vector<ProfileTraceEvent> ProfileTraceEventList;
+
     /** An individual profile that will be processed by the Profiler
         @remarks
-            Use the macro OgreProfile(name) instead of instantiating this profile directly
+            Use the macro OgreProfile(name) instead of instantiating this profile directly.
+            For string literal names, OgreProfileStatic(name) looks the zone up only once
+            per call site.
         @remarks
             We use this Profile to allow scoping rules to signify the beginning and end of
             the profile. Use the Profiler singleton (through the macro OgreProfileBegin(name)
@@ -106,12 +168,15 @@ namespace Ogre {
 
         public:
             Profile(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
+            Profile(const ProfileZone& zone, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
             ~Profile();
 
         protected:
 
-            /// The name of this profile
+            /// The name of this profile, when it was not created from a zone
             String mName;
+            /// The zone of this profile, NULL when it is looked up by name
+            const ProfileZone* mZone;
             /// The group ID
             uint32 mGroupID;
             
@@ -254,6 +319,11 @@ namespace Ogre {
         /// Here we get the real profiling information which we can use 
         virtual void displayResults(const ProfileInstance& instance, ulong maxTotalFrameTime) {};
 
+        /** In trace mode, called at the start of each frame with the events all threads
+            recorded since the last call, ordered by time.
+        */
+        virtual void traceEventsCollected(const ProfileTraceEventList& events) {}
+
         /// Set the display mode for the overlay. 
         void setDisplayMode(DisplayMode d) { mDisplayMode = d; }
     
@@ -265,6 +335,38 @@ namespace Ogre {
         DisplayMode mDisplayMode;
     };
 
+    /** Writes the events of trace mode to a file, in the Chrome trace event format
+        @remarks
+            The file can be opened in chrome://tracing or similar viewers. Profiles are
+            written as duration events, on a track per thread, and frames as global
+            instant events.
+    */
+    class _OgreExport ChromeTraceSessionListener : public ProfileSessionListener
+    {
+    public:
+        ChromeTraceSessionListener(const String& fileName);
+        ~ChromeTraceSessionListener();
+
+        /// Opens the file
+        void initializeSession();
+        /// Completes and closes the file
+        void finializeSession();
+        void traceEventsCollected(const ProfileTraceEventList& events);
+
+        /** Writes events as a comma separated list of Chrome trace events
+        @param os The stream to write to
+        @param events The events to write
+        @param first Whether no events were written to the list before
+        */
+        static void writeEvents(std::ostream& os, const ProfileTraceEventList& events, bool first);
+
+    protected:
+        String mFileName;
+        std::ofstream mFile;
+        /// Whether no events were written since the file was opened
+        bool mFirstEvent;
+    };
+
     /** The profiler allows you to measure the performance of your code
         @remarks
             Do not create profiles directly from this unless you want a profile to last
@@ -304,6 +406,8 @@ namespace Ogre {
             @param groupID A profile group identifier, which can allow you to mask profiles
             */
             void beginProfile(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
+            /// @copydoc beginProfile
+            void beginProfile(const ProfileZone& zone, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
 
             /** Ends a profile
             @remarks 
@@ -320,6 +424,41 @@ namespace Ogre {
             @param groupID A profile group identifier, which can allow you to mask profiles
             */
             void endProfile(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
+            /// @copydoc endProfile
+            void endProfile(const ProfileZone& zone, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
+
+            /** Gets the zone of a profile name, creating it the first time
+            @remarks
+                Thread safe. The zone stays valid after the profiler is destroyed.
+            */
+            static const ProfileZone& getZone(const String& profileName);
+            /// Gets a zone created by getZone(const String&)
+            static const ProfileZone& getZone(ProfileZoneId id);
+            /** Gets the number of zones created so far
+            @remarks
+                Profiles named at runtime only create a zone while they are recorded.
+            */
+            static size_t getZoneCount();
+
+            /** Sets whether profiles are recorded as trace events
+            @remarks
+                In trace mode, profiles of all threads are recorded as begin and end events
+                in per thread buffers, without locking. markFrame passes the events to
+                ProfileSessionListener::traceEventsCollected. The statistics of
+                setEnabled are independent of it and only ever consider the thread
+                that created the profiler, as they assume a single call stack.
+            */
+            void setTraceEnabled(bool enabled);
+            /** Gets whether profiles are recorded as trace events */
+            bool getTraceEnabled() const { return mTraceEnabled; }
+
+            /** Marks the start of a frame in trace mode and passes the events recorded
+                since the last call to the listeners
+            @remarks
+                Root calls this through OgreProfileMarkFrame when a frame starts. Must be
+                called from the thread that created the profiler.
+            */
+            void markFrame();
 
             /** Mark the beginning of a GPU event group
              @remarks Can be safely called in the middle of the profile.
@@ -440,17 +579,21 @@ namespace Ogre {
             /** Handles a change of the profiler's enabled state*/
             void changeEnableState();
 
-            // lol. Uses typedef; put's original container type in name.
-            typedef std::set<String> DisabledProfileMap;
+            /** Whether the calling thread keeps the statistics of setEnabled */
+            bool isStatisticsThread() const;
+
+            /** Whether profiles of the calling thread are traced or timed */
+            bool isRecording() const;
+
+            /** Records a trace event on the calling thread */
+            void recordTraceEvent(ProfileZoneId zone, ProfileTraceEvent::Type type);
+
             typedef ProfileInstance::ProfileChildren ProfileChildren;
 
             ProfileInstance* mCurrent;
             ProfileInstance* mLast;
             ProfileInstance mRoot;
 
-            /// Holds the names of disabled profiles
-            DisabledProfileMap mDisabledProfiles;
-
             /// Whether the GUI elements have been initialized
             bool mInitialized;
 
@@ -484,6 +627,19 @@ namespace Ogre {
             Real mAverageFrameTime;
             bool mResetExtents;
 
+            /// Whether profiles are recorded as trace events
+            AtomicScalar<bool> mTraceEnabled;
+            /// The event buffer of a thread
+            struct ThreadTrace;
+            /// The buffers of all threads that recorded events, the mutex is only
+            /// taken when a thread records its first event
+            std::vector<ThreadTrace*> mThreadTraces;
+            OGRE_WQ_MUTEX(mThreadTracesMutex);
+            /// Identifies this profiler in the per thread buffer caches
+            uint64 mTraceId;
+            /// Events collected by markFrame
+            ProfileTraceEventList mTraceEvents;
+
 
     }; // end class
     /** @} */
@@ -123,110 +123,40 @@ namespace Ogre {
         };
 
     protected:
-        /// Comparator to order pass groups
-        struct PassGroupLess
-        {
-            bool operator()(const Pass* a, const Pass* b) const
-            {
-                // Sort by passHash, which is pass, then texture unit changes
-                uint32 hasha = a->getHash();
-                uint32 hashb = b->getHash();
-                if (hasha == hashb)
-                {
-                    // Must differentTransparentQueueItemLessiate by pointer incase 2 passes end up with the same hash
-                    return a < b;
-                }
-                else
-                {
-                    return hasha < hashb;
-                }
-            }
-        };
-        /// Comparator to order objects by descending camera distance
-        struct DepthSortDescendingLess
-        {
-            const Camera* camera;
-
-            DepthSortDescendingLess(const Camera* cam)
-                : camera(cam)
-            {
-            }
-
-            bool operator()(const RenderablePass& a, const RenderablePass& b) const
-            {
-                if (a.renderable == b.renderable)
-                {
-                    // Same renderable, sort by pass hash
-                    return a.pass->getHash() < b.pass->getHash();
-                }
-                else
-                {
-                    // Different renderables, sort by depth
-                    Real adepth = a.renderable->getSquaredViewDepth(camera);
-                    Real bdepth = b.renderable->getSquaredViewDepth(camera);
-                    if (Math::RealEqual(adepth, bdepth))
-                    {
-                        // Must return deterministic result, doesn't matter what
-                        return a.pass < b.pass;
-                    }
-                    else
-                    {
-                        // Sort DESCENDING by depth (i.e. far objects first)
-                        return (adepth > bdepth);
-                    }
-                }
-
-            }
-        };
-
         /** Vector of RenderablePass objects, this is built on the assumption that
          vectors only ever increase in size, so even if we do clear() the memory stays
          allocated, ie fast */
         typedef std::vector<RenderablePass> RenderablePassList;
-        /** Map of pass to renderable lists, this is a grouping by pass. */
-        typedef std::map<Pass*, RenderableList, PassGroupLess> PassGroupRenderableMap;
-
-        /// Functor for accessing sort value 1 for radix sort (Pass)
-        struct RadixSortFunctorPass
-        {
-            uint32 operator()(const RenderablePass& p) const
-            {
-                return p.pass->getHash();
-            }
-        };
-
-        /// Radix sorter for accessing sort value 1 (Pass)
-        static RadixSort<RenderablePassList, RenderablePass, uint32> msRadixSorter1;
 
-        /// Functor for descending sort value 2 for radix sort (distance)
-        struct RadixSortFunctorDistance
+        /// 64 bit sort key of an entry, along with its position before sorting
+        struct SortEntry
         {
-            const Camera* camera;
-
-            RadixSortFunctorDistance(const Camera* cam)
-                : camera(cam)
-            {
-            }
-
-            float operator()(const RenderablePass& p) const
-            {
-                // Sort DESCENDING by depth (ie far objects first), use negative distance
-                // here because radix sorter always dealing with accessing sort
-                return static_cast<float>(- p.renderable->getSquaredViewDepth(camera));
-            }
+            uint64 key;
+            uint32 index;
         };
+        typedef std::vector<SortEntry> SortEntryList;
 
-        /// Radix sorter for sort value 2 (distance)
-        static RadixSort<RenderablePassList, RenderablePass, float> msRadixSorter2;
+        /// Buffers for sorting, shared between all collections
+        static SortEntryList msSortEntries;
+        static SortEntryList msSortScratch;
+        static RenderablePassList msSortedPasses;
 
         /// Bitmask of the organisation modes requested
         uint8 mOrganisationMode;
+        /// Whether mGrouped has entries that were not sorted by sort() yet
+        bool mGroupedDirty;
 
-        /// Grouped 
-        PassGroupRenderableMap mGrouped;
+        /// Grouped by pass, ordered by pass hash after sorting
+        RenderablePassList mGrouped;
         /// Sorted descending (can iterate backwards to get ascending)
         RenderablePassList mSortedDescending;
+        /// Renderables of the pass group being visited
+        mutable RenderableList mVisitedGroup;
 
+        /// Stable radix sort of the entries by the keys in msSortEntries, skipping bytes all keys share
+        static void sortByKeys(RenderablePassList& list);
+        /// Sort mGrouped by pass
+        void sortGrouped(void);
         /// Internal visitor implementation
         void acceptVisitorGrouped(QueuedRenderableVisitor* visitor) const;
         /// Internal visitor implementation
@@ -240,10 +170,10 @@ namespace Ogre {
         /// Empty the collection
         void clear(void);
 
-        /** Remove the group entry (if any) for a given Pass.
+        /** Remove the entries (if any) using a given Pass.
         @remarks
             To be used when a pass is destroyed, such that any
-            grouping level for it becomes useless.
+            queued renderables using it become useless.
         */  
         void removePassGroup(Pass* p);
         
@@ -271,6 +201,11 @@ namespace Ogre {
         void addRenderable(Pass* pass, Renderable* rend);
         
         /** Perform any sorting that is required on this collection.
+        @remarks
+            Entries are radix sorted by the pass hash, or by the camera distance
+            followed by the pass hash. The sort is stable, so equal keys keep the
+            order they were added in. Pass groups are only formed by sorting, so
+            this must be called before acceptVisitor.
         @param cam The camera
         */
         void sort(const Camera* cam);
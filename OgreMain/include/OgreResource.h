@@ -131,11 +131,26 @@ namespace Ogre {
             LF_PRESERVE_STATE = 4,
         };
 
+        /// Classes of resources evicted to stay within a memory budget, lowest first
+        enum EvictionPriority
+        {
+            /// Evicted before any other class
+            EVICT_PRIORITY_LOW,
+            /// The default class
+            EVICT_PRIORITY_NORMAL,
+            /// Only evicted once no lower class resource can be
+            EVICT_PRIORITY_HIGH,
+            /// Never evicted to satisfy a memory budget
+            EVICT_PRIORITY_NEVER
+        };
+
     protected:
         /// Creator
         ResourceManager* mCreator;
         /// Unique name of the resource
         String mName;
+        /// Hash of the name, computed once for the name index of the creator
+        uint32 mNameHash;
         /// The name of the resource group
         String mGroup;
         /// Numeric handle for more efficient look up than name
@@ -154,6 +169,17 @@ namespace Ogre {
         ManualResourceLoader* mLoader;
         /// State count, the number of times this resource has changed state
         size_t mStateCount;
+        /// Class this resource is evicted in when over a memory budget
+        EvictionPriority mEvictionPriority;
+        /// Links in the least recently used list of the creator, only used while loaded
+        Resource* mLruPrev;
+        Resource* mLruNext;
+        /// Index of the creator list this resource is linked in, -1 if none
+        int mLruList;
+        /// Value of the global touch counter when this resource was last used
+        uint64 mLastTouched;
+
+        friend class ResourceManager;
 
         typedef std::set<Listener*> ListenerList;
         ListenerList mListenerList;
@@ -162,8 +188,10 @@ namespace Ogre {
         /** Protected unnamed constructor to prevent default construction. 
         */
         Resource() 
-            : mCreator(0), mHandle(0), mLoadingState(LOADSTATE_UNLOADED), 
-              mIsBackgroundLoaded(0), mIsManual(0), mSize(0), mLoader(0), mStateCount(0)
+            : mCreator(0), mNameHash(0), mHandle(0), mLoadingState(LOADSTATE_UNLOADED), 
+              mIsBackgroundLoaded(0), mIsManual(0), mSize(0), mLoader(0), mStateCount(0),
+              mEvictionPriority(EVICT_PRIORITY_NORMAL), mLruPrev(0), mLruNext(0), mLruList(-1),
+              mLastTouched(0)
         { 
         }
 
@@ -296,9 +324,30 @@ namespace Ogre {
         }
 
         /** 'Touches' the resource to indicate it has been used.
+        @remarks
+            The creator keeps its loaded resources in least recently used order,
+            so touched resources are the last ones evicted to stay within a
+            memory budget.
         */
         virtual void touch(void);
 
+        /** Sets the class this resource is evicted in when its creator, or the
+            ResourceGroupManager, is over its memory budget.
+        @remarks
+            All resources of a lower class are evicted before any of a higher one,
+            least recently used first within a class. This counts as a use of the
+            resource.
+        */
+        void setEvictionPriority(EvictionPriority priority);
+
+        /// Gets the class this resource is evicted in
+        EvictionPriority getEvictionPriority(void) const { return mEvictionPriority; }
+
+        /** Gets the value of the global touch counter when this resource was
+            last used, higher values being more recent.
+        */
+        uint64 getLastTouched(void) const { return mLastTouched; }
+
         /** Gets resource name.
         */
         virtual const String& getName(void) const 
@@ -306,6 +355,9 @@ namespace Ogre {
             return mName; 
         }
 
+        /// Gets the hash of the name, as used by ResourceManager::hashName
+        uint32 getNameHash(void) const { return mNameHash; }
+
         virtual ResourceHandle getHandle(void) const
         {
             return mHandle;
@@ -419,6 +419,12 @@ namespace Ogre {
 
         /// Stored current group - optimisation for when bulk loading a group
         ResourceGroup* mCurrentGroup;
+
+        /// Limit on the combined memory usage of all managers, in bytes
+        size_t mMemoryBudget;
+        /// Managers sharing the budget, kept apart from mResourceManagerMap so loads needn't take the main lock
+        std::vector<ResourceManager*> mBudgetManagers;
+        OGRE_MUTEX(mBudgetMutex);
     public:
         ResourceGroupManager();
         virtual ~ResourceGroupManager();
@@ -872,6 +878,34 @@ namespace Ogre {
         /** Shutdown all ResourceManagers, performed as part of clean-up. */
         void shutdownAll(void);
 
+        /** Sets a limit on the memory all registered ResourceManagers may use together.
+        @remarks
+            This applies on top of the budget of each manager. Whenever a resource
+            is loaded while the combined usage is over this budget, resources are
+            evicted as by evictResources. There is no limit by default.
+        */
+        void setMemoryBudget(size_t bytes);
+
+        /// Gets the limit on the memory all registered ResourceManagers may use together
+        size_t getMemoryBudget(void) const { return mMemoryBudget; }
+
+        /// Gets the combined memory usage of all registered ResourceManagers, in bytes
+        size_t getMemoryUsage(void) const;
+
+        /** Unloads resources of all registered ResourceManagers until at least
+            the given number of bytes is reclaimed, or no more resources can be.
+        @remarks
+            This works as ResourceManager::evictResources, but the least recently
+            used resource of a class goes first whichever manager it belongs to, so
+            a texture used a moment ago survives a mesh nobody used for an hour.
+        @return The number of bytes reclaimed
+        */
+        size_t evictResources(size_t bytes);
+
+        /** Internal method called by ResourceManager after a resource was loaded,
+            evicting resources if the shared memory budget is exceeded. */
+        void _checkMemoryBudget(void);
+
 
         /** Internal method for registering a ResourceManager (which should be
             a singleton). Creators of plugins can register new ResourceManagers
@@ -148,6 +148,9 @@ namespace Ogre {
                 budget, it will temporarily unload a resource to make room for the new one. This unloading
                 is not permanent and the Resource is not destroyed; it simply needs to be reloaded when
                 next used.
+            @par
+                Resources are evicted as by evictResources.
+            @see ResourceGroupManager::setMemoryBudget for a budget shared by all managers
         */
         void setMemoryBudget(size_t bytes);
 
@@ -158,6 +161,18 @@ namespace Ogre {
         /** Gets the current memory usage, in bytes. */
         size_t getMemoryUsage(void) const { return mMemoryUsage.load(); }
 
+        /** Unloads resources until at least the given number of bytes is reclaimed,
+            or no more resources can be.
+        @remarks
+            Only reloadable resources which are not referenced outside of the
+            resource system are unloaded. Resources of a lower
+            Resource::EvictionPriority go first, and within a class the least
+            recently used ones go first. Resources of EVICT_PRIORITY_NEVER are
+            never unloaded.
+        @return The number of bytes reclaimed
+        */
+        size_t evictResources(size_t bytes);
+
         /** Unloads a single resource by name.
         @remarks
             Unloaded resources are not removed, they simply free up their memory
@@ -315,9 +330,27 @@ namespace Ogre {
         virtual void removeUnreferencedResources(bool reloadableOnly = true);
 
         /** Retrieves a pointer to a resource by name, or null if the resource does not exist.
+        @remarks
+            Lookups only lock the part of the name index the name hashes to, so
+            they neither wait for the manager mutex nor for lookups of other names.
+            With AUTODETECT_RESOURCE_GROUP_NAME, a resource in the global pool is
+            preferred over ones in other groups, of which the first one created
+            (i.e. the one with the lowest handle) wins.
         */
         virtual ResourcePtr getResourceByName(const String& name, const String& groupName OGRE_RESOURCE_GROUP_INIT);
 
+        /** Retrieves a pointer to a resource by name, using a precomputed name hash.
+        @remarks
+            Lets callers which look up the same name repeatedly skip hashing it.
+        @param nameHash The hash of name, as returned by hashName or Resource::getNameHash
+        @param name The name of the resource
+        @param groupName The group, see getResourceByName(const String&, const String&)
+        */
+        virtual ResourcePtr getResourceByName(uint32 nameHash, const String& name, const String& groupName OGRE_RESOURCE_GROUP_INIT);
+
+        /// Hashes a resource name the way the name index does, see Resource::getNameHash
+        static uint32 hashName(const String& name) { return FastHash(name.c_str(), name.size()); }
+
         /** Retrieves a pointer to a resource by handle, or null if the resource does not exist.
         */
         virtual ResourcePtr getByHandle(ResourceHandle handle);
@@ -338,6 +371,24 @@ namespace Ogre {
         */
         virtual void _notifyResourceTouched(Resource* res);
 
+        typedef std::vector<ResourcePtr> ResourceList;
+        /** Internal method appending the resources of the given class which could
+            be evicted right now to a list, least recently used first.
+        @remarks
+            Loaded resources still referenced outside of the resource system are
+            counted as used at this point, so once released they are ordered by
+            when they were last in use rather than when they were loaded.
+        */
+        void _getEvictionCandidates(Resource::EvictionPriority priority, ResourceList& candidates);
+
+        /** Internal method unloading the given resources in least recently used
+            order until at least the given number of bytes is reclaimed.
+        @remarks
+            The list may hold resources of several managers, see _getEvictionCandidates.
+        @return The number of bytes reclaimed
+        */
+        static size_t _evictCandidates(ResourceList& candidates, size_t bytes);
+
         /** Notify this manager that a resource which it manages has been 
             loaded. 
         */
@@ -495,6 +546,16 @@ namespace Ogre {
         */
         void checkUsage(void);
 
+        /// Adds a resource just inserted in mResources or mResourcesWithGroup to the name index
+        void addToNameIndex(const ResourcePtr* res, bool global);
+        /// Removes a resource from the name index, must happen before it leaves the maps
+        void removeFromNameIndex(const Resource* res);
+
+        /// Links a loaded resource at the most recently used end of the list of its class
+        void linkLru(Resource* res);
+        /// Removes a resource from the list it is linked in, if any
+        void unlinkLru(Resource* res);
+
 
     public:
         typedef std::unordered_map< String, ResourcePtr > ResourceMap;
@@ -510,6 +571,29 @@ namespace Ogre {
 
         bool mVerbose;
 
+        /// Entry of the name index, pointing into mResources or mResourcesWithGroup
+        struct NameIndexEntry
+        {
+            const ResourcePtr* res;
+            /// Whether it lives in mResources, i.e. its group is in the global pool
+            bool global;
+        };
+        typedef std::unordered_multimap<uint32, NameIndexEntry> NameIndexMap;
+        /// Independently locked part of the name index
+        struct NameIndexShard
+        {
+            NameIndexMap entries;
+            OGRE_MUTEX(mutex);
+        };
+        enum { NAME_INDEX_SHARD_COUNT = 16 };
+        /// All resources by name hash, whatever their group
+        NameIndexShard mNameIndex[NAME_INDEX_SHARD_COUNT];
+
+        /// Loaded resources per eviction class, from least to most recently used
+        Resource* mLruHead[Resource::EVICT_PRIORITY_NEVER + 1];
+        Resource* mLruTail[Resource::EVICT_PRIORITY_NEVER + 1];
+        OGRE_MUTEX(mLruMutex);
+
         // IMPORTANT - all subclasses must populate the fields below
 
         /// Patterns to use to look for scripts if supported (e.g. *.overlay)
@@ -83,7 +83,9 @@ namespace Ogre
         std::unique_ptr<ScriptCompilerManager> mCompilerManager;
         std::unique_ptr<DynLibManager> mDynLibManager;
         std::unique_ptr<Timer> mTimer;
+        std::unique_ptr<FrameMemory> mFrameMemory;
         std::unique_ptr<WorkQueue> mWorkQueue;
+        std::unique_ptr<ThreadPool> mThreadPool;
         std::unique_ptr<ResourceGroupManager> mResourceGroupManager;
         std::unique_ptr<ResourceBackgroundQueue> mResourceBackgroundQueue;
         std::unique_ptr<MaterialManager> mMaterialManager;
@@ -192,7 +194,7 @@ namespace Ogre
         };
 
         /// Contains the times of recently fired events
-        typedef std::deque<unsigned long> EventTimesQueue;
+        typedef std::vector<unsigned long> EventTimesQueue;
         EventTimesQueue mEventTimes[FETT_COUNT];
 
         /** Internal method for calculating the average time between recently fired events.
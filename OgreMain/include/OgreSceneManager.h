@@ -158,12 +158,13 @@ namespace Ogre {
         {
             _OgreExport bool operator()(const Material* x, const Material* y) const;
         };
-        /// Comparator for sorting lights relative to a point
+        /** Comparator for sorting lights relative to a point
+        @deprecated _populateLightList no longer sorts by Light::tempSquareDist
+        */
         struct lightLess
         {
-            _OgreExport bool operator()(const Light* a, const Light* b) const;
+            OGRE_DEPRECATED _OgreExport bool operator()(const Light* a, const Light* b) const;
         };
-
         /// Describes the stage of rendering when performing complex illumination
         enum IlluminationRenderStage
         {
@@ -376,6 +377,28 @@ namespace Ogre {
         /// Allow visitor helper to access protected methods
         friend class SceneMgrQueuedRenderableVisitor;
 
+        /** Render state changes issued by _setPass and renderSingleObject in a frame.
+        @remarks
+            State already set by the previous pass is not sent to the render system again.
+            The counters are reset when the first viewport of a new frame is rendered.
+        */
+        struct RenderStateStats
+        {
+            RenderStateStats() { reset(); }
+            void reset(void) { passChanges = stateChanges = programBinds = textureBinds = redundantChanges = 0; }
+
+            /// Passes set
+            size_t passChanges;
+            /// Fixed function, blend, depth and rasterisation state blocks sent
+            size_t stateChanges;
+            /// Gpu programs bound
+            size_t programBinds;
+            /// Texture units set
+            size_t textureBinds;
+            /// State blocks, programs and texture units skipped because they were already set
+            size_t redundantChanges;
+        };
+
         typedef std::map<String, Camera* > CameraList;
         typedef std::map<String, Animation*> AnimationList;
     protected:
@@ -572,6 +595,36 @@ namespace Ogre {
         LightInfoList mTestLightInfos; // potentially new list
         ulong mLightsDirtyCounter;
 
+        /** Uniform grid binning the lights affecting the frustum by their range.
+        @remarks
+            Cells store indices into mLightsAffectingFrustum, so _populateLightList only
+            has to look at the lights near the queried position.
+        */
+        struct LightClusters
+        {
+            LightClusters() : dirtyCounter(std::numeric_limits<ulong>::max())
+            {
+                resolution[0] = resolution[1] = resolution[2] = 0;
+            }
+            /// Whether a light is binned into cells, or affects every position
+            static bool isBounded(const Light* l);
+            /// The cells along an axis overlapping [lo, hi] in cell coordinates
+            void getCellRange(int axis, Real lo, Real hi, int& cellMin, int& cellMax) const;
+
+            Vector3 origin;
+            Vector3 invCellSize;
+            int resolution[3];
+            /// Start of each cell in indices, followed by the total count
+            std::vector<uint32> offsets;
+            /// Indices of the lights overlapping each cell
+            std::vector<uint32> indices;
+            /// Indices of the directional lights and lights of unbounded range
+            std::vector<uint32> unbounded;
+            /// Value of mLightsDirtyCounter the clusters were built for
+            ulong dirtyCounter;
+        };
+        LightClusters mLightClusters;
+
         typedef std::map<String, MovableObject*> MovableObjectMap;
         /// Simple structure to hold MovableObject map and a mutex to go with it.
         struct MovableObjectCollection
@@ -915,6 +968,12 @@ namespace Ogre {
             which may be occluded by word geometry.
         */
         virtual void findLightsAffectingFrustum(const Camera* camera);
+        /** Bin the lights affecting the frustum into the light clusters used by _populateLightList.
+        @remarks
+            Called by _renderScene whenever findLightsAffectingFrustum changed the light list,
+            before any light list is populated.
+        */
+        void buildLightClusters(void);
         /// Internal method for setting up materials for shadows
         virtual void initShadowVolumeMaterials(void);
         /// Internal method for creating shadow textures (texture-based shadows)
@@ -1058,9 +1117,78 @@ namespace Ogre {
         /// Gpu params that need rebinding (mask of GpuParamVariability)
         uint16 mGpuParamsDirty;
 
+        /** Render state last sent to the render system by _setPass.
+        @remarks
+            Used to only forward the state that differs from the previous pass. Anything
+            changing the render system state directly must invalidate it.
+        */
+        struct RenderStateCache
+        {
+            /// Groups of render state that are sent together
+            enum StateBlock
+            {
+                SB_SURFACE = 0x1,
+                SB_LIGHTING = 0x2,
+                SB_FOG = 0x4,
+                SB_BLEND = 0x8,
+                SB_LINE_WIDTH = 0x10,
+                SB_POINT = 0x20,
+                SB_POINT_SPRITES = 0x40,
+                SB_DEPTH = 0x80,
+                SB_DEPTH_BIAS = 0x100,
+                SB_ALPHA_REJECT = 0x200,
+                SB_SHADING = 0x400,
+                SB_POLYGON_MODE = 0x800
+            };
+
+            RenderStateCache() { invalidate(); }
+            void invalidate(void);
+            /** Whether a state block has to be sent to the render system, counting the outcome.
+            @param block The StateBlock to check
+            @param changed Whether the new state differs from the cached one, only
+                meaningful if the cached block is valid
+            */
+            bool update(uint32 block, bool changed, RenderStateStats& stats);
+
+            /// Mask of StateBlock that hold the actual render system state
+            uint32 validBlocks;
+            GpuProgram* programs[GPT_COUNT];
+            bool lightingEnabled;
+            ColourValue ambient, diffuse, specular, emissive;
+            Real shininess;
+            TrackVertexColourType tracking;
+            FogMode fogMode;
+            ColourValue fogColour;
+            Real fogDensity, fogStart, fogEnd;
+            ColourBlendState blendState;
+            float lineWidth;
+            Real pointSize, pointAttenuation[3], pointMinSize, pointMaxSize;
+            bool pointAttenuationEnabled;
+            bool pointSprites;
+            /// Texture units that only depend on their texture, and that texture
+            const TextureUnitState* textureUnits[OGRE_MAX_TEXTURE_LAYERS];
+            const Texture* textures[OGRE_MAX_TEXTURE_LAYERS];
+            CompareFunction depthFunction;
+            bool depthCheck, depthWrite;
+            float depthBiasConstant, depthBiasSlopeScale;
+            CompareFunction alphaRejectFunction;
+            unsigned char alphaRejectValue;
+            bool alphaToCoverage;
+            ShadeOptions shading;
+            PolygonMode polygonMode;
+        };
+        RenderStateCache mRenderStateCache;
+        RenderStateStats mRenderStateStats;
+
         void useLights(const LightList& lights, ushort limit, bool fixedFunction);
         void setViewMatrix(const Affine3& m);
         void bindGpuProgram(GpuProgram* prog);
+        /// Set a texture unit unless the same texture unit is still set
+        void setTextureUnitSettings(size_t unit, TextureUnitState* tex);
+        /// Disable the texture units from texUnit on, forgetting what they were set to
+        void disableTextureUnitsFrom(size_t texUnit);
+        /// Set the polygon mode unless it is already set
+        void setPolygonMode(PolygonMode mode);
         void updateGpuProgramParameters(const Pass* p);
 
 
@@ -3345,6 +3473,16 @@ namespace Ogre {
         */
         void _markGpuParamsDirty(uint16 mask);
 
+        /// Get the render state changes made in the current frame
+        const RenderStateStats& getRenderStateStats(void) const { return mRenderStateStats; }
+
+        /** Forget the render state remembered from the previous pass.
+        @remarks
+            Call this after changing the render system state directly, e.g. in a
+            RenderQueueListener or RenderObjectListener, so the next pass is set in full.
+        */
+        void _invalidateRenderStateCache(void) { mRenderStateCache.invalidate(); }
+
 
         /** Indicates to the SceneManager whether it should suppress the 
             active shadow rendering technique until told otherwise.
@@ -242,7 +242,46 @@ namespace Ogre {
         virtual void extrudeBounds(AxisAlignedBox& box, const Vector4& lightPos, 
             Real extrudeDist) const;
 
+        /** The indexes of the last shadow volume generated by this caster.
+        @remarks
+            The silhouette only depends on the light position in object space and the
+            face normals, so while neither the light nor the caster moves the indexes
+            are copied from here instead of being generated again.
+        */
+        struct ShadowVolumeCache
+        {
+            /// The edge list the indexes were generated from
+            const EdgeData* edgeData;
+            /// EdgeData::faceNormalsVersion of the edge list
+            uint32 faceNormalsVersion;
+            /// Object space light position the light facings were calculated for
+            Vector4 lightPos;
+            /// Whether updateEdgeListLightFacing left the light facings as they were
+            bool lightFacingsReused;
+            /// Whether the indexes below are valid for the key above
+            bool indexesValid;
+            unsigned long flags;
+            int lightType;
+            bool useMcGuire;
+            /// Volume indexes of each edge group, followed by its light cap indexes
+            std::vector<unsigned short> indexes;
+            /// Number of volume and light cap indexes of each edge group
+            std::vector<std::pair<size_t, size_t> > groupIndexCounts;
+            /// Number of used entries in indexes, the vector only grows
+            size_t numIndexes;
+            /// Scratch list of the silhouette edges, two oriented indexes per edge
+            std::vector<unsigned short> silhouette;
+
+            ShadowVolumeCache()
+                : edgeData(0), faceNormalsVersion(0), lightFacingsReused(false),
+                  indexesValid(false), flags(0), lightType(0), useMcGuire(false), numIndexes(0) {}
+        };
+        ShadowVolumeCache mShadowVolumeCache;
 
+    private:
+        /// Fills mShadowVolumeCache with the shadow volume indexes of an edge list
+        void buildShadowVolumeIndexes(EdgeData* edgeData, const Light* light, bool useMcGuire,
+            unsigned long flags);
     };
     /** @} */
     /** @} */
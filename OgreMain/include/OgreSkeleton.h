@@ -307,6 +307,12 @@ namespace Ogre {
         */
         virtual void optimiseAllAnimations(bool preservingIdentityNodeTracks = false);
 
+        /** Compress the node tracks of all of this skeleton's animations.
+        @see Animation::compressNodeTracks
+        @param tolerance The largest error allowed per key component
+        */
+        virtual void compressAllAnimations(Real tolerance = 1e-3);
+
         /** Allows you to use the animations from another Skeleton object to animate
             this skeleton.
         @remarks
@@ -0,0 +1,152 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __SkeletonEvaluationCache_H__
+#define __SkeletonEvaluationCache_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreCommon.h"
+#include "OgreAnimationState.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre {
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Animation
+    *  @{
+    */
+    /** Shares evaluated bone matrices between entities playing identical animation states.
+    @remarks
+        Crowds often consist of many entities with their own SkeletonInstance, which all
+        play the same animations at the same time positions. The first entity evaluating
+        a given combination of skeleton, enabled animations, time positions, weights and
+        blend masks in a frame stores the resulting bone matrices here, every other entity
+        with the same combination copies them instead of applying the animations again.
+    @par
+        The SkeletonInstance of an entity served from the cache is not updated, so entities
+        which need their bones posed (objects attached to bones, manually controlled bones,
+        bounding boxes from the skeleton or displaying the skeleton) always evaluate their
+        own skeleton. Other code reading the bones of a served entity, like Bone::_getDerivedPosition
+        or a TagPoint created later, sees the pose they were last evaluated with. The cache is
+        therefore disabled by default. Entries only live for the frame they were created in.
+    */
+    class _OgreExport SkeletonEvaluationCache : public AnimationAlloc
+    {
+    public:
+        /// Lookup statistics, since the last call to resetStatistics
+        struct Statistics
+        {
+            /// The number of evaluations requested
+            size_t lookups;
+            /// The number of evaluations served from the cache
+            size_t hits;
+
+            Statistics() : lookups(0), hits(0) {}
+            /// The fraction of evaluations served from the cache
+            Real getHitRate() const { return lookups ? Real(hits) / Real(lookups) : 0; }
+        };
+
+        SkeletonEvaluationCache();
+
+        /** Get the bone matrices of a skeleton instance posed by an animation state set.
+        @remarks
+            Copies cached matrices if another instance of the same skeleton was already
+            evaluated with identical animation states during this frame, otherwise
+            applies the states to the instance and caches its bone matrices.
+        @param master The skeleton the instance was created from
+        @param instance The skeleton instance to evaluate on a cache miss
+        @param animSet The animation states to apply
+        @param frameNumber The current frame, entries of other frames are discarded
+        @param matrices Receives getNumBones() matrices
+        @return true if the matrices came from the cache
+        */
+        bool _getBoneMatrices(const Skeleton* master, SkeletonInstance* instance,
+                              const AnimationStateSet& animSet, unsigned long frameNumber,
+                              Affine3* matrices);
+
+        /** Enable or disable the cache, it is disabled by default.
+        @remarks
+            Only enable it if the bones of the entities sharing matrices are not read
+            by the application, see the class description.
+        */
+        void setEnabled(bool enabled);
+        /// Whether the cache is enabled
+        bool getEnabled(void) const { return mEnabled; }
+
+        /// Remove all entries
+        void clear(void);
+
+        /// Get the lookup statistics
+        const Statistics& getStatistics(void) const { return mStatistics; }
+        /// Reset the lookup statistics
+        void resetStatistics(void) { mStatistics = Statistics(); }
+
+    private:
+        /// Everything an enabled animation state contributes to the pose
+        struct StateKey
+        {
+            String name;
+            Real timePos;
+            Real weight;
+            /// Empty without a blend mask
+            AnimationState::BoneBlendMask blendMask;
+
+            bool operator==(const StateKey& rhs) const
+            {
+                return timePos == rhs.timePos && weight == rhs.weight && name == rhs.name &&
+                       blendMask == rhs.blendMask;
+            }
+        };
+
+        struct Entry
+        {
+            const Skeleton* skeleton;
+            uint16 blendMode;
+            std::vector<StateKey> states;
+            std::vector<Affine3> matrices;
+        };
+        typedef std::unordered_multimap<uint32, size_t> EntryIndex;
+
+        bool mEnabled;
+        unsigned long mFrameNumber;
+        /// Entries in use this frame, the ones behind it are kept to reuse their storage
+        size_t mNumEntries;
+        std::vector<Entry> mEntries;
+        EntryIndex mIndex;
+        /// Key of the current lookup, kept to avoid reallocations
+        std::vector<StateKey> mKey;
+        Statistics mStatistics;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
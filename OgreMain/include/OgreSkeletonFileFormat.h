@@ -101,6 +101,19 @@ namespace Ogre {
                     // Quaternion rotate            : Rotation to apply at this keyframe
                     // Vector3 translate            : Translation to apply at this keyframe
                     // Vector3 scale                : Scale to apply at this keyframe
+
+            SKELETON_ANIMATION_COMPRESSED = 0x4200,
+            // [Optional] compressed node tracks, replaces the SKELETON_ANIMATION_TRACK chunks
+            // (see CompressedAnimationClip, requires version 1.12)
+
+                // unsigned short flags              : 1 if rotations use spherical interpolation
+                // unsigned int numTracks
+                // unsigned int numKeys
+                // unsigned short handles[numTracks] : Index of bone each track applies to
+                // unsigned int keyStart[numTracks * 3 + 1] : First key of each channel
+                // float ranges[numTracks * 18]      : Quantisation offset and step of each channel
+                // unsigned short times[numKeys]     : Quantised key times
+                // unsigned short values[numKeys * 3] : Quantised key values
         SKELETON_ANIMATION_LINK         = 0x5000
         // Link to another skeleton, to re-use its animations
 
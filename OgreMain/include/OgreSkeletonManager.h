@@ -32,6 +32,7 @@ THE SOFTWARE.
 
 #include "OgreResourceManager.h"
 #include "OgreSingleton.h"
+#include "OgreSkeletonEvaluationCache.h"
 
 namespace Ogre {
 
@@ -65,6 +66,11 @@ namespace Ogre {
         /// @see ResourceManager::getResourceByName
         SkeletonPtr getByName(const String& name, const String& groupName OGRE_RESOURCE_GROUP_INIT);
 
+        /** The cache entities use to share bone matrices of identical animation states.
+        @see SkeletonEvaluationCache
+        */
+        SkeletonEvaluationCache& getEvaluationCache(void) { return mEvaluationCache; }
+
         /// @copydoc Singleton::getSingleton()
         static SkeletonManager& getSingleton(void);
         /// @copydoc Singleton::getSingleton()
@@ -76,6 +82,7 @@ namespace Ogre {
             const String& group, bool isManual, ManualResourceLoader* loader, 
             const NameValuePairList* createParams);
 
+        SkeletonEvaluationCache mEvaluationCache;
     };
 
     /** @} */
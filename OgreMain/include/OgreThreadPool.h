@@ -0,0 +1,132 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef __OgreThreadPool_H__
+#define __OgreThreadPool_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreSingleton.h"
+#include "OgreAtomicScalar.h"
+#include "Threading/OgreThreadHeaders.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** A pool of threads to split loops over large arrays into ranges processed in parallel.
+    @remarks
+        Unlike the WorkQueue, which processes requests in the background and returns
+        responses in a later frame, parallelFor blocks until the whole loop is done, so
+        it can be used for work which is needed immediately, like filling a buffer which
+        is about to be rendered. The calling thread processes ranges as well.
+    @par
+        The worker threads are started on the first parallel loop. Without thread
+        support, or when called from inside another parallel loop, the ranges are
+        processed one after the other on the calling thread.
+    */
+    class _OgreExport ThreadPool : public Singleton<ThreadPool>, public UtilityAlloc
+    {
+    public:
+        /// Processes the indices [begin, end)
+        typedef std::function<void(size_t begin, size_t end)> RangeFunction;
+
+        /** Constructor.
+        @param numThreads The number of worker threads, 0 for one less than the
+            number of hardware threads
+        */
+        explicit ThreadPool(size_t numThreads = 0);
+        ~ThreadPool();
+
+        /** Call a function for consecutive ranges covering [0, count), in parallel.
+        @remarks
+            Every range starts at a multiple of rangeSize and all but the last one
+            are rangeSize long, so results can be stored per range at begin / rangeSize.
+            The function must not throw and must only touch data owned by its range.
+        @param count The number of indices
+        @param rangeSize The number of indices per range
+        @param func The function to call for each range
+        */
+        void parallelFor(size_t count, size_t rangeSize, const RangeFunction& func);
+
+        /// The number of worker threads, not counting the calling thread
+        size_t getNumThreads(void) const { return mNumThreads; }
+
+        /// @copydoc Singleton::getSingleton()
+        static ThreadPool& getSingleton(void);
+        /// @copydoc Singleton::getSingleton()
+        static ThreadPool* getSingletonPtr(void);
+
+    private:
+        size_t mNumThreads;
+
+        /// Process ranges of the current loop until none are left
+        void processRanges(void);
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+        struct _OgreExport WorkerFunc OGRE_THREAD_WORKER_INHERIT
+        {
+            ThreadPool* mPool;
+
+            WorkerFunc(ThreadPool* pool) : mPool(pool) {}
+
+            void operator()();
+            void operator()() const;
+            void run();
+        };
+
+        void startThreads(void);
+        void workerLoop(void);
+
+        WorkerFunc* mWorkerFunc;
+        std::vector<OGRE_THREAD_TYPE*> mThreads;
+        OGRE_WQ_MUTEX(mMutex);
+        OGRE_WQ_THREAD_SYNCHRONISER(mWorkCondition);
+        OGRE_WQ_THREAD_SYNCHRONISER(mDoneCondition);
+        /// Incremented for each loop, wakes the workers
+        uint32 mGeneration;
+        size_t mBusyThreads;
+        bool mRunning;
+        bool mShuttingDown;
+#endif
+        /// The current loop, valid while it is running
+        const RangeFunction* mFunc;
+        size_t mCount;
+        size_t mRangeSize;
+        AtomicScalar<size_t> mNextRange;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
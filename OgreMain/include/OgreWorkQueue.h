@@ -84,6 +84,7 @@ namespace Ogre
         class _OgreExport Request : public UtilityAlloc
         {
             friend class WorkQueue;
+            friend class DefaultWorkQueueBase;
         protected:
             /// The request channel, as an integer 
             uint16 mChannel;
@@ -97,10 +98,13 @@ namespace Ogre
             RequestID mID;
             /// Abort Flag
             mutable bool mAborted;
+            /// Requests with a higher priority are processed first
+            Real mPriority;
 
         public:
             /// Constructor 
-            Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid);
+            Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid,
+                Real priority = 0);
             ~Request();
             /// Set the abort flag
             void abortRequest() const { mAborted = true; }
@@ -116,6 +120,8 @@ namespace Ogre
             RequestID getID() const { return mID; }
             /// Get the abort flag
             bool getAborted() const { return mAborted; }
+            /// Get the priority of this request
+            Real getPriority() const { return mPriority; }
         };
 
         /** General purpose response structure. 
@@ -273,9 +279,53 @@ namespace Ogre
         virtual RequestID addRequest(uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount = 0, 
             bool forceSynchronous = false, bool idleThread = false) = 0;
 
+        /** Add a new request to the queue, ahead of the waiting requests with a lower priority.
+        @remarks
+            Requests of equal priority are processed in the order they were added. Requests
+            added by addRequest have a priority of 0. Queues without support for priorities
+            treat this like addRequest.
+        @param channel The channel this request will go into
+        @param requestType An identifier that's unique within this queue which
+            identifies the type of the request (user decides the actual value)
+        @param rData The data required by the request process. 
+        @param priority The priority of the request, higher values are processed first
+        @param retryCount The number of times the request should be retried
+            if it fails.
+        @param forceSynchronous Forces the request to be processed immediately
+            even if threading is enabled.
+        @return The ID of the request that has been added
+        */
+        virtual RequestID addRequestWithPriority(uint16 channel, uint16 requestType, const Any& rData,
+            Real priority, uint8 retryCount = 0, bool forceSynchronous = false)
+        {
+            return addRequest(channel, requestType, rData, retryCount, forceSynchronous);
+        }
+
+        /** Change the priority of a request which is still waiting to be processed.
+        @param id The ID of the previously issued request.
+        @param priority The new priority, higher values are processed first
+        @retval true If the priority was changed.
+        @retval false If the request is already being processed or aborted, or the queue
+            does not support priorities.
+        */
+        virtual bool setRequestPriority(RequestID id, Real priority) { return false; }
+
+        /** Limit the number of requests of a channel which are processed at the same time.
+        @remarks
+            Requests over the limit wait in the queue, where their priority can still 
+            change and they can be aborted before any work is done for them. This keeps
+            long running requests such as loading from occupying all workers with work 
+            which may no longer be needed when it completes.
+        @param channel The channel to limit
+        @param maxRequests The number of requests, 0 for no limit (the default)
+        */
+        virtual void setMaxConcurrentRequests(uint16 channel, size_t maxRequests) {}
+        /// Get the number of requests of a channel which are processed at the same time, 0 for no limit
+        virtual size_t getMaxConcurrentRequests(uint16 channel) const { return 0; }
+
         /** Abort a previously issued request.
-        If the request is still waiting to be processed, it will be 
-        removed from the queue.
+        If the request is still waiting to be processed, no work is done for it. It is
+        only passed to the handlers with the abort flag set, so they can release its data.
         @param id The ID of the previously issued request.
         */
         virtual void abortRequest(RequestID id) = 0;
@@ -443,6 +493,15 @@ namespace Ogre
         /// @copydoc WorkQueue::addRequest
         virtual RequestID addRequest(uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount = 0, 
             bool forceSynchronous = false, bool idleThread = false);
+        /// @copydoc WorkQueue::addRequestWithPriority
+        virtual RequestID addRequestWithPriority(uint16 channel, uint16 requestType, const Any& rData,
+            Real priority, uint8 retryCount = 0, bool forceSynchronous = false);
+        /// @copydoc WorkQueue::setRequestPriority
+        virtual bool setRequestPriority(RequestID id, Real priority);
+        /// @copydoc WorkQueue::setMaxConcurrentRequests
+        virtual void setMaxConcurrentRequests(uint16 channel, size_t maxRequests);
+        /// @copydoc WorkQueue::getMaxConcurrentRequests
+        virtual size_t getMaxConcurrentRequests(uint16 channel) const;
         /// @copydoc WorkQueue::abortRequest
         virtual void abortRequest(RequestID id);
         /// @copydoc WorkQueue::abortPendingRequest
@@ -476,10 +535,14 @@ namespace Ogre
 
         typedef std::deque<Request*> RequestQueue;
         typedef std::deque<Response*> ResponseQueue;
-        RequestQueue mRequestQueue; // Guarded by mRequestMutex
+        RequestQueue mRequestQueue; // Guarded by mRequestMutex, ordered by priority
         RequestQueue mProcessQueue; // Guarded by mProcessMutex
         ResponseQueue mResponseQueue; // Guarded by mResponseMutex
 
+        typedef std::map<uint16, size_t> ChannelCountMap;
+        ChannelCountMap mMaxConcurrentRequests; // Guarded by mRequestMutex
+        ChannelCountMap mConcurrentRequests; // Guarded by mRequestMutex
+
         /// Thread function
         struct _OgreExport WorkerFunc OGRE_THREAD_WORKER_INHERIT
         {
@@ -574,7 +637,20 @@ namespace Ogre
         /// Notify workers about a new request. 
         virtual void notifyWorkers() = 0;
         /// Put a Request on the queue with a specific RequestID.
-        void addRequestWithRID(RequestID rid, uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount);
+        void addRequestWithRID(RequestID rid, uint16 channel, uint16 requestType, const Any& rData, uint8 retryCount,
+            Real priority);
+        /// Put a Request on the queue behind the requests of the same or a higher priority, mRequestMutex must be held
+        void insertRequest(Request* req);
+        /** Abort a request on the queue and move it to the front, mRequestMutex must be held
+        @remarks
+            It still passes through the handlers, which release its data, but it is not held back
+            by its priority or the limit of its channel.
+        */
+        void abortWaitingRequest(RequestQueue::iterator i);
+        /// Whether a request on the queue may be processed now, mRequestMutex must be held
+        bool hasProcessableRequest() const;
+        /// Take the next request which may be processed now off the queue, mRequestMutex must be held
+        Request* takeNextRequest();
         
         RequestQueue mIdleRequestQueue; // Guarded by mIdleMutex
         bool mIdleThreadRunning; // Guarded by mIdleMutex
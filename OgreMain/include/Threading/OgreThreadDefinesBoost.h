@@ -34,6 +34,7 @@ THE SOFTWARE
 #define OGRE_THREAD_CREATE(name, worker) boost::thread* name = OGRE_NEW_T(boost::thread, MEMCATEGORY_GENERAL)(worker)
 #define OGRE_THREAD_DESTROY(name) OGRE_DELETE_T(name, thread, MEMCATEGORY_GENERAL)
 #define OGRE_THREAD_CURRENT_ID boost::this_thread::get_id()
+#define OGRE_THREAD_ID_TYPE boost::thread::id
 #define OGRE_THREAD_HARDWARE_CONCURRENCY boost::thread::hardware_concurrency()
 #define OGRE_THREAD_WORKER_INHERIT
 
@@ -79,7 +80,6 @@ THE SOFTWARE
 #define OGRE_MUTEX_CONDITIONAL(mutex) if (mutex)
 
 // Utility
-#define OGRE_THREAD_ID_TYPE boost::thread::id
 #define OGRE_THREAD_YIELD boost::this_thread::yield()
 #endif
 
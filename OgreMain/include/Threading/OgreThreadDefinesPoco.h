@@ -35,6 +35,7 @@ THE SOFTWARE
 #define OGRE_THREAD_DESTROY(name) OGRE_DELETE_T(name, Thread, MEMCATEGORY_GENERAL)
 #define OGRE_THREAD_HARDWARE_CONCURRENCY Poco::Environment::processorCount()
 #define OGRE_THREAD_CURRENT_ID (size_t)Poco::Thread::current()
+#define OGRE_THREAD_ID_TYPE size_t
 #define OGRE_THREAD_WORKER_INHERIT : public Poco::Runnable
 
 #define OGRE_WQ_MUTEX(name) mutable Poco::Mutex name
@@ -68,7 +69,6 @@ THE SOFTWARE
 // (hardware concurrency is not accessible via POCO atm)
 // Utility
 #define OGRE_THREAD_SLEEP(ms) Poco::Thread::sleep(ms)
-#define OGRE_THREAD_ID_TYPE size_t
 #define OGRE_THREAD_YIELD Poco::Thread::yield()
 #endif
 
@@ -35,6 +35,7 @@ THE SOFTWARE
 #define OGRE_THREAD_DESTROY(name) OGRE_DELETE_T(name, thread, MEMCATEGORY_GENERAL)
 #define OGRE_THREAD_HARDWARE_CONCURRENCY std::thread::hardware_concurrency()
 #define OGRE_THREAD_CURRENT_ID std::this_thread::get_id()
+#define OGRE_THREAD_ID_TYPE std::thread::id
 #define OGRE_THREAD_WORKER_INHERIT
 
 #define OGRE_WQ_MUTEX(name) mutable std::recursive_mutex name
@@ -68,7 +69,6 @@ THE SOFTWARE
 #define OGRE_MUTEX_CONDITIONAL(mutex) if (mutex)
 
 // Utility
-#define OGRE_THREAD_ID_TYPE std::thread::id
 #define OGRE_THREAD_YIELD std::this_thread::yield()
 #endif
 
@@ -31,6 +31,7 @@ THE SOFTWARE
 
 #define OGRE_THREAD_HARDWARE_CONCURRENCY tbb::task_scheduler_init::default_num_threads()
 #define OGRE_THREAD_CURRENT_ID tbb::this_tbb_thread::get_id()
+#define OGRE_THREAD_ID_TYPE tbb::tbb_thread::id
 #define OGRE_THREAD_WORKER_INHERIT
 
 #define OGRE_WQ_MUTEX(name) mutable tbb::recursive_mutex name
@@ -60,7 +61,6 @@ THE SOFTWARE
 
 // Utility
 #define OGRE_THREAD_SLEEP(ms) tbb::this_tbb_thread::sleep(tbb::tick_count::interval_t(double(ms)/1000))
-#define OGRE_THREAD_ID_TYPE tbb::tbb_thread::id
 #define OGRE_THREAD_YIELD tbb::this_tbb_thread::yield()
 #endif
 
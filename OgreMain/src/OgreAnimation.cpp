@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 #include "OgreAnimation.h"
+#include "OgreCompressedAnimationClip.h"
 #include "OgreKeyFrame.h"
 #include "OgreEntity.h"
 #include "OgreSubEntity.h"
@@ -47,12 +48,14 @@ namespace Ogre {
         , mBaseKeyFrameTime(0.0f)
         , mBaseKeyFrameAnimationName(BLANKSTRING)
         , mContainer(0)
+        , mCompressedClip(0)
     {
     }
     //---------------------------------------------------------------------
     Animation::~Animation()
     {
         destroyAllTracks();
+        OGRE_DELETE mCompressedClip;
     }
     //---------------------------------------------------------------------
     Real Animation::getLength(void) const
@@ -63,6 +66,9 @@ namespace Ogre {
     void Animation::setLength(Real len)
     {
         mLength = len;
+        // the quantised key times are relative to the length
+        if (mCompressedClip)
+            mCompressedClip->setLength(len);
     }
     //---------------------------------------------------------------------
     NodeAnimationTrack* Animation::createNodeTrack(unsigned short handle)
@@ -347,6 +353,12 @@ namespace Ogre {
     {
         _applyBaseKeyFrame();
 
+        if (mCompressedClip)
+        {
+            mCompressedClip->apply(skel, timePos, weight, NULL, scale);
+            return;
+        }
+
         // Calculate time index for fast keyframe search
         TimeIndex timeIndex = _getTimeIndex(timePos);
 
@@ -366,6 +378,12 @@ namespace Ogre {
     {
         _applyBaseKeyFrame();
 
+        if (mCompressedClip)
+        {
+            mCompressedClip->apply(skel, timePos, weight, blendMask, scale);
+            return;
+        }
+
         // Calculate time index for fast keyframe search
       TimeIndex timeIndex = _getTimeIndex(timePos);
 
@@ -623,12 +641,33 @@ namespace Ogre {
         {
             i->second->_clone(newAnim);
         }
+        if (mCompressedClip)
+            newAnim->mCompressedClip = OGRE_NEW CompressedAnimationClip(*mCompressedClip);
 
         newAnim->_keyFrameListChanged();
         return newAnim;
 
     }
     //-----------------------------------------------------------------------
+    void Animation::compressNodeTracks(Real tolerance, bool destroyNodeTracks)
+    {
+        // keys are compressed in their final form
+        _applyBaseKeyFrame();
+
+        CompressedAnimationClip* clip = OGRE_NEW CompressedAnimationClip();
+        clip->build(this, tolerance);
+        _setCompressedClip(clip);
+
+        if (destroyNodeTracks)
+            destroyAllNodeTracks();
+    }
+    //-----------------------------------------------------------------------
+    void Animation::_setCompressedClip(CompressedAnimationClip* clip)
+    {
+        OGRE_DELETE mCompressedClip;
+        mCompressedClip = clip;
+    }
+    //-----------------------------------------------------------------------
     TimeIndex Animation::_getTimeIndex(Real timePos) const
     {
         // Uncomment following statement for work as previous
@@ -773,6 +812,24 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void Animation::_prepareForApply(void)
+    {
+        _applyBaseKeyFrame();
+
+        // builds the keyframe time list
+        TimeIndex timeIndex = _getTimeIndex(0);
+
+        // builds the splines of spline interpolated tracks
+        for (NodeTrackList::iterator i = mNodeTrackList.begin(); i != mNodeTrackList.end(); ++i)
+        {
+            if (i->second->getNumKeyFrames())
+            {
+                TransformKeyFrame kf(0, 0);
+                i->second->getInterpolatedKeyFrame(timeIndex, &kf);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::_notifyContainer(AnimationContainer* c)
     {
         mContainer = c;
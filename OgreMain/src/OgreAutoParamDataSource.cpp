@@ -34,6 +34,8 @@ THE SOFTWARE.
 #include "OgreViewport.h"
 
 namespace Ogre {
+    /// Shared by all sources, so a version never identifies the state of two sources
+    static uint64 gAutoParamVersionCounter = 0;
     //-----------------------------------------------------------------------------
     AutoParamDataSource::AutoParamDataSource()
         : mWorldMatrixCount(0),
@@ -64,8 +66,12 @@ namespace Ogre {
          mCurrentViewport(0), 
          mCurrentSceneManager(0),
          mMainCamBoundsInfo(0),
-         mCurrentPass(0)
+         mCurrentPass(0),
+         mGlobalVersion(0),
+         mObjectVersion(0),
+         mLightsVersion(0)
     {
+        notifyChanged(GPV_ALL);
         mBlankLight.setDiffuseColour(ColourValue::Black);
         mBlankLight.setSpecularColour(ColourValue::Black);
         mBlankLight.setAttenuation(0,1,0,0);
@@ -101,6 +107,14 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentRenderable(const Renderable* rend)
     {
+        // view and projection matrices are global, unless overridden by the renderable
+        bool identityView = rend && rend->getUseIdentityView();
+        bool identityProj = rend && rend->getUseIdentityProjection();
+        if (identityView != (mCurrentRenderable && mCurrentRenderable->getUseIdentityView()) ||
+            identityProj != (mCurrentRenderable && mCurrentRenderable->getUseIdentityProjection()))
+            notifyChanged(GPV_GLOBAL);
+        notifyChanged(GPV_PER_OBJECT);
+
         mCurrentRenderable = rend;
         mWorldMatrixDirty = true;
         mViewMatrixDirty = true;
@@ -125,6 +139,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentCamera(const Camera* cam, bool useCameraRelative)
     {
+        notifyChanged(GPV_GLOBAL);
         mCurrentCamera = cam;
         mCameraRelativeRendering = useCameraRelative;
         mCameraRelativePosition = cam->getDerivedPosition();
@@ -144,6 +159,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentLightList(const LightList* ll)
     {
+        notifyChanged(GPV_LIGHTS);
         mCurrentLightList = ll;
         for(size_t i = 0; i < ll->size() && i < OGRE_MAX_SIMULTANEOUS_LIGHTS; ++i)
         {
@@ -248,17 +264,20 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setMainCamBoundsInfo(VisibleObjectsBoundsInfo* info)
     {
+        notifyChanged(GPV_GLOBAL);
         mMainCamBoundsInfo = info;
         mSceneDepthRangeDirty = true;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentSceneManager(const SceneManager* sm)
     {
+        notifyChanged(GPV_GLOBAL);
         mCurrentSceneManager = sm;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setWorldMatrices(const Affine3* m, size_t count)
     {
+        notifyChanged(GPV_PER_OBJECT);
         mWorldMatrixArray = m;
         mWorldMatrixCount = count;
         mWorldMatrixDirty = false;
@@ -510,6 +529,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setAmbientLightColour(const ColourValue& ambient)
     {
+        notifyChanged(GPV_GLOBAL);
         mAmbientLight = ambient;
     }
     //---------------------------------------------------------------------
@@ -531,6 +551,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentPass(const Pass* pass)
     {
+        if (pass != mCurrentPass)
+            notifyChanged(GPV_GLOBAL);
         mCurrentPass = pass;
     }
     //-----------------------------------------------------------------------------
@@ -616,6 +638,7 @@ namespace Ogre {
         Real expDensity, Real linearStart, Real linearEnd)
     {
         (void)mode; // ignored
+        notifyChanged(GPV_GLOBAL);
         mFogColour = colour;
         mFogParams.x = expDensity;
         mFogParams.y = linearStart;
@@ -636,6 +659,7 @@ namespace Ogre {
     void AutoParamDataSource::setPointParameters(Real size, bool attenuation, Real constant,
                                                  Real linear, Real quadratic)
     {
+        notifyChanged(GPV_GLOBAL);
         mPointParams.x = size;
         if(attenuation)
             mPointParams.x *= getViewportHeight();
@@ -653,6 +677,7 @@ namespace Ogre {
     {
         if (index < OGRE_MAX_SIMULTANEOUS_LIGHTS)
         {
+            notifyChanged(GPV_LIGHTS);
             mCurrentTextureProjector[index] = frust;
             mTextureViewProjMatrixDirty[index] = true;
             mTextureWorldViewProjMatrixDirty[index] = true;
@@ -806,6 +831,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentRenderTarget(const RenderTarget* target)
     {
+        notifyChanged(GPV_GLOBAL);
         mCurrentRenderTarget = target;
     }
     //-----------------------------------------------------------------------------
@@ -816,16 +842,19 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setCurrentViewport(const Viewport* viewport)
     {
+        notifyChanged(GPV_GLOBAL);
         mCurrentViewport = viewport;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setShadowDirLightExtrusionDistance(Real dist)
     {
+        notifyChanged(GPV_GLOBAL);
         mDirLightExtrusionDistance = dist;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setShadowPointLightExtrusionDistance(Real dist)
     {
+        notifyChanged(GPV_GLOBAL);
         mPointLightExtrusionDistance = dist;
     }
     //-----------------------------------------------------------------------------
@@ -1056,14 +1085,43 @@ namespace Ogre {
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::setPassNumber(const int passNumber)
     {
+        if (passNumber != mPassNumber)
+            notifyChanged(GPV_GLOBAL);
         mPassNumber = passNumber;
     }
     //-----------------------------------------------------------------------------
     void AutoParamDataSource::incPassNumber(void)
     {
+        notifyChanged(GPV_GLOBAL);
         ++mPassNumber;
     }
     //-----------------------------------------------------------------------------
+    void AutoParamDataSource::notifyChanged(uint16 variability)
+    {
+        uint64 version = ++gAutoParamVersionCounter;
+        if (variability & GPV_GLOBAL)
+            mGlobalVersion = version;
+        if (variability & GPV_PER_OBJECT)
+            mObjectVersion = version;
+        if (variability & GPV_LIGHTS)
+            mLightsVersion = version;
+    }
+    //-----------------------------------------------------------------------------
+    uint64 AutoParamDataSource::getVersion(uint16 variability) const
+    {
+        // the pass iteration number is incremented in the parameters directly
+        if (variability & GPV_PASS_ITERATION_NUMBER)
+            return 0;
+
+        // all values depend on the camera, versions only ever increase
+        uint64 version = mGlobalVersion;
+        if (variability & GPV_PER_OBJECT)
+            version = std::max(version, mObjectVersion);
+        if (variability & GPV_LIGHTS)
+            version = std::max(version, mLightsVersion);
+        return version;
+    }
+    //-----------------------------------------------------------------------------
     const Vector4& AutoParamDataSource::getSceneDepthRange() const
     {
         static Vector4 dummy(0, 100000, 100000, 1.f/100000);
@@ -0,0 +1,288 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+#include "OgreBakedAnimationAtlas.h"
+#include "OgreSkeletonInstance.h"
+#include "OgreAnimation.h"
+#include "OgreAnimationState.h"
+
+namespace Ogre {
+    //---------------------------------------------------------------------
+    const size_t BakedAnimationAtlas::MAX_FRAMES = 65536;
+    //---------------------------------------------------------------------
+    BakedAnimationAtlas::BakedAnimationAtlas()
+        : mFramesPerSecond(0), mNumBones(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    void BakedAnimationAtlas::bake(const SkeletonPtr& skeleton, const StringVector& animations,
+                                   Real framesPerSecond)
+    {
+        if (framesPerSecond <= 0)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "The frame rate must be positive",
+                "BakedAnimationAtlas::bake");
+        }
+
+        skeleton->load();
+
+        // Instances select their frame with a 16 bit lookup number
+        size_t totalFrames = 0;
+        for (StringVector::const_iterator it = animations.begin(); it != animations.end(); ++it)
+        {
+            // Raises an exception for unknown animations
+            Real length = skeleton->getAnimation(*it)->getLength();
+            totalFrames += std::max<size_t>(1, static_cast<size_t>(Math::Ceil(length * framesPerSecond)));
+        }
+        if (totalFrames > MAX_FRAMES)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Baking the animations of " + skeleton->getName() +
+                " needs " + StringConverter::toString(totalFrames) + " frames, at most " +
+                StringConverter::toString(MAX_FRAMES) + " are supported. Lower the frame rate "
+                "or bake fewer animations.", "BakedAnimationAtlas::bake");
+        }
+
+        // Pose a private instance, the skeleton may be in use by entities
+        SkeletonInstance* instance = OGRE_NEW SkeletonInstance(skeleton);
+        instance->load();
+
+        mSkeletonName = skeleton->getName();
+        mFramesPerSecond = framesPerSecond;
+        mNumBones = instance->getNumBones();
+        mClips.clear();
+        mFrames.clear();
+
+        std::vector<Affine3> matrices(mNumBones);
+        AnimationStateSet states;
+        size_t numFrames = 0;
+        for (StringVector::const_iterator it = animations.begin(); it != animations.end(); ++it)
+        {
+            const Animation* anim = instance->getAnimation(*it);
+
+            Clip clip;
+            clip.name = *it;
+            clip.length = anim->getLength();
+            clip.firstFrame = numFrames;
+            clip.numFrames = std::max<size_t>(1, static_cast<size_t>(Math::Ceil(clip.length * framesPerSecond)));
+            numFrames += clip.numFrames;
+            mClips.push_back(clip);
+
+            AnimationState* state = states.createAnimationState(clip.name, 0, clip.length);
+            state->setEnabled(true);
+            for (size_t f = 0; f < clip.numFrames; ++f)
+            {
+                state->setTimePosition(std::min(f / framesPerSecond, clip.length));
+                instance->setAnimationState(states);
+                instance->_getBoneMatrices(&matrices[0]);
+
+                for (unsigned short b = 0; b < mNumBones; ++b)
+                {
+                    for (int row = 0; row < 3; ++row)
+                    {
+                        for (int col = 0; col < 4; ++col)
+                            mFrames.push_back(static_cast<float>(matrices[b][row][col]));
+                    }
+                }
+            }
+            states.removeAnimationState(clip.name);
+        }
+
+        OGRE_DELETE instance;
+
+        LogManager::getSingleton().stream()
+            << "Baked " << mClips.size() << " animations of skeleton " << mSkeletonName
+            << " into " << numFrames << " frames";
+    }
+    //---------------------------------------------------------------------
+    bool BakedAnimationAtlas::hasClips(const StringVector& animations, Real framesPerSecond) const
+    {
+        if (mFramesPerSecond != framesPerSecond)
+            return false;
+
+        for (StringVector::const_iterator it = animations.begin(); it != animations.end(); ++it)
+        {
+            bool found = false;
+            for (ClipList::const_iterator c = mClips.begin(); c != mClips.end() && !found; ++c)
+                found = c->name == *it;
+            if (!found)
+                return false;
+        }
+        return true;
+    }
+    //---------------------------------------------------------------------
+    size_t BakedAnimationAtlas::getClipIndex(const String& name) const
+    {
+        for (size_t i = 0; i < mClips.size(); ++i)
+        {
+            if (mClips[i].name == name)
+                return i;
+        }
+
+        OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "No baked animation named " + name,
+            "BakedAnimationAtlas::getClipIndex");
+    }
+    //---------------------------------------------------------------------
+    size_t BakedAnimationAtlas::getFrameIndex(size_t clipIndex, size_t frame) const
+    {
+        const Clip& clip = mClips.at(clipIndex);
+        return clip.firstFrame + frame % clip.numFrames;
+    }
+    //---------------------------------------------------------------------
+    size_t BakedAnimationAtlas::getFrameIndexAtTime(size_t clipIndex, Real timePos, bool loop) const
+    {
+        const Clip& clip = mClips.at(clipIndex);
+        if (loop && clip.length > 0)
+        {
+            timePos = std::fmod(timePos, clip.length);
+            if (timePos < 0)
+                timePos += clip.length;
+        }
+
+        Real frame = Math::Clamp<Real>(timePos * mFramesPerSecond + 0.5f, 0, Real(clip.numFrames));
+        size_t index = static_cast<size_t>(frame);
+        if (index >= clip.numFrames)
+            index = loop ? 0 : clip.numFrames - 1;
+        return clip.firstFrame + index;
+    }
+    //---------------------------------------------------------------------
+    String BakedAnimationAtlas::getDefaultFileName(const String& skeletonName)
+    {
+        String baseName, extension;
+        StringUtil::splitBaseFilename(skeletonName, baseName, extension);
+        return baseName + ".bakedanim";
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    BakedAnimationSerializer::BakedAnimationSerializer()
+    {
+        mVersion = "[BakedAnimationSerializer_v1.00]";
+    }
+    //---------------------------------------------------------------------
+    void BakedAnimationSerializer::exportAtlas(const BakedAnimationAtlas* atlas,
+        const String& filename, Endian endianMode)
+    {
+        std::fstream *f = OGRE_NEW_T(std::fstream, MEMCATEGORY_GENERAL)();
+        f->open(filename.c_str(), std::ios::binary | std::ios::out);
+        DataStreamPtr stream(OGRE_NEW FileStreamDataStream(f));
+
+        exportAtlas(atlas, stream, endianMode);
+
+        stream->close();
+    }
+    //---------------------------------------------------------------------
+    void BakedAnimationSerializer::exportAtlas(const BakedAnimationAtlas* atlas,
+        DataStreamPtr stream, Endian endianMode)
+    {
+        determineEndianness(endianMode);
+
+        mStream = stream;
+        if (!stream->isWriteable())
+        {
+            OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                "Unable to write to stream " + stream->getName(),
+                "BakedAnimationSerializer::exportAtlas");
+        }
+
+        writeFileHeader();
+
+        writeString(atlas->mSkeletonName);
+        uint16 numBones = atlas->mNumBones;
+        writeShorts(&numBones, 1);
+        float framesPerSecond = static_cast<float>(atlas->mFramesPerSecond);
+        writeFloats(&framesPerSecond, 1);
+
+        uint32 numClips = static_cast<uint32>(atlas->mClips.size());
+        writeInts(&numClips, 1);
+        for (BakedAnimationAtlas::ClipList::const_iterator it = atlas->mClips.begin();
+             it != atlas->mClips.end(); ++it)
+        {
+            writeString(it->name);
+            float length = static_cast<float>(it->length);
+            writeFloats(&length, 1);
+            uint32 numFrames = static_cast<uint32>(it->numFrames);
+            writeInts(&numFrames, 1);
+        }
+
+        if (!atlas->mFrames.empty())
+            writeFloats(&atlas->mFrames[0], atlas->mFrames.size());
+
+        mStream.reset();
+    }
+    //---------------------------------------------------------------------
+    void BakedAnimationSerializer::importAtlas(DataStreamPtr& stream, BakedAnimationAtlas* atlas)
+    {
+        // Determine endianness (must be the first thing we do!)
+        determineEndianness(stream);
+        readFileHeader(stream);
+
+        atlas->mSkeletonName = readString(stream);
+        uint16 numBones;
+        readShorts(stream, &numBones, 1);
+        atlas->mNumBones = numBones;
+        float framesPerSecond;
+        readFloats(stream, &framesPerSecond, 1);
+        atlas->mFramesPerSecond = framesPerSecond;
+
+        uint32 numClips;
+        readInts(stream, &numClips, 1);
+        atlas->mClips.resize(numClips);
+        size_t numFrames = 0;
+        for (uint32 i = 0; i < numClips; ++i)
+        {
+            BakedAnimationAtlas::Clip& clip = atlas->mClips[i];
+            clip.name = readString(stream);
+            float length;
+            readFloats(stream, &length, 1);
+            clip.length = length;
+            uint32 clipFrames;
+            readInts(stream, &clipFrames, 1);
+            clip.firstFrame = numFrames;
+            clip.numFrames = clipFrames;
+            numFrames += clipFrames;
+        }
+
+        if (numFrames > BakedAnimationAtlas::MAX_FRAMES)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, stream->getName() + " holds " +
+                StringConverter::toString(numFrames) + " frames, at most " +
+                StringConverter::toString(BakedAnimationAtlas::MAX_FRAMES) + " are supported",
+                "BakedAnimationSerializer::importAtlas");
+        }
+
+        atlas->mFrames.resize(numFrames * numBones * 12);
+        if (!atlas->mFrames.empty())
+            readFloats(stream, &atlas->mFrames[0], atlas->mFrames.size());
+
+        if (stream->eof() && stream->tell() != stream->size())
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Truncated baked animation file " + stream->getName(),
+                "BakedAnimationSerializer::importAtlas");
+        }
+    }
+}
@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include "OgreViewport.h"
 #include "OgreMovablePlane.h"
+#include "OgreFrameAllocator.h"
 
 namespace Ogre {
 
@@ -408,8 +409,8 @@ namespace Ogre {
         }
 
         //notify prerender scene
-        ListenerList listenersCopy = mListeners;
-        for (ListenerList::iterator i = listenersCopy.begin(); i != listenersCopy.end(); ++i)
+        frame_vector<Listener*> listenersCopy(mListeners.begin(), mListeners.end());
+        for (frame_vector<Listener*>::iterator i = listenersCopy.begin(); i != listenersCopy.end(); ++i)
         {
             (*i)->cameraPreRenderScene(this);
         }
@@ -418,10 +419,10 @@ namespace Ogre {
         mSceneMgr->_renderScene(this, vp, includeOverlays);
 
         // Listener list may have change
-        listenersCopy = mListeners;
+        listenersCopy.assign(mListeners.begin(), mListeners.end());
 
         //notify postrender scene
-        for (ListenerList::iterator i = listenersCopy.begin(); i != listenersCopy.end(); ++i)
+        for (frame_vector<Listener*>::iterator i = listenersCopy.begin(); i != listenersCopy.end(); ++i)
         {
             (*i)->cameraPostRenderScene(this);
         }
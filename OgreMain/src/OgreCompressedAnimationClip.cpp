@@ -0,0 +1,423 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreCompressedAnimationClip.h"
+#include "OgreAnimation.h"
+#include "OgreKeyFrame.h"
+#include "OgreBone.h"
+#include "OgreSkeleton.h"
+
+namespace Ogre {
+namespace
+{
+    /// Quantised key time of the end of the animation
+    const Real MAX_KEY_TIME = 65535;
+    /// The smallest three components of a unit quaternion are within +-1/sqrt(2)
+    const Real ROTATION_RANGE = Real(0.70710678118654752);
+    const Real ROTATION_STEPS = 32767;
+
+    uint16 quantise(Real value, Real offset, Real step)
+    {
+        if (step <= 0)
+            return 0;
+        return static_cast<uint16>(Math::Clamp<Real>(std::floor((value - offset) / step + 0.5f), 0, 65535));
+    }
+
+    /// Store the 3 smallest components in 15 bits each, the index of the largest in the top bits
+    void encodeRotation(Quaternion q, uint16* out)
+    {
+        q.normalise();
+        const Real* c = q.ptr();
+        int largest = 0;
+        for (int i = 1; i < 4; ++i)
+        {
+            if (std::abs(c[i]) > std::abs(c[largest]))
+                largest = i;
+        }
+        // q and -q are the same rotation, so the largest component can be made positive
+        Real sign = c[largest] < 0 ? -1 : 1;
+        for (int i = 0, j = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+            Real v = (c[i] * sign + ROTATION_RANGE) / (2 * ROTATION_RANGE) * ROTATION_STEPS;
+            out[j++] = static_cast<uint16>(Math::Clamp<Real>(std::floor(v + 0.5f), 0, ROTATION_STEPS));
+        }
+        out[0] |= static_cast<uint16>((largest >> 1) << 15);
+        out[1] |= static_cast<uint16>((largest & 1) << 15);
+    }
+
+    Quaternion decodeRotation(const uint16* in)
+    {
+        int largest = ((in[0] >> 15) << 1) | (in[1] >> 15);
+        Quaternion q;
+        Real* c = q.ptr();
+        Real sum = 0;
+        for (int i = 0, j = 0; i < 4; ++i)
+        {
+            if (i == largest)
+                continue;
+            Real v = (in[j++] & 0x7FFF) * (2 * ROTATION_RANGE / ROTATION_STEPS) - ROTATION_RANGE;
+            c[i] = v;
+            sum += v * v;
+        }
+        c[largest] = std::sqrt(std::max<Real>(0, 1 - sum));
+        return q;
+    }
+
+    Quaternion interpolateRotation(Real t, const Quaternion& a, const Quaternion& b, bool spherical)
+    {
+        return spherical ? Quaternion::Slerp(t, a, b, true) : Quaternion::nlerp(t, a, b, true);
+    }
+
+    /// Largest component difference, q and -q being equal for rotations
+    Real channelError(const Real* a, const Real* b, int dims)
+    {
+        Real sign = 1;
+        if (dims == 4 && a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3] < 0)
+            sign = -1;
+
+        Real error = 0;
+        for (int i = 0; i < dims; ++i)
+            error = std::max(error, std::abs(a[i] - b[i] * sign));
+        return error;
+    }
+
+    /** Pick the samples that must be kept as keys so that linear interpolation between
+        them stays within tolerance of all the other samples.
+    */
+    void fitChannel(const std::vector<Real>& times, const std::vector<Real>& values, int dims,
+                    bool spherical, Real tolerance, const Real* identity, std::vector<size_t>& keys)
+    {
+        keys.clear();
+        size_t count = times.size();
+
+        bool constant = true;
+        for (size_t i = 1; i < count && constant; ++i)
+            constant = channelError(&values[0], &values[i * dims], dims) <= tolerance;
+        if (constant)
+        {
+            // a channel staying at identity does not need any keys
+            if (channelError(&values[0], identity, dims) > tolerance)
+                keys.push_back(0);
+            return;
+        }
+
+        keys.push_back(0);
+        size_t anchor = 0;
+        for (size_t end = 2; end < count; ++end)
+        {
+            Real span = times[end] - times[anchor];
+            bool fits = true;
+            for (size_t i = anchor + 1; i < end && fits; ++i)
+            {
+                Real t = span > 0 ? (times[i] - times[anchor]) / span : 0;
+                Real interpolated[4];
+                if (dims == 4)
+                {
+                    Quaternion q = interpolateRotation(
+                        t, Quaternion(const_cast<Real*>(&values[anchor * 4])),
+                        Quaternion(const_cast<Real*>(&values[end * 4])), spherical);
+                    memcpy(interpolated, q.ptr(), sizeof(Real) * 4);
+                }
+                else
+                {
+                    for (int c = 0; c < dims; ++c)
+                        interpolated[c] = values[anchor * dims + c] +
+                                          (values[end * dims + c] - values[anchor * dims + c]) * t;
+                }
+                fits = channelError(interpolated, &values[i * dims], dims) <= tolerance;
+            }
+
+            if (!fits)
+            {
+                anchor = end - 1;
+                keys.push_back(anchor);
+            }
+        }
+        keys.push_back(count - 1);
+    }
+}
+    //---------------------------------------------------------------------
+    CompressedAnimationClip::CompressedAnimationClip()
+        : mLength(0), mSphericalRotation(false)
+    {
+        mKeyStart.push_back(0);
+    }
+    //---------------------------------------------------------------------
+    void CompressedAnimationClip::setLength(Real length)
+    {
+        if (mLength > 0 && length > 0)
+        {
+            Real scale = mLength / length;
+            for (size_t i = 0; i < mKeyTimes.size(); ++i)
+                mKeyTimes[i] = static_cast<uint16>(
+                    Math::Clamp<Real>(std::floor(mKeyTimes[i] * scale + 0.5f), 0, MAX_KEY_TIME));
+        }
+        mLength = length;
+    }
+    //---------------------------------------------------------------------
+    void CompressedAnimationClip::build(const Animation* anim, Real tolerance)
+    {
+        mLength = anim->getLength();
+        mSphericalRotation = anim->getRotationInterpolationMode() == Animation::RIM_SPHERICAL;
+        mHandles.clear();
+        mKeyStart.assign(1, 0);
+        mRanges.clear();
+        mKeyTimes.clear();
+        mKeyValues.clear();
+
+        // spline segments are approximated by sampling in between the keys
+        const int subdivisions = anim->getInterpolationMode() == Animation::IM_SPLINE ? 4 : 1;
+        const Real identityTranslate[3] = {0, 0, 0};
+        const Real identityRotate[4] = {1, 0, 0, 0};
+        const Real identityScale[3] = {1, 1, 1};
+
+        std::vector<Real> times, translates, rotations, scales;
+        std::vector<size_t> keys;
+        const Animation::NodeTrackList& tracks = anim->_getNodeTrackList();
+        for (Animation::NodeTrackList::const_iterator it = tracks.begin(); it != tracks.end(); ++it)
+        {
+            const NodeAnimationTrack* track = it->second;
+            unsigned short numKeyFrames = track->getNumKeyFrames();
+            // applying a track without keys does nothing
+            if (numKeyFrames == 0)
+                continue;
+
+            times.clear();
+            for (unsigned short k = 0; k < numKeyFrames; ++k)
+            {
+                Real time = track->getKeyFrame(k)->getTime();
+                if (k > 0)
+                {
+                    Real prev = times.back();
+                    for (int s = 1; s < subdivisions; ++s)
+                        times.push_back(prev + (time - prev) * s / subdivisions);
+                }
+                times.push_back(time);
+            }
+
+            translates.clear();
+            rotations.clear();
+            scales.clear();
+            TransformKeyFrame kf(0, 0);
+            Quaternion previous = Quaternion::IDENTITY;
+            for (size_t s = 0; s < times.size(); ++s)
+            {
+                track->getInterpolatedKeyFrame(TimeIndex(times[s]), &kf);
+                // keep neighbouring rotations in the same hemisphere, so they fit straight lines
+                Quaternion q = kf.getRotation();
+                if (q.Dot(previous) < 0)
+                    q = -q;
+                previous = q;
+                translates.insert(translates.end(), kf.getTranslate().ptr(), kf.getTranslate().ptr() + 3);
+                rotations.insert(rotations.end(), q.ptr(), q.ptr() + 4);
+                scales.insert(scales.end(), kf.getScale().ptr(), kf.getScale().ptr() + 3);
+            }
+
+            mHandles.push_back(it->first);
+            for (int channel = 0; channel < CH_COUNT; ++channel)
+            {
+                const std::vector<Real>& values =
+                    channel == CH_TRANSLATE ? translates : channel == CH_ROTATE ? rotations : scales;
+                const Real* identity =
+                    channel == CH_TRANSLATE ? identityTranslate
+                                            : channel == CH_ROTATE ? identityRotate : identityScale;
+                int dims = channel == CH_ROTATE ? 4 : 3;
+                fitChannel(times, values, dims, mSphericalRotation, tolerance, identity, keys);
+
+                // quantisation range of the kept keys
+                float range[6] = {0, 0, 0, 0, 0, 0};
+                if (channel != CH_ROTATE && !keys.empty())
+                {
+                    for (int c = 0; c < 3; ++c)
+                    {
+                        Real lo = values[keys[0] * 3 + c], hi = lo;
+                        for (size_t k = 1; k < keys.size(); ++k)
+                        {
+                            lo = std::min(lo, values[keys[k] * 3 + c]);
+                            hi = std::max(hi, values[keys[k] * 3 + c]);
+                        }
+                        range[c] = float(lo);
+                        range[c + 3] = float((hi - lo) / 65535);
+                    }
+                }
+                mRanges.insert(mRanges.end(), range, range + 6);
+
+                for (size_t k = 0; k < keys.size(); ++k)
+                {
+                    size_t s = keys[k];
+                    Real keyTime = mLength > 0 ? times[s] / mLength * MAX_KEY_TIME : 0;
+                    mKeyTimes.push_back(
+                        static_cast<uint16>(Math::Clamp<Real>(std::floor(keyTime + 0.5f), 0, MAX_KEY_TIME)));
+
+                    uint16 quantised[3];
+                    if (channel == CH_ROTATE)
+                    {
+                        encodeRotation(Quaternion(const_cast<Real*>(&values[s * 4])), quantised);
+                    }
+                    else
+                    {
+                        for (int c = 0; c < 3; ++c)
+                            quantised[c] = quantise(values[s * 3 + c], range[c], range[c + 3]);
+                    }
+                    mKeyValues.insert(mKeyValues.end(), quantised, quantised + 3);
+                }
+                mKeyStart.push_back(static_cast<uint32>(mKeyTimes.size()));
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    size_t CompressedAnimationClip::getNumKeys(size_t track, Channel channel) const
+    {
+        size_t index = track * CH_COUNT + channel;
+        return mKeyStart[index + 1] - mKeyStart[index];
+    }
+    //---------------------------------------------------------------------
+    size_t CompressedAnimationClip::getMemoryUsage(void) const
+    {
+        return sizeof(*this) + mHandles.size() * sizeof(unsigned short) +
+               mKeyStart.size() * sizeof(uint32) + mRanges.size() * sizeof(float) +
+               mKeyTimes.size() * sizeof(uint16) + mKeyValues.size() * sizeof(uint16);
+    }
+    //---------------------------------------------------------------------
+    Real CompressedAnimationClip::toKeyTime(Real timePos) const
+    {
+        if (mLength <= 0)
+            return 0;
+        // Wrap time
+        if (timePos > mLength)
+            timePos = std::fmod(timePos, mLength);
+        return timePos / mLength * MAX_KEY_TIME;
+    }
+    //---------------------------------------------------------------------
+    bool CompressedAnimationClip::findKeys(size_t channel, Real keyTime, uint32& key1, uint32& key2,
+                                           Real& t) const
+    {
+        uint32 begin = mKeyStart[channel], end = mKeyStart[channel + 1];
+        if (begin == end)
+            return false;
+
+        // Same rules as AnimationTrack::getKeyFramesAtTime, past the last key
+        // interpolate towards the first one
+        const uint16* times = &mKeyTimes[0];
+        uint32 i = static_cast<uint32>(std::lower_bound(times + begin, times + end, keyTime) - times);
+        Real t1, t2;
+        if (i == end)
+        {
+            key2 = begin;
+            t2 = MAX_KEY_TIME + times[begin];
+            key1 = end - 1;
+        }
+        else
+        {
+            key2 = i;
+            t2 = times[i];
+            key1 = (i != begin && keyTime < times[i]) ? i - 1 : i;
+        }
+        t1 = times[key1];
+        t = t2 > t1 ? (keyTime - t1) / (t2 - t1) : 0;
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void CompressedAnimationClip::sampleTrack(size_t track, Real keyTime, Vector3& translate,
+                                              Quaternion& rotate, Vector3& scale) const
+    {
+        size_t channel = track * CH_COUNT;
+        uint32 key1, key2;
+        Real t;
+
+        translate = Vector3::ZERO;
+        if (findKeys(channel + CH_TRANSLATE, keyTime, key1, key2, t))
+        {
+            const float* range = &mRanges[(channel + CH_TRANSLATE) * 6];
+            const uint16* v1 = &mKeyValues[key1 * 3];
+            const uint16* v2 = &mKeyValues[key2 * 3];
+            for (int c = 0; c < 3; ++c)
+                translate[c] = range[c] + (v1[c] + (Real(v2[c]) - v1[c]) * t) * range[c + 3];
+        }
+
+        rotate = Quaternion::IDENTITY;
+        if (findKeys(channel + CH_ROTATE, keyTime, key1, key2, t))
+        {
+            rotate = decodeRotation(&mKeyValues[key1 * 3]);
+            if (t != 0)
+                rotate = interpolateRotation(t, rotate, decodeRotation(&mKeyValues[key2 * 3]),
+                                             mSphericalRotation);
+        }
+
+        scale = Vector3::UNIT_SCALE;
+        if (findKeys(channel + CH_SCALE, keyTime, key1, key2, t))
+        {
+            const float* range = &mRanges[(channel + CH_SCALE) * 6];
+            const uint16* v1 = &mKeyValues[key1 * 3];
+            const uint16* v2 = &mKeyValues[key2 * 3];
+            for (int c = 0; c < 3; ++c)
+                scale[c] = range[c] + (v1[c] + (Real(v2[c]) - v1[c]) * t) * range[c + 3];
+        }
+    }
+    //---------------------------------------------------------------------
+    void CompressedAnimationClip::sample(Real timePos, Vector3* translates, Quaternion* rotations,
+                                         Vector3* scales) const
+    {
+        Real keyTime = toKeyTime(timePos);
+        for (size_t i = 0; i < mHandles.size(); ++i)
+            sampleTrack(i, keyTime, translates[i], rotations[i], scales[i]);
+    }
+    //---------------------------------------------------------------------
+    void CompressedAnimationClip::apply(Skeleton* skeleton, Real timePos, Real weight,
+                                        const AnimationState::BoneBlendMask* blendMask,
+                                        Real scl) const
+    {
+        Real keyTime = toKeyTime(timePos);
+        for (size_t i = 0; i < mHandles.size(); ++i)
+        {
+            Bone* bone = skeleton->getBone(mHandles[i]);
+            Real boneWeight = blendMask ? (*blendMask)[bone->getHandle()] * weight : weight;
+            if (!boneWeight)
+                continue;
+
+            Vector3 translate, scale;
+            Quaternion rotate;
+            sampleTrack(i, keyTime, translate, rotate, scale);
+
+            // Same as NodeAnimationTrack::applyToNode
+            bone->translate(translate * boneWeight * scl);
+            bone->rotate(interpolateRotation(boneWeight, Quaternion::IDENTITY, rotate, mSphericalRotation));
+
+            if (scale != Vector3::UNIT_SCALE)
+            {
+                if (scl != 1.0f)
+                    scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * scl;
+                else if (boneWeight != 1.0f)
+                    scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * boneWeight;
+            }
+            bone->scale(scale);
+        }
+    }
+}
@@ -29,10 +29,81 @@ THE SOFTWARE.
 #include "OgreEdgeListBuilder.h"
 #include "OgreVertexIndexData.h"
 #include "OgreOptimisedUtil.h"
+#include "OgreThreadPool.h"
 
 namespace Ogre {
 
-    EdgeData::EdgeData() : isClosed(false){}
+    namespace
+    {
+        const size_t EMPTY_SLOT = static_cast<size_t>(~0);
+        /// Triangles read per parallel range
+        const size_t TRIANGLE_RANGE_SIZE = 4096;
+        /// Triangles tested for light facing per parallel range
+        const size_t LIGHT_FACING_RANGE_SIZE = 16384;
+
+        AtomicScalar<uint32> gNextFaceNormalsVersion(0);
+
+        uint32 floatBits(float f)
+        {
+            // -0 and 0 are the same position
+            if (f == 0)
+                f = 0;
+            uint32 bits;
+            memcpy(&bits, &f, sizeof(bits));
+            return bits;
+        }
+
+        /// 64 bit finaliser, so the low bits can be masked
+        uint64 mixBits(uint64 h)
+        {
+            h ^= h >> 33;
+            h *= 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+            h *= 0xc4ceb9fe1a85ec53ULL;
+            h ^= h >> 33;
+            return h;
+        }
+
+        /// Hash of the exact position
+        uint32 hashPosition(const Vector3& v)
+        {
+            uint64 h = floatBits(static_cast<float>(v.x));
+            h = (h << 32) | floatBits(static_cast<float>(v.y));
+            h = mixBits(h) ^ floatBits(static_cast<float>(v.z));
+            return static_cast<uint32>(mixBits(h));
+        }
+
+        size_t hashEdge(size_t sharedVertIndex0, size_t sharedVertIndex1)
+        {
+            uint64 key = (static_cast<uint64>(sharedVertIndex0) << 32) ^ static_cast<uint64>(sharedVertIndex1);
+            return static_cast<size_t>(mixBits(key));
+        }
+
+        /// Power of two number of slots keeping a hash table at most half full
+        size_t tableSizeFor(size_t numEntries)
+        {
+            size_t size = 16;
+            while (size < numEntries * 2)
+                size <<= 1;
+            return size;
+        }
+
+        size_t countTriangles(const IndexData* indexData, RenderOperation::OperationType opType)
+        {
+            switch (opType)
+            {
+            case RenderOperation::OT_TRIANGLE_LIST:
+                return indexData->indexCount / 3;
+            case RenderOperation::OT_TRIANGLE_FAN:
+            case RenderOperation::OT_TRIANGLE_STRIP:
+                return indexData->indexCount >= 3 ? indexData->indexCount - 2 : 0;
+            default:
+                return 0; // Just in case
+            }
+        }
+    }
+
+    EdgeData::EdgeData() : isClosed(false), faceNormalsVersion(++gNextFaceNormalsVersion){}
     
     void EdgeData::log(Log* l)
     {
@@ -75,7 +146,7 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     EdgeListBuilder::EdgeListBuilder()
-        : mEdgeData(0)
+        : mEdgeData(0), mNumEdgeKeys(0), mNumPendingEdges(0)
     {
     }
     //---------------------------------------------------------------------
@@ -181,19 +252,34 @@ namespace Ogre {
             mEdgeData->edgeGroups[vSet].triCount = 0;
         }
 
-        // Build triangles and edge list
+        // Size the common vertex table, there can't be more common vertices than
+        // vertices. The edge table only holds unconnected edges, it grows as needed.
+        size_t numVertices = 0;
+        for (VertexDataList::const_iterator v = mVertexDataList.begin(); v != mVertexDataList.end(); ++v)
+            numVertices += (*v)->vertexCount;
+        mVertices.reserve(mVertices.size() + numVertices);
+        if (mCommonVertexTable.size() < tableSizeFor(mVertices.capacity()))
+            growCommonVertexTable();
+        if (mEdgeTable.empty())
+        {
+            PendingEdgeList emptySlot = {{EMPTY_SLOT, EMPTY_SLOT}, EMPTY_SLOT, EMPTY_SLOT};
+            mEdgeTable.assign(tableSizeFor(256), emptySlot);
+        }
+
         GeometryList::const_iterator i, iend;
         iend = mGeometryList.end();
+        // Build triangles and edge list
         for (i = mGeometryList.begin(); i != iend; ++i)
         {
             buildTrianglesEdges(*i);
         }
+        mRawTriangles.clear();
 
         // Allocate memory for light facing calculate
         mEdgeData->triangleLightFacings.resize(mEdgeData->triangles.size());
 
         // Record closed, ie the mesh is manifold
-        mEdgeData->isClosed = mEdgeMap.empty();
+        mEdgeData->isClosed = mNumPendingEdges == 0;
 
         return mEdgeData;
     }
@@ -202,44 +288,14 @@ namespace Ogre {
     {
         size_t indexSet = geometry.indexSet;
         size_t vertexSet = geometry.vertexSet;
-        const IndexData* indexData = geometry.indexData;
-        RenderOperation::OperationType opType = geometry.opType;
-
-        size_t iterations;
-        
-        switch (opType)
-        {
-        case RenderOperation::OT_TRIANGLE_LIST:
-            iterations = indexData->indexCount / 3;
-            break;
-        case RenderOperation::OT_TRIANGLE_FAN:
-        case RenderOperation::OT_TRIANGLE_STRIP:
-            iterations = indexData->indexCount - 2;
-            break;
-        default:
-            return; // Just in case
-        };
+        size_t iterations = countTriangles(geometry.indexData, geometry.opType);
 
         // The edge group now we are dealing with.
         EdgeData::EdgeGroup& eg = mEdgeData->edgeGroups[vertexSet];
 
-        // locate position element & the buffer to go with it
-        const VertexData* vertexData = mVertexDataList[vertexSet];
-        const VertexElement* posElem = vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
-        HardwareVertexBufferSharedPtr vbuf = 
-            vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
-        // lock the buffer for reading
-        HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::HBL_READ_ONLY);
-        unsigned char* pBaseVertex = static_cast<unsigned char*>(vertexLock.pData);
-
-        // Get the indexes ready for reading
-        bool idx32bit = (indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_32BIT);
-        HardwareBufferLockGuard indexLock(indexData->indexBuffer, HardwareBuffer::HBL_READ_ONLY);
-        unsigned short* p16Idx = static_cast<unsigned short*>(indexLock.pData) + indexData->indexStart;
-        unsigned int* p32Idx = static_cast<unsigned int*>(indexLock.pData) + indexData->indexStart;
+        // Reading the triangles doesn't depend on the other geometries
+        readTriangles(geometry, iterations);
 
-        // Iterate over all the groups of 3 indexes
-        unsigned int index[3];
         // Get the triangle start, if we have more than one index set then this
         // will not be zero
         size_t triangleIndex = mEdgeData->triangles.size();
@@ -252,62 +308,23 @@ namespace Ogre {
         // Pre-reserve memory for less thrashing
         mEdgeData->triangles.reserve(triangleIndex + iterations);
         mEdgeData->triangleFaceNormals.reserve(triangleIndex + iterations);
+
+        // Common vertices and edges are numbered in the order they are found,
+        // so they are connected serially
         for (size_t t = 0; t < iterations; ++t)
         {
+            const RawTriangle& raw = mRawTriangles[t];
             EdgeData::Triangle tri;
             tri.indexSet = indexSet;
             tri.vertexSet = vertexSet;
 
-            if (opType == RenderOperation::OT_TRIANGLE_LIST || t == 0)
-            {
-                // Standard 3-index read for tri list or first tri in strip / fan
-                if (idx32bit)
-                {
-                    index[0] = p32Idx[0];
-                    index[1] = p32Idx[1];
-                    index[2] = p32Idx[2];
-                    p32Idx += 3;
-                }
-                else
-                {
-                    index[0] = p16Idx[0];
-                    index[1] = p16Idx[1];
-                    index[2] = p16Idx[2];
-                    p16Idx += 3;
-                }
-            }
-            else
-            {
-                // Strips are formed from last 2 indexes plus the current one for
-                // triangles after the first.
-                // For fans, all the triangles share the first vertex, plus last
-                // one index and the current one for triangles after the first.
-                // We also make sure that all the triangles are process in the
-                // _anti_ clockwise orientation
-                index[(opType == RenderOperation::OT_TRIANGLE_STRIP) && (t & 1) ? 0 : 1] = index[2];
-                // Read for the last tri index
-                if (idx32bit)
-                    index[2] = *p32Idx++;
-                else
-                    index[2] = *p16Idx++;
-            }
-
-            Vector3 v[3];
             for (size_t i = 0; i < 3; ++i)
             {
                 // Populate tri original vertex index
-                tri.vertIndex[i] = index[i];
-
-                // Retrieve the vertex position
-                unsigned char* pVertex = pBaseVertex + (index[i] * vbuf->getVertexSize());
-                float* pFloat;
-                posElem->baseVertexPointerToElement(pVertex, &pFloat);
-                v[i].x = *pFloat++;
-                v[i].y = *pFloat++;
-                v[i].z = *pFloat++;
+                tri.vertIndex[i] = raw.index[i];
                 // find this vertex in the existing vertex map, or create it
-                tri.sharedVertIndex[i] = 
-                    findOrCreateCommonVertex(v[i], vertexSet, indexSet, index[i]);
+                tri.sharedVertIndex[i] = findOrCreateCommonVertex(
+                    raw.position[i], raw.hash[i], vertexSet, indexSet, raw.index[i]);
             }
 
             // Ignore degenerate triangle
@@ -317,8 +334,7 @@ namespace Ogre {
             {
                 // Calculate triangle normal (NB will require recalculation for 
                 // skeletally animated meshes)
-                mEdgeData->triangleFaceNormals.push_back(
-                    Math::calculateFaceNormalWithoutNormalize(v[0], v[1], v[2]));
+                mEdgeData->triangleFaceNormals.push_back(raw.faceNormal);
                 // Add triangle to list
                 mEdgeData->triangles.push_back(tri);
                 // Connect or create edges from common list
@@ -340,29 +356,119 @@ namespace Ogre {
         eg.triCount = triangleIndex - eg.triStart;
     }
     //---------------------------------------------------------------------
+    void EdgeListBuilder::readTriangles(const Geometry &geometry, size_t numTriangles)
+    {
+        const IndexData* indexData = geometry.indexData;
+        RenderOperation::OperationType opType = geometry.opType;
+
+        // locate position element & the buffer to go with it
+        const VertexData* vertexData = mVertexDataList[geometry.vertexSet];
+        const VertexElement* posElem = vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        HardwareVertexBufferSharedPtr vbuf = 
+            vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+        const size_t vertexSize = vbuf->getVertexSize();
+        // lock the buffer for reading
+        HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::HBL_READ_ONLY);
+        unsigned char* pBaseVertex = static_cast<unsigned char*>(vertexLock.pData);
+
+        // Get the indexes ready for reading
+        bool idx32bit = (indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_32BIT);
+        HardwareBufferLockGuard indexLock(indexData->indexBuffer, HardwareBuffer::HBL_READ_ONLY);
+        const unsigned short* p16Idx = static_cast<unsigned short*>(indexLock.pData) + indexData->indexStart;
+        const unsigned int* p32Idx = static_cast<unsigned int*>(indexLock.pData) + indexData->indexStart;
+
+        mRawTriangles.resize(numTriangles);
+
+        ThreadPool::RangeFunction readRange = [&](size_t begin, size_t end)
+        {
+            for (size_t t = begin; t < end; ++t)
+            {
+                RawTriangle& raw = mRawTriangles[t];
+
+                // Lists use 3 indexes per triangle. Strips are formed from the last 2
+                // indexes plus the current one, fans share the first index and use the
+                // last and the current one. We also make sure that all the triangles
+                // are processed in the _anti_ clockwise orientation.
+                size_t first = opType == RenderOperation::OT_TRIANGLE_LIST ? t * 3 : t;
+                for (size_t i = 0; i < 3; ++i)
+                    raw.index[i] = idx32bit ? p32Idx[first + i] : p16Idx[first + i];
+                if (opType == RenderOperation::OT_TRIANGLE_STRIP && (t & 1))
+                    std::swap(raw.index[0], raw.index[1]);
+                else if (opType == RenderOperation::OT_TRIANGLE_FAN)
+                    raw.index[0] = idx32bit ? p32Idx[0] : p16Idx[0];
+
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    // Retrieve the vertex position
+                    unsigned char* pVertex = pBaseVertex + (raw.index[i] * vertexSize);
+                    float* pFloat;
+                    posElem->baseVertexPointerToElement(pVertex, &pFloat);
+                    raw.position[i].x = pFloat[0];
+                    raw.position[i].y = pFloat[1];
+                    raw.position[i].z = pFloat[2];
+                    raw.hash[i] = hashPosition(raw.position[i]);
+                }
+
+                raw.faceNormal = Math::calculateFaceNormalWithoutNormalize(
+                    raw.position[0], raw.position[1], raw.position[2]);
+            }
+        };
+
+        if (ThreadPool* pool = ThreadPool::getSingletonPtr())
+            pool->parallelFor(numTriangles, TRIANGLE_RANGE_SIZE, readRange);
+        else
+            readRange(0, numTriangles);
+    }
+    //---------------------------------------------------------------------
     void EdgeListBuilder::connectOrCreateEdge(size_t vertexSet, size_t triangleIndex, 
         size_t vertIndex0, size_t vertIndex1, size_t sharedVertIndex0, 
         size_t sharedVertIndex1)
     {
         // Find the existing edge (should be reversed order) on shared vertices
-        EdgeMap::iterator emi = mEdgeMap.find(std::pair<size_t, size_t>(sharedVertIndex1, sharedVertIndex0));
-        if (emi != mEdgeMap.end())
+        size_t reversedSlot = findEdgeSlot(sharedVertIndex1, sharedVertIndex0);
+        PendingEdgeList& reversed = mEdgeTable[reversedSlot];
+        if (reversed.sharedVertIndex[0] != EMPTY_SLOT)
         {
             // The edge already exist, connect it
-            EdgeData::Edge& e = mEdgeData->edgeGroups[emi->second.first].edges[emi->second.second];
+            const PendingEdge& pending = mPendingEdges[reversed.first];
+            EdgeData::Edge& e = mEdgeData->edgeGroups[pending.vertexSet].edges[pending.edgeIndex];
             // update with second side
             e.triIndex[1] = triangleIndex;
             e.degenerate = false;
 
-            // Remove from the edge map, so we never supplied to connect edge again
-            mEdgeMap.erase(emi);
+            // Remove from the pending edges, so we never supplied to connect edge again
+            reversed.first = pending.next;
+            --mNumPendingEdges;
+            if (reversed.first == EMPTY_SLOT)
+                eraseEdgeSlot(reversedSlot);
         }
         else
         {
             // Not found, create new edge
-            mEdgeMap.insert(EdgeMap::value_type(
-                std::pair<size_t, size_t>(sharedVertIndex0, sharedVertIndex1),
-                std::pair<size_t, size_t>(vertexSet, mEdgeData->edgeGroups[vertexSet].edges.size())));
+            if ((mNumEdgeKeys + 1) * 2 > mEdgeTable.size())
+                growEdgeTable();
+
+            PendingEdgeList& list = mEdgeTable[findEdgeSlot(sharedVertIndex0, sharedVertIndex1)];
+            // Queue behind the edges already waiting on the same vertices
+            PendingEdge pending;
+            pending.vertexSet = vertexSet;
+            pending.edgeIndex = mEdgeData->edgeGroups[vertexSet].edges.size();
+            pending.next = EMPTY_SLOT;
+            if (list.sharedVertIndex[0] == EMPTY_SLOT)
+            {
+                list.sharedVertIndex[0] = sharedVertIndex0;
+                list.sharedVertIndex[1] = sharedVertIndex1;
+                list.first = mPendingEdges.size();
+                ++mNumEdgeKeys;
+            }
+            else
+            {
+                mPendingEdges[list.last].next = mPendingEdges.size();
+            }
+            list.last = mPendingEdges.size();
+            mPendingEdges.push_back(pending);
+            ++mNumPendingEdges;
+
             EdgeData::Edge e;
             e.degenerate = true; // initialise as degenerate
 
@@ -377,19 +483,74 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
-    size_t EdgeListBuilder::findOrCreateCommonVertex(const Vector3& vec, 
+    size_t EdgeListBuilder::findEdgeSlot(size_t sharedVertIndex0, size_t sharedVertIndex1) const
+    {
+        const size_t mask = mEdgeTable.size() - 1;
+        size_t slot = hashEdge(sharedVertIndex0, sharedVertIndex1) & mask;
+        while (true)
+        {
+            const PendingEdgeList& list = mEdgeTable[slot];
+            if (list.sharedVertIndex[0] == EMPTY_SLOT ||
+                (list.sharedVertIndex[0] == sharedVertIndex0 && list.sharedVertIndex[1] == sharedVertIndex1))
+            {
+                return slot;
+            }
+            slot = (slot + 1) & mask;
+        }
+    }
+    //---------------------------------------------------------------------
+    void EdgeListBuilder::eraseEdgeSlot(size_t slot)
+    {
+        // Linear probing needs no gaps between a key's home slot and its slot
+        const size_t mask = mEdgeTable.size() - 1;
+        size_t next = (slot + 1) & mask;
+        while (mEdgeTable[next].sharedVertIndex[0] != EMPTY_SLOT)
+        {
+            const PendingEdgeList& list = mEdgeTable[next];
+            size_t home = hashEdge(list.sharedVertIndex[0], list.sharedVertIndex[1]) & mask;
+            // Move back unless the home slot lies after the gap, cyclically
+            if (((next - home) & mask) >= ((next - slot) & mask))
+            {
+                mEdgeTable[slot] = list;
+                slot = next;
+            }
+            next = (next + 1) & mask;
+        }
+        mEdgeTable[slot].sharedVertIndex[0] = EMPTY_SLOT;
+        --mNumEdgeKeys;
+    }
+    //---------------------------------------------------------------------
+    void EdgeListBuilder::growEdgeTable(void)
+    {
+        PendingEdgeList emptySlot = {{EMPTY_SLOT, EMPTY_SLOT}, EMPTY_SLOT, EMPTY_SLOT};
+        std::vector<PendingEdgeList> oldTable(std::max<size_t>(16, mEdgeTable.size() * 2), emptySlot);
+        oldTable.swap(mEdgeTable);
+
+        for (std::vector<PendingEdgeList>::const_iterator i = oldTable.begin(); i != oldTable.end(); ++i)
+        {
+            if (i->sharedVertIndex[0] != EMPTY_SLOT)
+                mEdgeTable[findEdgeSlot(i->sharedVertIndex[0], i->sharedVertIndex[1])] = *i;
+        }
+    }
+    //---------------------------------------------------------------------
+    size_t EdgeListBuilder::findOrCreateCommonVertex(const Vector3& vec, uint32 hash,
         size_t vertexSet, size_t indexSet, size_t originalIndex)
     {
         // Because the algorithm doesn't care about manifold or not, we just identifying
         // the common vertex by EXACT same position.
-        // Hint: We can use quantize method for welding almost same position vertex fastest.
-        std::pair<CommonVertexMap::iterator, bool> inserted =
-            mCommonVertexMap.insert(CommonVertexMap::value_type(vec, mVertices.size()));
-        if (!inserted.second)
+        const size_t mask = mCommonVertexTable.size() - 1;
+        size_t slot = hash & mask;
+        while (mCommonVertexTable[slot] != EMPTY_SLOT)
         {
-            // Already existing, return old one
-            return inserted.first->second;
+            const CommonVertex& common = mVertices[mCommonVertexTable[slot]];
+            if (common.position == vec)
+            {
+                // Already existing, return old one
+                return common.index;
+            }
+            slot = (slot + 1) & mask;
         }
+
         // Not found, insert
         CommonVertex newCommon;
         newCommon.index = mVertices.size();
@@ -398,9 +559,29 @@ namespace Ogre {
         newCommon.indexSet = indexSet;
         newCommon.originalIndex = originalIndex;
         mVertices.push_back(newCommon);
+        mCommonVertexTable[slot] = newCommon.index;
+
+        // Only happens when indexes reference vertices past the vertex count
+        if (mVertices.size() * 2 > mCommonVertexTable.size())
+            growCommonVertexTable();
+
         return newCommon.index;
     }
     //---------------------------------------------------------------------
+    void EdgeListBuilder::growCommonVertexTable(void)
+    {
+        mCommonVertexTable.assign(tableSizeFor(std::max(mVertices.capacity(), mVertices.size() * 2)),
+                                  EMPTY_SLOT);
+        const size_t mask = mCommonVertexTable.size() - 1;
+        for (CommonVertexList::const_iterator i = mVertices.begin(); i != mVertices.end(); ++i)
+        {
+            size_t slot = hashPosition(i->position) & mask;
+            while (mCommonVertexTable[slot] != EMPTY_SLOT)
+                slot = (slot + 1) & mask;
+            mCommonVertexTable[slot] = i->index;
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     void EdgeData::updateTriangleLightFacing(const Vector4& lightPos)
     {
@@ -410,11 +591,25 @@ namespace Ogre {
         // Use optimised util to determine if triangle's face normal are light facing
         if(!triangleFaceNormals.empty())
         {
-            OptimisedUtil::getImplementation()->calculateLightFacing(
-                lightPos,
-                &triangleFaceNormals.front(),
-                &triangleLightFacings.front(),
-                triangleLightFacings.size());
+            OptimisedUtil* util = OptimisedUtil::getImplementation();
+            ThreadPool* pool = ThreadPool::getSingletonPtr();
+            if (pool && triangleFaceNormals.size() > LIGHT_FACING_RANGE_SIZE)
+            {
+                pool->parallelFor(triangleFaceNormals.size(), LIGHT_FACING_RANGE_SIZE,
+                    [&](size_t begin, size_t end)
+                    {
+                        util->calculateLightFacing(lightPos, &triangleFaceNormals[begin],
+                                                   &triangleLightFacings[begin], end - begin);
+                    });
+            }
+            else
+            {
+                util->calculateLightFacing(
+                    lightPos,
+                    &triangleFaceNormals.front(),
+                    &triangleLightFacings.front(),
+                    triangleLightFacings.size());
+            }
         }
     }
     //---------------------------------------------------------------------
@@ -431,6 +626,7 @@ namespace Ogre {
         const EdgeData::EdgeGroup& eg = edgeGroups[vertexSet];
         if (eg.triCount != 0) 
         {
+            faceNormalsVersion = ++gNextFaceNormalsVersion;
             HardwareBufferLockGuard positionsLock(positionBuffer, HardwareBuffer::HBL_READ_ONLY);
             OptimisedUtil::getImplementation()->calculateFaceNormals(
                 static_cast<float*>(positionsLock.pData),
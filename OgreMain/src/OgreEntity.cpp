@@ -30,6 +30,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreSubEntity.h"
 #include "OgreTagPoint.h"
 #include "OgreSkeletonInstance.h"
+#include "OgreSkeletonManager.h"
 #include "OgreOptimisedUtil.h"
 #include "OgreLodStrategy.h"
 #include "OgreLodListener.h"
@@ -1410,7 +1411,22 @@ namespace Ogre {
             (hasSkeleton() && getSkeleton()->getManualBonesDirty()))
         {
             if ((!mSkipAnimStateUpdates) && (*mFrameBonesLastUpdated != currentFrameNumber))
+            {
+                // Entities that need their bones posed evaluate their own skeleton, the others
+                // may share the bone matrices of other entities playing the same animations
+                if (mChildObjectList.empty() && !mSharedSkeletonEntities && !mDisplaySkeleton &&
+                    !mUpdateBoundingBoxFromSkeleton && !mAlwaysUpdateMainSkeleton &&
+                    !mSkeletonInstance->hasManualBones())
+                {
+                    SkeletonManager::getSingleton().getEvaluationCache()._getBoneMatrices(
+                        mMesh->getSkeleton().get(), mSkeletonInstance, *mAnimationState,
+                        currentFrameNumber, mBoneMatrices);
+                    *mFrameBonesLastUpdated = currentFrameNumber;
+
+                    return true;
+                }
                 mSkeletonInstance->setAnimationState(*mAnimationState);
+            }
             mSkeletonInstance->_getBoneMatrices(mBoneMatrices);
             *mFrameBonesLastUpdated  = currentFrameNumber;
 
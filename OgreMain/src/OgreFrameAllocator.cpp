@@ -0,0 +1,130 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreFrameAllocator.h"
+#include "OgreBitwise.h"
+
+namespace Ogre {
+
+    //-----------------------------------------------------------------------
+    template<> FrameMemory* Singleton<FrameMemory>::msSingleton = 0;
+    FrameMemory* FrameMemory::getSingletonPtr(void)
+    {
+        return msSingleton;
+    }
+    FrameMemory& FrameMemory::getSingleton(void)
+    {
+        assert( msSingleton );  return ( *msSingleton );
+    }
+    //-----------------------------------------------------------------------
+    FrameMemory::FrameMemory(size_t initialSize)
+        : mChunk(0), mChunkStart(0), mChunkEnd(0), mTop(0), mLast(0), mUsed(0), mPeak(0),
+          mCapacity(0), mOwnerThread(std::this_thread::get_id())
+    {
+        addChunk(initialSize);
+    }
+    //-----------------------------------------------------------------------
+    FrameMemory::~FrameMemory()
+    {
+        freeChunks();
+    }
+    //-----------------------------------------------------------------------
+    void* FrameMemory::allocate(size_t size, size_t alignment)
+    {
+        assert(Bitwise::isPO2(alignment));
+
+        uchar* p = (uchar*)(((size_t)mTop + alignment - 1) & ~(alignment - 1));
+        if (p + size > mChunkEnd)
+        {
+            // Keep the old chunk until the reset, its memory may still be in use
+            mUsed += mTop - mChunkStart;
+            addChunk(std::max(size + alignment, mChunk->size * 2));
+            p = (uchar*)(((size_t)mTop + alignment - 1) & ~(alignment - 1));
+        }
+
+        mLast = mTop;
+        mTop = p + size;
+        return p;
+    }
+    //-----------------------------------------------------------------------
+    void FrameMemory::deallocate(void* p, size_t size)
+    {
+        // Scoped containers give their memory back in reverse order, so the
+        // arena does not grow with them even when no frames are rendered
+        if (mLast && (uchar*)p + size == mTop)
+        {
+            mTop = mLast;
+            mLast = 0;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void FrameMemory::reset(void)
+    {
+        size_t used = getUsedSize();
+        mPeak = std::max(mPeak, used);
+
+        if (mChunk->prev)
+        {
+            // Merge the chunks into one big enough for the whole frame
+            size_t size = mCapacity;
+            freeChunks();
+            addChunk(size);
+        }
+
+        mTop = mChunkStart;
+        mLast = 0;
+        mUsed = 0;
+        mOwnerThread = std::this_thread::get_id();
+    }
+    //-----------------------------------------------------------------------
+    void FrameMemory::addChunk(size_t minSize)
+    {
+        size_t size = std::max(minSize, (size_t)4096);
+        Chunk* chunk = (Chunk*)OGRE_MALLOC(sizeof(Chunk) + size, MEMCATEGORY_GENERAL);
+        chunk->prev = mChunk;
+        chunk->size = size;
+
+        mChunk = chunk;
+        mChunkStart = (uchar*)(chunk + 1);
+        mChunkEnd = mChunkStart + size;
+        mTop = mChunkStart;
+        mLast = 0;
+        mCapacity += size;
+    }
+    //-----------------------------------------------------------------------
+    void FrameMemory::freeChunks(void)
+    {
+        while (mChunk)
+        {
+            Chunk* prev = mChunk->prev;
+            OGRE_FREE(mChunk, MEMCATEGORY_GENERAL);
+            mChunk = prev;
+        }
+        mCapacity = 0;
+    }
+}
@@ -32,6 +32,9 @@ THE SOFTWARE.
 
 namespace Ogre {
     static uint32 CACHE_CHUNK_ID = StreamSerialiser::makeIdentifier("OGPC"); // Ogre Gpu Program cache
+    static uint32 MANAGED_CACHE_CHUNK_ID = StreamSerialiser::makeIdentifier("OGPM"); // managed cache index
+    static uint32 MANAGED_DATA_CHUNK_ID = StreamSerialiser::makeIdentifier("OGPD"); // managed cache blobs
+    static uint16 MANAGED_CACHE_VERSION = 1;
 
     //-----------------------------------------------------------------------
     template<> GpuProgramManager* Singleton<GpuProgramManager>::msSingleton = 0;
@@ -57,6 +60,11 @@ namespace Ogre {
         mResourceType = "GpuProgram";
         mSaveMicrocodesToCache = false;
         mCacheDirty = false;
+        mMicrocodeDataStart = 0;
+        mMicrocodeCacheGeneration = 0;
+        mMicrocodeCacheMaxAge = 16;
+        mMicrocodeCacheHits = 0;
+        mMicrocodeCacheMisses = 0;
 
         // subclasses should register with resource group manager
     }
@@ -64,6 +72,14 @@ namespace Ogre {
     GpuProgramManager::~GpuProgramManager()
     {
         // subclasses should unregister with resource group manager
+        try
+        {
+            flushMicrocodeCache();
+        }
+        catch (const Exception& e)
+        {
+            LogManager::getSingleton().logError("Could not write Microcode Cache: " + e.getDescription());
+        }
     }
     //---------------------------------------------------------------------------
     GpuProgramPtr GpuProgramManager::load(const String& name,
@@ -247,12 +263,30 @@ namespace Ogre {
     //---------------------------------------------------------------------
     bool GpuProgramManager::isMicrocodeAvailableInCache( uint32 id ) const
     {
-        return mMicrocodeCache.find(id) != mMicrocodeCache.end();
+        OGRE_LOCK_AUTO_MUTEX;
+        bool available = mMicrocodeCache.find(id) != mMicrocodeCache.end() ||
+                         mMicrocodeFileIndex.find(id) != mMicrocodeFileIndex.end();
+        if (!available)
+            mMicrocodeCacheMisses++;
+        return available;
     }
     //---------------------------------------------------------------------
     const GpuProgramManager::Microcode & GpuProgramManager::getMicrocodeFromCache( uint32 id ) const
     {
-        return mMicrocodeCache.find(id)->second;
+        OGRE_LOCK_AUTO_MUTEX;
+        mMicrocodeCacheHits++;
+
+        auto entry = mMicrocodeFileIndex.find(id);
+        if (entry != mMicrocodeFileIndex.end())
+            entry->second.lastUsed = mMicrocodeCacheGeneration;
+
+        auto it = mMicrocodeCache.find(id);
+        if (it != mMicrocodeCache.end() || entry == mMicrocodeFileIndex.end())
+            return it->second;
+
+        // not resident yet - fetch it from the managed cache file
+        Microcode microcode = readMicrocodeBlob(mMicrocodeCacheFile, mMicrocodeDataStart, entry->second);
+        return mMicrocodeCache.emplace(id, microcode).first->second;
     }
     //---------------------------------------------------------------------
     GpuProgramManager::Microcode GpuProgramManager::createMicrocode( size_t size ) const
@@ -262,7 +296,14 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void GpuProgramManager::addMicrocodeToCache( uint32 id, const GpuProgramManager::Microcode & microcode )
     {   
+        OGRE_LOCK_AUTO_MUTEX;
         auto foundIter = mMicrocodeCache.find(id);
+        if (!mMicrocodeCachePath.empty())
+        {
+            MicrocodeFileEntry entry = {0, static_cast<uint32>(microcode->size()), mMicrocodeCacheGeneration};
+            mMicrocodeFileIndex[id] = entry;
+        }
+
         if ( foundIter == mMicrocodeCache.end() )
         {
             mMicrocodeCache.insert(make_pair(id, microcode));
@@ -278,6 +319,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void GpuProgramManager::removeMicrocodeFromCache( uint32 id )
     {
+        OGRE_LOCK_AUTO_MUTEX;
         auto foundIter = mMicrocodeCache.find(id);
 
         if (foundIter != mMicrocodeCache.end())
@@ -285,6 +327,9 @@ namespace Ogre {
             mMicrocodeCache.erase( foundIter );
             mCacheDirty = true;
         }
+
+        if (mMicrocodeFileIndex.erase(id))
+            mCacheDirty = true;
     }
     //---------------------------------------------------------------------
     void GpuProgramManager::saveMicrocodeCache( DataStreamPtr stream ) const
@@ -373,5 +418,268 @@ namespace Ogre {
         
     }
     //---------------------------------------------------------------------
+    void GpuProgramManager::setMicrocodeCachePath(const String& path)
+    {
+        if (path.empty())
+        {
+            setMicrocodeCachePath(path, BLANKSTRING);
+            return;
+        }
+
+        setSaveMicrocodesToCache(true);
+        if (!mSaveMicrocodesToCache)
+        {
+            LogManager::getSingleton().logWarning(
+                "Microcode Cache: render system can not retrieve compiled shaders, cache disabled");
+            setMicrocodeCachePath(BLANKSTRING, BLANKSTRING);
+            return;
+        }
+
+        RenderSystem* rs = Root::getSingleton().getRenderSystem();
+        StringStream identity;
+        identity << rs->getName() << "|" << rs->getCapabilities()->getDeviceName() << "|"
+                 << rs->getDriverVersion().toString() << "|" << OGRE_VERSION_MAJOR << "."
+                 << OGRE_VERSION_MINOR << "." << OGRE_VERSION_PATCH;
+        setMicrocodeCachePath(path, identity.str());
+    }
+    //---------------------------------------------------------------------
+    void GpuProgramManager::setMicrocodeCachePath(const String& path, const String& identity)
+    {
+        flushMicrocodeCache();
+
+        OGRE_LOCK_AUTO_MUTEX;
+        mMicrocodeCachePath = path;
+        mMicrocodeFileIndex.clear();
+        mMicrocodeCacheFile.reset();
+        mMicrocodeCacheGeneration = 0;
+
+        if (path.empty())
+            return;
+
+        mMicrocodeCacheIdentity = identity;
+
+        std::ifstream* ifs = OGRE_NEW_T(std::ifstream, MEMCATEGORY_GENERAL)(path.c_str(), std::ios::binary);
+        if (!*ifs)
+        {
+            OGRE_DELETE_T(ifs, basic_ifstream, MEMCATEGORY_GENERAL);
+            LogManager::getSingleton().logMessage("Microcode Cache: creating new cache '" + path + "'");
+            return;
+        }
+
+        DataStreamPtr stream(OGRE_NEW FileStreamDataStream(path, ifs));
+        if (readMicrocodeCacheIndex(stream, mMicrocodeFileIndex, mMicrocodeDataStart,
+                                    mMicrocodeCacheGeneration))
+        {
+            mMicrocodeCacheFile = stream;
+            LogManager::getSingleton().stream()
+                << "Microcode Cache: " << mMicrocodeFileIndex.size() << " entries in '" << path << "'";
+        }
+        else
+        {
+            // stale cache of a different render system or driver
+            LogManager::getSingleton().logMessage("Microcode Cache: discarding outdated '" + path + "'");
+            mMicrocodeFileIndex.clear();
+            mCacheDirty = true;
+        }
+    }
+    //---------------------------------------------------------------------
+    bool GpuProgramManager::readMicrocodeCacheIndex(const DataStreamPtr& stream,
+                                                    MicrocodeFileIndex& index, size_t& dataStart,
+                                                    uint32& generation) const
+    {
+        StreamSerialiser serialiser(stream);
+
+        try
+        {
+            if (!serialiser.readChunkBegin(MANAGED_CACHE_CHUNK_ID, MANAGED_CACHE_VERSION))
+                return false;
+        }
+        catch (const Exception& e)
+        {
+            LogManager::getSingleton().logWarning("Could not load Microcode Cache: " +
+                                                  e.getDescription());
+            return false;
+        }
+
+        String identity;
+        serialiser.read(&identity);
+        if (identity != mMicrocodeCacheIdentity)
+        {
+            serialiser.readChunkEnd(MANAGED_CACHE_CHUNK_ID);
+            return false;
+        }
+
+        serialiser.read(&generation);
+
+        uint32 count = 0;
+        serialiser.read(&count);
+
+        uint32 offset = 0;
+        for (uint32 i = 0; i < count; i++)
+        {
+            uint32 id;
+            MicrocodeFileEntry entry;
+            serialiser.read(&id);
+            serialiser.read(&entry.size);
+            serialiser.read(&entry.lastUsed);
+            entry.offset = offset;
+            offset += entry.size;
+            index[id] = entry;
+        }
+        serialiser.readChunkEnd(MANAGED_CACHE_CHUNK_ID);
+
+        // the blobs are only located here and read on demand
+        if (!serialiser.readChunkBegin(MANAGED_DATA_CHUNK_ID, MANAGED_CACHE_VERSION))
+            return false;
+        dataStart = stream->tell();
+        serialiser.readChunkEnd(MANAGED_DATA_CHUNK_ID);
+
+        return true;
+    }
+    //---------------------------------------------------------------------
+    GpuProgramManager::Microcode GpuProgramManager::readMicrocodeBlob(const DataStreamPtr& stream,
+                                                                    size_t dataStart,
+                                                                    const MicrocodeFileEntry& entry)
+    {
+        Microcode microcode(OGRE_NEW MemoryDataStream(entry.size));
+        stream->seek(dataStart + entry.offset);
+        if (stream->read(microcode->getPtr(), entry.size) != entry.size)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "truncated Microcode Cache " + stream->getName());
+        }
+        return microcode;
+    }
+    //---------------------------------------------------------------------
+    void GpuProgramManager::flushMicrocodeCache()
+    {
+        if (mMicrocodeCachePath.empty() || !mCacheDirty)
+            return;
+
+        OGRE_LOCK_AUTO_MUTEX;
+
+        uint32 generation = mMicrocodeCacheGeneration + 1;
+        auto isStale = [this, &generation](const MicrocodeFileEntry& e) {
+            return mMicrocodeCacheMaxAge && e.lastUsed + mMicrocodeCacheMaxAge < generation;
+        };
+
+        // make the entries we keep resident, as the file is about to be replaced
+        for (const auto& e : mMicrocodeFileIndex)
+        {
+            if (!isStale(e.second) && mMicrocodeCache.find(e.first) == mMicrocodeCache.end())
+                mMicrocodeCache.emplace(
+                    e.first, readMicrocodeBlob(mMicrocodeCacheFile, mMicrocodeDataStart, e.second));
+        }
+        mMicrocodeCacheFile.reset();
+
+        // merge what other processes wrote since we opened the cache
+        std::ifstream* ifs = OGRE_NEW_T(std::ifstream, MEMCATEGORY_GENERAL)(mMicrocodeCachePath.c_str(), std::ios::binary);
+        if (*ifs)
+        {
+            DataStreamPtr stream(OGRE_NEW FileStreamDataStream(mMicrocodeCachePath, ifs));
+            MicrocodeFileIndex onDisk;
+            size_t dataStart;
+            uint32 diskGeneration = 0;
+            if (readMicrocodeCacheIndex(stream, onDisk, dataStart, diskGeneration))
+            {
+                generation = std::max(generation, diskGeneration + 1);
+                for (const auto& e : onDisk)
+                {
+                    if (isStale(e.second) || mMicrocodeCache.find(e.first) != mMicrocodeCache.end())
+                        continue;
+                    mMicrocodeCache.emplace(e.first, readMicrocodeBlob(stream, dataStart, e.second));
+                    mMicrocodeFileIndex[e.first] = e.second;
+                }
+            }
+        }
+        else
+        {
+            OGRE_DELETE_T(ifs, basic_ifstream, MEMCATEGORY_GENERAL);
+        }
+
+        size_t evicted = 0;
+        for (auto it = mMicrocodeFileIndex.begin(); it != mMicrocodeFileIndex.end();)
+        {
+            if (isStale(it->second))
+            {
+                mMicrocodeCache.erase(it->first);
+                it = mMicrocodeFileIndex.erase(it);
+                evicted++;
+            }
+            else
+                ++it;
+        }
+
+        // programs that were added before the managed cache was enabled
+        for (const auto& e : mMicrocodeCache)
+        {
+            if (mMicrocodeFileIndex.find(e.first) == mMicrocodeFileIndex.end())
+            {
+                MicrocodeFileEntry entry = {0, 0, mMicrocodeCacheGeneration};
+                mMicrocodeFileIndex[e.first] = entry;
+            }
+        }
+
+        // write to a temporary file and move it in place, so concurrent readers never see partial data
+        StringStream tmpName;
+        tmpName << mMicrocodeCachePath << "." << std::hex << (size_t)this << std::time(NULL) << ".tmp";
+        String tmpPath = tmpName.str();
+        {
+            std::fstream* ofs = OGRE_NEW_T(std::fstream, MEMCATEGORY_GENERAL);
+            ofs->open(tmpPath.c_str(), std::ios::out | std::ios::binary);
+            if (!*ofs)
+            {
+                OGRE_DELETE_T(ofs, basic_fstream, MEMCATEGORY_GENERAL);
+                OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE, "Can't open " + tmpPath + " for writing");
+            }
+            DataStreamPtr stream(OGRE_NEW FileStreamDataStream(tmpPath, ofs));
+            StreamSerialiser serialiser(stream);
+
+            serialiser.writeChunkBegin(MANAGED_CACHE_CHUNK_ID, MANAGED_CACHE_VERSION);
+            serialiser.write(&mMicrocodeCacheIdentity);
+            serialiser.write(&generation);
+            uint32 count = static_cast<uint32>(mMicrocodeFileIndex.size());
+            serialiser.write(&count);
+            uint32 offset = 0;
+            for (auto& e : mMicrocodeFileIndex)
+            {
+                e.second.size = static_cast<uint32>(mMicrocodeCache[e.first]->size());
+                e.second.offset = offset;
+                offset += e.second.size;
+                serialiser.write(&e.first);
+                serialiser.write(&e.second.size);
+                serialiser.write(&e.second.lastUsed);
+            }
+            serialiser.writeChunkEnd(MANAGED_CACHE_CHUNK_ID);
+
+            serialiser.writeChunkBegin(MANAGED_DATA_CHUNK_ID, MANAGED_CACHE_VERSION);
+            for (const auto& e : mMicrocodeFileIndex)
+            {
+                const Microcode& microcode = mMicrocodeCache[e.first];
+                serialiser.writeData(microcode->getPtr(), 1, microcode->size());
+            }
+            serialiser.writeChunkEnd(MANAGED_DATA_CHUNK_ID);
+        }
+
+        if (std::rename(tmpPath.c_str(), mMicrocodeCachePath.c_str()) != 0)
+        {
+            // rename does not replace existing files on all platforms
+            std::remove(mMicrocodeCachePath.c_str());
+            if (std::rename(tmpPath.c_str(), mMicrocodeCachePath.c_str()) != 0)
+            {
+                std::remove(tmpPath.c_str());
+                OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                            "Can't replace " + mMicrocodeCachePath);
+            }
+        }
+
+        mMicrocodeCacheGeneration = generation;
+        mCacheDirty = false;
+
+        LogManager::getSingleton().stream()
+            << "Microcode Cache: wrote " << mMicrocodeFileIndex.size() << " entries to '"
+            << mMicrocodeCachePath << "' (" << mMicrocodeCacheHits << " hits, "
+            << mMicrocodeCacheMisses << " misses, " << evicted << " evicted)";
+    }
+    //---------------------------------------------------------------------
 
 }
@@ -848,6 +848,7 @@ namespace Ogre
         , mTransposeMatrices(false)
         , mIgnoreMissingParams(false)
         , mActivePassIterationIndex(std::numeric_limits<size_t>::max())
+        , mAutoConstantGroupsDirty(true)
     {
     }
     //-----------------------------------------------------------------------------
@@ -876,6 +877,7 @@ namespace Ogre
         mTransposeMatrices = oth.mTransposeMatrices;
         mIgnoreMissingParams  = oth.mIgnoreMissingParams;
         mActivePassIterationIndex = oth.mActivePassIterationIndex;
+        mAutoConstantGroupsDirty = true;
 
         return *this;
     }
@@ -1733,6 +1735,7 @@ namespace Ogre
             mAutoConstants.push_back(AutoConstantEntry(acType, physicalIndex, extraInfo, variability, elementSize));
 
         mCombinedVariability |= variability;
+        mAutoConstantGroupsDirty = true;
 
 
     }
@@ -1783,6 +1786,7 @@ namespace Ogre
             mAutoConstants.push_back(AutoConstantEntry(acType, physicalIndex, rData, variability, elementSize));
 
         mCombinedVariability |= variability;
+        mAutoConstantGroupsDirty = true;
     }
     //-----------------------------------------------------------------------------
     void GpuProgramParameters::clearAutoConstant(size_t index)
@@ -1800,6 +1804,7 @@ namespace Ogre
                 if (i->physicalIndex == physicalIndex)
                 {
                     mAutoConstants.erase(i);
+                    mAutoConstantGroupsDirty = true;
                     break;
                 }
             }
@@ -1821,6 +1826,7 @@ namespace Ogre
                     if (i->physicalIndex == def->physicalIndex)
                     {
                         mAutoConstants.erase(i);
+                        mAutoConstantGroupsDirty = true;
                         break;
                     }
                 }
@@ -1832,6 +1838,7 @@ namespace Ogre
     {
         mAutoConstants.clear();
         mCombinedVariability = GPV_GLOBAL;
+        mAutoConstantGroupsDirty = true;
     }
     //-----------------------------------------------------------------------------
     GpuProgramParameters::AutoConstantIterator GpuProgramParameters::getAutoConstantIterator(void) const
@@ -1881,14 +1888,26 @@ namespace Ogre
         Matrix4 scaleM;
         DualQuaternion dQuat;
 
+        if (mAutoConstantGroupsDirty)
+            buildAutoConstantGroups();
+
         mActivePassIterationIndex = std::numeric_limits<size_t>::max();
 
-        // Autoconstant index is not a physical index
-        for (AutoConstantList::const_iterator i = mAutoConstants.begin(); i != mAutoConstants.end(); ++i)
+        for (AutoConstantGroupList::iterator g = mAutoConstantGroups.begin(); g != mAutoConstantGroups.end(); ++g)
         {
             // Only update needed slots
-            if (i->variability & mask)
+            if (!(g->variability & mask))
+                continue;
+
+            // Skip slots already written from the same source data
+            uint64 version = source->getVersion(g->variability);
+            if (version != 0 && version == g->version)
+                continue;
+
+            // Autoconstant index is not a physical index
+            for (size_t n = g->begin; n != g->end; ++n)
             {
+                const AutoConstantEntry* i = &mAutoConstants[mAutoConstantOrder[n]];
 
                 switch(i->paramType)
                 {
@@ -2513,8 +2532,39 @@ namespace Ogre
                     break;
                 };
             }
+
+            g->version = version;
+        }
+
+    }
+    //-----------------------------------------------------------------------------
+    void GpuProgramParameters::buildAutoConstantGroups(void)
+    {
+        mAutoConstantGroups.clear();
+        mAutoConstantOrder.resize(mAutoConstants.size());
+        for (size_t i = 0; i < mAutoConstants.size(); ++i)
+            mAutoConstantOrder[i] = i;
+
+        // keep the list order within each variability
+        const AutoConstantList& autos = mAutoConstants;
+        std::stable_sort(mAutoConstantOrder.begin(), mAutoConstantOrder.end(),
+                         [&autos](size_t a, size_t b) { return autos[a].variability < autos[b].variability; });
+
+        for (size_t n = 0; n < mAutoConstantOrder.size(); ++n)
+        {
+            uint16 variability = mAutoConstants[mAutoConstantOrder[n]].variability;
+            if (mAutoConstantGroups.empty() || mAutoConstantGroups.back().variability != variability)
+            {
+                AutoConstantGroup group;
+                group.variability = variability;
+                group.begin = n;
+                group.version = 0;
+                mAutoConstantGroups.push_back(group);
+            }
+            mAutoConstantGroups.back().end = n + 1;
         }
 
+        mAutoConstantGroupsDirty = false;
     }
     //---------------------------------------------------------------------------
     void GpuProgramParameters::setNamedConstant(const String& name, Real val)
@@ -2728,6 +2778,8 @@ namespace Ogre
     {
         if (index < mAutoConstants.size())
         {
+            // the entry may be modified
+            mAutoConstantGroupsDirty = true;
             return &(mAutoConstants[index]);
         }
         else
@@ -2869,6 +2921,7 @@ namespace Ogre
         mIntConstants = source.getIntConstantList();
         mAutoConstants = source.getAutoConstantList();
         mCombinedVariability = source.mCombinedVariability;
+        mAutoConstantGroupsDirty = true;
         copySharedParamSetUsage(source.mSharedParamSets);
     }
     //---------------------------------------------------------------------
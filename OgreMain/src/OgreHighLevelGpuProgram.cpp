@@ -98,6 +98,13 @@ namespace Ogre
             params->copyConstantsFrom(*(mDefaultParams.get()));
         return params;
     }
+    uint32 HighLevelGpuProgram::_getHash(uint32 seed) const
+    {
+        // the same source compiles to different microcode depending on the defines
+        uint32 hash = FastHash(mPreprocessorDefines.c_str(), mPreprocessorDefines.size(), seed);
+        return GpuProgram::_getHash(hash);
+    }
+    //---------------------------------------------------------------------------
     size_t HighLevelGpuProgram::calculateSize(void) const
     {
         size_t memSize = 0;
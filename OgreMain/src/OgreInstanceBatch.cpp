@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgreInstancedEntity.h"
 #include "OgreRenderQueue.h"
 #include "OgreLodListener.h"
+#include "OgreThreadPool.h"
 
 namespace Ogre
 {
@@ -611,16 +612,7 @@ namespace Ogre
         if( mVisible )
         {
             if( mMeshReference->hasSkeleton() )
-            {
-                InstancedEntityVec::const_iterator itor = mInstancedEntities.begin();
-                InstancedEntityVec::const_iterator end  = mInstancedEntities.end();
-
-                while( itor != end )    
-                {
-                    mDirtyAnimation |= (*itor)->_updateAnimation();
-                    ++itor;
-                }
-            }
+                updateAnimations();
 
             queue->addRenderable( this, mRenderQueueID, mRenderQueuePriority );
         }
@@ -630,6 +622,70 @@ namespace Ogre
         mVisible = true;
     }
     //-----------------------------------------------------------------------
+    namespace
+    {
+        /// Builds the data Animation::apply would otherwise build lazily on the first call
+        void prepareAnimations( const Skeleton *skeleton )
+        {
+            for( unsigned short i=0; i<skeleton->getNumAnimations(); ++i )
+                skeleton->getAnimation( i )->_prepareForApply();
+
+            Skeleton::LinkedSkeletonAnimSourceIterator linkIt =
+                                        skeleton->getLinkedSkeletonAnimationSourceIterator();
+            while( linkIt.hasMoreElements() )
+            {
+                const LinkedSkeletonAnimationSource &link = linkIt.getNext();
+                if( link.pSkeleton )
+                    prepareAnimations( link.pSkeleton.get() );
+            }
+        }
+    }
+    void InstanceBatch::updateAnimations(void)
+    {
+        const size_t numInstances = mInstancedEntities.size();
+        if( numInstances <= PARALLEL_RANGE_SIZE )
+        {
+            for( size_t i=0; i<numInstances; ++i )
+                mDirtyAnimation |= mInstancedEntities[i]->_updateAnimation();
+            return;
+        }
+
+        //Instances sharing their transform update the skeleton of another instance,
+        //possibly in another range. Those are updated serially afterwards.
+        prepareAnimations( mMeshReference->getSkeleton().get() );
+        const size_t numRanges = (numInstances + PARALLEL_RANGE_SIZE - 1) / PARALLEL_RANGE_SIZE;
+        std::vector<uint8> dirtyRanges( numRanges, 0 );
+        ThreadPool::getSingleton().parallelFor( numInstances, PARALLEL_RANGE_SIZE,
+                                                [&]( size_t begin, size_t end )
+        {
+            bool dirty = false;
+            for( size_t i=begin; i<end; ++i )
+            {
+                if( !mInstancedEntities[i]->mSharedTransformEntity )
+                    dirty |= mInstancedEntities[i]->_updateAnimation();
+            }
+            dirtyRanges[begin / PARALLEL_RANGE_SIZE] = dirty;
+        } );
+
+        for( size_t i=0; i<numRanges; ++i )
+            mDirtyAnimation |= dirtyRanges[i] != 0;
+
+        for( size_t i=0; i<numInstances; ++i )
+        {
+            if( mInstancedEntities[i]->mSharedTransformEntity )
+                mDirtyAnimation |= mInstancedEntities[i]->_updateAnimation();
+        }
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatch::prepareParallelUpdate( Camera *camera )
+    {
+        //Cameras update their planes and derived position on first use after a change
+        if( camera )
+            camera->isVisible( Sphere( Vector3::ZERO, 0 ) );
+        if( mCurrentCamera && mManager->getCameraRelativeRendering() )
+            mCurrentCamera->getDerivedPosition();
+    }
+    //-----------------------------------------------------------------------
     void InstanceBatch::visitRenderables( Renderable::Visitor* visitor, bool debugRenderables )
     {
         visitor->visit( this, 0, false );
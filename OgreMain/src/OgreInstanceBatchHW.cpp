@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreInstanceBatchHW.h"
 #include "OgreRenderOperation.h"
 #include "OgreInstancedEntity.h"
+#include "OgreThreadPool.h"
 
 namespace Ogre
 {
@@ -177,50 +178,69 @@ namespace Ogre
     //-----------------------------------------------------------------------
     size_t InstanceBatchHW::updateVertexBuffer( Camera *currentCamera )
     {
-        size_t retVal = 0;
-
         //Now lock the vertex buffer and copy the 4x3 matrices, only those who need it!
         VertexBufferBinding* binding = mRenderOperation.vertexData->vertexBufferBinding; 
         const ushort bufferIdx = ushort(binding->getBufferCount()-1);
         HardwareBufferLockGuard vertexLock(binding->getBuffer(bufferIdx), HardwareBuffer::HBL_DISCARD);
         float *pDest = static_cast<float*>(vertexLock.pData);
 
-        InstancedEntityVec::const_iterator itor = mInstancedEntities.begin();
-        InstancedEntityVec::const_iterator end  = mInstancedEntities.end();
+        const size_t numInstances               = mInstancedEntities.size();
+        const size_t numRanges                  = (numInstances + PARALLEL_RANGE_SIZE - 1) / PARALLEL_RANGE_SIZE;
+        const unsigned char numCustomParams     = mCreator->getNumCustomParams();
+        const size_t floatsPerInstance          = 12 + numCustomParams * 4;
+        const bool cameraRelative               = mManager->getCameraRelativeRendering();
+
+        prepareParallelUpdate( currentCamera );
+        mInstanceVisible.resize( numInstances );
+        mRangeOffsets.resize( numRanges + 1 );
+
+        //Cull on an individual basis, the less entities are visible, the less instances we draw.
+        //No need to use null matrices at all! Each range counts its visible instances first...
+        ThreadPool &threadPool = ThreadPool::getSingleton();
+        threadPool.parallelFor( numInstances, PARALLEL_RANGE_SIZE, [&]( size_t begin, size_t end )
+        {
+            size_t numVisible = 0;
+            for( size_t i=begin; i<end; ++i )
+            {
+                mInstanceVisible[i] = mInstancedEntities[i]->findVisible( currentCamera );
+                numVisible += mInstanceVisible[i];
+            }
+            mRangeOffsets[begin / PARALLEL_RANGE_SIZE + 1] = numVisible;
+        } );
 
-        unsigned char numCustomParams           = mCreator->getNumCustomParams();
-        size_t customParamIdx                   = 0;
+        mRangeOffsets[0] = 0;
+        for( size_t i=0; i<numRanges; ++i )
+            mRangeOffsets[i+1] += mRangeOffsets[i];
 
-        while( itor != end )
+        //...then writes them behind the visible instances of the ranges before it
+        threadPool.parallelFor( numInstances, PARALLEL_RANGE_SIZE, [&]( size_t begin, size_t end )
         {
-            //Cull on an individual basis, the less entities are visible, the less instances we draw.
-            //No need to use null matrices at all!
-            if( (*itor)->findVisible( currentCamera ) )
+            float *pRangeDest = pDest + mRangeOffsets[begin / PARALLEL_RANGE_SIZE] * floatsPerInstance;
+            for( size_t i=begin; i<end; ++i )
             {
-                const size_t floatsWritten = (*itor)->getTransforms3x4( pDest );
+                if( !mInstanceVisible[i] )
+                    continue;
+
+                const size_t floatsWritten = mInstancedEntities[i]->getTransforms3x4( pRangeDest );
 
-                if( mManager->getCameraRelativeRendering() )
-                    makeMatrixCameraRelative3x4( pDest, floatsWritten );
+                if( cameraRelative )
+                    makeMatrixCameraRelative3x4( pRangeDest, floatsWritten );
 
-                pDest += floatsWritten;
+                pRangeDest += floatsWritten;
 
                 //Write custom parameters, if any
-                for( unsigned char i=0; i<numCustomParams; ++i )
+                const Vector4 *customParams = numCustomParams ? &mCustomParams[i * numCustomParams] : 0;
+                for( unsigned char j=0; j<numCustomParams; ++j )
                 {
-                    *pDest++ = mCustomParams[customParamIdx+i].x;
-                    *pDest++ = mCustomParams[customParamIdx+i].y;
-                    *pDest++ = mCustomParams[customParamIdx+i].z;
-                    *pDest++ = mCustomParams[customParamIdx+i].w;
+                    *pRangeDest++ = customParams[j].x;
+                    *pRangeDest++ = customParams[j].y;
+                    *pRangeDest++ = customParams[j].z;
+                    *pRangeDest++ = customParams[j].w;
                 }
-
-                ++retVal;
             }
-            ++itor;
+        } );
 
-            customParamIdx += numCustomParams;
-        }
-
-        return retVal;
+        return mRangeOffsets[numRanges];
     }
     //-----------------------------------------------------------------------
     void InstanceBatchHW::_boundsDirty(void)
@@ -414,6 +414,10 @@ namespace Ogre
         
         mDirtyAnimation = false;
 
+        //Baked frames were uploaded once, instances only select theirs
+        if (mBakedAnimations)
+            return renderedInstances;
+
         //Now lock the texture and copy the 4x3 matrices!
         HardwareBufferLockGuard matTexLock(mMatrixTexture->getBuffer(), HardwareBuffer::HBL_DISCARD);
         const PixelBox &pixelBox = mMatrixTexture->getBuffer()->getCurrentLock();
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include "OgreInstancedEntity.h"
 #include "OgreMaterial.h"
 #include "OgreDualQuaternion.h"
+#include "OgreThreadPool.h"
+#include "OgreBakedAnimationAtlas.h"
 
 namespace Ogre
 {
@@ -53,7 +55,8 @@ namespace Ogre
                 mMaxLookupTableInstances(16),
                 mUseBoneDualQuaternions(false),
                 mForceOneWeight(false),
-                mUseOneWeight(false)
+                mUseOneWeight(false),
+                mBakedAnimations(0)
     {
         cloneMaterial( mMaterial );
     }
@@ -73,8 +76,8 @@ namespace Ogre
         //Remove cloned material
         MaterialManager::getSingleton().remove( mMaterial );
 
-        //Remove the VTF texture
-        if( mMatrixTexture )
+        //Remove the VTF texture. The baked one is shared, our creator removes it
+        if( mMatrixTexture && !mBakedAnimations )
             TextureManager::getSingleton().remove( mMatrixTexture );
 
         OGRE_FREE(mTempTransformsArray3x4, MEMCATEGORY_GENERAL);
@@ -238,7 +241,11 @@ namespace Ogre
         Currently assuming it's 4096x4096, which is a safe bet for any hardware with decent VTF*/
         
         size_t uniqueAnimations = mInstancesPerBatch;
-        if (useBoneMatrixLookup())
+        if (mBakedAnimations)
+        {
+            uniqueAnimations = mBakedAnimations->getNumFrames();
+        }
+        else if (useBoneMatrixLookup())
         {
             uniqueAnimations = std::min<size_t>(getMaxLookupTableInstances(), uniqueAnimations);
         }
@@ -283,15 +290,72 @@ namespace Ogre
         //TextureType texType = texHeight == 1 ? TEX_TYPE_1D : TEX_TYPE_2D;
         TextureType texType = TEX_TYPE_2D;
 
-        mMatrixTexture = TextureManager::getSingleton().createManual(
+        if( mBakedAnimations )
+        {
+            if( texHeight > c_maxTexHeight )
+            {
+                OGRE_EXCEPT( Exception::ERR_INVALIDPARAMS, "The " +
+                    StringConverter::toString( mBakedAnimations->getNumFrames() ) + " baked frames of " +
+                    mMeshReference->getName() + " need a " + StringConverter::toString( texWidth ) + "x" +
+                    StringConverter::toString( texHeight ) + " vertex texture, at most " +
+                    StringConverter::toString( c_maxTexHeight ) + " rows are supported. Lower the frame "
+                    "rate or bake fewer animations.", "BaseInstanceBatchVTF::createVertexTexture" );
+            }
+
+            //All batches of our creator sample the same frames, which never change
+            const String texName = mCreator->getName() + "/BakedVTF";
+            mMatrixTexture = TextureManager::getSingleton().getByName( texName, mMeshReference->getGroup() );
+            if( !mMatrixTexture )
+            {
+                mMatrixTexture = TextureManager::getSingleton().createManual(
+                                        texName, mMeshReference->getGroup(), texType,
+                                        (uint)texWidth, (uint)texHeight,
+                                        0, PF_FLOAT32_RGBA, TU_STATIC_WRITE_ONLY );
+                fillBakedAnimationTexture( baseSubMesh );
+            }
+        }
+        else
+        {
+            mMatrixTexture = TextureManager::getSingleton().createManual(
                                         mName + "/VTF", mMeshReference->getGroup(), texType,
                                         (uint)texWidth, (uint)texHeight,
                                         0, PF_FLOAT32_RGBA, TU_DYNAMIC_WRITE_ONLY_DISCARDABLE );
+        }
 
         //Set our cloned material to use this custom texture!
         setupMaterialToUseVTF( texType, mMaterial );
     }
 
+    //-----------------------------------------------------------------------
+    void BaseInstanceBatchVTF::fillBakedAnimationTexture( const SubMesh* baseSubMesh )
+    {
+        HardwareBufferLockGuard matTexLock(mMatrixTexture->getBuffer(), HardwareBuffer::HBL_DISCARD);
+        const PixelBox &pixelBox = mMatrixTexture->getBuffer()->getCurrentLock();
+
+        float *pSource = reinterpret_cast<float*>(pixelBox.data);
+
+        //Frames are laid out like the matrices of instances using the bone matrix lookup
+        const size_t floatsPerFrame = mMatricesPerInstance * mRowLength * 4;
+        const size_t framesPerPadding = mMaxFloatsPerLine / floatsPerFrame;
+        const Mesh::IndexMap &indexToBoneMap = baseSubMesh->blendIndexToBoneIndexMap;
+        std::vector<float> tempTransforms( mMatricesPerInstance * 3 * 4 );
+
+        for( size_t f=0; f<mBakedAnimations->getNumFrames(); ++f )
+        {
+            float *pDest = pSource + floatsPerFrame * f + (f / framesPerPadding) * mWidthFloatsPadding;
+            float *transforms = mUseBoneDualQuaternions ? &tempTransforms[0] : pDest;
+            const float *frame = mBakedAnimations->getFrameData( f );
+
+            for( size_t i=0; i<mMatricesPerInstance; ++i )
+            {
+                const size_t bone = indexToBoneMap.empty() ? 0 : indexToBoneMap[i];
+                memcpy( transforms + i * 12, frame + bone * 12, 12 * sizeof(float) );
+            }
+
+            if( mUseBoneDualQuaternions )
+                convert3x4MatricesToDualQuaternions( transforms, mMatricesPerInstance, pDest );
+        }
+    }
     //-----------------------------------------------------------------------
     size_t BaseInstanceBatchVTF::convert3x4MatricesToDualQuaternions(float* matrices, size_t numOfMatrices, float* outDualQuaternions)
     {
@@ -331,50 +395,42 @@ namespace Ogre
 
         float *pDest = reinterpret_cast<float*>(pixelBox.data);
 
-        InstancedEntityVec::const_iterator itor = mInstancedEntities.begin();
-        InstancedEntityVec::const_iterator end  = mInstancedEntities.end();
+        //Every instance writes the same amount of floats, so ranges of instances
+        //are written in parallel, straight to their place in the texture
+        const size_t floatsPerInstance = mMatricesPerInstance * mRowLength * 4;
+        const bool cameraRelative = mManager->getCameraRelativeRendering();
+        prepareParallelUpdate( 0 );
 
-        float* transforms;
-
-        //If using dual quaternion skinning, write the transforms to a temporary buffer,
-        //then convert to dual quaternions, then later write to the pixel buffer
-        //Otherwise simply write the transforms to the pixel buffer directly
-        if(mUseBoneDualQuaternions)
+        ThreadPool::getSingleton().parallelFor( mInstancedEntities.size(), PARALLEL_RANGE_SIZE,
+                                                [&]( size_t begin, size_t end )
         {
-            transforms = mTempTransformsArray3x4;
-        }
-        else
-        {
-            transforms = pDest;
-        }
+            //If using dual quaternion skinning, write the transforms to a temporary buffer,
+            //then convert to dual quaternions, then later write to the pixel buffer
+            //Otherwise simply write the transforms to the pixel buffer directly
+            std::vector<float> tempTransforms( mUseBoneDualQuaternions ? mMatricesPerInstance * 3 * 4 : 0 );
 
-        
-        while( itor != end )
-        {
-            size_t floatsWritten = (*itor)->getTransforms3x4( transforms );
+            for( size_t i=begin; i<end; ++i )
+            {
+                float *pInstanceDest = pDest + i * floatsPerInstance;
+                float *transforms = mUseBoneDualQuaternions ? &tempTransforms[0] : pInstanceDest;
 
-            if( mManager->getCameraRelativeRendering() )
-                makeMatrixCameraRelative3x4( transforms, floatsWritten );
+                size_t floatsWritten = mInstancedEntities[i]->getTransforms3x4( transforms );
 
-            if(mUseBoneDualQuaternions)
-            {
-                floatsWritten = convert3x4MatricesToDualQuaternions(transforms, floatsWritten / 12, pDest);
-                pDest += floatsWritten;
-            }
-            else
-            {
-                transforms += floatsWritten;
+                if( cameraRelative )
+                    makeMatrixCameraRelative3x4( transforms, floatsWritten );
+
+                if( mUseBoneDualQuaternions )
+                    convert3x4MatricesToDualQuaternions( transforms, floatsWritten / 12, pInstanceDest );
             }
-            
-            ++itor;
-        }
+        } );
     }
     /** update the lookup numbers for entities with shared transforms */
     void BaseInstanceBatchVTF::updateSharedLookupIndexes()
     {
         if (mTransformSharingDirty)
         {
-            if (useBoneMatrixLookup())
+            //With baked animations the lookup number is the frame set by the user
+            if (useBoneMatrixLookup() && !mBakedAnimations)
             {
                 //In each entity update the "transform lookup number" so that:
                 // 1. All entities sharing the same transformation will share the same unique number
@@ -416,6 +472,14 @@ namespace Ogre
     //-----------------------------------------------------------------------
     InstancedEntity* BaseInstanceBatchVTF::generateInstancedEntity(size_t num)
     {
+        if (mBakedAnimations)
+        {
+            //Start with the first frame, there are no transforms to share
+            InstancedEntity* entity = OGRE_NEW InstancedEntity(this, static_cast<uint32>(num), NULL);
+            entity->setTransformLookupNumber(0);
+            return entity;
+        }
+
         InstancedEntity* sharedTransformEntity = NULL;
         if ((useBoneMatrixLookup()) && (num >= getMaxLookupTableInstances()))
         {
@@ -428,6 +492,18 @@ namespace Ogre
 
         return OGRE_NEW InstancedEntity(this, static_cast<uint32>(num), sharedTransformEntity);
     }
+    //-----------------------------------------------------------------------
+    void BaseInstanceBatchVTF::setBakedAnimationAtlas( const BakedAnimationAtlas* atlas )
+    {
+        assert( mInstancedEntities.empty() );
+        mBakedAnimations = atlas;
+        if( atlas )
+        {
+            mUseBoneMatrixLookup = true;
+            //Instances are posed by the texture, they need no skeleton of their own
+            mTechnSupportsSkeletal = false;
+        }
+    }
 
 
     //-----------------------------------------------------------------------
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreInstanceBatchShader.h"
 #include "OgreInstanceBatchVTF.h"
 #include "OgreIteratorWrappers.h"
+#include "OgreBakedAnimationAtlas.h"
 
 namespace Ogre
 {
@@ -47,7 +48,8 @@ namespace Ogre
                 mSubMeshIdx( subMeshIdx ),
                 mSceneManager( sceneManager ),
                 mMaxLookupTableInstances(16),
-                mNumCustomParams( 0 )
+                mNumCustomParams( 0 ),
+                mBakedAnimations( 0 )
     {
         mMeshReference = MeshManager::getSingleton().load( meshName, groupName );
 
@@ -74,6 +76,15 @@ namespace Ogre
 
             ++itor;
         }
+
+        if( mBakedAnimations )
+        {
+            //The batches share this texture, see BaseInstanceBatchVTF::createVertexTexture
+            const String texName = mName + "/BakedVTF";
+            if( TextureManager::getSingleton().resourceExists( texName, mMeshReference->getGroup() ) )
+                TextureManager::getSingleton().remove( texName, mMeshReference->getGroup() );
+            OGRE_DELETE mBakedAnimations;
+        }
     }
     //----------------------------------------------------------------------
     void InstanceManager::setInstancesPerBatch( size_t instancesPerBatch )
@@ -111,6 +122,52 @@ namespace Ogre
         mNumCustomParams = numCustomParams;
     }
     //----------------------------------------------------------------------
+    void InstanceManager::setBakedAnimations( const StringVector &animations, Real framesPerSecond )
+    {
+        if( !mInstanceBatches.empty() )
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALID_STATE, "setBakedAnimations can only be called before"
+                " building the batch.", "InstanceManager::setBakedAnimations");
+        }
+
+        if( mInstancingTechnique != HWInstancingVTF )
+        {
+            OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "Baked animations are only supported by"
+                " HWInstancingVTF.", "InstanceManager::setBakedAnimations");
+        }
+
+        if( !mMeshReference->hasSkeleton() || !mMeshReference->getSkeleton() )
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Mesh " + mMeshReference->getName() +
+                " has no skeleton to bake.", "InstanceManager::setBakedAnimations");
+        }
+
+        if( !mBakedAnimations )
+            mBakedAnimations = OGRE_NEW BakedAnimationAtlas();
+
+        //Prefer frames baked offline and saved along the skeleton
+        const SkeletonPtr &skeleton = mMeshReference->getSkeleton();
+        const String fileName = BakedAnimationAtlas::getDefaultFileName( skeleton->getName() );
+        const String &group = skeleton->getGroup();
+        if( ResourceGroupManager::getSingleton().resourceExists( group, fileName ) )
+        {
+            DataStreamPtr stream = ResourceGroupManager::getSingleton().openResource( fileName, group );
+            BakedAnimationSerializer serializer;
+            serializer.importAtlas( stream, mBakedAnimations );
+
+            if( mBakedAnimations->getNumBones() == skeleton->getNumBones() &&
+                mBakedAnimations->hasClips( animations, framesPerSecond ) )
+            {
+                return;
+            }
+
+            LogManager::getSingleton().logMessage( "InstanceManager: " + fileName + " does not match "
+                "the requested animations, baking them again", LML_NORMAL );
+        }
+
+        mBakedAnimations->bake( skeleton, animations, framesPerSecond );
+    }
+    //----------------------------------------------------------------------
     size_t InstanceManager::getMaxOrBestNumInstancesPerBatch( const String &materialName, size_t suggestedSize,
                                                                 uint16 flags )
     {
@@ -237,6 +294,7 @@ namespace Ogre
             static_cast<InstanceBatchHW_VTF*>(batch)->setBoneDualQuaternions((mInstancingFlags & IM_USEBONEDUALQUATERNIONS) != 0);
             static_cast<InstanceBatchHW_VTF*>(batch)->setUseOneWeight((mInstancingFlags & IM_USEONEWEIGHT) != 0);
             static_cast<InstanceBatchHW_VTF*>(batch)->setForceOneWeight((mInstancingFlags & IM_FORCEONEWEIGHT) != 0);
+            static_cast<InstanceBatchHW_VTF*>(batch)->setBakedAnimationAtlas(mBakedAnimations);
             break;
         default:
             OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED,
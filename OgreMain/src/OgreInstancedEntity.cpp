@@ -32,6 +32,8 @@ THE SOFTWARE.
 #include "OgreAnimationState.h"
 #include "OgreOptimisedUtil.h"
 #include "OgreNameGenerator.h"
+#include "OgreInstanceManager.h"
+#include "OgreBakedAnimationAtlas.h"
 
 namespace Ogre
 {
@@ -400,6 +402,21 @@ namespace Ogre
         return mAnimationState;
     }
     //-----------------------------------------------------------------------
+    void InstancedEntity::setBakedAnimationFrame(size_t clipIndex, size_t frame)
+    {
+        const InstanceManager* creator = mBatchOwner->_getCreator();
+        const BakedAnimationAtlas* atlas = creator ? creator->getBakedAnimationAtlas() : 0;
+        if( !atlas )
+        {
+            OGRE_EXCEPT( Exception::ERR_INVALID_STATE, "'" + mName + "' does not use baked animations",
+                         "InstancedEntity::setBakedAnimationFrame" );
+        }
+
+        //The frame is the matrix lookup number, the vertex texture holds all frames.
+        //Atlases hold at most BakedAnimationAtlas::MAX_FRAMES frames, so it fits
+        mTransformLookupNumber = static_cast<uint16>( atlas->getFrameIndex( clipIndex, frame ) );
+    }
+    //-----------------------------------------------------------------------
     bool InstancedEntity::_updateAnimation(void)
     {
         if (mSharedTransformEntity)
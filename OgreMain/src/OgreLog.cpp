@@ -44,10 +44,313 @@ namespace {
 
 namespace Ogre
 {
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+    namespace
+    {
+        /// Identifies writers in the per thread ring caches, as logs may reuse addresses
+        AtomicScalar<uint64> gNextWriterId(1);
+    }
+
+    /** The asynchronous mode of a log.
+    @remarks
+        Every logging thread owns a ring buffer, which only it writes to and only the
+        writer thread reads from, so neither side needs a lock. The messages carry a
+        sequence number to merge the rings in the order they were logged.
+    */
+    struct Log::AsyncWriter : public LogAlloc
+    {
+        struct Entry
+        {
+            String message;
+            uint64 sequence;
+            time_t time;
+            LogMessageLevel lml;
+            bool maskDebug;
+        };
+
+        struct Ring : public LogAlloc
+        {
+            /// Number of entries, a power of two
+            static const size_t SIZE = 256;
+            Entry entries[SIZE];
+            /// Next entry to write, only changed by the owning thread
+            AtomicScalar<size_t> head;
+            /// Next entry to read, only changed by the writer thread
+            AtomicScalar<size_t> tail;
+            /// The entries before this one are flushed to the file
+            AtomicScalar<size_t> flushed;
+            /// The thread writing to this ring
+            OGRE_THREAD_ID_TYPE owner;
+
+            Ring() : head(0), tail(0), flushed(0), owner(OGRE_THREAD_CURRENT_ID) {}
+        };
+
+        struct WriterFunc OGRE_THREAD_WORKER_INHERIT
+        {
+            AsyncWriter* mWriter;
+
+            WriterFunc(AsyncWriter* writer) : mWriter(writer) {}
+
+            void operator()() { mWriter->writerLoop(); }
+            void operator()() const { mWriter->writerLoop(); }
+            void run() { mWriter->writerLoop(); }
+        };
+
+        Log* mLog;
+        uint64 mId;
+        /// All rings, the mutex is only taken when a ring is not in the thread's cache
+        std::vector<Ring*> mRings;
+        OGRE_WQ_MUTEX(mRingsMutex);
+        AtomicScalar<uint64> mNextSequence;
+        AtomicScalar<bool> mFlushRequested;
+        AtomicScalar<bool> mShuttingDown;
+        /// Lets the writer thread wait for messages and logging threads for the writer
+        OGRE_WQ_MUTEX(mWakeMutex);
+        OGRE_WQ_THREAD_SYNCHRONISER(mWakeSync);
+        OGRE_WQ_THREAD_SYNCHRONISER(mProgressSync);
+        AtomicScalar<bool> mWriterSleeping;
+        AtomicScalar<size_t> mNumWaiting;
+        WriterFunc* mWriterFunc;
+        OGRE_THREAD_TYPE* mThread;
+        /// Messages taken from the rings, only used by the writer thread
+        std::vector<Entry> mBatch;
+        std::vector<size_t> mConsumed;
+
+        AsyncWriter(Log* log)
+            : mLog(log), mId(gNextWriterId++), mNextSequence(0), mFlushRequested(false),
+              mShuttingDown(false), mWriterSleeping(false), mNumWaiting(0)
+        {
+            mWriterFunc = OGRE_NEW_T(WriterFunc(this), MEMCATEGORY_GENERAL);
+            OGRE_THREAD_CREATE(t, *mWriterFunc);
+            mThread = t;
+        }
+
+        ~AsyncWriter()
+        {
+            // the writer thread writes and flushes what is left before it exits
+            {
+                OGRE_WQ_LOCK_MUTEX(mWakeMutex);
+                mShuttingDown = true;
+                OGRE_THREAD_NOTIFY_ONE(mWakeSync);
+            }
+            mThread->join();
+            OGRE_THREAD_DESTROY(mThread);
+            OGRE_DELETE_T(mWriterFunc, WriterFunc, MEMCATEGORY_GENERAL);
+
+            for (size_t i = 0; i < mRings.size(); ++i)
+                OGRE_DELETE mRings[i];
+        }
+
+        /// The ring of the calling thread
+        Ring* getRing()
+        {
+            // a thread usually logs to few logs, remember the rings of the last ones
+            struct CachedRing
+            {
+                uint64 writerId;
+                Ring* ring;
+            };
+            static const size_t CACHE_SIZE = 4;
+            static thread_local CachedRing cache[CACHE_SIZE] = {};
+            static thread_local size_t nextCacheSlot = 0;
+
+            for (size_t i = 0; i < CACHE_SIZE; ++i)
+            {
+                if (cache[i].writerId == mId)
+                    return cache[i].ring;
+            }
+
+            // the ring may only have fallen out of the cache, look for it before creating one
+            Ring* ring = NULL;
+            {
+                OGRE_WQ_LOCK_MUTEX(mRingsMutex);
+                OGRE_THREAD_ID_TYPE threadId = OGRE_THREAD_CURRENT_ID;
+                for (size_t i = 0; i < mRings.size() && !ring; ++i)
+                {
+                    if (mRings[i]->owner == threadId)
+                        ring = mRings[i];
+                }
+                if (!ring)
+                {
+                    ring = OGRE_NEW Ring();
+                    mRings.push_back(ring);
+                }
+            }
+            CachedRing& slot = cache[nextCacheSlot++ % CACHE_SIZE];
+            slot.writerId = mId;
+            slot.ring = ring;
+            return ring;
+        }
+
+        /// Queue a message, waiting until it is flushed if flush is set
+        void push(const String& message, LogMessageLevel lml, bool maskDebug, bool flush)
+        {
+            Ring* ring = getRing();
+            size_t head = ring->head;
+            // full, wait for the writer thread to catch up
+            if (head - ring->tail == Ring::SIZE)
+                waitUntil([ring, head]() { return head - ring->tail != Ring::SIZE; });
+
+            Entry& entry = ring->entries[head & (Ring::SIZE - 1)];
+            entry.message = message;
+            entry.sequence = mNextSequence++;
+            entry.time = time(0);
+            entry.lml = lml;
+            entry.maskDebug = maskDebug;
+            ring->head = head + 1;
+            wakeWriter();
+
+            if (flush)
+                waitUntil([ring, head]() { return ring->flushed > head; });
+        }
+
+        /// Wake the writer thread if it waits for messages
+        void wakeWriter()
+        {
+            if (mWriterSleeping)
+            {
+                OGRE_WQ_LOCK_MUTEX(mWakeMutex);
+                OGRE_THREAD_NOTIFY_ONE(mWakeSync);
+            }
+        }
+
+        /// Block until the writer thread made enough progress
+        template <typename Predicate> void waitUntil(Predicate done)
+        {
+            ++mNumWaiting;
+            wakeWriter();
+            {
+                OGRE_WQ_LOCK_MUTEX_NAMED(mWakeMutex, lock);
+                while (!done())
+                    OGRE_THREAD_WAIT(mProgressSync, mWakeMutex, lock);
+            }
+            --mNumWaiting;
+        }
+
+        /// Whether any ring holds messages the writer thread did not take yet
+        bool hasQueued()
+        {
+            OGRE_WQ_LOCK_MUTEX(mRingsMutex);
+            for (size_t i = 0; i < mRings.size(); ++i)
+            {
+                if (mRings[i]->head != mRings[i]->tail)
+                    return true;
+            }
+            return false;
+        }
+
+        /// Wait until everything queued so far is flushed
+        void flush()
+        {
+            std::vector<std::pair<Ring*, size_t> > heads;
+            {
+                OGRE_WQ_LOCK_MUTEX(mRingsMutex);
+                for (size_t i = 0; i < mRings.size(); ++i)
+                    heads.push_back(std::make_pair(mRings[i], size_t(mRings[i]->head)));
+            }
+            mFlushRequested = true;
+            waitUntil([&heads]() {
+                for (size_t i = 0; i < heads.size(); ++i)
+                {
+                    if (heads[i].first->flushed < heads[i].second)
+                        return false;
+                }
+                return true;
+            });
+        }
+
+        /// Write the queued messages of all rings, returns how many there were
+        size_t writeQueued()
+        {
+            bool flush = mFlushRequested.exchange(false);
+
+            std::vector<Ring*> rings;
+            {
+                OGRE_WQ_LOCK_MUTEX(mRingsMutex);
+                rings = mRings;
+            }
+            mConsumed.resize(rings.size());
+            for (size_t r = 0; r < rings.size(); ++r)
+            {
+                Ring* ring = rings[r];
+                size_t tail = ring->tail;
+                size_t head = ring->head;
+                for (; tail != head; ++tail)
+                {
+                    Entry& entry = ring->entries[tail & (Ring::SIZE - 1)];
+                    mBatch.push_back(Entry());
+                    mBatch.back().message.swap(entry.message);
+                    mBatch.back().sequence = entry.sequence;
+                    mBatch.back().time = entry.time;
+                    mBatch.back().lml = entry.lml;
+                    mBatch.back().maskDebug = entry.maskDebug;
+                    flush |= entry.lml >= mLog->mFlushLevel;
+                }
+                ring->tail = head;
+                mConsumed[r] = head;
+            }
+
+            std::sort(mBatch.begin(), mBatch.end(), sequenceLess);
+            for (size_t i = 0; i < mBatch.size(); ++i)
+            {
+                const Entry& entry = mBatch[i];
+                mLog->writeMessage(entry.message, entry.lml, entry.maskDebug, entry.time);
+            }
+
+            if (flush || mShuttingDown)
+            {
+                if (!mLog->mSuppressFile)
+                    mLog->mLog.flush();
+                for (size_t r = 0; r < rings.size(); ++r)
+                    rings[r]->flushed = mConsumed[r];
+            }
+
+            size_t numWritten = mBatch.size();
+            mBatch.clear();
+            return numWritten;
+        }
+
+        static bool sequenceLess(const Entry& a, const Entry& b)
+        {
+            return a.sequence < b.sequence;
+        }
+
+        void writerLoop()
+        {
+            while (true)
+            {
+                bool shuttingDown = mShuttingDown;
+                size_t numWritten = writeQueued();
+                if (mNumWaiting)
+                {
+                    OGRE_WQ_LOCK_MUTEX(mWakeMutex);
+                    OGRE_THREAD_NOTIFY_ALL(mProgressSync);
+                }
+                if (shuttingDown)
+                    break;
+
+                // messages logged while writing are taken as the next batch
+                if (!numWritten)
+                {
+                    OGRE_WQ_LOCK_MUTEX_NAMED(mWakeMutex, lock);
+                    mWriterSleeping = true;
+                    while (!mShuttingDown && !mFlushRequested && !hasQueued())
+                        OGRE_THREAD_WAIT(mWakeSync, mWakeMutex, lock);
+                    mWriterSleeping = false;
+                }
+            }
+        }
+    };
+#else
+    struct Log::AsyncWriter
+    {
+    };
+#endif
     //-----------------------------------------------------------------------
     Log::Log( const String& name, bool debuggerOutput, bool suppressFile ) : 
         mLogLevel(LL_NORMAL), mDebugOut(debuggerOutput),
-        mSuppressFile(suppressFile), mTimeStamp(true), mLogName(name), mTermHasColours(false)
+        mSuppressFile(suppressFile), mTimeStamp(true), mLogName(name), mTermHasColours(false),
+        mFlushLevel(LML_CRITICAL), mAsyncWriter(0)
     {
         if (!mSuppressFile)
         {
@@ -77,6 +380,7 @@ namespace Ogre
     //-----------------------------------------------------------------------
     Log::~Log()
     {
+        setAsynchronous(false);
         OGRE_LOCK_AUTO_MUTEX;
         if (!mSuppressFile)
         {
@@ -87,6 +391,25 @@ namespace Ogre
     //-----------------------------------------------------------------------
     void Log::logMessage( const String& message, LogMessageLevel lml, bool maskDebug )
     {
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+        if (mAsyncWriter)
+        {
+            if ((mLogLevel + lml) < OGRE_LOG_THRESHOLD)
+                return;
+
+            bool skipThisMessage = false;
+            {
+                // listeners don't need to be thread safe
+                OGRE_LOCK_AUTO_MUTEX;
+                for( mtLogListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
+                    (*i)->messageLogged( message, lml, maskDebug, mLogName, skipThisMessage);
+            }
+
+            if (!skipThisMessage)
+                mAsyncWriter->push(message, lml, maskDebug, lml >= mFlushLevel);
+            return;
+        }
+#endif
         OGRE_LOCK_AUTO_MUTEX;
         if ((mLogLevel + lml) >= OGRE_LOG_THRESHOLD)
         {
@@ -96,54 +419,81 @@ namespace Ogre
             
             if (!skipThisMessage)
             {
-                if (mDebugOut && !maskDebug)
-                {
+                writeMessage(message, lml, maskDebug, time(0));
+
+                // Flush stcmdream to ensure it is written (incase of a crash, we need log to be up to date)
+                if (!mSuppressFile)
+                    mLog.flush();
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Log::writeMessage(const String& message, LogMessageLevel lml, bool maskDebug, time_t ctTime)
+    {
+        if (mDebugOut && !maskDebug)
+        {
 #    if (OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT) && OGRE_DEBUG_MODE
-                    OutputDebugStringA("Ogre: ");
-                    OutputDebugStringA(message.c_str());
-                    OutputDebugStringA("\n");
+            OutputDebugStringA("Ogre: ");
+            OutputDebugStringA(message.c_str());
+            OutputDebugStringA("\n");
 #    endif
 
-                    std::ostream& os = int(lml) >= int(LML_WARNING) ? std::cerr : std::cout;
+            std::ostream& os = int(lml) >= int(LML_WARNING) ? std::cerr : std::cout;
 
-                    if(mTermHasColours) {
-                        if(lml == LML_WARNING)
-                            os << YELLOW;
-                        if(lml == LML_CRITICAL)
-                            os << RED;
-                    }
+            if(mTermHasColours) {
+                if(lml == LML_WARNING)
+                    os << YELLOW;
+                if(lml == LML_CRITICAL)
+                    os << RED;
+            }
 
-                    os << message;
+            os << message;
 
-                    if(mTermHasColours) {
-                        os << RESET;
-                    }
+            if(mTermHasColours) {
+                os << RESET;
+            }
 
-                    os << std::endl;
-                }
+            os << std::endl;
+        }
 
-                // Write time into log
-                if (!mSuppressFile)
-                {
-                    if (mTimeStamp)
-                    {
-                        struct tm *pTime;
-                        time_t ctTime; time(&ctTime);
-                        pTime = localtime( &ctTime );
-                        mLog << std::setw(2) << std::setfill('0') << pTime->tm_hour
-                            << ":" << std::setw(2) << std::setfill('0') << pTime->tm_min
-                            << ":" << std::setw(2) << std::setfill('0') << pTime->tm_sec
-                            << ": ";
-                    }
-                    mLog << message << std::endl;
-
-                    // Flush stcmdream to ensure it is written (incase of a crash, we need log to be up to date)
-                    mLog.flush();
-                }
+        // Write time into log
+        if (!mSuppressFile)
+        {
+            if (mTimeStamp)
+            {
+                struct tm *pTime;
+                pTime = localtime( &ctTime );
+                mLog << std::setw(2) << std::setfill('0') << pTime->tm_hour
+                    << ":" << std::setw(2) << std::setfill('0') << pTime->tm_min
+                    << ":" << std::setw(2) << std::setfill('0') << pTime->tm_sec
+                    << ": ";
             }
+            mLog << message << "\n";
         }
     }
-    
+    //-----------------------------------------------------------------------
+    void Log::setAsynchronous(bool async)
+    {
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+        if (async && !mAsyncWriter)
+        {
+            mAsyncWriter = OGRE_NEW AsyncWriter(this);
+        }
+        else if (!async && mAsyncWriter)
+        {
+            OGRE_DELETE mAsyncWriter;
+            mAsyncWriter = 0;
+        }
+#endif
+    }
+    //-----------------------------------------------------------------------
+    void Log::flush()
+    {
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+        if (mAsyncWriter)
+            mAsyncWriter->flush();
+#endif
+    }
     //-----------------------------------------------------------------------
     void Log::setTimeStampEnabled(bool timeStamp)
     {
@@ -0,0 +1,266 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+    (Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include "OgreStableHeaders.h"
+#include "OgreMemoryTracker.h"
+#include "OgreAtomicScalar.h"
+
+namespace Ogre
+{
+    namespace
+    {
+        /// Size of the header before each allocation, keeps the allocation aligned
+        const size_t HEADER_SIZE = 16;
+        const size_t ALIGNED_HEADER_SIZE = OGRE_SIMD_ALIGNMENT > HEADER_SIZE ? OGRE_SIMD_ALIGNMENT : HEADER_SIZE;
+
+        struct AllocationHeader
+        {
+            size_t bytes;
+            uint32 category;
+        };
+
+        /// Counters of a category, either shared by all threads or owned by a single thread
+        struct Counters
+        {
+            AtomicScalar<int64> liveBytes;
+            AtomicScalar<int64> peakBytes;
+            AtomicScalar<uint64> numAllocations;
+            AtomicScalar<uint64> numFrees;
+        };
+
+        struct ThreadCounters
+        {
+            uint32 threadIndex;
+            Counters categories[MEMCATEGORY_COUNT];
+        };
+
+        /// Zero initialised before any allocation can happen
+        Counters gCategoryCounters[MEMCATEGORY_COUNT];
+        AtomicScalar<uint32> gLogInterval;
+        AtomicScalar<uint32> gFramesSinceLog;
+
+        struct ThreadRegistry
+        {
+            std::vector<ThreadCounters*> threads;
+            OGRE_WQ_MUTEX(mutex);
+        };
+
+        ThreadRegistry& getThreadRegistry()
+        {
+            // never destroyed, memory is still freed while static objects are destroyed
+            static ThreadRegistry* registry = new ThreadRegistry();
+            return *registry;
+        }
+
+        thread_local ThreadCounters* tThreadCounters = 0;
+
+        Counters& getThreadCounters(uint32 category)
+        {
+            if (!tThreadCounters)
+            {
+                // kept after the thread exits, so its counters are still reported
+                ThreadCounters* counters = new ThreadCounters();
+                ThreadRegistry& registry = getThreadRegistry();
+                OGRE_WQ_LOCK_MUTEX(registry.mutex);
+                counters->threadIndex = static_cast<uint32>(registry.threads.size());
+                registry.threads.push_back(counters);
+                tThreadCounters = counters;
+            }
+            return tThreadCounters->categories[category];
+        }
+
+        void raisePeak(AtomicScalar<int64>& peak, int64 value)
+        {
+            int64 current = peak.load(std::memory_order_relaxed);
+            while (value > current && !peak.compare_exchange_weak(current, value, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void* track(void* block, size_t headerSize, size_t bytes, MemoryCategory category)
+        {
+            AllocationHeader* header = static_cast<AllocationHeader*>(block);
+            header->bytes = bytes;
+            header->category = category;
+
+            Counters& shared = gCategoryCounters[category];
+            int64 live = shared.liveBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            raisePeak(shared.peakBytes, live);
+            shared.numAllocations.fetch_add(1, std::memory_order_relaxed);
+
+            // only this thread writes these, no read-modify-write needed
+            Counters& own = getThreadCounters(category);
+            live = own.liveBytes.load(std::memory_order_relaxed) + bytes;
+            own.liveBytes.store(live, std::memory_order_relaxed);
+            if (live > own.peakBytes.load(std::memory_order_relaxed))
+                own.peakBytes.store(live, std::memory_order_relaxed);
+            own.numAllocations.store(own.numAllocations.load(std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
+
+            return static_cast<char*>(block) + headerSize;
+        }
+
+        void* untrack(void* ptr, size_t headerSize)
+        {
+            void* block = static_cast<char*>(ptr) - headerSize;
+            const AllocationHeader* header = static_cast<const AllocationHeader*>(block);
+            const int64 bytes = static_cast<int64>(header->bytes);
+
+            Counters& shared = gCategoryCounters[header->category];
+            shared.liveBytes.fetch_sub(bytes, std::memory_order_relaxed);
+            shared.numFrees.fetch_add(1, std::memory_order_relaxed);
+
+            // charged to the freeing thread, which may not be the allocating one
+            Counters& own = getThreadCounters(header->category);
+            own.liveBytes.store(own.liveBytes.load(std::memory_order_relaxed) - bytes,
+                                std::memory_order_relaxed);
+            own.numFrees.store(own.numFrees.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+            return block;
+        }
+
+        MemoryTracker::Stats getStats(const Counters& counters)
+        {
+            MemoryTracker::Stats stats;
+            stats.liveBytes = counters.liveBytes.load(std::memory_order_relaxed);
+            stats.peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+            stats.numAllocations = counters.numAllocations.load(std::memory_order_relaxed);
+            stats.numFrees = counters.numFrees.load(std::memory_order_relaxed);
+            return stats;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void* MemoryTracker::allocate(size_t bytes, MemoryCategory category)
+    {
+        assert(category < MEMCATEGORY_COUNT && "Invalid memory category");
+        void* block = malloc(HEADER_SIZE + bytes);
+        if (!block)
+            throw std::bad_alloc();
+        return track(block, HEADER_SIZE, bytes, category);
+    }
+    //-----------------------------------------------------------------------
+    void MemoryTracker::deallocate(void* ptr)
+    {
+        if (ptr)
+            free(untrack(ptr, HEADER_SIZE));
+    }
+    //-----------------------------------------------------------------------
+    void* MemoryTracker::allocateAligned(size_t bytes, MemoryCategory category)
+    {
+        assert(category < MEMCATEGORY_COUNT && "Invalid memory category");
+        return track(AlignedMemory::allocate(ALIGNED_HEADER_SIZE + bytes), ALIGNED_HEADER_SIZE, bytes,
+                     category);
+    }
+    //-----------------------------------------------------------------------
+    void MemoryTracker::deallocateAligned(void* ptr)
+    {
+        if (ptr)
+            AlignedMemory::deallocate(untrack(ptr, ALIGNED_HEADER_SIZE));
+    }
+    //-----------------------------------------------------------------------
+    MemoryTracker::Stats MemoryTracker::getCategoryStats(MemoryCategory category)
+    {
+        return getStats(gCategoryCounters[category]);
+    }
+    //-----------------------------------------------------------------------
+    void MemoryTracker::getThreadStats(ThreadStatsList& stats)
+    {
+        ThreadRegistry& registry = getThreadRegistry();
+        OGRE_WQ_LOCK_MUTEX(registry.mutex);
+        stats.resize(registry.threads.size());
+        for (size_t i = 0; i < registry.threads.size(); ++i)
+        {
+            stats[i].threadIndex = registry.threads[i]->threadIndex;
+            for (int c = 0; c < MEMCATEGORY_COUNT; ++c)
+                stats[i].categories[c] = getStats(registry.threads[i]->categories[c]);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void MemoryTracker::resetPeaks()
+    {
+        for (int c = 0; c < MEMCATEGORY_COUNT; ++c)
+            gCategoryCounters[c].peakBytes = gCategoryCounters[c].liveBytes.load();
+
+        // the threads may change their peaks meanwhile, the peaks are only approximate
+        ThreadRegistry& registry = getThreadRegistry();
+        OGRE_WQ_LOCK_MUTEX(registry.mutex);
+        for (size_t i = 0; i < registry.threads.size(); ++i)
+        {
+            for (int c = 0; c < MEMCATEGORY_COUNT; ++c)
+            {
+                Counters& counters = registry.threads[i]->categories[c];
+                counters.peakBytes = counters.liveBytes.load();
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    const char* MemoryTracker::getCategoryName(MemoryCategory category)
+    {
+        static const char* names[MEMCATEGORY_COUNT] = {
+            "General", "Geometry", "Animation", "SceneControl",
+            "SceneObjects", "Resource", "Scripting", "RenderSystem"
+        };
+        return category < MEMCATEGORY_COUNT ? names[category] : "Unknown";
+    }
+    //-----------------------------------------------------------------------
+    void MemoryTracker::logStatistics()
+    {
+        LogManager* logManager = LogManager::getSingletonPtr();
+        if (!logManager)
+            return;
+
+        logManager->logMessage("Memory statistics (live KB / peak KB / allocations / frees):");
+        for (int c = 0; c < MEMCATEGORY_COUNT; ++c)
+        {
+            Stats stats = getCategoryStats(static_cast<MemoryCategory>(c));
+            logManager->stream() << "  " << getCategoryName(static_cast<MemoryCategory>(c)) << ": "
+                                 << stats.liveBytes / 1024 << " / " << stats.peakBytes / 1024 << " / "
+                                 << stats.numAllocations << " / " << stats.numFrees;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void MemoryTracker::setLogInterval(uint32 frames)
+    {
+        gLogInterval = frames;
+        gFramesSinceLog = 0;
+    }
+    //-----------------------------------------------------------------------
+    uint32 MemoryTracker::getLogInterval()
+    {
+        return gLogInterval;
+    }
+    //-----------------------------------------------------------------------
+    void MemoryTracker::_notifyFrameEnded()
+    {
+        uint32 interval = gLogInterval;
+        if (interval && ++gFramesSinceLog >= interval)
+        {
+            gFramesSinceLog = 0;
+            logStatistics();
+        }
+    }
+}
@@ -42,6 +42,132 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 #include "OgreTimer.h"
 
 namespace Ogre {
+    namespace
+    {
+        /// All zones ever created, zones are never removed
+        struct ZoneRegistry
+        {
+            std::deque<ProfileZone> zones;
+            std::unordered_map<String, ProfileZoneId> ids;
+            OGRE_WQ_MUTEX(mutex);
+        };
+
+        ZoneRegistry& getZoneRegistry()
+        {
+            // created on first use, profiles may run during static initialisation
+            static ZoneRegistry registry;
+            return registry;
+        }
+
+        ProfileZone& findOrCreateZone(const String& profileName)
+        {
+            ZoneRegistry& registry = getZoneRegistry();
+            OGRE_WQ_LOCK_MUTEX(registry.mutex);
+            std::unordered_map<String, ProfileZoneId>::iterator it = registry.ids.find(profileName);
+            if (it != registry.ids.end())
+                return registry.zones[it->second];
+
+            ProfileZoneId id = static_cast<ProfileZoneId>(registry.zones.size());
+            registry.zones.emplace_back(profileName, id);
+            registry.ids[profileName] = id;
+            return registry.zones.back();
+        }
+
+        /// Identifies profilers in the per thread buffer caches, as they may reuse addresses
+        AtomicScalar<uint64> gNextTraceId(1);
+        /// The profiler created by the current thread, which keeps the statistics
+        thread_local uint64 gStatisticsTraceId = 0;
+
+        bool traceEventTimeLess(const ProfileTraceEvent& a, const ProfileTraceEvent& b)
+        {
+            return a.time < b.time;
+        }
+    }
+
+    /** The trace events recorded by a thread.
+    @remarks
+        A list of blocks which only the owning thread appends to and only markFrame
+        reads and frees, so neither side needs a lock.
+    */
+    struct Profiler::ThreadTrace : public ProfilerAlloc
+    {
+        static const size_t BLOCK_SIZE = 4096;
+
+        struct Block : public ProfilerAlloc
+        {
+            ProfileTraceEvent events[BLOCK_SIZE];
+            /// Number of events written, only changed by the owning thread
+            AtomicScalar<size_t> count;
+            /// Set by the owning thread when this block is full
+            AtomicScalar<Block*> next;
+
+            Block() : count(0), next(0) {}
+        };
+
+        uint16 thread;
+        /// Oldest block and the events read from it, only used by the reader
+        Block* head;
+        size_t headRead;
+        /// Block being written, only used by the owning thread
+        Block* tail;
+
+        ThreadTrace(uint16 threadIndex) : thread(threadIndex), headRead(0)
+        {
+            head = tail = OGRE_NEW Block();
+        }
+
+        ~ThreadTrace()
+        {
+            while (head)
+            {
+                Block* next = head->next;
+                OGRE_DELETE head;
+                head = next;
+            }
+        }
+
+        void push(uint64 time, ProfileZoneId zone, ProfileTraceEvent::Type type)
+        {
+            size_t count = tail->count;
+            if (count == BLOCK_SIZE)
+            {
+                Block* block = OGRE_NEW Block();
+                tail->next = block;
+                tail = block;
+                count = 0;
+            }
+
+            ProfileTraceEvent& event = tail->events[count];
+            event.time = time;
+            event.zone = zone;
+            event.thread = thread;
+            event.type = static_cast<uint8>(type);
+            tail->count = count + 1;
+        }
+
+        void collect(ProfileTraceEventList& events)
+        {
+            while (true)
+            {
+                size_t count = head->count;
+                events.insert(events.end(), head->events + headRead, head->events + count);
+                headRead = count;
+
+                // the owning thread is done with a block once it linked the next one
+                Block* next = head->next;
+                if (!next)
+                    break;
+                // events may have been added before the block was linked
+                count = head->count;
+                events.insert(events.end(), head->events + headRead, head->events + count);
+
+                OGRE_DELETE head;
+                head = next;
+                headRead = 0;
+            }
+        }
+    };
+
     //-----------------------------------------------------------------------
     // PROFILE DEFINITIONS
     //-----------------------------------------------------------------------
@@ -57,14 +183,107 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     Profile::Profile(const String& profileName, uint32 groupID) 
         : mName(profileName)
+        , mZone(NULL)
         , mGroupID(groupID)
     {
         Ogre::Profiler::getSingleton().beginProfile(profileName, groupID);
     }
     //-----------------------------------------------------------------------
+    Profile::Profile(const ProfileZone& zone, uint32 groupID)
+        : mZone(&zone)
+        , mGroupID(groupID)
+    {
+        Ogre::Profiler::getSingleton().beginProfile(zone, groupID);
+    }
+    //-----------------------------------------------------------------------
     Profile::~Profile()
     {
-        Ogre::Profiler::getSingleton().endProfile(mName, mGroupID);
+        if (mZone)
+            Ogre::Profiler::getSingleton().endProfile(*mZone, mGroupID);
+        else
+            Ogre::Profiler::getSingleton().endProfile(mName, mGroupID);
+    }
+    //-----------------------------------------------------------------------
+
+
+    //-----------------------------------------------------------------------
+    // CHROME TRACE DEFINITIONS
+    //-----------------------------------------------------------------------
+    ChromeTraceSessionListener::ChromeTraceSessionListener(const String& fileName)
+        : mFileName(fileName)
+        , mFirstEvent(true)
+    {
+    }
+    //-----------------------------------------------------------------------
+    ChromeTraceSessionListener::~ChromeTraceSessionListener()
+    {
+        finializeSession();
+    }
+    //-----------------------------------------------------------------------
+    void ChromeTraceSessionListener::initializeSession()
+    {
+        // the file is opened with the first events, trace mode is independent of the session
+    }
+    //-----------------------------------------------------------------------
+    void ChromeTraceSessionListener::finializeSession()
+    {
+        if (!mFile.is_open())
+            return;
+
+        mFile << "\n]}\n";
+        mFile.close();
+    }
+    //-----------------------------------------------------------------------
+    void ChromeTraceSessionListener::traceEventsCollected(const ProfileTraceEventList& events)
+    {
+        if (!mFile.is_open())
+        {
+            mFile.open(mFileName.c_str());
+            if (!mFile)
+            {
+                OGRE_EXCEPT(Exception::ERR_CANNOT_WRITE_TO_FILE,
+                            "Cannot open trace file " + mFileName,
+                            "ChromeTraceSessionListener::traceEventsCollected");
+            }
+            mFile << "{\"traceEvents\":[\n";
+            mFirstEvent = true;
+        }
+
+        writeEvents(mFile, events, mFirstEvent);
+        mFirstEvent = mFirstEvent && events.empty();
+    }
+    //-----------------------------------------------------------------------
+    void ChromeTraceSessionListener::writeEvents(std::ostream& os, const ProfileTraceEventList& events,
+                                                 bool first)
+    {
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            const ProfileTraceEvent& event = events[i];
+            if (!first || i)
+                os << ",\n";
+
+            os << "{\"name\":\"";
+            if (event.type == ProfileTraceEvent::TE_FRAME)
+            {
+                os << "Frame\",\"ph\":\"i\",\"s\":\"g";
+            }
+            else
+            {
+                // escape the name as a JSON string
+                const String& name = Profiler::getZone(event.zone).name;
+                for (size_t c = 0; c < name.size(); ++c)
+                {
+                    if (name[c] == '"' || name[c] == '\\')
+                        os << '\\' << name[c];
+                    else if (static_cast<unsigned char>(name[c]) < 0x20)
+                        os << ' ';
+                    else
+                        os << name[c];
+                }
+                os << "\",\"ph\":\"" << (event.type == ProfileTraceEvent::TE_BEGIN ? 'B' : 'E');
+            }
+            os << "\",\"ts\":" << event.time << ",\"pid\":0,\"tid\":" << event.thread << "}";
+        }
     }
     //-----------------------------------------------------------------------
 
@@ -87,8 +306,11 @@ namespace Ogre {
         , mMaxTotalFrameTime(0)
         , mAverageFrameTime(0)
         , mResetExtents(false)
+        , mTraceEnabled(false)
+        , mTraceId(gNextTraceId++)
     {
         mRoot.hierarchicalLvl = 0 - 1;
+        gStatisticsTraceId = mTraceId;
     }
     //-----------------------------------------------------------------------
     ProfileInstance::ProfileInstance(void)
@@ -129,8 +351,8 @@ namespace Ogre {
             logResults();
         }
 
-        // clear all our lists
-        mDisabledProfiles.clear();
+        for (size_t i = 0; i < mThreadTraces.size(); ++i)
+            OGRE_DELETE mThreadTraces[i];
     }
     //-----------------------------------------------------------------------
     void Profiler::setTimer(Timer* t)
@@ -182,32 +404,128 @@ namespace Ogre {
     void Profiler::disableProfile(const String& profileName)
     {
         // even if we are in the middle of this profile, endProfile() will still end it.
-        mDisabledProfiles.insert(profileName);
+        findOrCreateZone(profileName).disabled = true;
     }
     //-----------------------------------------------------------------------
     void Profiler::enableProfile(const String& profileName) 
     {
-        mDisabledProfiles.erase(profileName);
+        findOrCreateZone(profileName).disabled = false;
     }
     //-----------------------------------------------------------------------
-    void Profiler::beginProfile(const String& profileName, uint32 groupID) 
+    const ProfileZone& Profiler::getZone(const String& profileName)
     {
-        // regardless of whether or not we are enabled, we need the application's root profile (ie the first profile started each frame)
-        // we need this so bogus profiles don't show up when users enable profiling mid frame
-        // so we check
+        return findOrCreateZone(profileName);
+    }
+    //-----------------------------------------------------------------------
+    const ProfileZone& Profiler::getZone(ProfileZoneId id)
+    {
+        ZoneRegistry& registry = getZoneRegistry();
+        OGRE_WQ_LOCK_MUTEX(registry.mutex);
+        assert(id < registry.zones.size() && "Unknown profile zone");
+        return registry.zones[id];
+    }
+    //-----------------------------------------------------------------------
+    size_t Profiler::getZoneCount()
+    {
+        ZoneRegistry& registry = getZoneRegistry();
+        OGRE_WQ_LOCK_MUTEX(registry.mutex);
+        return registry.zones.size();
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::setTraceEnabled(bool enabled)
+    {
+        mTraceEnabled = enabled;
+    }
+    //-----------------------------------------------------------------------
+    bool Profiler::isStatisticsThread() const
+    {
+        return gStatisticsTraceId == mTraceId;
+    }
+    //-----------------------------------------------------------------------
+    bool Profiler::isRecording() const
+    {
+        return mTraceEnabled || (mEnabled && isStatisticsThread());
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::recordTraceEvent(ProfileZoneId zone, ProfileTraceEvent::Type type)
+    {
+        // a thread usually records for a single profiler, remember its buffer
+        struct CachedTrace
+        {
+            uint64 traceId;
+            ThreadTrace* trace;
+        };
+        static thread_local CachedTrace cache = {0, 0};
+
+        if (cache.traceId != mTraceId)
+        {
+            OGRE_WQ_LOCK_MUTEX(mThreadTracesMutex);
+            cache.trace = OGRE_NEW ThreadTrace(static_cast<uint16>(mThreadTraces.size()));
+            cache.traceId = mTraceId;
+            mThreadTraces.push_back(cache.trace);
+        }
+
+        // need a timer to profile!
+        assert (mTimer && "Timer not set!");
+        cache.trace->push(mTimer->getMicroseconds(), zone, type);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::markFrame()
+    {
+        if (mTraceEnabled)
+            recordTraceEvent(0, ProfileTraceEvent::TE_FRAME);
+
+        std::vector<ThreadTrace*> traces;
+        {
+            OGRE_WQ_LOCK_MUTEX(mThreadTracesMutex);
+            traces = mThreadTraces;
+        }
+
+        mTraceEvents.clear();
+        for (size_t i = 0; i < traces.size(); ++i)
+            traces[i]->collect(mTraceEvents);
+        if (mTraceEvents.empty())
+            return;
+
+        // keeps the order of events of a thread with the same time
+        std::stable_sort(mTraceEvents.begin(), mTraceEvents.end(), traceEventTimeLess);
 
-        // if the profiler is enabled
-        if (!mEnabled) 
+        for( TProfileSessionListener::iterator i = mListeners.begin(); i != mListeners.end(); ++i )
+            (*i)->traceEventsCollected(mTraceEvents);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::beginProfile(const String& profileName, uint32 groupID) 
+    {
+        // looking up the zone takes the registry lock, so only do it when the profile is recorded
+        if ((groupID & mProfileMask) == 0 || !isRecording())
             return;
 
+        beginProfile(getZone(profileName), groupID);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::beginProfile(const ProfileZone& zone, uint32 groupID)
+    {
         // mask groups
         if ((groupID & mProfileMask) == 0)
             return;
 
         // we only process this profile if isn't disabled
-        if (mDisabledProfiles.find(profileName) != mDisabledProfiles.end()) 
+        if (zone.disabled)
+            return;
+
+        if (mTraceEnabled)
+            recordTraceEvent(zone.id, ProfileTraceEvent::TE_BEGIN);
+
+        // regardless of whether or not we are enabled, we need the application's root profile (ie the first profile started each frame)
+        // we need this so bogus profiles don't show up when users enable profiling mid frame
+        // so we check
+
+        // if the profiler is enabled, statistics only follow a single call stack
+        if (!isStatisticsThread() || !mEnabled)
             return;
 
+        const String& profileName = zone.name;
+
         // empty string is reserved for the root
         // not really fatal anymore, however one shouldn't name one's profile as an empty string anyway.
         assert ((profileName != "") && ("Profile name can't be an empty string"));
@@ -251,6 +569,27 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void Profiler::endProfile(const String& profileName, uint32 groupID) 
     {
+        if (isRecording())
+        {
+            endProfile(getZone(profileName), groupID);
+            return;
+        }
+
+        // the end of the root profile still applies a pending enable request
+        if (isStatisticsThread() && mNewEnableState != mEnabled)
+            changeEnableState();
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::endProfile(const ProfileZone& zone, uint32 groupID)
+    {
+        if (mTraceEnabled && (groupID & mProfileMask) != 0 && !zone.disabled)
+            recordTraceEvent(zone.id, ProfileTraceEvent::TE_END);
+
+        if (!isStatisticsThread())
+            return;
+
+        const String& profileName = zone.name;
+
         if(!mEnabled) 
         {
             // if the profiler received a request to be enabled or disabled
@@ -321,7 +660,7 @@ namespace Ogre {
 
         // we only process this profile if isn't disabled
         // we check the current instance name against the provided profileName as a guard against disabling a profile name /after/ said profile began
-        if(mCurrent->name != profileName && mDisabledProfiles.find(profileName) != mDisabledProfiles.end()) 
+        if(mCurrent->name != profileName && zone.disabled) 
             return;
 
         // calculate the elapsed time of this profile
@@ -30,10 +30,9 @@ THE SOFTWARE.
 
 namespace Ogre {
     // Init statics
-    RadixSort<QueuedRenderableCollection::RenderablePassList,
-        RenderablePass, uint32> QueuedRenderableCollection::msRadixSorter1;
-    RadixSort<QueuedRenderableCollection::RenderablePassList,
-        RenderablePass, float> QueuedRenderableCollection::msRadixSorter2;
+    QueuedRenderableCollection::SortEntryList QueuedRenderableCollection::msSortEntries;
+    QueuedRenderableCollection::SortEntryList QueuedRenderableCollection::msSortScratch;
+    QueuedRenderableCollection::RenderablePassList QueuedRenderableCollection::msSortedPasses;
 
 
     //-----------------------------------------------------------------------
@@ -272,20 +271,16 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     QueuedRenderableCollection::QueuedRenderableCollection(void)
-        :mOrganisationMode(0)
+        :mOrganisationMode(0), mGroupedDirty(false)
     {
     }
 
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::clear(void)
     {
-        PassGroupRenderableMap::iterator i, iend;
-        iend = mGrouped.end();
-        for (i = mGrouped.begin(); i != iend; ++i)
-        {
-            // Clear the list associated with this pass, but leave the pass entry
-            i->second.clear();
-        }
+        // Lists keep their memory, so no allocations once warmed up
+        mGrouped.clear();
+        mGroupedDirty = false;
 
         // Clear sorted list
         mSortedDescending.clear();
@@ -293,13 +288,102 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::removePassGroup(Pass* p)
     {
-        PassGroupRenderableMap::iterator i;
+        struct UsesPass
+        {
+            const Pass* pass;
+            bool operator()(const RenderablePass& rp) const { return rp.pass == pass; }
+        };
+        UsesPass usesPass = {p};
+
+        mGrouped.erase(std::remove_if(mGrouped.begin(), mGrouped.end(), usesPass), mGrouped.end());
+        mSortedDescending.erase(
+            std::remove_if(mSortedDescending.begin(), mSortedDescending.end(), usesPass),
+            mSortedDescending.end());
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::sortByKeys(RenderablePassList& list)
+    {
+        const size_t count = msSortEntries.size();
+        msSortScratch.resize(count);
 
-        i = mGrouped.find(p);
-        if (i != mGrouped.end())
+        // Histograms of all 8 bytes in a single pass
+        uint32 histograms[8][256];
+        memset(histograms, 0, sizeof(histograms));
+        for (size_t i = 0; i < count; ++i)
         {
-            // erase from map
-            mGrouped.erase(i);
+            uint64 key = msSortEntries[i].key;
+            for (int byte = 0; byte < 8; ++byte)
+                ++histograms[byte][(key >> (byte * 8)) & 0xFF];
+        }
+
+        // Least significant byte first, each pass is stable
+        SortEntry* src = &msSortEntries[0];
+        SortEntry* dst = &msSortScratch[0];
+        for (int byte = 0; byte < 8; ++byte)
+        {
+            uint32* counts = histograms[byte];
+            // Skip the pass if all keys share this byte, very common for the upper bits
+            if (counts[(src[0].key >> (byte * 8)) & 0xFF] == count)
+                continue;
+
+            uint32 offset = 0;
+            for (int bucket = 0; bucket < 256; ++bucket)
+            {
+                uint32 bucketSize = counts[bucket];
+                counts[bucket] = offset;
+                offset += bucketSize;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+                dst[counts[(src[i].key >> (byte * 8)) & 0xFF]++] = src[i];
+
+            std::swap(src, dst);
+        }
+
+        // Reorder the list according to the sorted keys
+        msSortedPasses.clear();
+        for (size_t i = 0; i < count; ++i)
+            msSortedPasses.push_back(list[src[i].index]);
+        std::copy(msSortedPasses.begin(), msSortedPasses.end(), list.begin());
+    }
+    //-----------------------------------------------------------------------
+    void QueuedRenderableCollection::sortGrouped(void)
+    {
+        mGroupedDirty = false;
+        if (mGrouped.size() < 2)
+            return;
+
+        // Pass hash only, the stable sort keeps the order the renderables were added in
+        msSortEntries.resize(mGrouped.size());
+        for (uint32 i = 0; i < mGrouped.size(); ++i)
+        {
+            msSortEntries[i].key = mGrouped[i].pass->getHash();
+            msSortEntries[i].index = i;
+        }
+        sortByKeys(mGrouped);
+
+        // Must differentiate by pointer in case 2 passes end up with the same hash
+        RenderablePassList::iterator groupStart = mGrouped.begin();
+        while (groupStart != mGrouped.end())
+        {
+            uint32 hash = groupStart->pass->getHash();
+            bool mixedPasses = false;
+            RenderablePassList::iterator groupEnd = groupStart + 1;
+            for (; groupEnd != mGrouped.end() && groupEnd->pass->getHash() == hash; ++groupEnd)
+                mixedPasses |= groupEnd->pass != groupStart->pass;
+
+            if (mixedPasses)
+            {
+                struct PassLess
+                {
+                    bool operator()(const RenderablePass& a, const RenderablePass& b) const
+                    {
+                        return a.pass < b.pass;
+                    }
+                };
+                std::stable_sort(groupStart, groupEnd, PassLess());
+            }
+            groupStart = groupEnd;
         }
     }
     //-----------------------------------------------------------------------
@@ -308,37 +392,27 @@ namespace Ogre {
         // ascending and descending sort both set bit 1
         // We always sort descending, because the only difference is in the
         // acceptVisitor method, where we iterate in reverse in ascending mode
-        if (mOrganisationMode & OM_SORT_DESCENDING)
+        if ((mOrganisationMode & OM_SORT_DESCENDING) && mSortedDescending.size() > 1)
         {
-            
-            // We can either use a stable_sort and the 'less' implementation,
-            // or a 2-pass radix sort (once by pass, then by distance, since
-            // radix sorting is inherently stable this will work)
-            // We use stable_sort if the number of items is 512 or less, since
-            // the complexity of the radix sort is approximately O(10N), since 
-            // each sort is O(5N) (1 pass histograms, 4 passes sort)
-            // Since stable_sort has a worst-case performance of O(N(logN)^2)
-            // the performance tipping point is from about 1500 items, but in
-            // stable_sorts best-case scenario O(NlogN) it would be much higher.
-            // Take a stab at 2000 items.
-            
-            if (mSortedDescending.size() > 2000)
+            // Descending depth in the upper half, pass hash in the lower half.
+            // Radix sorting is stable, so equal keys keep the order they were added in
+            msSortEntries.resize(mSortedDescending.size());
+            for (uint32 i = 0; i < mSortedDescending.size(); ++i)
             {
-                // sort by pass
-                msRadixSorter1.sort(mSortedDescending, RadixSortFunctorPass());
-                // sort by depth
-                msRadixSorter2.sort(mSortedDescending, RadixSortFunctorDistance(cam));
-            }
-            else
-            {
-                std::stable_sort(
-                    mSortedDescending.begin(), mSortedDescending.end(), 
-                    DepthSortDescendingLess(cam));
+                const RenderablePass& rp = mSortedDescending[i];
+                float depth = static_cast<float>(rp.renderable->getSquaredViewDepth(cam));
+                uint32 depthBits;
+                memcpy(&depthBits, &depth, sizeof(depthBits));
+                // Order floats as unsigned ints, then invert to sort far objects first
+                depthBits = (depthBits & 0x80000000) ? ~depthBits : depthBits | 0x80000000;
+                msSortEntries[i].key = (uint64(~depthBits) << 32) | rp.pass->getHash();
+                msSortEntries[i].index = i;
             }
+            sortByKeys(mSortedDescending);
         }
 
-        // Nothing needs to be done for pass groups, they auto-organise
-
+        if (mGroupedDirty)
+            sortGrouped();
     }
     //-----------------------------------------------------------------------
     void QueuedRenderableCollection::addRenderable(Pass* pass, Renderable* rend)
@@ -351,23 +425,9 @@ namespace Ogre {
 
         if (mOrganisationMode & OM_PASS_GROUP)
         {
-            PassGroupRenderableMap::iterator i = mGrouped.find(pass);
-            if (i == mGrouped.end())
-            {
-                std::pair<PassGroupRenderableMap::iterator, bool> retPair;
-                // Create new pass entry, build a new list
-                // Note that this pass and list are never destroyed until the 
-                // engine shuts down, or a pass is destroyed or has it's hash
-                // recalculated, although the lists will be cleared
-                retPair = mGrouped.insert(
-                    PassGroupRenderableMap::value_type(pass, RenderableList()));
-                assert(retPair.second && 
-                    "Error inserting new pass entry into PassGroupRenderableMap");
-                i = retPair.first;
-            }
-            // Insert renderable
-            i->second.push_back(rend);
-            
+            // Grouped by sorting on the pass hash later
+            mGrouped.push_back(RenderablePass(rend, pass));
+            mGroupedDirty = true;
         }
         
     }
@@ -409,15 +469,18 @@ namespace Ogre {
     void QueuedRenderableCollection::acceptVisitorGrouped(
         QueuedRenderableVisitor* visitor) const
     {
-        PassGroupRenderableMap::const_iterator ipass, ipassend;
-        ipassend = mGrouped.end();
-        for (ipass = mGrouped.begin(); ipass != ipassend; ++ipass)
+        // Without sort() the renderables are visited in the order they were added,
+        // still grouping consecutive ones using the same pass
+        RenderablePassList::const_iterator i = mGrouped.begin();
+        while (i != mGrouped.end())
         {
-            // Fast bypass if this group is now empty
-            if (ipass->second.empty()) continue;
+            Pass* pass = i->pass;
+            mVisitedGroup.clear();
+            for (; i != mGrouped.end() && i->pass == pass; ++i)
+                mVisitedGroup.push_back(i->renderable);
 
-            visitor->visit(ipass->first, const_cast<RenderableList&>(ipass->second));
-        } 
+            visitor->visit(pass, mVisitedGroup);
+        }
 
     }
     //-----------------------------------------------------------------------
@@ -452,26 +515,10 @@ namespace Ogre {
     {
         mSortedDescending.insert( mSortedDescending.end(), rhs.mSortedDescending.begin(), rhs.mSortedDescending.end() );
 
-        PassGroupRenderableMap::const_iterator srcGroup;
-        for( srcGroup = rhs.mGrouped.begin(); srcGroup != rhs.mGrouped.end(); ++srcGroup )
+        if (!rhs.mGrouped.empty())
         {
-            PassGroupRenderableMap::iterator dstGroup = mGrouped.find( srcGroup->first );
-            if (dstGroup == mGrouped.end())
-            {
-                std::pair<PassGroupRenderableMap::iterator, bool> retPair;
-                // Create new pass entry, build a new list
-                // Note that this pass and list are never destroyed until the 
-                // engine shuts down, or a pass is destroyed or has it's hash
-                // recalculated, although the lists will be cleared
-                retPair = mGrouped.insert(
-                    PassGroupRenderableMap::value_type(srcGroup->first, RenderableList()));
-                assert(retPair.second && 
-                    "Error inserting new pass entry into PassGroupRenderableMap");
-                dstGroup = retPair.first;
-            }
-
-            // Insert renderable
-            dstGroup->second.insert( dstGroup->second.end(), srcGroup->second.begin(), srcGroup->second.end() );
+            mGrouped.insert( mGrouped.end(), rhs.mGrouped.begin(), rhs.mGrouped.end() );
+            mGroupedDirty = true;
         }
     }
 
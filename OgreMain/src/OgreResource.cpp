@@ -33,9 +33,12 @@ namespace Ogre
     //-----------------------------------------------------------------------
     Resource::Resource(ResourceManager* creator, const String& name, ResourceHandle handle,
         const String& group, bool isManual, ManualResourceLoader* loader)
-        : mCreator(creator), mName(name), mGroup(group), mHandle(handle), 
+        : mCreator(creator), mName(name), mNameHash(ResourceManager::hashName(name)),
+        mGroup(group), mHandle(handle), 
         mLoadingState(LOADSTATE_UNLOADED), mIsBackgroundLoaded(false),
-        mIsManual(isManual), mSize(0),  mLoader(loader), mStateCount(0)
+        mIsManual(isManual), mSize(0),  mLoader(loader), mStateCount(0),
+        mEvictionPriority(EVICT_PRIORITY_NORMAL), mLruPrev(0), mLruNext(0), mLruList(-1),
+        mLastTouched(0)
     {
     }
     //-----------------------------------------------------------------------
@@ -359,6 +362,15 @@ namespace Ogre
             mCreator->_notifyResourceTouched(this);
     }
     //-----------------------------------------------------------------------
+    void Resource::setEvictionPriority(EvictionPriority priority)
+    {
+        mEvictionPriority = priority;
+
+        // move it to the list of its new class
+        if(mCreator && isLoaded())
+            mCreator->_notifyResourceTouched(this);
+    }
+    //-----------------------------------------------------------------------
     void Resource::addListener(Resource::Listener* lis)
     {
             OGRE_LOCK_MUTEX(mListenerListMutex);
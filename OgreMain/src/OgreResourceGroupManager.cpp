@@ -55,7 +55,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mCurrentGroup(0), mMemoryBudget(std::numeric_limits<size_t>::max())
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME, true); // the "General" group is synonymous to global pool
@@ -888,6 +888,9 @@ namespace Ogre {
         LogManager::getSingleton().logMessage(
             "Registering ResourceManager for type " + resourceType);
         mResourceManagerMap[resourceType] = rm;
+
+        OGRE_LOCK_MUTEX(mBudgetMutex);
+        mBudgetManagers.push_back(rm);
     }
     //-----------------------------------------------------------------------
     void ResourceGroupManager::_unregisterResourceManager(
@@ -901,10 +904,59 @@ namespace Ogre {
         ResourceManagerMap::iterator i = mResourceManagerMap.find(resourceType);
         if (i != mResourceManagerMap.end())
         {
+            OGRE_LOCK_MUTEX(mBudgetMutex);
+            mBudgetManagers.erase(std::remove(mBudgetManagers.begin(), mBudgetManagers.end(), i->second),
+                mBudgetManagers.end());
             mResourceManagerMap.erase(i);
         }
     }
     //-----------------------------------------------------------------------
+    void ResourceGroupManager::setMemoryBudget(size_t bytes)
+    {
+        mMemoryBudget = bytes;
+        _checkMemoryBudget();
+    }
+    //-----------------------------------------------------------------------
+    size_t ResourceGroupManager::getMemoryUsage(void) const
+    {
+        OGRE_LOCK_MUTEX(mBudgetMutex);
+        size_t usage = 0;
+        for (size_t i = 0; i < mBudgetManagers.size(); ++i)
+            usage += mBudgetManagers[i]->getMemoryUsage();
+        return usage;
+    }
+    //-----------------------------------------------------------------------
+    size_t ResourceGroupManager::evictResources(size_t bytes)
+    {
+        std::vector<ResourceManager*> managers;
+        {
+            OGRE_LOCK_MUTEX(mBudgetMutex);
+            managers = mBudgetManagers;
+        }
+
+        size_t reclaimed = 0;
+        ResourceManager::ResourceList candidates;
+        for (int p = Resource::EVICT_PRIORITY_LOW; p < Resource::EVICT_PRIORITY_NEVER && reclaimed < bytes; ++p)
+        {
+            candidates.clear();
+            for (size_t i = 0; i < managers.size(); ++i)
+                managers[i]->_getEvictionCandidates(Resource::EvictionPriority(p), candidates);
+            reclaimed += ResourceManager::_evictCandidates(candidates, bytes - reclaimed);
+        }
+        return reclaimed;
+    }
+    //-----------------------------------------------------------------------
+    void ResourceGroupManager::_checkMemoryBudget(void)
+    {
+        size_t usage = getMemoryUsage();
+        if (usage > mMemoryBudget)
+        {
+            size_t reclaimed = evictResources(usage - mMemoryBudget);
+            LogManager::getSingleton().stream(LML_TRIVIAL)
+                << "Shared resource budget exceeded, evicted " << reclaimed << " bytes";
+        }
+    }
+    //-----------------------------------------------------------------------
     void ResourceGroupManager::_registerScriptLoader(ScriptLoader* su)
     {
             OGRE_LOCK_AUTO_MUTEX;
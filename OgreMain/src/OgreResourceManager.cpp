@@ -30,12 +30,28 @@ THE SOFTWARE.
 
 namespace Ogre {
 
+    namespace
+    {
+        /// Shared by all managers, so recency can be compared between them
+        AtomicScalar<uint64> gTouchCount(0);
+
+        bool lessRecentlyUsed(const ResourcePtr& a, const ResourcePtr& b)
+        {
+            return a->getLastTouched() < b->getLastTouched();
+        }
+    }
     //-----------------------------------------------------------------------
     ResourceManager::ResourceManager()
         : mNextHandle(1), mMemoryUsage(0), mVerbose(true), mLoadOrder(0)
     {
         // Init memory limit & usage
         mMemoryBudget = std::numeric_limits<unsigned long>::max();
+
+        for (int i = 0; i <= Resource::EVICT_PRIORITY_NEVER; ++i)
+        {
+            mLruHead[i] = 0;
+            mLruTail[i] = 0;
+        }
     }
     //-----------------------------------------------------------------------
     ResourceManager::~ResourceManager()
@@ -109,7 +125,10 @@ namespace Ogre {
             OGRE_LOCK_AUTO_MUTEX;
 
             std::pair<ResourceMap::iterator, bool> result;
-        if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
+        // in case the name was set after construction
+        res->mNameHash = hashName(res->getName());
+        bool global = ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup());
+        if(global)
         {
             result = mResources.insert( ResourceMap::value_type( res->getName(), res ) );
         }
@@ -140,7 +159,7 @@ namespace Ogre {
             }
 
             // Try to do the addition again, no seconds attempts to resolve collisions are allowed
-            if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
+            if(global)
             {
                 result = mResources.insert( ResourceMap::value_type( res->getName(), res ) );
             }
@@ -156,6 +175,7 @@ namespace Ogre {
             OGRE_EXCEPT(Exception::ERR_DUPLICATE_ITEM, getResourceType()+" with the name " + res->getName() +
                 " already exists.", "ResourceManager::add");
         }
+        addToNameIndex(&result.first->second, global);
 
         // Insert the handle
         std::pair<ResourceHandleMap::iterator, bool> resultHandle =
@@ -174,10 +194,12 @@ namespace Ogre {
 
         OGRE_LOCK_AUTO_MUTEX;
 
+        removeFromNameIndex(res.get());
+
         if(ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(res->getGroup()))
         {
             ResourceMap::iterator nameIt = mResources.find(res->getName());
-            if (nameIt != mResources.end())
+            if (nameIt != mResources.end() && nameIt->second == res)
             {
                 mResources.erase(nameIt);
             }
@@ -188,7 +210,7 @@ namespace Ogre {
             if (groupIt != mResourcesWithGroup.end())
             {
                 ResourceMap::iterator nameIt = groupIt->second.find(res->getName());
-                if (nameIt != groupIt->second.end())
+                if (nameIt != groupIt->second.end() && nameIt->second == res)
                 {
                     groupIt->second.erase(nameIt);
                 }
@@ -205,6 +227,11 @@ namespace Ogre {
         {
             mResourcesByHandle.erase(handleIt);
         }
+        {
+            // it may outlive its place in this manager
+            OGRE_LOCK_MUTEX(mLruMutex);
+            unlinkLru(res.get());
+        }
         // Tell resource group manager
         ResourceGroupManager::getSingleton()._notifyResourceRemoved(res);
     }
@@ -334,6 +361,19 @@ namespace Ogre {
     {
             OGRE_LOCK_AUTO_MUTEX;
 
+        {
+            OGRE_LOCK_MUTEX(mLruMutex);
+            for (int i = 0; i <= Resource::EVICT_PRIORITY_NEVER; ++i)
+            {
+                while (mLruHead[i])
+                    unlinkLru(mLruHead[i]);
+            }
+        }
+        for (int i = 0; i < NAME_INDEX_SHARD_COUNT; ++i)
+        {
+            OGRE_LOCK_MUTEX(mNameIndex[i].mutex);
+            mNameIndex[i].entries.clear();
+        }
         mResources.clear();
         mResourcesWithGroup.clear();
         mResourcesByHandle.clear();
@@ -368,60 +408,76 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     ResourcePtr ResourceManager::getResourceByName(const String& name, const String& groupName /* = ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME */)
     {
-        OGRE_LOCK_AUTO_MUTEX;
+        return getResourceByName(hashName(name), name, groupName);
+    }
+    //-----------------------------------------------------------------------
+    ResourcePtr ResourceManager::getResourceByName(uint32 nameHash, const String& name, const String& groupName)
+    {
+        assert(nameHash == hashName(name) && "name hash does not match the name");
+        bool autodetect = groupName == ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME;
+#if OGRE_RESOURCEMANAGER_STRICT
+        // asked before locking the index, the group manager may be looking up resources itself
+        bool useGlobal = autodetect || ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(groupName);
+#else
+        // fall back to global
+        bool useGlobal = true;
+#endif
 
-        // resource should be in global pool
-        bool isGlobal = ResourceGroupManager::getSingleton().isResourceGroupInGlobalPool(groupName);
+        NameIndexShard& shard = mNameIndex[nameHash % NAME_INDEX_SHARD_COUNT];
+        OGRE_LOCK_MUTEX(shard.mutex);
 
-        if(isGlobal)
+        const ResourcePtr* global = 0;
+        const ResourcePtr* grouped = 0;
+        std::pair<NameIndexMap::iterator, NameIndexMap::iterator> range = shard.entries.equal_range(nameHash);
+        for (NameIndexMap::iterator i = range.first; i != range.second; ++i)
         {
-            ResourceMap::iterator it = mResources.find(name);
-            if( it != mResources.end())
-            {
-                return it->second;
-            }
+            const ResourcePtr& res = *i->second.res;
+            if (res->getName() != name)
+                continue;
+
+            // names are unique within the global pool
+            if (i->second.global)
+                global = &res;
+            else if (res->getGroup() == groupName)
+                return res;
+            // the index bucket order is unspecified, pick the oldest resource
+            else if (!grouped || res->getHandle() < (*grouped)->getHandle())
+                grouped = &res;
         }
 
+        if (global && useGlobal)
+            return *global;
         // look in all grouped pools
-        if (groupName == ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME)
-        {
-            ResourceWithGroupMap::iterator iter = mResourcesWithGroup.begin();
-            ResourceWithGroupMap::iterator iterE = mResourcesWithGroup.end();
-            for ( ; iter != iterE ; ++iter )
-            {
-                ResourceMap::iterator resMapIt = iter->second.find(name);
-
-                if( resMapIt != iter->second.end())
-                {
-                    return resMapIt->second;
-                }
-            }
-        }
-        else if (!isGlobal)
-        {
-            // look in the grouped pool
-            ResourceWithGroupMap::iterator itGroup = mResourcesWithGroup.find(groupName);
-            if( itGroup != mResourcesWithGroup.end())
-            {
-                ResourceMap::iterator it = itGroup->second.find(name);
+        if (grouped && autodetect)
+            return *grouped;
 
-                if( it != itGroup->second.end())
-                {
-                    return it->second;
-                }
-            }
+        return ResourcePtr();
+    }
+    //-----------------------------------------------------------------------
+    void ResourceManager::addToNameIndex(const ResourcePtr* res, bool global)
+    {
+        NameIndexEntry entry = {res, global};
+        uint32 hash = (*res)->getNameHash();
+        NameIndexShard& shard = mNameIndex[hash % NAME_INDEX_SHARD_COUNT];
+        OGRE_LOCK_MUTEX(shard.mutex);
+        shard.entries.insert(NameIndexMap::value_type(hash, entry));
+    }
+    //-----------------------------------------------------------------------
+    void ResourceManager::removeFromNameIndex(const Resource* res)
+    {
+        uint32 hash = res->getNameHash();
+        NameIndexShard& shard = mNameIndex[hash % NAME_INDEX_SHARD_COUNT];
+        OGRE_LOCK_MUTEX(shard.mutex);
 
-#if !OGRE_RESOURCEMANAGER_STRICT
-            // fall back to global
-            ResourceMap::iterator it = mResources.find(name);
-            if( it != mResources.end())
+        std::pair<NameIndexMap::iterator, NameIndexMap::iterator> range = shard.entries.equal_range(hash);
+        for (NameIndexMap::iterator i = range.first; i != range.second; ++i)
+        {
+            if (i->second.res->get() == res)
             {
-                return it->second;
+                shard.entries.erase(i);
+                return;
             }
-#endif
         }
-    
-        return ResourcePtr();
     }
     //-----------------------------------------------------------------------
     ResourcePtr ResourceManager::getByHandle(ResourceHandle handle)
@@ -439,42 +495,153 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ResourceManager::checkUsage(void)
     {
-        if (getMemoryUsage() > mMemoryBudget)
+        size_t usage = getMemoryUsage();
+        if (usage > mMemoryBudget)
         {
-            OGRE_LOCK_AUTO_MUTEX;
-            // unload unreferenced resources until we are within our budget again
-            ResourceMap::iterator i, iend;
-            iend = mResources.end();
-            for (i = mResources.begin(); i != iend && getMemoryUsage() > mMemoryBudget; ++i)
+            size_t reclaimed = evictResources(usage - mMemoryBudget);
+            if (mVerbose)
             {
-                // A use count of 3 means that only RGM and RM have references
-                // RGM has one (this one) and RM has 2 (by name and by handle)
-                if (i->second.use_count() == ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS)
-                {
-                    Resource* res = i->second.get();
-                    if (res->isReloadable())
-                    {
-                        res->unload();
-                    }
-                }
+                LogManager::getSingleton().stream(LML_TRIVIAL)
+                    << mResourceType << " budget exceeded, evicted " << reclaimed << " bytes";
             }
         }
+
+        ResourceGroupManager* rgm = ResourceGroupManager::getSingletonPtr();
+        if (rgm)
+            rgm->_checkMemoryBudget();
+    }
+    //-----------------------------------------------------------------------
+    size_t ResourceManager::evictResources(size_t bytes)
+    {
+        size_t reclaimed = 0;
+        ResourceList candidates;
+        for (int p = Resource::EVICT_PRIORITY_LOW; p < Resource::EVICT_PRIORITY_NEVER && reclaimed < bytes; ++p)
+        {
+            candidates.clear();
+            _getEvictionCandidates(Resource::EvictionPriority(p), candidates);
+            reclaimed += _evictCandidates(candidates, bytes - reclaimed);
+        }
+        return reclaimed;
+    }
+    //-----------------------------------------------------------------------
+    void ResourceManager::_getEvictionCandidates(Resource::EvictionPriority priority, ResourceList& candidates)
+    {
+        if (priority == Resource::EVICT_PRIORITY_NEVER)
+            return;
+
+        OGRE_LOCK_AUTO_MUTEX;
+        OGRE_LOCK_MUTEX(mLruMutex);
+
+        // resources moved to the back below must not be visited again
+        Resource* last = mLruTail[priority];
+        Resource* next = mLruHead[priority];
+        while (next)
+        {
+            Resource* res = next;
+            next = res->mLruNext;
+
+            ResourceHandleMap::iterator i = mResourcesByHandle.find(res->getHandle());
+            // A use count of 3 means that only RGM and RM have references
+            // RGM has one and RM has 2 (by name and by handle)
+            if (i != mResourcesByHandle.end() && i->second.get() == res &&
+                i->second.use_count() > ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS)
+            {
+                // still in use, so as good as touched
+                res->mLastTouched = ++gTouchCount;
+                linkLru(res);
+            }
+            else if (i != mResourcesByHandle.end() && i->second.get() == res && res->isReloadable())
+            {
+                candidates.push_back(i->second);
+            }
+
+            if (res == last)
+                break;
+        }
+    }
+    //-----------------------------------------------------------------------
+    size_t ResourceManager::_evictCandidates(ResourceList& candidates, size_t bytes)
+    {
+        // lists from several managers are each in order, but not with each other
+        std::stable_sort(candidates.begin(), candidates.end(), lessRecentlyUsed);
+
+        size_t reclaimed = 0;
+        for (ResourceList::iterator i = candidates.begin(); i != candidates.end() && reclaimed < bytes; ++i)
+        {
+            Resource* res = i->get();
+            // it might have been picked up again since the list was made,
+            // the list holds one more reference itself
+            if (i->use_count() > ResourceGroupManager::RESOURCE_SYSTEM_NUM_REFERENCE_COUNTS + 1 ||
+                !res->isLoaded())
+                continue;
+
+            res->unload();
+            if (!res->isLoaded())
+                reclaimed += res->getSize();
+        }
+        return reclaimed;
+    }
+    //-----------------------------------------------------------------------
+    void ResourceManager::linkLru(Resource* res)
+    {
+        unlinkLru(res);
+
+        int list = res->mEvictionPriority;
+        res->mLruList = list;
+        res->mLruPrev = mLruTail[list];
+        res->mLruNext = 0;
+        if (mLruTail[list])
+            mLruTail[list]->mLruNext = res;
+        else
+            mLruHead[list] = res;
+        mLruTail[list] = res;
+    }
+    //-----------------------------------------------------------------------
+    void ResourceManager::unlinkLru(Resource* res)
+    {
+        int list = res->mLruList;
+        if (list < 0)
+            return;
+
+        if (res->mLruPrev)
+            res->mLruPrev->mLruNext = res->mLruNext;
+        else
+            mLruHead[list] = res->mLruNext;
+        if (res->mLruNext)
+            res->mLruNext->mLruPrev = res->mLruPrev;
+        else
+            mLruTail[list] = res->mLruPrev;
+
+        res->mLruPrev = 0;
+        res->mLruNext = 0;
+        res->mLruList = -1;
     }
     //-----------------------------------------------------------------------
     void ResourceManager::_notifyResourceTouched(Resource* res)
     {
-        // TODO
+        OGRE_LOCK_MUTEX(mLruMutex);
+        res->mLastTouched = ++gTouchCount;
+        // only loaded resources can be evicted
+        if (res->mLruList >= 0)
+            linkLru(res);
     }
     //-----------------------------------------------------------------------
     void ResourceManager::_notifyResourceLoaded(Resource* res)
     {
         mMemoryUsage += res->getSize();
+        {
+            OGRE_LOCK_MUTEX(mLruMutex);
+            res->mLastTouched = ++gTouchCount;
+            linkLru(res);
+        }
         checkUsage();
     }
     //-----------------------------------------------------------------------
     void ResourceManager::_notifyResourceUnloaded(Resource* res)
     {
         mMemoryUsage -= res->getSize();
+        OGRE_LOCK_MUTEX(mLruMutex);
+        unlinkLru(res);
     }
     //---------------------------------------------------------------------
     ResourceManager::ResourcePool* ResourceManager::getResourcePool(const String& name)
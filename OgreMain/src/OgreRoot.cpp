@@ -48,9 +48,11 @@ THE SOFTWARE.
 #include "OgreConvexBody.h"
 #include "OgreTimer.h"
 #include "OgreFrameListener.h"
+#include "OgreFrameAllocator.h"
 #include "OgreLodStrategyManager.h"
 #include "OgreFileSystemLayer.h"
 #include "OgreSceneLoaderManager.h"
+#include "OgreThreadPool.h"
 
 #if OGRE_NO_DDS_CODEC == 0
 #include "OgreDDSCodec.h"
@@ -155,6 +157,9 @@ namespace Ogre {
         defaultQ->setWorkersCanAccessRenderSystem(OGRE_THREAD_SUPPORT == 1);
         mWorkQueue.reset(defaultQ);
 
+        // ThreadPool, for loops which are split over all hardware threads
+        mThreadPool.reset(new ThreadPool());
+
         // ResourceBackgroundQueue
         mResourceBackgroundQueue.reset(new ResourceBackgroundQueue());
 
@@ -167,6 +172,7 @@ namespace Ogre {
         mSkeletonManager.reset(new SkeletonManager());
         mParticleManager.reset(new ParticleSystemManager());
         mTimer.reset(new Timer());
+        mFrameMemory.reset(new FrameMemory());
         mLodStrategyManager.reset(new LodStrategyManager());
 
 #if OGRE_PROFILING
@@ -711,7 +717,8 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     bool Root::_fireFrameStarted(FrameEvent& evt)
     {
-        OgreProfileBeginGroup("Frame", OGREPROF_GENERAL);
+        OgreProfileMarkFrame();
+        OgreProfileStaticBeginGroup("Frame", OGREPROF_GENERAL);
         _syncAddedRemovedFrameListeners();
 
         // Tell all listeners
@@ -771,7 +778,14 @@ namespace Ogre {
         // Tell the queue to process responses
         mWorkQueue->processResponses();
 
-        OgreProfileEndGroup("Frame", OGREPROF_GENERAL);
+#if OGRE_MEMORY_TRACKER
+        MemoryTracker::_notifyFrameEnded();
+#endif
+
+        // Nothing allocated for this frame may be used anymore
+        mFrameMemory->reset();
+
+        OgreProfileStaticEndGroup("Frame", OGREPROF_GENERAL);
 
         return ret;
     }
@@ -46,6 +46,7 @@ THE SOFTWARE.
 #include "OgreRenderTexture.h"
 #include "OgreLodListener.h"
 #include "OgreUnifiedHighLevelGpuProgram.h"
+#include "OgreFrameAllocator.h"
 
 // This class implements the most basic scene manager
 
@@ -350,40 +351,134 @@ bool SceneManager::lightLess::operator()(const Light* a, const Light* b) const
     return a->tempSquareDist < b->tempSquareDist;
 }
 //-----------------------------------------------------------------------
+namespace
+{
+    /** Sorts lights by distance to a position, without touching Light::tempSquareDist.
+        Equal distances keep their order, as std::stable_sort would, but the keys are
+        computed once and the scratch memory comes from the frame arena.
+    */
+    void sortLightsByDistance(LightList::iterator first, LightList::iterator last, const Vector3& position)
+    {
+        struct SortKey
+        {
+            Real squareDist;
+            size_t order;
+            Light* light;
+            bool operator<(const SortKey& o) const
+            {
+                return squareDist < o.squareDist || (squareDist == o.squareDist && order < o.order);
+            }
+        };
+
+        frame_vector<SortKey> keys;
+        keys.reserve(last - first);
+        for (LightList::iterator i = first; i != last; ++i)
+        {
+            Real squareDist = 0;
+            if ((*i)->getType() != Light::LT_DIRECTIONAL)
+                squareDist = (position - (*i)->getDerivedPosition()).squaredLength();
+            SortKey key = {squareDist, keys.size(), *i};
+            keys.push_back(key);
+        }
+
+        std::sort(keys.begin(), keys.end());
+        for (size_t i = 0; i < keys.size(); ++i)
+            first[i] = keys[i].light;
+    }
+}
+//-----------------------------------------------------------------------
 void SceneManager::_populateLightList(const Vector3& position, Real radius, 
                                       LightList& destList, uint32 lightMask)
 {
-    // Really basic trawl of the lights, then sort
-    // Subclasses could do something smarter
-
     // Pick up the lights that affecting frustum only, which should has been
     // cached, so better than take all lights in the scene into account.
+    // The light clusters narrow these down to the lights near the position.
     const LightList& candidateLights = _getLightsAffectingFrustum();
 
-    // Pre-allocate memory
     destList.clear();
-    destList.reserve(candidateLights.size());
+    if (candidateLights.empty())
+        return;
 
-    LightList::const_iterator it;
-    for (it = candidateLights.begin(); it != candidateLights.end(); ++it)
+    // The clusters are built once per frame by _renderScene, as this may run on several
+    // threads. Outside of that all candidates are range tested.
+    const LightClusters& clusters = mLightClusters;
+    const bool useClusters = clusters.dirtyCounter == mLightsDirtyCounter;
+
+    // One bit per candidate light - collects each light once and keeps the frustum order
+    uint32 localBits[32];
+    frame_vector<uint32> heapBits;
+    const size_t numWords = (candidateLights.size() + 31) / 32;
+    uint32* candidateBits = localBits;
+    if (numWords > 32)
     {
-        Light* lt = *it;
-        // check whether or not this light is suppose to be taken into consideration for the current light mask set for this operation
-        if(!(lt->getLightMask() & lightMask))
-            continue; //skip this light
+        heapBits.resize(numWords, 0);
+        candidateBits = &heapBits[0];
+    }
+    else
+    {
+        memset(localBits, 0, sizeof(uint32) * numWords);
+    }
 
-        // Calc squared distance
-        lt->_calcTempSquareDist(position);
+    if (!useClusters)
+    {
+        for (size_t index = 0; index < candidateLights.size(); ++index)
+            candidateBits[index >> 5] |= 1u << (index & 31);
+    }
+    else
+    {
+        // Directional and unbounded lights are always included
+        for (uint32 index : clusters.unbounded)
+            candidateBits[index >> 5] |= 1u << (index & 31);
+    }
 
-        if (lt->getType() == Light::LT_DIRECTIONAL)
+    // Add the lights of all cells overlapped by the bounding sphere
+    int cellMin[3], cellMax[3];
+    bool overlapsGrid = useClusters && !clusters.indices.empty();
+    for (int axis = 0; axis < 3 && overlapsGrid; ++axis)
+    {
+        Real lo = (position[axis] - radius - clusters.origin[axis]) * clusters.invCellSize[axis];
+        Real hi = (position[axis] + radius - clusters.origin[axis]) * clusters.invCellSize[axis];
+        overlapsGrid = hi >= 0 && lo < clusters.resolution[axis];
+        clusters.getCellRange(axis, lo, hi, cellMin[axis], cellMax[axis]);
+    }
+
+    if (overlapsGrid)
+    {
+        for (int z = cellMin[2]; z <= cellMax[2]; ++z)
         {
-            // Always included
-            destList.push_back(lt);
+            for (int y = cellMin[1]; y <= cellMax[1]; ++y)
+            {
+                size_t cell = (z * clusters.resolution[1] + y) * clusters.resolution[0] + cellMin[0];
+                uint32 begin = clusters.offsets[cell];
+                uint32 end = clusters.offsets[cell + cellMax[0] - cellMin[0] + 1];
+                for (uint32 i = begin; i < end; ++i)
+                {
+                    uint32 index = clusters.indices[i];
+                    candidateBits[index >> 5] |= 1u << (index & 31);
+                }
+            }
         }
-        else
+    }
+
+    // Pre-allocate memory
+    destList.reserve(candidateLights.size());
+
+    Sphere bounds(position, radius);
+    for (size_t word = 0; word < numWords; ++word)
+    {
+        uint32 bits = candidateBits[word];
+        for (size_t index = word * 32; bits != 0; ++index, bits >>= 1)
         {
+            if (!(bits & 1))
+                continue;
+
+            Light* lt = candidateLights[index];
+            // check whether or not this light is suppose to be taken into consideration for the current light mask set for this operation
+            if(!(lt->getLightMask() & lightMask))
+                continue; //skip this light
+
             // only add in-range lights
-            if (lt->isInLightRange(Sphere(position,radius)))
+            if (lt->getType() == Light::LT_DIRECTIONAL || lt->isInLightRange(bounds))
             {
                 destList.push_back(lt);
             }
@@ -401,12 +496,12 @@ void SceneManager::_populateLightList(const Vector3& position, Real radius,
         {
             LightList::iterator start = destList.begin();
             std::advance(start, getShadowTextureCount());
-            std::stable_sort(start, destList.end(), lightLess());
+            sortLightsByDistance(start, destList.end(), position);
         }
     }
     else
     {
-        std::stable_sort(destList.begin(), destList.end(), lightLess());
+        sortLightsByDistance(destList.begin(), destList.end(), position);
     }
 
     // Now assign indexes in the list so they can be examined if needed
@@ -417,6 +512,121 @@ void SceneManager::_populateLightList(const Vector3& position, Real radius,
     }
 
 
+}
+//-----------------------------------------------------------------------
+bool SceneManager::LightClusters::isBounded(const Light* l)
+{
+    // Larger ranges would put every light into a few cells of a huge grid
+    static const Real MAX_RANGE = 1e6;
+    return l->getType() != Light::LT_DIRECTIONAL && l->getAttenuationRange() < MAX_RANGE;
+}
+//-----------------------------------------------------------------------
+void SceneManager::LightClusters::getCellRange(int axis, Real lo, Real hi, int& cellMin, int& cellMax) const
+{
+    // Clamp before converting, the cell coordinates of a huge sphere do not fit an int
+    Real maxCell = Real(resolution[axis] - 1);
+    cellMin = static_cast<int>(Math::Floor(Math::Clamp(lo, Real(0), maxCell)));
+    cellMax = static_cast<int>(Math::Floor(Math::Clamp(hi, Real(0), maxCell)));
+}
+//-----------------------------------------------------------------------
+void SceneManager::buildLightClusters(void)
+{
+    LightClusters& clusters = mLightClusters;
+    clusters.dirtyCounter = mLightsDirtyCounter;
+    clusters.unbounded.clear();
+    clusters.indices.clear();
+
+    // Bounds of all ranged lights
+    AxisAlignedBox bounds;
+    size_t numRanged = 0;
+    for (uint32 index = 0; index < mLightsAffectingFrustum.size(); ++index)
+    {
+        const Light* l = mLightsAffectingFrustum[index];
+        if (!clusters.isBounded(l))
+        {
+            clusters.unbounded.push_back(index);
+            continue;
+        }
+        Real range = l->getAttenuationRange();
+        const Vector3& pos = l->getDerivedPosition();
+        bounds.merge(AxisAlignedBox(pos - range, pos + range));
+        ++numRanged;
+    }
+
+    if (numRanged == 0)
+    {
+        clusters.offsets.clear();
+        return;
+    }
+
+    // Aim for about one cell per light, dropping degenerate axes
+    static const int MAX_RESOLUTION = 32;
+    Vector3 extent = bounds.getSize();
+    Real maxExtent = std::max(extent.x, std::max(extent.y, extent.z));
+    Real minExtent = std::max(maxExtent / MAX_RESOLUTION, std::numeric_limits<Real>::epsilon());
+    extent.makeCeil(Vector3(minExtent));
+    Real cellSize = std::pow(extent.x * extent.y * extent.z / numRanged, Real(1) / 3);
+
+    size_t numCells = 1;
+    for (int axis = 0; axis < 3; ++axis)
+    {
+        clusters.resolution[axis] = Math::Clamp(static_cast<int>(Math::Ceil(extent[axis] / cellSize)), 1, MAX_RESOLUTION);
+        clusters.invCellSize[axis] = clusters.resolution[axis] / extent[axis];
+        numCells *= clusters.resolution[axis];
+    }
+    clusters.origin = bounds.getMinimum();
+
+    // Counting sort of the lights into the cells, in two passes over the lights
+    clusters.offsets.assign(numCells + 1, 0);
+    for (int pass = 0; pass < 2; ++pass)
+    {
+        for (uint32 index = 0; index < mLightsAffectingFrustum.size(); ++index)
+        {
+            const Light* l = mLightsAffectingFrustum[index];
+            if (!clusters.isBounded(l))
+                continue;
+
+            Real range = l->getAttenuationRange();
+            const Vector3& pos = l->getDerivedPosition();
+            int cellMin[3], cellMax[3];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                Real lo = (pos[axis] - range - clusters.origin[axis]) * clusters.invCellSize[axis];
+                Real hi = (pos[axis] + range - clusters.origin[axis]) * clusters.invCellSize[axis];
+                clusters.getCellRange(axis, lo, hi, cellMin[axis], cellMax[axis]);
+            }
+
+            for (int z = cellMin[2]; z <= cellMax[2]; ++z)
+            {
+                for (int y = cellMin[1]; y <= cellMax[1]; ++y)
+                {
+                    for (int x = cellMin[0]; x <= cellMax[0]; ++x)
+                    {
+                        size_t cell = (z * clusters.resolution[1] + y) * clusters.resolution[0] + x;
+                        if (pass == 0)
+                            ++clusters.offsets[cell + 1];
+                        else
+                            clusters.indices[clusters.offsets[cell]++] = index;
+                    }
+                }
+            }
+        }
+
+        if (pass == 0)
+        {
+            // Turn the counts into start offsets
+            for (size_t cell = 0; cell < numCells; ++cell)
+                clusters.offsets[cell + 1] += clusters.offsets[cell];
+            clusters.indices.resize(clusters.offsets[numCells]);
+        }
+        else
+        {
+            // Filling advanced each start to the start of the next cell
+            for (size_t cell = numCells; cell > 0; --cell)
+                clusters.offsets[cell] = clusters.offsets[cell - 1];
+            clusters.offsets[0] = 0;
+        }
+    }
 }
 //-----------------------------------------------------------------------
 void SceneManager::_populateLightList(const SceneNode* sn, Real radius, LightList& destList, uint32 lightMask) 
@@ -858,6 +1068,18 @@ SceneNode* SceneManager::getSceneNode(const String& name, bool throwExceptionIfN
     return NULL;
 }
 
+//-----------------------------------------------------------------------
+namespace
+{
+    bool blendStateEqual(const ColourBlendState& a, const ColourBlendState& b)
+    {
+        return a.writeR == b.writeR && a.writeG == b.writeG && a.writeB == b.writeB &&
+               a.writeA == b.writeA && a.sourceFactor == b.sourceFactor &&
+               a.destFactor == b.destFactor && a.sourceFactorAlpha == b.sourceFactorAlpha &&
+               a.destFactorAlpha == b.destFactorAlpha && a.operation == b.operation &&
+               a.alphaOperation == b.alphaOperation;
+    }
+}
 //-----------------------------------------------------------------------
 const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed, 
                                    bool shadowDerivation)
@@ -892,6 +1114,9 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
 
     // Tell params about current pass
     mAutoParamDataSource->setCurrentPass(pass);
+    ++mRenderStateStats.passChanges;
+
+    RenderStateCache& cache = mRenderStateCache;
 
     GpuProgram* vprog = pass->hasVertexProgram() ? pass->getVertexProgram().get() : 0;
     GpuProgram* fprog = pass->hasFragmentProgram() ? pass->getFragmentProgram().get() : 0;
@@ -919,6 +1144,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         {
             mDestRenderSystem->unbindGpuProgram(GPT_VERTEX_PROGRAM);
         }
+        cache.programs[GPT_VERTEX_PROGRAM] = 0;
         // Set fixed-function vertex parameters
     }
 
@@ -934,6 +1160,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         {
             mDestRenderSystem->unbindGpuProgram(GPT_GEOMETRY_PROGRAM);
         }
+        cache.programs[GPT_GEOMETRY_PROGRAM] = 0;
     }
     if (pass->hasTessellationHullProgram())
     {
@@ -947,6 +1174,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         {
             mDestRenderSystem->unbindGpuProgram(GPT_HULL_PROGRAM);
         }
+        cache.programs[GPT_HULL_PROGRAM] = 0;
     }
 
     if (pass->hasTessellationDomainProgram())
@@ -961,6 +1189,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         {
             mDestRenderSystem->unbindGpuProgram(GPT_DOMAIN_PROGRAM);
         }
+        cache.programs[GPT_DOMAIN_PROGRAM] = 0;
     }
 
     if (pass->hasComputeProgram())
@@ -975,13 +1204,27 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         {
             mDestRenderSystem->unbindGpuProgram(GPT_COMPUTE_PROGRAM);
         }
+        cache.programs[GPT_COMPUTE_PROGRAM] = 0;
     }
 
     if (passSurfaceAndLightParams)
     {
         // Set surface reflectance properties, only valid if lighting is enabled
-        if (pass->getLightingEnabled())
+        if (pass->getLightingEnabled() &&
+            cache.update(RenderStateCache::SB_SURFACE,
+                         cache.ambient != pass->getAmbient() || cache.diffuse != pass->getDiffuse() ||
+                             cache.specular != pass->getSpecular() ||
+                             cache.emissive != pass->getSelfIllumination() ||
+                             cache.shininess != pass->getShininess() ||
+                             cache.tracking != pass->getVertexColourTracking(),
+                         mRenderStateStats))
         {
+            cache.ambient = pass->getAmbient();
+            cache.diffuse = pass->getDiffuse();
+            cache.specular = pass->getSpecular();
+            cache.emissive = pass->getSelfIllumination();
+            cache.shininess = pass->getShininess();
+            cache.tracking = pass->getVertexColourTracking();
             mDestRenderSystem->_setSurfaceParams(
                 pass->getAmbient(),
                 pass->getDiffuse(),
@@ -992,7 +1235,12 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         }
 
         // Dynamic lighting enabled?
-        mDestRenderSystem->setLightingEnabled(pass->getLightingEnabled());
+        if (cache.update(RenderStateCache::SB_LIGHTING,
+                         cache.lightingEnabled != pass->getLightingEnabled(), mRenderStateStats))
+        {
+            cache.lightingEnabled = pass->getLightingEnabled();
+            mDestRenderSystem->setLightingEnabled(pass->getLightingEnabled());
+        }
     }
 
     // Using a fragment program?
@@ -1017,6 +1265,7 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         {
             mDestRenderSystem->unbindGpuProgram(GPT_FRAGMENT_PROGRAM);
         }
+        cache.programs[GPT_FRAGMENT_PROGRAM] = 0;
         // Set fixed-function fragment settings
     }
 
@@ -1050,7 +1299,19 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
         fragment program, and in other ways, them maybe access by gpu program via
         "state.fog.XXX".
         */
-        mDestRenderSystem->_setFog(newFogMode, newFogColour, newFogDensity, newFogStart, newFogEnd);
+        if (cache.update(RenderStateCache::SB_FOG,
+                         cache.fogMode != newFogMode || cache.fogColour != newFogColour ||
+                             cache.fogDensity != newFogDensity || cache.fogStart != newFogStart ||
+                             cache.fogEnd != newFogEnd,
+                         mRenderStateStats))
+        {
+            cache.fogMode = newFogMode;
+            cache.fogColour = newFogColour;
+            cache.fogDensity = newFogDensity;
+            cache.fogStart = newFogStart;
+            cache.fogEnd = newFogEnd;
+            mDestRenderSystem->_setFog(newFogMode, newFogColour, newFogDensity, newFogStart, newFogEnd);
+        }
     }
     // Tell params about ORIGINAL fog
     // Need to be able to override fixed function fog, but still have
@@ -1060,24 +1321,57 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
     // The rest of the settings are the same no matter whether we use programs or not
 
     // Set scene blending
-    mDestRenderSystem->setColourBlendState(pass->getBlendState());
+    if (cache.update(RenderStateCache::SB_BLEND,
+                     !blendStateEqual(cache.blendState, pass->getBlendState()), mRenderStateStats))
+    {
+        cache.blendState = pass->getBlendState();
+        mDestRenderSystem->setColourBlendState(pass->getBlendState());
+    }
 
     // Line width
-    if (mDestRenderSystem->getCapabilities()->hasCapability(RSC_WIDE_LINES))
+    if (mDestRenderSystem->getCapabilities()->hasCapability(RSC_WIDE_LINES) &&
+        cache.update(RenderStateCache::SB_LINE_WIDTH, cache.lineWidth != pass->getLineWidth(),
+                     mRenderStateStats))
+    {
+        cache.lineWidth = pass->getLineWidth();
         mDestRenderSystem->_setLineWidth(pass->getLineWidth());
+    }
 
     // Set point parameters
-    mDestRenderSystem->_setPointParameters(
-        pass->getPointSize(),
-        pass->isPointAttenuationEnabled(),
-        pass->getPointAttenuationConstant(),
-        pass->getPointAttenuationLinear(),
-        pass->getPointAttenuationQuadratic(),
-        pass->getPointMinSize(),
-        pass->getPointMaxSize());
-
-    if (mDestRenderSystem->getCapabilities()->hasCapability(RSC_POINT_SPRITES))
+    if (cache.update(RenderStateCache::SB_POINT,
+                     cache.pointSize != pass->getPointSize() ||
+                         cache.pointAttenuationEnabled != pass->isPointAttenuationEnabled() ||
+                         cache.pointAttenuation[0] != pass->getPointAttenuationConstant() ||
+                         cache.pointAttenuation[1] != pass->getPointAttenuationLinear() ||
+                         cache.pointAttenuation[2] != pass->getPointAttenuationQuadratic() ||
+                         cache.pointMinSize != pass->getPointMinSize() ||
+                         cache.pointMaxSize != pass->getPointMaxSize(),
+                     mRenderStateStats))
+    {
+        cache.pointSize = pass->getPointSize();
+        cache.pointAttenuationEnabled = pass->isPointAttenuationEnabled();
+        cache.pointAttenuation[0] = pass->getPointAttenuationConstant();
+        cache.pointAttenuation[1] = pass->getPointAttenuationLinear();
+        cache.pointAttenuation[2] = pass->getPointAttenuationQuadratic();
+        cache.pointMinSize = pass->getPointMinSize();
+        cache.pointMaxSize = pass->getPointMaxSize();
+        mDestRenderSystem->_setPointParameters(
+            pass->getPointSize(),
+            pass->isPointAttenuationEnabled(),
+            pass->getPointAttenuationConstant(),
+            pass->getPointAttenuationLinear(),
+            pass->getPointAttenuationQuadratic(),
+            pass->getPointMinSize(),
+            pass->getPointMaxSize());
+    }
+
+    if (mDestRenderSystem->getCapabilities()->hasCapability(RSC_POINT_SPRITES) &&
+        cache.update(RenderStateCache::SB_POINT_SPRITES,
+                     cache.pointSprites != pass->getPointSpritesEnabled(), mRenderStateStats))
+    {
+        cache.pointSprites = pass->getPointSpritesEnabled();
         mDestRenderSystem->_setPointSpritesEnabled(pass->getPointSpritesEnabled());
+    }
 
     mAutoParamDataSource->setPointParameters(
         pass->getPointSize(), pass->isPointAttenuationEnabled(),
@@ -1170,22 +1464,50 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
             }
             pTex->_setTexturePtr(refTex);
         }
-        mDestRenderSystem->_setTextureUnitSettings(unit, *pTex);
+        setTextureUnitSettings(unit, pTex);
         ++unit;
     }
     // Disable remaining texture units
-    mDestRenderSystem->_disableTextureUnitsFrom(pass->getNumTextureUnitStates());
+    disableTextureUnitsFrom(pass->getNumTextureUnitStates());
 
     // Set up non-texture related material settings
     // Depth buffer settings
-    mDestRenderSystem->_setDepthBufferFunction(pass->getDepthFunction());
-    mDestRenderSystem->_setDepthBufferCheckEnabled(pass->getDepthCheckEnabled());
-    mDestRenderSystem->_setDepthBufferWriteEnabled(pass->getDepthWriteEnabled());
-    mDestRenderSystem->_setDepthBias(pass->getDepthBiasConstant(), pass->getDepthBiasSlopeScale());
+    if (cache.update(RenderStateCache::SB_DEPTH,
+                     cache.depthFunction != pass->getDepthFunction() ||
+                         cache.depthCheck != pass->getDepthCheckEnabled() ||
+                         cache.depthWrite != pass->getDepthWriteEnabled(),
+                     mRenderStateStats))
+    {
+        cache.depthFunction = pass->getDepthFunction();
+        cache.depthCheck = pass->getDepthCheckEnabled();
+        cache.depthWrite = pass->getDepthWriteEnabled();
+        mDestRenderSystem->_setDepthBufferFunction(pass->getDepthFunction());
+        mDestRenderSystem->_setDepthBufferCheckEnabled(pass->getDepthCheckEnabled());
+        mDestRenderSystem->_setDepthBufferWriteEnabled(pass->getDepthWriteEnabled());
+    }
+    if (cache.update(RenderStateCache::SB_DEPTH_BIAS,
+                     cache.depthBiasConstant != pass->getDepthBiasConstant() ||
+                         cache.depthBiasSlopeScale != pass->getDepthBiasSlopeScale(),
+                     mRenderStateStats))
+    {
+        cache.depthBiasConstant = pass->getDepthBiasConstant();
+        cache.depthBiasSlopeScale = pass->getDepthBiasSlopeScale();
+        mDestRenderSystem->_setDepthBias(pass->getDepthBiasConstant(), pass->getDepthBiasSlopeScale());
+    }
     // Alpha-reject settings
-    mDestRenderSystem->_setAlphaRejectSettings(pass->getAlphaRejectFunction(),
-                                               pass->getAlphaRejectValue(),
-                                               pass->isAlphaToCoverageEnabled());
+    if (cache.update(RenderStateCache::SB_ALPHA_REJECT,
+                     cache.alphaRejectFunction != pass->getAlphaRejectFunction() ||
+                         cache.alphaRejectValue != pass->getAlphaRejectValue() ||
+                         cache.alphaToCoverage != pass->isAlphaToCoverageEnabled(),
+                     mRenderStateStats))
+    {
+        cache.alphaRejectFunction = pass->getAlphaRejectFunction();
+        cache.alphaRejectValue = pass->getAlphaRejectValue();
+        cache.alphaToCoverage = pass->isAlphaToCoverageEnabled();
+        mDestRenderSystem->_setAlphaRejectSettings(pass->getAlphaRejectFunction(),
+                                                   pass->getAlphaRejectValue(),
+                                                   pass->isAlphaToCoverageEnabled());
+    }
 
     // Culling mode
     if (isShadowTechniqueTextureBased() && mIlluminationStage == IRS_RENDER_TO_TEXTURE &&
@@ -1198,9 +1520,23 @@ const Pass* SceneManager::_setPass(const Pass* pass, bool evenIfSuppressed,
     {
         mPassCullingMode = pass->getCullingMode();
     }
-    mDestRenderSystem->_setCullingMode(mPassCullingMode);
-    mDestRenderSystem->setShadingType(pass->getShadingMode());
-    mDestRenderSystem->_setPolygonMode(pass->getPolygonMode());
+    // The render system keeps track of the culling mode itself
+    if (mPassCullingMode != mDestRenderSystem->_getCullingMode())
+    {
+        mDestRenderSystem->_setCullingMode(mPassCullingMode);
+        ++mRenderStateStats.stateChanges;
+    }
+    else
+    {
+        ++mRenderStateStats.redundantChanges;
+    }
+    if (cache.update(RenderStateCache::SB_SHADING, cache.shading != pass->getShadingMode(),
+                     mRenderStateStats))
+    {
+        cache.shading = pass->getShadingMode();
+        mDestRenderSystem->setShadingType(pass->getShadingMode());
+    }
+    setPolygonMode(pass->getPolygonMode());
 
     mAutoParamDataSource->setPassNumber( pass->getIndex() );
     // mark global params as dirty
@@ -1276,7 +1612,7 @@ void SceneManager::prepareRenderQueue(void)
 //-----------------------------------------------------------------------
 void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverlays)
 {
-    OgreProfileGroup("_renderScene", OGREPROF_GENERAL);
+    OgreProfileStaticGroup("_renderScene", OGREPROF_GENERAL);
 
     Root::getSingleton()._pushCurrentSceneManager(this);
     mActiveQueuedRenderableVisitor->targetSceneMgr = this;
@@ -1293,6 +1629,9 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     LightList emptyLightList;
     useLights(emptyLightList, 0, true);
 
+    // the render system may have been used by someone else since the last pass
+    mRenderStateCache.invalidate();
+
     if (isShadowTechniqueInUse())
     {
         // Prepare shadow materials
@@ -1325,6 +1664,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
         // Update animations
         _applySceneAnimations();
         updateDirtyInstanceManagers();
+        mRenderStateStats.reset();
         mLastFrameNumber = thisFrameNumber;
     }
 
@@ -1334,7 +1674,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
         // Update scene graph for this camera (can happen multiple times per frame)
         {
-            OgreProfileGroup("_updateSceneGraph", OGREPROF_GENERAL);
+            OgreProfileStaticGroup("_updateSceneGraph", OGREPROF_GENERAL);
             _updateSceneGraph(camera);
 
             // Auto-track nodes
@@ -1353,6 +1693,10 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
             // Locate any lights which could be affecting the frustum
             findLightsAffectingFrustum(camera);
 
+            // Bin them before any light list is populated
+            if (mLightClusters.dirtyCounter != mLightsDirtyCounter)
+                buildLightClusters();
+
             // Are we using any shadows at all?
             if (isShadowTechniqueInUse() && vp->getShadowsEnabled())
             {
@@ -1360,7 +1704,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
                 // technique in use
                 if (isShadowTechniqueTextureBased())
                 {
-                    OgreProfileGroup("prepareShadowTextures", OGREPROF_GENERAL);
+                    OgreProfileStaticGroup("prepareShadowTextures", OGREPROF_GENERAL);
 
                     // *******
                     // WARNING
@@ -1408,13 +1752,13 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
         // Prepare render queue for receiving new objects
         {
-            OgreProfileGroup("prepareRenderQueue", OGREPROF_GENERAL);
+            OgreProfileStaticGroup("prepareRenderQueue", OGREPROF_GENERAL);
             prepareRenderQueue();
         }
 
         if (mFindVisibleObjects)
         {
-            OgreProfileGroup("_findVisibleObjects", OGREPROF_CULLING);
+            OgreProfileStaticGroup("_findVisibleObjects", OGREPROF_CULLING);
 
             // Assemble an AAB on the fly which contains the scene elements visible
             // by the camera.
@@ -1455,7 +1799,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     mDestRenderSystem->_beginFrame();
 
     // Set rasterisation mode
-    mDestRenderSystem->_setPolygonMode(camera->getPolygonMode());
+    setPolygonMode(camera->getPolygonMode());
 
     // Set initial camera state
     mDestRenderSystem->_setProjectionMatrix(mCameraInProgress->getProjectionMatrixRS());
@@ -1473,7 +1817,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     // Render scene content
     {
-        OgreProfileGroup("_renderVisibleObjects", OGREPROF_RENDERING);
+        OgreProfileStaticGroup("_renderVisibleObjects", OGREPROF_RENDERING);
         _renderVisibleObjects();
     }
 
@@ -1932,6 +2276,9 @@ void SceneManager::renderObjects(const QueuedRenderableCollection& objs,
 void SceneManager::_renderQueueGroupObjects(RenderQueueGroup* pGroup, 
                                            QueuedRenderableCollection::OrganisationMode om)
 {
+    // listeners may have changed the render system state
+    mRenderStateCache.invalidate();
+
     bool doShadows = 
         pGroup->getShadowsEnabled() && 
         mCurrentViewport->getShadowsEnabled() && 
@@ -2083,7 +2430,7 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
         TextureUnitState* pTex = *it;
         if (pTex->hasViewRelativeTextureCoordinateGeneration())
         {
-            mDestRenderSystem->_setTextureUnitSettings(unit, *pTex);
+            setTextureUnitSettings(unit, pTex);
         }
         ++unit;
     }
@@ -2121,7 +2468,10 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
         // this also copes with returning from negative scale in previous render op
         // for same pass
         if (cullMode != mDestRenderSystem->_getCullingMode())
+        {
             mDestRenderSystem->_setCullingMode(cullMode);
+            ++mRenderStateStats.stateChanges;
+        }
     }
 
     // Set up the solid / wireframe override
@@ -2138,7 +2488,7 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
             reqMode = camPolyMode;
         }
     }
-    mDestRenderSystem->_setPolygonMode(reqMode);
+    setPolygonMode(reqMode);
 
     if (!doLightIteration)
     {
@@ -2237,7 +2587,7 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
                     ++shadowTexIndex;
                     // Have to set TU on rendersystem right now, although
                     // autoparams will be set later
-                    mDestRenderSystem->_setTextureUnitSettings(tuindex, *tu);
+                    setTextureUnitSettings(tuindex, tu);
                 }
             }
             // Did we run out of lights before slots? e.g. 5 lights, 2 per iteration
@@ -2311,6 +2661,9 @@ void SceneManager::renderSingleObject(Renderable* rend, const Pass* pass,
 
             // Set modified depth bias right away
             mDestRenderSystem->_setDepthBias(depthBiasBase, pass->getDepthBiasSlopeScale());
+            // the render system may also derive it per iteration, so set it again for the next pass
+            mRenderStateCache.validBlocks &= ~uint32(RenderStateCache::SB_DEPTH_BIAS);
+            ++mRenderStateStats.stateChanges;
 
             // Set to increment internally too if rendersystem iterates
             mDestRenderSystem->setDeriveDepthBias(true,
@@ -2587,6 +2940,7 @@ void SceneManager::manualRender(RenderOperation* rend,
     setViewMatrix(viewMatrix);
     mDestRenderSystem->_setProjectionMatrix(projMatrix);
 
+    mRenderStateCache.invalidate();
     _setPass(pass);
     // Do we need to update GPU program parameters?
     if (pass->isProgrammable())
@@ -2625,6 +2979,7 @@ void SceneManager::manualRender(Renderable* rend, const Pass* pass, Viewport* vp
     setViewMatrix(viewMatrix);
     mDestRenderSystem->_setProjectionMatrix(projMatrix);
 
+    mRenderStateCache.invalidate();
     _setPass(pass);
     Camera dummyCam(BLANKSTRING, 0);
     dummyCam.setCustomViewMatrix(true, viewMatrix);
@@ -2819,8 +3174,8 @@ void SceneManager::fireRenderSingleObject(Renderable* rend, const Pass* pass,
 //---------------------------------------------------------------------
 void SceneManager::fireShadowTexturesUpdated(size_t numberOfShadowTextures)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    frame_vector<Listener*> listenersCopy(mListeners.begin(), mListeners.end());
+    frame_vector<Listener*>::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -2831,8 +3186,8 @@ void SceneManager::fireShadowTexturesUpdated(size_t numberOfShadowTextures)
 //---------------------------------------------------------------------
 void SceneManager::fireShadowTexturesPreCaster(Light* light, Camera* camera, size_t iteration)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    frame_vector<Listener*> listenersCopy(mListeners.begin(), mListeners.end());
+    frame_vector<Listener*>::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -2843,8 +3198,8 @@ void SceneManager::fireShadowTexturesPreCaster(Light* light, Camera* camera, siz
 //---------------------------------------------------------------------
 void SceneManager::fireShadowTexturesPreReceiver(Light* light, Frustum* f)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    frame_vector<Listener*> listenersCopy(mListeners.begin(), mListeners.end());
+    frame_vector<Listener*>::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -2855,8 +3210,8 @@ void SceneManager::fireShadowTexturesPreReceiver(Light* light, Frustum* f)
 //---------------------------------------------------------------------
 void SceneManager::firePreUpdateSceneGraph(Camera* camera)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    frame_vector<Listener*> listenersCopy(mListeners.begin(), mListeners.end());
+    frame_vector<Listener*>::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -2867,8 +3222,8 @@ void SceneManager::firePreUpdateSceneGraph(Camera* camera)
 //---------------------------------------------------------------------
 void SceneManager::firePostUpdateSceneGraph(Camera* camera)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    frame_vector<Listener*> listenersCopy(mListeners.begin(), mListeners.end());
+    frame_vector<Listener*>::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -2880,8 +3235,8 @@ void SceneManager::firePostUpdateSceneGraph(Camera* camera)
 //---------------------------------------------------------------------
 void SceneManager::firePreFindVisibleObjects(Viewport* v)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    frame_vector<Listener*> listenersCopy(mListeners.begin(), mListeners.end());
+    frame_vector<Listener*>::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -2893,8 +3248,8 @@ void SceneManager::firePreFindVisibleObjects(Viewport* v)
 //---------------------------------------------------------------------
 void SceneManager::firePostFindVisibleObjects(Viewport* v)
 {
-    ListenerList listenersCopy = mListeners;
-    ListenerList::iterator i, iend;
+    frame_vector<Listener*> listenersCopy(mListeners.begin(), mListeners.end());
+    frame_vector<Listener*>::iterator i, iend;
 
     iend = listenersCopy.end();
     for (i = listenersCopy.begin(); i != iend; ++i)
@@ -3139,8 +3494,8 @@ void SceneManager::findLightsAffectingFrustum(const Camera* camera)
             // Allow a Listener to override light sorting
             // Reverse iterate so last takes precedence
             bool overridden = false;
-            ListenerList listenersCopy = mListeners;
-            for (ListenerList::reverse_iterator ri = listenersCopy.rbegin();
+            frame_vector<Listener*> listenersCopy(mListeners.begin(), mListeners.end());
+            for (frame_vector<Listener*>::reverse_iterator ri = listenersCopy.rbegin();
                 ri != listenersCopy.rend(); ++ri)
             {
                 overridden = (*ri)->sortLightsAffectingFrustum(mLightsAffectingFrustum);
@@ -3783,7 +4138,7 @@ void SceneManager::_resumeRendering(SceneManager::RenderContext* context)
     mDestRenderSystem->_resumeFrame(context->rsContext);
 
     // Set rasterisation mode
-    mDestRenderSystem->_setPolygonMode(mCameraInProgress->getPolygonMode());
+    setPolygonMode(mCameraInProgress->getPolygonMode());
 
     // Set initial camera state
     mDestRenderSystem->_setProjectionMatrix(mCameraInProgress->getProjectionMatrixRS());
@@ -4322,6 +4677,7 @@ void SceneManager::_injectRenderWithPass(Pass *pass, Renderable *rend, bool shad
     bool doLightIteration, const LightList* manualLightList)
 {
     // render something as if it came from the current queue
+    mRenderStateCache.invalidate();
     const Pass *usedPass = _setPass(pass, false, shadowDerivation);
     renderSingleObject(rend, usedPass, false, doLightIteration, manualLightList);
 }
@@ -4485,11 +4841,87 @@ void SceneManager::bindGpuProgram(GpuProgram* prog)
     // need to dirty the light hash, and params that need resetting, since program params will have been invalidated
     // Use 1 to guarantee changing it (using 0 could result in no change if list is empty)
     // Hash == 1 is almost impossible to achieve otherwise
+    // The parameters come from the new pass even if the program is still bound
     mLastLightHash = 1;
     mGpuParamsDirty = (uint16)GPV_ALL;
+
+    GpuProgram*& boundProg = mRenderStateCache.programs[prog->getType()];
+    if (boundProg == prog)
+    {
+        ++mRenderStateStats.redundantChanges;
+        return;
+    }
+    boundProg = prog;
+    ++mRenderStateStats.programBinds;
     mDestRenderSystem->bindGpuProgram(prog);
 }
 //---------------------------------------------------------------------
+void SceneManager::setTextureUnitSettings(size_t unit, TextureUnitState* tex)
+{
+    if (unit < OGRE_MAX_TEXTURE_LAYERS)
+    {
+        // Effects and shadow / compositor content change the unit without changing the pointers
+        const Texture* texture = tex->_getTexturePtr().get();
+        bool cacheable = tex->getEffects().empty() && texture && texture->isLoaded() &&
+                         tex->getContentType() == TextureUnitState::CONTENT_NAMED;
+        if (cacheable && mRenderStateCache.textureUnits[unit] == tex &&
+            mRenderStateCache.textures[unit] == texture)
+        {
+            ++mRenderStateStats.redundantChanges;
+            return;
+        }
+        mRenderStateCache.textureUnits[unit] = cacheable ? tex : NULL;
+        mRenderStateCache.textures[unit] = texture;
+    }
+    ++mRenderStateStats.textureBinds;
+    mDestRenderSystem->_setTextureUnitSettings(unit, *tex);
+}
+//---------------------------------------------------------------------
+void SceneManager::disableTextureUnitsFrom(size_t texUnit)
+{
+    // A unit set again after being disabled has to be sent in full
+    for (size_t i = texUnit; i < OGRE_MAX_TEXTURE_LAYERS; ++i)
+    {
+        mRenderStateCache.textureUnits[i] = NULL;
+        mRenderStateCache.textures[i] = NULL;
+    }
+    mDestRenderSystem->_disableTextureUnitsFrom(texUnit);
+}
+//---------------------------------------------------------------------
+void SceneManager::setPolygonMode(PolygonMode mode)
+{
+    RenderStateCache& cache = mRenderStateCache;
+    if (cache.update(RenderStateCache::SB_POLYGON_MODE, cache.polygonMode != mode, mRenderStateStats))
+    {
+        cache.polygonMode = mode;
+        mDestRenderSystem->_setPolygonMode(mode);
+    }
+}
+//---------------------------------------------------------------------
+void SceneManager::RenderStateCache::invalidate(void)
+{
+    validBlocks = 0;
+    for (int i = 0; i < GPT_COUNT; ++i)
+        programs[i] = NULL;
+    for (size_t i = 0; i < OGRE_MAX_TEXTURE_LAYERS; ++i)
+    {
+        textureUnits[i] = NULL;
+        textures[i] = NULL;
+    }
+}
+//---------------------------------------------------------------------
+bool SceneManager::RenderStateCache::update(uint32 block, bool changed, RenderStateStats& stats)
+{
+    if (!changed && (validBlocks & block) == block)
+    {
+        ++stats.redundantChanges;
+        return false;
+    }
+    validBlocks |= block;
+    ++stats.stateChanges;
+    return true;
+}
+//---------------------------------------------------------------------
 void SceneManager::_markGpuParamsDirty(uint16 mask)
 {
     mGpuParamsDirty |= mask;
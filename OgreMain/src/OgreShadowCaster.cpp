@@ -29,8 +29,80 @@ THE SOFTWARE.
 #include "OgreLight.h"
 #include "OgreEdgeListBuilder.h"
 #include "OgreOptimisedUtil.h"
+#include "OgreThreadPool.h"
 
 namespace Ogre {
+    namespace
+    {
+        /// Edges tested for the silhouette per parallel range
+        const size_t SILHOUETTE_RANGE_SIZE = 8192;
+
+        /** Writes the vertex indexes of the silhouette edges in a range, ordered so
+            they run anticlockwise along the light facing triangle. Every edge is written,
+            only silhouette edges advance the output, which keeps the loop free of
+            unpredictable branches.
+        @return The number of silhouette edges written
+        */
+        size_t compactSilhouetteEdges(const EdgeData::Edge* edges, size_t numEdges,
+            const char* lightFacings, unsigned short* out)
+        {
+            size_t numSilhouetteEdges = 0;
+            for (size_t i = 0; i < numEdges; ++i)
+            {
+                const EdgeData::Edge& edge = edges[i];
+                // Silhouette edge, when two tris has opposite light facing, or
+                // degenerate edge where only tri 1 is valid and the tri light facing
+                char lightFacing = lightFacings[edge.triIndex[0]];
+                size_t otherTri = edge.degenerate ? edge.triIndex[0] : edge.triIndex[1];
+                char otherLightFacing = edge.degenerate ? 0 : lightFacings[otherTri];
+
+                assert(edge.vertIndex[0] < 65536 && edge.vertIndex[1] < 65536 &&
+                    "Vertex count exceeds 16-bit index limit!");
+                unsigned short v0 = static_cast<unsigned short>(edge.vertIndex[0]);
+                unsigned short v1 = static_cast<unsigned short>(edge.vertIndex[1]);
+                // Inverse edge indexes when t1 is light away
+                out[numSilhouetteEdges * 2] = lightFacing ? v0 : v1;
+                out[numSilhouetteEdges * 2 + 1] = lightFacing ? v1 : v0;
+                numSilhouetteEdges += lightFacing != otherLightFacing;
+            }
+            return numSilhouetteEdges;
+        }
+
+        /// Finds the silhouette edges of an edge group, in parallel for long edge lists
+        size_t findSilhouetteEdges(const EdgeData::EdgeGroup& eg, const char* lightFacings,
+            std::vector<unsigned short>& silhouette)
+        {
+            const size_t numEdges = eg.edges.size();
+            if (numEdges == 0)
+                return 0;
+            if (silhouette.size() < numEdges * 2)
+                silhouette.resize(numEdges * 2);
+
+            const EdgeData::Edge* edges = &eg.edges[0];
+            unsigned short* out = &silhouette[0];
+            ThreadPool* pool = ThreadPool::getSingletonPtr();
+            if (!pool || numEdges <= SILHOUETTE_RANGE_SIZE)
+                return compactSilhouetteEdges(edges, numEdges, lightFacings, out);
+
+            // Each range compacts in place, then the ranges are joined in order
+            std::vector<size_t> rangeCounts((numEdges + SILHOUETTE_RANGE_SIZE - 1) / SILHOUETTE_RANGE_SIZE);
+            pool->parallelFor(numEdges, SILHOUETTE_RANGE_SIZE, [&](size_t begin, size_t end)
+            {
+                rangeCounts[begin / SILHOUETTE_RANGE_SIZE] =
+                    compactSilhouetteEdges(edges + begin, end - begin, lightFacings, out + begin * 2);
+            });
+
+            size_t numSilhouetteEdges = rangeCounts[0];
+            for (size_t r = 1; r < rangeCounts.size(); ++r)
+            {
+                memmove(out + numSilhouetteEdges * 2, out + r * SILHOUETTE_RANGE_SIZE * 2,
+                        rangeCounts[r] * 2 * sizeof(unsigned short));
+                numSilhouetteEdges += rangeCounts[r];
+            }
+            return numSilhouetteEdges;
+        }
+    }
+
     const LightList& ShadowRenderable::getLights(void) const 
     {
         // return empty
@@ -51,7 +123,20 @@ namespace Ogre {
     void ShadowCaster::updateEdgeListLightFacing(EdgeData* edgeData, 
         const Vector4& lightPos)
     {
+        // Nothing to do while neither the light nor the caster moved. The light
+        // facings of an edge list shared with other casters may have been overwritten
+        // since, generateShadowVolume recalculates them if it needs them after all.
+        ShadowVolumeCache& cache = mShadowVolumeCache;
+        cache.lightFacingsReused = cache.indexesValid && cache.edgeData == edgeData &&
+            cache.faceNormalsVersion == edgeData->faceNormalsVersion && cache.lightPos == lightPos;
+        if (cache.lightFacingsReused)
+            return;
+
         edgeData->updateTriangleLightFacing(lightPos);
+        cache.edgeData = edgeData;
+        cache.faceNormalsVersion = edgeData->faceNormalsVersion;
+        cache.lightPos = lightPos;
+        cache.indexesValid = false;
     }
     // ------------------------------------------------------------------------
     static bool isBoundOkForMcGuire(const AxisAlignedBox& lightCapBounds, const Ogre::Vector3& lightPosition)
@@ -125,109 +210,23 @@ namespace Ogre {
         // or when light position is too close to light cap bound.
         bool useMcGuire = edgeData->edgeGroups.size() <= 1 && 
             (lightType == Light::LT_DIRECTIONAL || isBoundOkForMcGuire(getLightCapBounds(), light->getDerivedPosition()));
-        EdgeData::EdgeGroupList::const_iterator egi, egiend;
-        ShadowRenderableList::const_iterator si;
 
-        // pre-count the size of index data we need since it makes a big perf difference
-        // to GL in particular if we lock a smaller area of the index buffer
-        size_t preCountIndexes = 0;
-
-        si = shadowRenderables.begin();
-        egiend = edgeData->edgeGroups.end();
-        for (egi = edgeData->edgeGroups.begin(); egi != egiend; ++egi, ++si)
+        // Reuse the indexes of the last volume if the silhouette can't have changed
+        ShadowVolumeCache& cache = mShadowVolumeCache;
+        if (!cache.lightFacingsReused || cache.edgeData != edgeData || cache.flags != flags ||
+            cache.lightType != lightType || cache.useMcGuire != useMcGuire)
         {
-            const EdgeData::EdgeGroup& eg = *egi;
-            bool  firstDarkCapTri = true;
-
-            EdgeData::EdgeList::const_iterator i, iend;
-            iend = eg.edges.end();
-            for (i = eg.edges.begin(); i != iend; ++i)
+            if (cache.lightFacingsReused && cache.edgeData == edgeData)
             {
-                const EdgeData::Edge& edge = *i;
-
-                // Silhouette edge, when two tris has opposite light facing, or
-                // degenerate edge where only tri 1 is valid and the tri light facing
-                char lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
-                if ((edge.degenerate && lightFacing) ||
-                    (!edge.degenerate && (lightFacing != edgeData->triangleLightFacings[edge.triIndex[1]])))
-                {
-
-                    preCountIndexes += 3;
-
-                    // Are we extruding to infinity?
-                    if (!(lightType == Light::LT_DIRECTIONAL &&
-                        flags & SRF_EXTRUDE_TO_INFINITY))
-                    {
-                        preCountIndexes += 3;
-                    }
-
-                    if(useMcGuire)
-                    {
-                        // Do dark cap tri
-                        // Use McGuire et al method, a triangle fan covering all silhouette
-                        // edges and one point (taken from the initial tri)
-                        if (flags & SRF_INCLUDE_DARK_CAP)
-                        {
-                            if (firstDarkCapTri)
-                            {
-                                firstDarkCapTri = false;
-                            }
-                            else
-                            {
-                                preCountIndexes += 3;
-                            }
-                        }
-                    }
-                }
-
-            }
-
-            if(useMcGuire)
-            {
-                // Do light cap
-                if (flags & SRF_INCLUDE_LIGHT_CAP) 
-                {
-                    // Iterate over the triangles which are using this vertex set
-                    EdgeData::TriangleList::const_iterator ti, tiend;
-                    EdgeData::TriangleLightFacingList::const_iterator lfi;
-                    ti = edgeData->triangles.begin() + eg.triStart;
-                    tiend = ti + eg.triCount;
-                    lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                    for ( ; ti != tiend; ++ti, ++lfi)
-                    {
-                        assert(ti->vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
-                        {
-                            preCountIndexes += 3;
-                        }
-                    }
-
-                }
-            }
-            else
-            {
-                // Do both caps
-                int increment = ((flags & SRF_INCLUDE_DARK_CAP) ? 3 : 0) + ((flags & SRF_INCLUDE_LIGHT_CAP) ? 3 : 0);
-                if(increment != 0)
-                {
-                    // Iterate over the triangles which are using this vertex set
-                    EdgeData::TriangleList::const_iterator ti, tiend;
-                    EdgeData::TriangleLightFacingList::const_iterator lfi;
-                    ti = edgeData->triangles.begin() + eg.triStart;
-                    tiend = ti + eg.triCount;
-                    lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                    for ( ; ti != tiend; ++ti, ++lfi)
-                    {
-                        assert(ti->vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
-                            preCountIndexes += increment;
-                    }
-                }
+                // skipped by updateEdgeListLightFacing
+                edgeData->updateTriangleLightFacing(cache.lightPos);
             }
+            buildShadowVolumeIndexes(edgeData, light, useMcGuire, flags);
         }
-        // End pre-count
+
+        // we know the size of index data we need since it makes a big perf difference
+        // to GL in particular if we lock a smaller area of the index buffer
+        size_t preCountIndexes = cache.numIndexes;
         
         //Check if index buffer is to small 
         if (preCountIndexes > indexBuffer->getNumIndexes())
@@ -257,19 +256,20 @@ namespace Ogre {
         }
 
         // Lock index buffer for writing, just enough length as we need
-        HardwareBufferLockGuard indexLock(indexBuffer,
-            sizeof(unsigned short) * indexBufferUsedSize, sizeof(unsigned short) * preCountIndexes,
-            indexBufferUsedSize == 0 ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NO_OVERWRITE);
-        unsigned short* pIdx = static_cast<unsigned short*>(indexLock.pData);
+        {
+            HardwareBufferLockGuard indexLock(indexBuffer,
+                sizeof(unsigned short) * indexBufferUsedSize, sizeof(unsigned short) * preCountIndexes,
+                indexBufferUsedSize == 0 ? HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NO_OVERWRITE);
+            if (preCountIndexes)
+                memcpy(indexLock.pData, &cache.indexes[0], sizeof(unsigned short) * preCountIndexes);
+        }
         size_t numIndices = indexBufferUsedSize;
         
         // Iterate over the groups and form renderables for each based on their
         // lightFacing
-        si = shadowRenderables.begin();
-        egiend = edgeData->edgeGroups.end();
-        for (egi = edgeData->edgeGroups.begin(); egi != egiend; ++egi, ++si)
+        ShadowRenderableList::const_iterator si = shadowRenderables.begin();
+        for (size_t group = 0; group < edgeData->edgeGroups.size(); ++group, ++si)
         {
-            const EdgeData::EdgeGroup& eg = *egi;
             // Initialise the index start for this shadow renderable
             IndexData* indexData = (*si)->getRenderOperationForUpdate()->indexData;
 
@@ -280,173 +280,161 @@ namespace Ogre {
             }
 
             indexData->indexStart = numIndices;
+            numIndices += cache.groupIndexCounts[group].first;
+
+            // separate light cap?
+            if ((flags & SRF_INCLUDE_LIGHT_CAP) && (*si)->isLightCapSeparate())
+            {
+                // update index count for this shadow renderable
+                indexData->indexCount = numIndices - indexData->indexStart;
+
+                // get light cap index data for update
+                indexData = (*si)->getLightCapRenderable()->getRenderOperationForUpdate()->indexData;
+                // start indexes after the current total
+                indexData->indexStart = numIndices;
+            }
+            numIndices += cache.groupIndexCounts[group].second;
+
+            // update index count for current index data (either this shadow renderable or its light cap)
+            indexData->indexCount = numIndices - indexData->indexStart;
+        }
+
+        // In debug mode, check we didn't overrun the index buffer
+        assert(numIndices == indexBufferUsedSize + preCountIndexes);
+        assert(numIndices <= indexBuffer->getNumIndexes() &&
+            "Index buffer overrun while generating shadow volume!! "
+            "You must increase the size of the shadow index buffer.");
+
+        indexBufferUsedSize = numIndices;
+    }
+    // ------------------------------------------------------------------------
+    void ShadowCaster::buildShadowVolumeIndexes(EdgeData* edgeData, const Light* light,
+        bool useMcGuire, unsigned long flags)
+    {
+        ShadowVolumeCache& cache = mShadowVolumeCache;
+        const EdgeData::EdgeGroupList& edgeGroups = edgeData->edgeGroups;
+        const char* lightFacings = edgeData->triangleLightFacings.empty() ? 0 : &edgeData->triangleLightFacings[0];
+        // Are we extruding to infinity?
+        bool extrudeToInfinity = light->getType() == Light::LT_DIRECTIONAL && (flags & SRF_EXTRUDE_TO_INFINITY);
+
+        // At most 3 triangles per silhouette edge and 2 per light facing triangle
+        size_t maxIndexes = 0;
+        for (size_t group = 0; group < edgeGroups.size(); ++group)
+            maxIndexes += edgeGroups[group].edges.size() * 9 + edgeGroups[group].triCount * 6;
+        if (cache.indexes.size() < maxIndexes)
+            cache.indexes.resize(maxIndexes);
+        cache.groupIndexCounts.resize(edgeGroups.size());
+        unsigned short* pIdx = cache.indexes.empty() ? 0 : &cache.indexes[0];
+        const unsigned short* pStart = pIdx;
+
+        for (size_t group = 0; group < edgeGroups.size(); ++group)
+        {
+            const EdgeData::EdgeGroup& eg = edgeGroups[group];
+            const unsigned short* pGroupStart = pIdx;
             // original number of verts (without extruded copy)
-            size_t originalVertexCount = eg.vertexData->vertexCount;
-            bool  firstDarkCapTri = true;
+            assert(eg.vertexData->vertexCount * 2 <= 65536 && "Vertex count exceeds 16-bit index limit!");
+            unsigned short originalVertexCount = static_cast<unsigned short>(eg.vertexData->vertexCount);
+            bool firstDarkCapTri = true;
             unsigned short darkCapStart = 0;
 
-            EdgeData::EdgeList::const_iterator i, iend;
-            iend = eg.edges.end();
-            for (i = eg.edges.begin(); i != iend; ++i)
+            size_t numSilhouetteEdges = findSilhouetteEdges(eg, lightFacings, cache.silhouette);
+            const unsigned short* silhouette = cache.silhouette.empty() ? 0 : &cache.silhouette[0];
+            for (size_t e = 0; e < numSilhouetteEdges; ++e)
             {
-                const EdgeData::Edge& edge = *i;
-
-                // Silhouette edge, when two tris has opposite light facing, or
-                // degenerate edge where only tri 1 is valid and the tri light facing
-                char lightFacing = edgeData->triangleLightFacings[edge.triIndex[0]];
-                if ((edge.degenerate && lightFacing) ||
-                    (!edge.degenerate && (lightFacing != edgeData->triangleLightFacings[edge.triIndex[1]])))
+                unsigned short v0 = silhouette[e * 2];
+                unsigned short v1 = silhouette[e * 2 + 1];
+
+                /* Note edge(v0, v1) run anticlockwise along the edge from
+                the light facing tri so to point shadow volume tris outward,
+                light cap indexes have to be backwards
+
+                We emit 2 tris if light is a point light, 1 if light 
+                is directional, because directional lights cause all
+                points to converge to a single point at infinity.
+
+                First side tri = near1, near0, far0
+                Second tri = far0, far1, near1
+
+                'far' indexes are 'near' index + originalVertexCount
+                because 'far' verts are in the second half of the 
+                buffer
+                */
+                pIdx[0] = v1;
+                pIdx[1] = v0;
+                pIdx[2] = v0 + originalVertexCount;
+                pIdx += 3;
+
+                if (!extrudeToInfinity)
                 {
-                    size_t v0 = edge.vertIndex[0];
-                    size_t v1 = edge.vertIndex[1];
-                    if (!lightFacing)
-                    {
-                        // Inverse edge indexes when t1 is light away
-                        std::swap(v0, v1);
-                    }
+                    // additional tri to make quad
+                    pIdx[0] = v0 + originalVertexCount;
+                    pIdx[1] = v1 + originalVertexCount;
+                    pIdx[2] = v1;
+                    pIdx += 3;
+                }
 
-                    /* Note edge(v0, v1) run anticlockwise along the edge from
-                    the light facing tri so to point shadow volume tris outward,
-                    light cap indexes have to be backwards
-
-                    We emit 2 tris if light is a point light, 1 if light 
-                    is directional, because directional lights cause all
-                    points to converge to a single point at infinity.
-
-                    First side tri = near1, near0, far0
-                    Second tri = far0, far1, near1
-
-                    'far' indexes are 'near' index + originalVertexCount
-                    because 'far' verts are in the second half of the 
-                    buffer
-                    */
-                    assert(v1 < 65536 && v0 < 65536 && (v0 + originalVertexCount) < 65536 &&
-                        "Vertex count exceeds 16-bit index limit!");
-                    *pIdx++ = static_cast<unsigned short>(v1);
-                    *pIdx++ = static_cast<unsigned short>(v0);
-                    *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                    numIndices += 3;
-
-                    // Are we extruding to infinity?
-                    if (!(lightType == Light::LT_DIRECTIONAL &&
-                        flags & SRF_EXTRUDE_TO_INFINITY))
+                // Do dark cap tri
+                // Use McGuire et al method, a triangle fan covering all silhouette
+                // edges and one point (taken from the initial tri)
+                if (useMcGuire && (flags & SRF_INCLUDE_DARK_CAP))
+                {
+                    if (firstDarkCapTri)
                     {
-                        // additional tri to make quad
-                        *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                        *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
-                        *pIdx++ = static_cast<unsigned short>(v1);
-                        numIndices += 3;
+                        darkCapStart = v0 + originalVertexCount;
+                        firstDarkCapTri = false;
                     }
-
-                    if(useMcGuire)
+                    else
                     {
-                        // Do dark cap tri
-                        // Use McGuire et al method, a triangle fan covering all silhouette
-                        // edges and one point (taken from the initial tri)
-                        if (flags & SRF_INCLUDE_DARK_CAP)
-                        {
-                            if (firstDarkCapTri)
-                            {
-                                darkCapStart = static_cast<unsigned short>(v0 + originalVertexCount);
-                                firstDarkCapTri = false;
-                            }
-                            else
-                            {
-                                *pIdx++ = darkCapStart;
-                                *pIdx++ = static_cast<unsigned short>(v1 + originalVertexCount);
-                                *pIdx++ = static_cast<unsigned short>(v0 + originalVertexCount);
-                                numIndices += 3;
-                            }
-
-                        }
+                        pIdx[0] = darkCapStart;
+                        pIdx[1] = v1 + originalVertexCount;
+                        pIdx[2] = v0 + originalVertexCount;
+                        pIdx += 3;
                     }
                 }
-
             }
 
-            if(!useMcGuire)
+            // The triangles which are using this vertex set, the caps are made of the
+            // light facing ones. As with the edges only those advance the output.
+            const EdgeData::Triangle* triangles = eg.triCount ? &edgeData->triangles[eg.triStart] : 0;
+            const char* triLightFacings = eg.triCount ? lightFacings + eg.triStart : 0;
+
+            // Do dark cap
+            if (!useMcGuire && (flags & SRF_INCLUDE_DARK_CAP))
             {
-                // Do dark cap
-                if (flags & SRF_INCLUDE_DARK_CAP) 
+                for (size_t t = 0; t < eg.triCount; ++t)
                 {
-                    // Iterate over the triangles which are using this vertex set
-                    EdgeData::TriangleList::const_iterator ti, tiend;
-                    EdgeData::TriangleLightFacingList::const_iterator lfi;
-                    ti = edgeData->triangles.begin() + eg.triStart;
-                    tiend = ti + eg.triCount;
-                    lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                    for ( ; ti != tiend; ++ti, ++lfi)
-                    {
-                        const EdgeData::Triangle& t = *ti;
-                        assert(t.vertexSet == eg.vertexSet);
-                        // Check it's light facing
-                        if (*lfi)
-                        {
-                            assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
-                                t.vertIndex[2] < 65536 && 
-                                "16-bit index limit exceeded!");
-                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[1] + originalVertexCount);
-                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[0] + originalVertexCount);
-                            *pIdx++ = static_cast<unsigned short>(t.vertIndex[2] + originalVertexCount);
-                            numIndices += 3;
-                        }
-                    }
-
+                    const EdgeData::Triangle& tri = triangles[t];
+                    assert(tri.vertexSet == eg.vertexSet);
+                    pIdx[0] = static_cast<unsigned short>(tri.vertIndex[1] + originalVertexCount);
+                    pIdx[1] = static_cast<unsigned short>(tri.vertIndex[0] + originalVertexCount);
+                    pIdx[2] = static_cast<unsigned short>(tri.vertIndex[2] + originalVertexCount);
+                    pIdx += 3 * triLightFacings[t];
                 }
             }
+            cache.groupIndexCounts[group].first = pIdx - pGroupStart;
 
             // Do light cap
-            if (flags & SRF_INCLUDE_LIGHT_CAP) 
+            const unsigned short* pLightCapStart = pIdx;
+            if (flags & SRF_INCLUDE_LIGHT_CAP)
             {
-                // separate light cap?
-                if ((*si)->isLightCapSeparate())
+                for (size_t t = 0; t < eg.triCount; ++t)
                 {
-                    // update index count for this shadow renderable
-                    indexData->indexCount = numIndices - indexData->indexStart;
-
-                    // get light cap index data for update
-                    indexData = (*si)->getLightCapRenderable()->getRenderOperationForUpdate()->indexData;
-                    // start indexes after the current total
-                    indexData->indexStart = numIndices;
-                }
-
-                // Iterate over the triangles which are using this vertex set
-                EdgeData::TriangleList::const_iterator ti, tiend;
-                EdgeData::TriangleLightFacingList::const_iterator lfi;
-                ti = edgeData->triangles.begin() + eg.triStart;
-                tiend = ti + eg.triCount;
-                lfi = edgeData->triangleLightFacings.begin() + eg.triStart;
-                for ( ; ti != tiend; ++ti, ++lfi)
-                {
-                    const EdgeData::Triangle& t = *ti;
-                    assert(t.vertexSet == eg.vertexSet);
-                    // Check it's light facing
-                    if (*lfi)
-                    {
-                        assert(t.vertIndex[0] < 65536 && t.vertIndex[1] < 65536 &&
-                            t.vertIndex[2] < 65536 && 
-                            "16-bit index limit exceeded!");
-                        *pIdx++ = static_cast<unsigned short>(t.vertIndex[0]);
-                        *pIdx++ = static_cast<unsigned short>(t.vertIndex[1]);
-                        *pIdx++ = static_cast<unsigned short>(t.vertIndex[2]);
-                        numIndices += 3;
-                    }
+                    const EdgeData::Triangle& tri = triangles[t];
+                    assert(tri.vertexSet == eg.vertexSet);
+                    pIdx[0] = static_cast<unsigned short>(tri.vertIndex[0]);
+                    pIdx[1] = static_cast<unsigned short>(tri.vertIndex[1]);
+                    pIdx[2] = static_cast<unsigned short>(tri.vertIndex[2]);
+                    pIdx += 3 * triLightFacings[t];
                 }
-
             }
-
-            // update index count for current index data (either this shadow renderable or its light cap)
-            indexData->indexCount = numIndices - indexData->indexStart;
-
+            cache.groupIndexCounts[group].second = pIdx - pLightCapStart;
         }
 
-        // In debug mode, check we didn't overrun the index buffer
-        assert(numIndices == indexBufferUsedSize + preCountIndexes);
-        assert(numIndices <= indexBuffer->getNumIndexes() &&
-            "Index buffer overrun while generating shadow volume!! "
-            "You must increase the size of the shadow index buffer.");
-
-        indexBufferUsedSize = numIndices;
+        cache.numIndexes = pIdx - pStart;
+        cache.flags = flags;
+        cache.lightType = light->getType();
+        cache.useMcGuire = useMcGuire;
+        cache.indexesValid = true;
     }
     // ------------------------------------------------------------------------
     void ShadowCaster::extrudeVertices(
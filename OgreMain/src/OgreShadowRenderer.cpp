@@ -187,6 +187,7 @@ void SceneManager::ShadowRenderer::renderAdditiveStencilShadowedQueueGroupObject
             mDestRenderSystem->setStencilBufferParams();
             mDestRenderSystem->setStencilCheckEnabled(false);
             mDestRenderSystem->_setDepthBufferParams();
+            mSceneManager->_invalidateRenderStateCache();
 
             if (scissored == CLIPPED_SOME)
                 mSceneManager->resetScissor();
@@ -268,6 +269,7 @@ void SceneManager::ShadowRenderer::renderModulativeStencilShadowedQueueGroupObje
             mDestRenderSystem->setStencilBufferParams();
             mDestRenderSystem->setStencilCheckEnabled(false);
             mDestRenderSystem->_setDepthBufferParams();
+            mSceneManager->_invalidateRenderStateCache();
         }
 
     }// for each light
@@ -943,6 +945,8 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
     }
 
     mDestRenderSystem->unbindGpuProgram(GPT_FRAGMENT_PROGRAM);
+    // state is set directly from here on
+    mSceneManager->_invalidateRenderStateCache();
 
     // Can we do a 2-sided stencil?
     bool stencil2sided = false;
@@ -1017,7 +1021,7 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
     ColourBlendState disabled;
     disabled.writeR = disabled.writeG = disabled.writeB = disabled.writeA = false;
     mDestRenderSystem->setColourBlendState(disabled);
-    mDestRenderSystem->_disableTextureUnitsFrom(0);
+    mSceneManager->disableTextureUnitsFrom(0);
     mDestRenderSystem->_setDepthBufferParams(true, false, CMPF_LESS);
     mDestRenderSystem->setStencilCheckEnabled(true);
 
@@ -1135,6 +1139,7 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
                 true, false, false);
             mDestRenderSystem->setColourBlendState(disabled);
             mDestRenderSystem->_setDepthBufferFunction(CMPF_LESS);
+            mSceneManager->_invalidateRenderStateCache();
         }
     }
 
@@ -1144,6 +1149,7 @@ void SceneManager::ShadowRenderer::renderShadowVolumesToStencil(const Light* lig
     mDestRenderSystem->setStencilCheckEnabled(false);
 
     mDestRenderSystem->unbindGpuProgram(GPT_VERTEX_PROGRAM);
+    mSceneManager->_invalidateRenderStateCache();
 
     if (scissored == CLIPPED_SOME)
     {
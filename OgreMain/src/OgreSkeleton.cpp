@@ -679,6 +679,14 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void Skeleton::compressAllAnimations(Real tolerance)
+    {
+        for (AnimationList::iterator ai = mAnimationsList.begin(); ai != mAnimationsList.end(); ++ai)
+        {
+            ai->second->compressNodeTracks(tolerance);
+        }
+    }
+    //---------------------------------------------------------------------
     void Skeleton::addLinkedSkeletonAnimationSource(const String& skelName, 
         Real scale)
     {
@@ -921,6 +929,14 @@ namespace Ogre {
                 }
             }
 
+            if (srcAnimation->getCompressedClip() && !srcAnimation->getNumNodeTracks())
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALID_STATE,
+                    "Animation " + srcAnimation->getName() + " only has compressed node tracks, "
+                    "merge the skeletons before compressing",
+                    "Skeleton::_mergeSkeletonAnimations");
+            }
+
             // Create target animation
             Animation* dstAnimation = this->createAnimation(srcAnimation->getName(), srcAnimation->getLength());
 
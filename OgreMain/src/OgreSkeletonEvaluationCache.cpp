@@ -0,0 +1,127 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+#include "OgreSkeletonEvaluationCache.h"
+#include "OgreSkeletonInstance.h"
+
+namespace Ogre {
+    //---------------------------------------------------------------------
+    SkeletonEvaluationCache::SkeletonEvaluationCache()
+        : mEnabled(false), mFrameNumber(0), mNumEntries(0)
+    {
+    }
+    //---------------------------------------------------------------------
+    void SkeletonEvaluationCache::setEnabled(bool enabled)
+    {
+        mEnabled = enabled;
+        if (!mEnabled)
+            clear();
+    }
+    //---------------------------------------------------------------------
+    void SkeletonEvaluationCache::clear(void)
+    {
+        mNumEntries = 0;
+        mIndex.clear();
+    }
+    //---------------------------------------------------------------------
+    bool SkeletonEvaluationCache::_getBoneMatrices(const Skeleton* master, SkeletonInstance* instance,
+                                                   const AnimationStateSet& animSet,
+                                                   unsigned long frameNumber, Affine3* matrices)
+    {
+        if (!mEnabled)
+        {
+            instance->setAnimationState(animSet);
+            instance->_getBoneMatrices(matrices);
+            return false;
+        }
+
+        if (frameNumber != mFrameNumber)
+        {
+            clear();
+            mFrameNumber = frameNumber;
+        }
+        ++mStatistics.lookups;
+
+        // build the key of this evaluation
+        uint16 blendMode = static_cast<uint16>(instance->getBlendMode());
+        uint32 hash = HashCombine(0, master);
+        hash = HashCombine(hash, blendMode);
+        mKey.resize(animSet.getEnabledAnimationStates().size());
+        size_t s = 0;
+        EnabledAnimationStateList::const_iterator it;
+        for (it = animSet.getEnabledAnimationStates().begin();
+             it != animSet.getEnabledAnimationStates().end(); ++it, ++s)
+        {
+            const AnimationState* state = *it;
+            StateKey& key = mKey[s];
+            key.name = state->getAnimationName();
+            key.timePos = state->getTimePosition();
+            key.weight = state->getWeight();
+            key.blendMask.clear();
+            if (state->hasBlendMask())
+                key.blendMask = *state->getBlendMask();
+
+            hash = FastHash(key.name.c_str(), key.name.size(), hash);
+            hash = HashCombine(hash, key.timePos);
+            hash = HashCombine(hash, key.weight);
+            if (!key.blendMask.empty())
+                hash = FastHash((const char*)&key.blendMask[0], key.blendMask.size() * sizeof(float), hash);
+        }
+
+        size_t numBones = instance->getNumBones();
+        std::pair<EntryIndex::iterator, EntryIndex::iterator> range = mIndex.equal_range(hash);
+        for (EntryIndex::iterator e = range.first; e != range.second; ++e)
+        {
+            const Entry& entry = mEntries[e->second];
+            if (entry.skeleton == master && entry.blendMode == blendMode &&
+                entry.matrices.size() == numBones && entry.states == mKey)
+            {
+                std::copy(entry.matrices.begin(), entry.matrices.end(), matrices);
+                ++mStatistics.hits;
+                return true;
+            }
+        }
+
+        instance->setAnimationState(animSet);
+        instance->_getBoneMatrices(matrices);
+
+        // reuse the storage of entries from previous frames
+        if (mNumEntries == mEntries.size())
+            mEntries.push_back(Entry());
+        Entry& entry = mEntries[mNumEntries];
+        entry.skeleton = master;
+        entry.blendMode = blendMode;
+        entry.states = mKey;
+        entry.matrices.assign(matrices, matrices + numBones);
+        mIndex.insert(EntryIndex::value_type(hash, mNumEntries));
+        ++mNumEntries;
+
+        return false;
+    }
+}
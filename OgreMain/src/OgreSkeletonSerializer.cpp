@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreAnimation.h"
 #include "OgreAnimationTrack.h"
 #include "OgreKeyFrame.h"
+#include "OgreCompressedAnimationClip.h"
 
 namespace Ogre {
     /// stream overhead = ID + size
@@ -61,6 +62,15 @@ namespace Ogre {
     void SkeletonSerializer::exportSkeleton(const Skeleton* pSkeleton, 
         DataStreamPtr stream, SkeletonVersion ver, Endian endianMode)
     {
+        // only write the version that needs the compressed animation reader if it is used
+        if ((int)ver >= (int)SKELETON_VERSION_1_12)
+        {
+            bool compressed = false;
+            for (unsigned short i = 0; i < pSkeleton->getNumAnimations() && !compressed; ++i)
+                compressed = pSkeleton->getAnimation(i)->getCompressedClip() != 0;
+            if (!compressed)
+                ver = SKELETON_VERSION_1_8;
+        }
         setWorkingVersion(ver);
         // Decide on endian mode
         determineEndianness(endianMode);
@@ -124,7 +134,8 @@ namespace Ogre {
         // Read version
         String ver = readString(stream);
         if ((ver != "[Serializer_v1.10]") &&
-            (ver != "[Serializer_v1.80]"))
+            (ver != "[Serializer_v1.80]") &&
+            (ver != "[Serializer_v1.120]"))
         {
             OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
                 "Invalid file: version incompatible, file reports " + String(ver),
@@ -176,7 +187,9 @@ namespace Ogre {
     {
         if (ver == SKELETON_VERSION_1_0)
             mVersion = "[Serializer_v1.10]";
-        else mVersion = "[Serializer_v1.80]";
+        else if (ver == SKELETON_VERSION_1_8)
+            mVersion = "[Serializer_v1.80]";
+        else mVersion = "[Serializer_v1.120]";
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeleton(const Skeleton* pSkel, SkeletonVersion ver)
@@ -250,6 +263,15 @@ namespace Ogre {
     void SkeletonSerializer::writeAnimation(const Skeleton* pSkel, 
         const Animation* anim, SkeletonVersion ver)
     {
+        const CompressedAnimationClip* clip = anim->getCompressedClip();
+        if (clip && !anim->getNumNodeTracks() && (int)ver < (int)SKELETON_VERSION_1_12)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Animation " + anim->getName() + " only has compressed node tracks, "
+                "which require at least SKELETON_VERSION_1_12",
+                "SkeletonSerializer::writeAnimation");
+        }
+
         writeChunkHeader(SKELETON_ANIMATION, calcAnimationSize(pSkel, anim, ver));
 
         // char* name                       : Name of the animation
@@ -286,6 +308,11 @@ namespace Ogre {
         {
             writeAnimationTrack(pSkel, trackIt.getNext());
         }
+
+        if (clip && (int)ver >= (int)SKELETON_VERSION_1_12)
+        {
+            writeCompressedAnimation(clip);
+        }
         }
         popInnerChunk(mStream);
 
@@ -329,6 +356,32 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::writeCompressedAnimation(const CompressedAnimationClip* clip)
+    {
+        writeChunkHeader(SKELETON_ANIMATION_COMPRESSED, calcCompressedAnimationSize(clip));
+
+        // unsigned short flags              : 1 if rotations use spherical interpolation
+        uint16 flags = clip->mSphericalRotation ? 1 : 0;
+        writeShorts(&flags, 1);
+        // unsigned int numTracks
+        uint32 numTracks = static_cast<uint32>(clip->mHandles.size());
+        writeInts(&numTracks, 1);
+        // unsigned int numKeys
+        uint32 numKeys = static_cast<uint32>(clip->mKeyTimes.size());
+        writeInts(&numKeys, 1);
+        if (numTracks)
+        {
+            writeShorts(&clip->mHandles[0], numTracks);
+            writeInts(&clip->mKeyStart[0], clip->mKeyStart.size());
+            writeFloats(&clip->mRanges[0], clip->mRanges.size());
+        }
+        if (numKeys)
+        {
+            writeShorts(&clip->mKeyTimes[0], numKeys);
+            writeShorts(&clip->mKeyValues[0], clip->mKeyValues.size());
+        }
+    }
+    //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcBoneSize(const Skeleton* pSkel, 
         const Bone* pBone)
     {
@@ -405,6 +458,11 @@ namespace Ogre {
             size += calcAnimationTrackSize(pSkel, trackIt.getNext());
         }
 
+        if (pAnim->getCompressedClip() && (int)ver >= (int)SKELETON_VERSION_1_12)
+        {
+            size += calcCompressedAnimationSize(pAnim->getCompressedClip());
+        }
+
         return size;
     }
     //---------------------------------------------------------------------
@@ -454,6 +512,22 @@ namespace Ogre {
         return size;
     }
     //---------------------------------------------------------------------
+    size_t SkeletonSerializer::calcCompressedAnimationSize(const CompressedAnimationClip* clip)
+    {
+        size_t size = SSTREAM_OVERHEAD_SIZE;
+
+        // flags, numTracks and numKeys
+        size += sizeof(uint16) + sizeof(uint32) * 2;
+        // handles, key starts and ranges
+        size += sizeof(uint16) * clip->mHandles.size();
+        size += sizeof(uint32) * clip->mKeyStart.size();
+        size += sizeof(float) * clip->mRanges.size();
+        // key times and values
+        size += sizeof(uint16) * (clip->mKeyTimes.size() + clip->mKeyValues.size());
+
+        return size;
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::readBone(DataStreamPtr& stream, Skeleton* pSkel)
     {
         // char* name
@@ -553,6 +627,16 @@ namespace Ogre {
                     streamID = readChunk(stream);
                 }
             }
+            if (streamID == SKELETON_ANIMATION_COMPRESSED && !stream->eof())
+            {
+                readCompressedAnimation(stream, pAnim);
+
+                if (!stream->eof())
+                {
+                    // Get next stream
+                    streamID = readChunk(stream);
+                }
+            }
             if (!stream->eof())
             {
                 // Backpedal back to start of this stream if we've found a non-track
@@ -627,6 +711,50 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::readCompressedAnimation(DataStreamPtr& stream, Animation* anim)
+    {
+        CompressedAnimationClip* clip = OGRE_NEW CompressedAnimationClip();
+        clip->mLength = anim->getLength();
+
+        // unsigned short flags              : 1 if rotations use spherical interpolation
+        uint16 flags;
+        readShorts(stream, &flags, 1);
+        clip->mSphericalRotation = (flags & 1) != 0;
+        // unsigned int numTracks
+        uint32 numTracks;
+        readInts(stream, &numTracks, 1);
+        // unsigned int numKeys
+        uint32 numKeys;
+        readInts(stream, &numKeys, 1);
+
+        clip->mHandles.resize(numTracks);
+        clip->mKeyStart.resize(numTracks * CompressedAnimationClip::CH_COUNT + 1, 0);
+        clip->mRanges.resize(numTracks * CompressedAnimationClip::CH_COUNT * 6);
+        clip->mKeyTimes.resize(numKeys);
+        clip->mKeyValues.resize(numKeys * 3);
+        if (numTracks)
+        {
+            readShorts(stream, &clip->mHandles[0], numTracks);
+            readInts(stream, &clip->mKeyStart[0], clip->mKeyStart.size());
+            readFloats(stream, &clip->mRanges[0], clip->mRanges.size());
+        }
+        if (numKeys)
+        {
+            readShorts(stream, &clip->mKeyTimes[0], numKeys);
+            readShorts(stream, &clip->mKeyValues[0], clip->mKeyValues.size());
+        }
+
+        if (clip->mKeyStart.back() != numKeys)
+        {
+            OGRE_DELETE clip;
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                "Invalid compressed tracks in animation " + anim->getName(),
+                "SkeletonSerializer::readCompressedAnimation");
+        }
+
+        anim->_setCompressedClip(clip);
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeletonAnimationLink(const Skeleton* pSkel, 
         const LinkedSkeletonAnimationSource& link)
     {
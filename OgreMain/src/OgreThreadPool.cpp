@@ -0,0 +1,193 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "OgreStableHeaders.h"
+#include "OgreThreadPool.h"
+
+namespace Ogre
+{
+    //-----------------------------------------------------------------------
+    template<> ThreadPool* Singleton<ThreadPool>::msSingleton = 0;
+    ThreadPool* ThreadPool::getSingletonPtr(void)
+    {
+        return msSingleton;
+    }
+    ThreadPool& ThreadPool::getSingleton(void)
+    {
+        assert( msSingleton );  return ( *msSingleton );
+    }
+    //-----------------------------------------------------------------------
+    ThreadPool::ThreadPool(size_t numThreads)
+        : mNumThreads(numThreads)
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+        , mWorkerFunc(0)
+        , mGeneration(0)
+        , mBusyThreads(0)
+        , mRunning(false)
+        , mShuttingDown(false)
+#endif
+        , mFunc(0)
+        , mCount(0)
+        , mRangeSize(1)
+        , mNextRange(0)
+    {
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+        if (!mNumThreads)
+        {
+            size_t hardwareThreads = OGRE_THREAD_HARDWARE_CONCURRENCY;
+            mNumThreads = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+        }
+#else
+        mNumThreads = 0;
+#endif
+    }
+    //-----------------------------------------------------------------------
+    ThreadPool::~ThreadPool()
+    {
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+        {
+            OGRE_WQ_LOCK_MUTEX(mMutex);
+            mShuttingDown = true;
+            OGRE_THREAD_NOTIFY_ALL(mWorkCondition);
+        }
+
+        for (size_t i = 0; i < mThreads.size(); ++i)
+        {
+            mThreads[i]->join();
+            OGRE_THREAD_DESTROY(mThreads[i]);
+        }
+        mThreads.clear();
+
+        OGRE_DELETE_T(mWorkerFunc, WorkerFunc, MEMCATEGORY_GENERAL);
+#endif
+    }
+    //-----------------------------------------------------------------------
+    void ThreadPool::processRanges(void)
+    {
+        size_t numRanges = (mCount + mRangeSize - 1) / mRangeSize;
+        for (size_t range = mNextRange++; range < numRanges; range = mNextRange++)
+        {
+            size_t begin = range * mRangeSize;
+            (*mFunc)(begin, std::min(begin + mRangeSize, mCount));
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ThreadPool::parallelFor(size_t count, size_t rangeSize, const RangeFunction& func)
+    {
+        rangeSize = std::max<size_t>(rangeSize, 1);
+
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+        bool parallel = mNumThreads && count > rangeSize;
+        if (parallel)
+        {
+            OGRE_WQ_LOCK_MUTEX(mMutex);
+            // nested loops and loops from other threads run serially
+            parallel = !mFunc && !mShuttingDown;
+            if (parallel)
+            {
+                if (!mRunning)
+                    startThreads();
+
+                mFunc = &func;
+                mCount = count;
+                mRangeSize = rangeSize;
+                mNextRange = 0;
+                mBusyThreads = mThreads.size();
+                ++mGeneration;
+                OGRE_THREAD_NOTIFY_ALL(mWorkCondition);
+            }
+        }
+
+        if (parallel)
+        {
+            processRanges();
+
+            OGRE_WQ_LOCK_MUTEX_NAMED(mMutex, lock);
+            while (mBusyThreads)
+                OGRE_THREAD_WAIT(mDoneCondition, mMutex, lock);
+            mFunc = 0;
+            return;
+        }
+#endif
+        for (size_t begin = 0; begin < count; begin += rangeSize)
+            func(begin, std::min(begin + rangeSize, count));
+    }
+#if OGRE_THREAD_SUPPORT && OGRE_THREAD_PROVIDER != 3
+    //-----------------------------------------------------------------------
+    void ThreadPool::startThreads(void)
+    {
+        mWorkerFunc = OGRE_NEW_T(WorkerFunc(this), MEMCATEGORY_GENERAL);
+        for (size_t i = 0; i < mNumThreads; ++i)
+        {
+            OGRE_THREAD_CREATE(t, *mWorkerFunc);
+            mThreads.push_back(t);
+        }
+        mRunning = true;
+    }
+    //-----------------------------------------------------------------------
+    void ThreadPool::workerLoop(void)
+    {
+        uint32 generation = 0;
+        while (true)
+        {
+            {
+                OGRE_WQ_LOCK_MUTEX_NAMED(mMutex, lock);
+                while (!mShuttingDown && mGeneration == generation)
+                    OGRE_THREAD_WAIT(mWorkCondition, mMutex, lock);
+
+                if (mShuttingDown)
+                    return;
+                generation = mGeneration;
+            }
+
+            processRanges();
+
+            {
+                OGRE_WQ_LOCK_MUTEX(mMutex);
+                if (--mBusyThreads == 0)
+                    OGRE_THREAD_NOTIFY_ALL(mDoneCondition);
+            }
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ThreadPool::WorkerFunc::operator()()
+    {
+        mPool->workerLoop();
+    }
+    //-----------------------------------------------------------------------
+    void ThreadPool::WorkerFunc::operator()() const
+    {
+        mPool->workerLoop();
+    }
+    //-----------------------------------------------------------------------
+    void ThreadPool::WorkerFunc::run()
+    {
+        mPool->workerLoop();
+    }
+#endif
+}
@@ -43,8 +43,10 @@ namespace Ogre {
         return i->second;
     }
     //---------------------------------------------------------------------
-    WorkQueue::Request::Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid)
+    WorkQueue::Request::Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid,
+        Real priority)
         : mChannel(channel), mType(rtype), mData(rData), mRetryCount(retry), mID(rid), mAborted(false)
+        , mPriority(priority)
     {
 
     }
@@ -200,11 +202,14 @@ namespace Ogre {
     WorkQueue::RequestID DefaultWorkQueueBase::addRequest(uint16 channel, uint16 requestType, 
         const Any& rData, uint8 retryCount, bool forceSynchronous, bool idleThread)
     {
+        if (!OGRE_THREAD_SUPPORT || forceSynchronous || !idleThread)
+            return addRequestWithPriority(channel, requestType, rData, 0, retryCount, forceSynchronous);
+
         Request* req = 0;
         RequestID rid = 0;
 
         {
-            // lock to acquire rid and push request to the queue
+            // lock to acquire rid
                     OGRE_WQ_LOCK_MUTEX(mRequestMutex);
 
             if (!mAcceptRequests || mShuttingDown)
@@ -217,32 +222,158 @@ namespace Ogre {
                 "DefaultWorkQueueBase('" << mName << "') - QUEUED(thread:" <<
                 OGRE_THREAD_CURRENT_ID
                 << "): ID=" << rid
-                << " channel=" << channel << " requestType=" << requestType;
+                << " channel=" << channel << " requestType=" << requestType << " idle";
+        }
+
+        // idle requests are processed in order of arrival
+        OGRE_WQ_LOCK_MUTEX(mIdleMutex);
+        mIdleRequestQueue.push_back(req);
+        if(!mIdleThreadRunning)
+        {
+            notifyWorkers();
+        }
+        return rid;
+
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::RequestID DefaultWorkQueueBase::addRequestWithPriority(uint16 channel, uint16 requestType, 
+        const Any& rData, Real priority, uint8 retryCount, bool forceSynchronous)
+    {
+        Request* req = 0;
+        RequestID rid = 0;
+
+        {
+            // lock to acquire rid and push request to the queue
+                    OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+
+            if (!mAcceptRequests || mShuttingDown)
+                return 0;
+
+            rid = ++mRequestCount;
+            req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid, priority);
+
+            LogManager::getSingleton().stream(LML_TRIVIAL) << 
+                "DefaultWorkQueueBase('" << mName << "') - QUEUED(thread:" <<
+                OGRE_THREAD_CURRENT_ID
+                << "): ID=" << rid
+                << " channel=" << channel << " requestType=" << requestType << " priority=" << priority;
 #if OGRE_THREAD_SUPPORT
-            if (!forceSynchronous&& !idleThread)
+            if (!forceSynchronous)
             {
-                mRequestQueue.push_back(req);
+                insertRequest(req);
                 notifyWorkers();
                 return rid;
             }
 #endif
         }
-        if(OGRE_THREAD_SUPPORT && idleThread){
-            OGRE_WQ_LOCK_MUTEX(mIdleMutex);
-            mIdleRequestQueue.push_back(req);
-            if(!mIdleThreadRunning)
+        processRequestResponse(req, true);
+        return rid;
+
+    }
+    //---------------------------------------------------------------------
+    bool DefaultWorkQueueBase::setRequestPriority(RequestID id, Real priority)
+    {
+            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+
+        for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
+        {
+            if ((*i)->getID() == id)
             {
-                notifyWorkers();
+                Request* req = *i;
+                if (req->getAborted())
+                    return false;
+                if (req->mPriority != priority)
+                {
+                    mRequestQueue.erase(i);
+                    req->mPriority = priority;
+                    insertRequest(req);
+                }
+                return true;
             }
-        } else { //forceSynchronous
-            processRequestResponse(req, true);
         }
-        return rid;
+        return false;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::setMaxConcurrentRequests(uint16 channel, size_t maxRequests)
+    {
+            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+
+        if (maxRequests)
+            mMaxConcurrentRequests[channel] = maxRequests;
+        else
+            mMaxConcurrentRequests.erase(channel);
+
+        // requests held back so far may be processed now
+        if (!mRequestQueue.empty())
+            notifyWorkers();
+    }
+    //---------------------------------------------------------------------
+    size_t DefaultWorkQueueBase::getMaxConcurrentRequests(uint16 channel) const
+    {
+            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+
+        ChannelCountMap::const_iterator i = mMaxConcurrentRequests.find(channel);
+        return i != mMaxConcurrentRequests.end() ? i->second : 0;
+    }
+    //---------------------------------------------------------------------
+    static bool requestPriorityGreater(const WorkQueue::Request* a, const WorkQueue::Request* b)
+    {
+        return a->getPriority() > b->getPriority();
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::insertRequest(Request* req)
+    {
+        mRequestQueue.insert(std::upper_bound(mRequestQueue.begin(), mRequestQueue.end(), req,
+            requestPriorityGreater), req);
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::abortWaitingRequest(RequestQueue::iterator i)
+    {
+        Request* req = *i;
+        req->abortRequest();
+        req->mPriority = std::numeric_limits<Real>::max();
+        mRequestQueue.erase(i);
+        mRequestQueue.push_front(req);
+    }
+    //---------------------------------------------------------------------
+    bool DefaultWorkQueueBase::hasProcessableRequest() const
+    {
+        if (mMaxConcurrentRequests.empty())
+            return !mRequestQueue.empty();
 
+        for (RequestQueue::const_iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
+        {
+            if ((*i)->getAborted())
+                return true;
+            ChannelCountMap::const_iterator max = mMaxConcurrentRequests.find((*i)->getChannel());
+            if (max == mMaxConcurrentRequests.end())
+                return true;
+            ChannelCountMap::const_iterator count = mConcurrentRequests.find((*i)->getChannel());
+            if (count == mConcurrentRequests.end() || count->second < max->second)
+                return true;
+        }
+        return false;
+    }
+    //---------------------------------------------------------------------
+    WorkQueue::Request* DefaultWorkQueueBase::takeNextRequest()
+    {
+        for (RequestQueue::iterator i = mRequestQueue.begin(); i != mRequestQueue.end(); ++i)
+        {
+            Request* req = *i;
+            size_t& count = mConcurrentRequests[req->getChannel()];
+            ChannelCountMap::const_iterator max = mMaxConcurrentRequests.find(req->getChannel());
+            if (req->getAborted() || max == mMaxConcurrentRequests.end() || count < max->second)
+            {
+                ++count;
+                mRequestQueue.erase(i);
+                return req;
+            }
+        }
+        return 0;
     }
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::addRequestWithRID(WorkQueue::RequestID rid, uint16 channel, 
-        uint16 requestType, const Any& rData, uint8 retryCount)
+        uint16 requestType, const Any& rData, uint8 retryCount, Real priority)
     {
         // lock to push request to the queue
             OGRE_WQ_LOCK_MUTEX(mRequestMutex);
@@ -250,7 +381,7 @@ namespace Ogre {
         if (mShuttingDown)
             return;
 
-        Request* req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid);
+        Request* req = OGRE_NEW Request(channel, requestType, rData, retryCount, rid, priority);
 
         LogManager::getSingleton().stream(LML_TRIVIAL) << 
             "DefaultWorkQueueBase('" << mName << "') - REQUEUED(thread:" <<
@@ -258,7 +389,7 @@ namespace Ogre {
             << "): ID=" << rid
                    << " channel=" << channel << " requestType=" << requestType;
 #if OGRE_THREAD_SUPPORT
-        mRequestQueue.push_back(req);
+        insertRequest(req);
         notifyWorkers();
 #else
         processRequestResponse(req, true);
@@ -288,7 +419,8 @@ namespace Ogre {
             {
                 if ((*i)->getID() == id)
                 {
-                    (*i)->abortRequest();
+                    abortWaitingRequest(i);
+                    notifyWorkers();
                     break;
                 }
             }
@@ -330,7 +462,8 @@ namespace Ogre {
             {
                 if ((*i)->getID() == id)
                 {
-                    (*i)->abortRequest();
+                    abortWaitingRequest(i);
+                    notifyWorkers();
                     return true;
                 }
             }
@@ -511,12 +644,9 @@ namespace Ogre {
             {
                             OGRE_WQ_LOCK_MUTEX(mRequestMutex);
 
-                if (!mRequestQueue.empty())
-                {
-                    request = mRequestQueue.front();
-                    mRequestQueue.pop_front();
+                request = takeNextRequest();
+                if (request)
                     mProcessQueue.push_back( request );
-                }
             }
         }
 
@@ -540,6 +670,12 @@ namespace Ogre {
             if( (*it) == r )
             {
                 mProcessQueue.erase( it );
+
+                OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+                --mConcurrentRequests[r->getChannel()];
+                // a request held back by the limit of this channel may be processed now
+                if (!mRequestQueue.empty() && mMaxConcurrentRequests.count(r->getChannel()))
+                    notifyWorkers();
                 break;
             }
         }
@@ -556,7 +692,7 @@ namespace Ogre {
                 if (req->getRetryCount())
                 {
                     addRequestWithRID(req->getID(), req->getChannel(), req->getType(), req->getData(), 
-                        req->getRetryCount() - 1);
+                        req->getRetryCount() - 1, req->getPriority());
                     // discard response (this also deletes request)
                     OGRE_DELETE response;
                     return;
@@ -152,7 +152,11 @@ namespace Ogre {
                 "STBIImageCodec::encode");
         }
 
-        return DataStreamPtr(new MemoryDataStream(data, len, true));
+        // stbi allocates with malloc, MemoryDataStream frees with OGRE_FREE
+        MemoryDataStreamPtr output(OGRE_NEW MemoryDataStream(len));
+        memcpy(output->getPtr(), data, len);
+        STBIW_FREE(data);
+        return output;
     }
     //---------------------------------------------------------------------
     void STBIImageCodec::encodeToFile(const MemoryDataStreamPtr& input, const String& outFileName,
@@ -219,8 +223,11 @@ namespace Ogre {
         
         size_t dstPitch = imgData->width * PixelUtil::getNumElemBytes(imgData->format);
         imgData->size = dstPitch * imgData->height;
-        MemoryDataStreamPtr output(OGRE_NEW MemoryDataStream(pixelData, imgData->size, true));
-        
+        // stbi allocates with malloc, MemoryDataStream frees with OGRE_FREE
+        MemoryDataStreamPtr output(OGRE_NEW MemoryDataStream(imgData->size));
+        memcpy(output->getPtr(), pixelData, imgData->size);
+        stbi_image_free(pixelData);
+
         DecodeResult ret;
         ret.first = output;
         ret.second = imgData;
@@ -0,0 +1,459 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "RootWithoutRenderSystemFixture.h"
+#include "OgreOverlaySystem.h"
+#include "OgreOverlayManager.h"
+#include "OgreOverlay.h"
+#include "OgreOverlayContainer.h"
+#include "OgreOverlayBatcher.h"
+#include "OgreFontManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreRenderQueue.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreTechnique.h"
+
+using namespace Ogre;
+
+namespace
+{
+    /// Counts the uploads, the contents are discarded
+    class NullPixelBuffer : public HardwarePixelBuffer
+    {
+    public:
+        size_t mUploads;
+
+        NullPixelBuffer(uint32 width, uint32 height, PixelFormat format)
+            : HardwarePixelBuffer(width, height, 1, format, HBU_STATIC, false, false), mUploads(0)
+        {
+        }
+
+        void blitFromMemory(const PixelBox& src, const Box& dstBox) { ++mUploads; }
+        void blitToMemory(const Box& srcBox, const PixelBox& dst) {}
+
+    protected:
+        PixelBox lockImpl(const Box& lockBox, LockOptions options) { return PixelBox(); }
+        void unlockImpl(void) {}
+    };
+
+    class NullTexture : public Texture
+    {
+    public:
+        NullTexture(ResourceManager* creator, const String& name, ResourceHandle handle,
+                    const String& group, bool isManual, ManualResourceLoader* loader)
+            : Texture(creator, name, handle, group, isManual, loader)
+        {
+        }
+        ~NullTexture() { unload(); }
+
+        NullPixelBuffer* getNullBuffer() { return static_cast<NullPixelBuffer*>(getBuffer().get()); }
+
+    protected:
+        void createInternalResourcesImpl(void)
+        {
+            mSurfaceList.push_back(
+                HardwarePixelBufferSharedPtr(OGRE_NEW NullPixelBuffer(mWidth, mHeight, mFormat)));
+        }
+        void freeInternalResourcesImpl(void) { mSurfaceList.clear(); }
+    };
+
+    /// Lets fonts create their textures without a render system
+    class NullTextureManager : public TextureManager
+    {
+    public:
+        NullTextureManager() { ResourceGroupManager::getSingleton()._registerResourceManager(mResourceType, this); }
+        ~NullTextureManager() { ResourceGroupManager::getSingleton()._unregisterResourceManager(mResourceType); }
+
+        PixelFormat getNativeFormat(TextureType ttype, PixelFormat format, int usage) { return format; }
+
+    protected:
+        Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+                             bool isManual, ManualResourceLoader* loader,
+                             const NameValuePairList* createParams)
+        {
+            return OGRE_NEW NullTexture(this, name, handle, group, isManual, loader);
+        }
+    };
+
+    struct FontTests : public RootWithoutRenderSystemFixture
+    {
+        NullTextureManager* mTextureMgr;
+        OverlaySystem* mOverlaySystem;
+
+        void SetUp()
+        {
+            RootWithoutRenderSystemFixture::SetUp();
+            mTextureMgr = OGRE_NEW NullTextureManager();
+            mOverlaySystem = OGRE_NEW OverlaySystem();
+        }
+        void TearDown()
+        {
+            OGRE_DELETE mOverlaySystem;
+            OGRE_DELETE mTextureMgr;
+            RootWithoutRenderSystemFixture::TearDown();
+        }
+
+        FontPtr createDynamicFont(uint32 maxAtlasSize)
+        {
+            FontPtr font = FontManager::getSingleton().create("DynamicFont", "Essential");
+            font->setType(FT_TRUETYPE);
+            font->setSource("cuckoo.ttf");
+            font->setTrueTypeSize(16);
+            font->setTrueTypeResolution(96);
+            font->setDynamic(true);
+            font->setMaxAtlasSize(maxAtlasSize);
+            font->load();
+            return font;
+        }
+
+        NullTexture* getTexture(const FontPtr& font)
+        {
+            return static_cast<NullTexture*>(
+                font->getMaterial()->getTechnique(0)->getPass(0)->getTextureUnitState(0)->_getTexturePtr().get());
+        }
+    };
+
+    /// Letters, so every glyph is in the font
+    const String LETTERS = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+
+    /// A quad at its relative position, which needs no render system to place
+    class QuadElement : public OverlayElement
+    {
+    public:
+        QuadElement(const String& name, const MaterialPtr& mat, Real left, Real top, Real width,
+                    Real height)
+            : OverlayElement(name)
+        {
+            mMaterial = mat;
+            setPosition(left, top);
+            setDimensions(width, height);
+
+            mRenderOp.vertexData = OGRE_NEW VertexData();
+            mRenderOp.vertexData->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+            mRenderOp.vertexData->vertexCount = 4;
+            mRenderOp.operationType = RenderOperation::OT_TRIANGLE_STRIP;
+            mRenderOp.useIndexes = false;
+            mRenderOp.vertexData->vertexBufferBinding->setBinding(
+                0, HardwareBufferManager::getSingleton().createVertexBuffer(
+                       3 * sizeof(float), 4, HardwareBuffer::HBU_STATIC_WRITE_ONLY));
+            mInitialised = true;
+            updatePositionGeometry();
+        }
+        ~QuadElement() { OGRE_DELETE mRenderOp.vertexData; }
+
+        void initialise(void) {}
+        const String& getTypeName(void) const { return BLANKSTRING; }
+        void getRenderOperation(RenderOperation& op) { op = mRenderOp; }
+
+    protected:
+        RenderOperation mRenderOp;
+
+        void updatePositionGeometry(void)
+        {
+            float left = _getDerivedLeft() * 2 - 1;
+            float top = -(_getDerivedTop() * 2 - 1);
+            float right = left + mWidth * 2;
+            float bottom = top - mHeight * 2;
+            float pos[] = {left, top, -1, left, bottom, -1, right, top, -1, right, bottom, -1};
+            mRenderOp.vertexData->vertexBufferBinding->getBuffer(0)->writeData(0, sizeof(pos), pos, true);
+            _notifyGeometryChanged();
+        }
+        void updateTextureGeometry(void) {}
+        void _updateFromParent(void)
+        {
+            mDerivedLeft = mLeft;
+            mDerivedTop = mTop;
+            mDerivedOutOfDate = false;
+        }
+    };
+
+    /// Remembers which vertex buffers were created with a shadow buffer, the default ones have none
+    class ShadowRecordingBufferManager : public DefaultHardwareBufferManager
+    {
+    public:
+        std::set<const HardwareVertexBuffer*> mShadowed;
+
+        HardwareVertexBufferSharedPtr createVertexBuffer(size_t vertexSize, size_t numVerts,
+                                                         HardwareBuffer::Usage usage, bool useShadowBuffer)
+        {
+            HardwareVertexBufferSharedPtr vbuf =
+                DefaultHardwareBufferManager::createVertexBuffer(vertexSize, numVerts, usage, useShadowBuffer);
+            // a new buffer may reuse the address of a destroyed one
+            if (useShadowBuffer)
+                mShadowed.insert(vbuf.get());
+            else
+                mShadowed.erase(vbuf.get());
+            return vbuf;
+        }
+    };
+
+    /// Counts the queued renderables, without a render system they have no technique to queue with
+    class QueueCounter : public RenderQueue::RenderableListener
+    {
+    public:
+        size_t mQueued;
+
+        QueueCounter() : mQueued(0) {}
+
+        bool renderableQueued(Renderable* rend, uint8 groupID, ushort priority, Technique** ppTech,
+                              RenderQueue* pQueue)
+        {
+            ++mQueued;
+            return false;
+        }
+    };
+
+    struct OverlayBatcherTests : public RootWithoutRenderSystemFixture
+    {
+        RenderQueue mQueue;
+        QueueCounter mCounter;
+        ShadowRecordingBufferManager* mBufferMgr;
+        OverlaySystem* mOverlaySystem;
+        Overlay* mOverlay;
+        MaterialPtr mMaterialA;
+        MaterialPtr mMaterialB;
+
+        void SetUp()
+        {
+            RootWithoutRenderSystemFixture::SetUp();
+            delete mHBM;
+            mHBM = mBufferMgr = new ShadowRecordingBufferManager();
+            mOverlaySystem = OGRE_NEW OverlaySystem();
+            mOverlay = OverlayManager::getSingleton().create("Batched");
+            mMaterialA = MaterialManager::getSingleton().create("A", RGN_DEFAULT);
+            mMaterialB = MaterialManager::getSingleton().create("B", RGN_DEFAULT);
+            mQueue.setRenderableListener(&mCounter);
+        }
+
+        /// Ends the batcher and returns how many renderables it queued
+        size_t end(OverlayBatcher& batcher)
+        {
+            mCounter.mQueued = 0;
+            batcher.end(&mQueue);
+            return mCounter.mQueued;
+        }
+        void TearDown()
+        {
+            mMaterialA.reset();
+            mMaterialB.reset();
+            OGRE_DELETE mOverlaySystem;
+            RootWithoutRenderSystemFixture::TearDown();
+        }
+
+        bool hasShadowBuffers(OverlayElement* elem)
+        {
+            RenderOperation op;
+            elem->getRenderOperation(op);
+            VertexBufferBinding* bind = op.vertexData->vertexBufferBinding;
+            for (unsigned short i = 0; i <= bind->getLastBoundIndex(); ++i)
+            {
+                if (bind->isBufferBound(i) && !mBufferMgr->mShadowed.count(bind->getBuffer(i).get()))
+                    return false;
+            }
+            return bind->getBufferCount() > 0;
+        }
+    };
+}
+//--------------------------------------------------------------------------
+TEST_F(FontTests, DynamicAtlasGrowsAndReplacesGlyphs)
+{
+    FontPtr font = createDynamicFont(128);
+    NullTexture* tex = getTexture(font);
+    uint32 initialHeight = tex->getHeight();
+    ASSERT_LE(initialHeight, 64u);
+
+    // rasterised on first use, only the changed part is uploaded
+    size_t uploads = tex->getNullBuffer()->mUploads;
+    uint32 generation = font->_getGlyphGeneration();
+    Font::UVRect first = font->getGlyphTexCoords(LETTERS[0]);
+    EXPECT_GT(first.width(), 0);
+    EXPECT_EQ(font->_getGlyphGeneration(), generation);
+    font->_updateTexture();
+    EXPECT_EQ(tex->getNullBuffer()->mUploads, uploads + 1);
+
+    // the atlas grows downwards, which moves the texture coordinates
+    size_t next = 1;
+    while (next < LETTERS.size() && font->_getGlyphGeneration() == generation)
+        font->getGlyphTexCoords(LETTERS[next++]);
+    ASSERT_NE(font->_getGlyphGeneration(), generation);
+    Font::UVRect moved = font->getGlyphTexCoords(LETTERS[0]);
+    EXPECT_FLOAT_EQ(moved.top, first.top * 0.5f);
+    EXPECT_FLOAT_EQ(moved.bottom, first.bottom * 0.5f);
+    font->_updateTexture();
+    EXPECT_EQ(tex->getHeight(), initialHeight * 2);
+
+    // once full, the least recently used glyph is replaced, which is the first letter now
+    for (size_t i = 1; i < next; ++i)
+        font->getGlyphTexCoords(LETTERS[i]);
+    generation = font->_getGlyphGeneration();
+    Font::UVRect replacement;
+    while (next < LETTERS.size() && font->_getGlyphGeneration() == generation)
+        replacement = font->getGlyphTexCoords(LETTERS[next++]);
+    ASSERT_NE(font->_getGlyphGeneration(), generation);
+    EXPECT_FLOAT_EQ(replacement.left, moved.left);
+    EXPECT_FLOAT_EQ(replacement.top, moved.top);
+    EXPECT_EQ(tex->getHeight(), initialHeight * 2);
+}
+//--------------------------------------------------------------------------
+TEST_F(FontTests, PinnedGlyphsAreKept)
+{
+    FontPtr font = createDynamicFont(128);
+
+    // a caption with more letters than the atlas holds
+    font->_pinGlyphs();
+    size_t capacity = 0;
+    while (capacity < LETTERS.size() && font->getGlyphTexCoords(LETTERS[capacity]).width() > 0)
+        ++capacity;
+    ASSERT_LT(capacity, LETTERS.size());
+
+    // the letters which fit stay in place, the others are skipped
+    uint32 generation = font->_getGlyphGeneration();
+    std::vector<Font::UVRect> rects;
+    for (size_t i = 0; i < capacity; ++i)
+        rects.push_back(font->getGlyphTexCoords(LETTERS[i]));
+    for (size_t i = capacity; i < LETTERS.size(); ++i)
+        EXPECT_EQ(font->getGlyphTexCoords(LETTERS[i]).width(), 0);
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        Font::UVRect rect = font->getGlyphTexCoords(LETTERS[i]);
+        EXPECT_EQ(rect.left, rects[i].left);
+        EXPECT_EQ(rect.top, rects[i].top);
+        EXPECT_EQ(rect.right, rects[i].right);
+        EXPECT_EQ(rect.bottom, rects[i].bottom);
+    }
+    EXPECT_EQ(font->_getGlyphGeneration(), generation);
+
+    // once unpinned, they may be replaced again
+    font->_unpinGlyphs();
+    EXPECT_GT(font->getGlyphTexCoords(LETTERS[capacity]).width(), 0);
+    EXPECT_NE(font->_getGlyphGeneration(), generation);
+}
+//--------------------------------------------------------------------------
+TEST_F(OverlayBatcherTests, NonOverlappingElementsAreMerged)
+{
+    QuadElement a("a", mMaterialA, 0, 0, 0.1, 0.1);
+    QuadElement b("b", mMaterialB, 0.5, 0.5, 0.1, 0.1);
+    QuadElement c("c", mMaterialA, 0.2, 0, 0.1, 0.1);
+    QuadElement d("d", mMaterialB, 0.5, 0.2, 0.1, 0.1);
+
+    OverlayBatcher batcher(mOverlay);
+    batcher.begin();
+    EXPECT_TRUE(batcher.addElement(&a));
+    EXPECT_TRUE(batcher.addElement(&b));
+    EXPECT_TRUE(batcher.addElement(&c));
+    EXPECT_TRUE(batcher.addElement(&d));
+    EXPECT_EQ(end(batcher), 2u);
+    EXPECT_EQ(batcher.getNumBatches(), 2u);
+
+    // elements which only touch do not overlap
+    batcher.begin();
+    EXPECT_TRUE(batcher.addElement(&a));
+    QuadElement touching("touching", mMaterialB, 0.1, 0, 0.1, 0.1);
+    EXPECT_TRUE(batcher.addElement(&touching));
+    EXPECT_TRUE(batcher.addElement(&c));
+    EXPECT_EQ(end(batcher), 2u);
+    EXPECT_EQ(batcher.getNumBatches(), 1u);
+}
+//--------------------------------------------------------------------------
+TEST_F(OverlayBatcherTests, OverlappingElementsKeepTheirOrder)
+{
+    QuadElement a("a", mMaterialA, 0, 0, 0.2, 0.2);
+    QuadElement b("b", mMaterialB, 0.1, 0.1, 0.2, 0.2);
+    QuadElement c("c", mMaterialA, 0.25, 0.25, 0.1, 0.1);
+
+    // c would be drawn below b if it joined a
+    OverlayBatcher batcher(mOverlay);
+    batcher.begin();
+    EXPECT_TRUE(batcher.addElement(&a));
+    EXPECT_TRUE(batcher.addElement(&b));
+    EXPECT_TRUE(batcher.addElement(&c));
+    EXPECT_EQ(end(batcher), 3u);
+    EXPECT_EQ(batcher.getNumBatches(), 0u);
+
+    // once moved away from b it may join a
+    c.setPosition(0.5, 0.5);
+    c._update();
+    batcher.begin();
+    EXPECT_TRUE(batcher.addElement(&a));
+    EXPECT_TRUE(batcher.addElement(&b));
+    EXPECT_TRUE(batcher.addElement(&c));
+    EXPECT_EQ(end(batcher), 2u);
+    EXPECT_EQ(batcher.getNumBatches(), 1u);
+}
+//--------------------------------------------------------------------------
+TEST_F(OverlayBatcherTests, BarriersKeepTheirOrder)
+{
+    QuadElement a("a", mMaterialA, 0, 0, 0.1, 0.1);
+    QuadElement c("c", mMaterialA, 0.5, 0.5, 0.1, 0.1);
+    QuadElement covering("covering", mMaterialB, 0.4, 0.4, 0.3, 0.3);
+    QuadElement elsewhere("elsewhere", mMaterialB, 0.8, 0, 0.1, 0.1);
+
+    OverlayBatcher batcher(mOverlay);
+    batcher.begin();
+    EXPECT_TRUE(batcher.addElement(&a));
+    batcher.addBarrier(&covering);
+    EXPECT_TRUE(batcher.addElement(&c));
+    EXPECT_EQ(end(batcher), 2u);
+    EXPECT_EQ(batcher.getNumBatches(), 0u);
+
+    batcher.begin();
+    EXPECT_TRUE(batcher.addElement(&a));
+    batcher.addBarrier(&elsewhere);
+    EXPECT_TRUE(batcher.addElement(&c));
+    EXPECT_EQ(end(batcher), 1u);
+    EXPECT_EQ(batcher.getNumBatches(), 1u);
+}
+//--------------------------------------------------------------------------
+TEST_F(OverlayBatcherTests, ShadowBuffersOnlyWhenBatched)
+{
+    OverlayManager& overlayMgr = OverlayManager::getSingleton();
+    OverlayContainer* panel =
+        static_cast<OverlayContainer*>(overlayMgr.createOverlayElement("Panel", "panel"));
+    OverlayElement* text = overlayMgr.createOverlayElement("TextArea", "text");
+    panel->addChild(text);
+    mOverlay->add2D(panel);
+    mOverlay->show();
+
+    EXPECT_FALSE(hasShadowBuffers(panel));
+    EXPECT_FALSE(hasShadowBuffers(text));
+
+    mOverlay->setBatchingEnabled(true);
+    EXPECT_TRUE(hasShadowBuffers(panel));
+    EXPECT_TRUE(hasShadowBuffers(text));
+
+    mOverlay->setBatchingEnabled(false);
+    EXPECT_FALSE(hasShadowBuffers(panel));
+    EXPECT_FALSE(hasShadowBuffers(text));
+
+    mOverlay->remove2D(panel);
+    overlayMgr.destroyOverlayElement(text);
+    overlayMgr.destroyOverlayElement(panel);
+}
@@ -30,7 +30,14 @@ THE SOFTWARE.
 #include "OgreRoot.h"
 #include "OgrePageManager.h"
 #include "OgreGrid2DPageStrategy.h"
+#include "OgrePagedWorld.h"
+#include "OgrePagedWorldSection.h"
+#include "OgrePage.h"
+#include "OgreWorkQueue.h"
+#include "OgreSceneNode.h"
 #include "OgreFileSystemLayer.h"
+#include "OgreDefaultHardwareBufferManager.h"
+#include "OgreMaterialManager.h"
 #include "OgreBuildSettings.h"
 
 
@@ -38,6 +45,9 @@ THE SOFTWARE.
 #include "OgrePaging.h"
 #include "OgreLogManager.h"
 
+#include <mutex>
+#include <thread>
+
 using namespace Ogre;
 
 class PageCoreTests : public ::testing::Test
@@ -47,6 +57,7 @@ public:
     PageManager* mPageManager;
     SceneManager* mSceneMgr;
     FileSystemLayer* mFSLayer;
+    HardwareBufferManager* mHBM;
 
 #ifdef OGRE_STATIC_LIB
     OgreBites::StaticPluginLoader mStaticPluginLoader;
@@ -70,6 +81,9 @@ void PageCoreTests::SetUp()
     mRoot = OGRE_NEW Root(pluginsPath);
 #endif
 
+    // cameras need a buffer manager, without a render system there is none
+    mHBM = OGRE_NEW DefaultHardwareBufferManager();
+    MaterialManager::getSingleton().initialise();
     mPageManager = OGRE_NEW PageManager();
 
     // make certain the resource location is NOT read-only
@@ -83,6 +97,7 @@ void PageCoreTests::TearDown()
 {
     OGRE_DELETE mPageManager;
     OGRE_DELETE mRoot;
+    OGRE_DELETE mHBM;
     OGRE_DELETE_T(mFSLayer, FileSystemLayer, Ogre::MEMCATEGORY_GENERAL);
 }
 //--------------------------------------------------------------------------
@@ -117,3 +132,129 @@ TEST_F(PageCoreTests,SimpleCreateSaveLoadWorld)
 }
 //--------------------------------------------------------------------------
 
+namespace
+{
+    /// Generates empty pages, remembering the order they were prepared in
+    class RecordingPageProvider : public PageProvider
+    {
+    public:
+        std::vector<PageID> prepared;
+        std::mutex mutex;
+
+        bool prepareProceduralPage(Page* page, PagedWorldSection* section)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            prepared.push_back(page->getID());
+            return true;
+        }
+        bool loadProceduralPage(Page* page, PagedWorldSection* section) { return true; }
+        bool unloadProceduralPage(Page* page, PagedWorldSection* section) { return true; }
+        bool unprepareProceduralPage(Page* page, PagedWorldSection* section) { return true; }
+    };
+}
+//--------------------------------------------------------------------------
+TEST_F(PageCoreTests,PrefetchLoadsPagesAheadFirst)
+{
+    // a single worker prepares the pages in the order they were requested
+    DefaultWorkQueueBase* wq = static_cast<DefaultWorkQueueBase*>(mRoot->getWorkQueue());
+    wq->setWorkerThreadCount(1);
+    wq->startup();
+
+    RecordingPageProvider provider;
+    mPageManager->setPageProvider(&provider);
+
+    PagedWorld* world = mPageManager->createWorld();
+    PagedWorldSection* section = world->createSection("Grid2D", mSceneMgr);
+    Grid2DPageStrategyData* data = static_cast<Grid2DPageStrategyData*>(section->getStrategyData());
+    data->setCellSize(100);
+    data->setLoadRadius(200);
+    data->setHoldRadius(300);
+    data->getPrefetcher().setLookAheadTime(1);
+
+    Camera* cam = mSceneMgr->createCamera("Camera");
+    SceneNode* camNode = mSceneMgr->getRootSceneNode()->createChildSceneNode();
+    camNode->attachObject(cam);
+
+    // let the camera gain speed along +x before anything is loaded
+    mPageManager->setPagingOperationsEnabled(false);
+    for (int i = 0; i < 2; ++i)
+    {
+        camNode->setPosition(Real(i * 100), 0, 0);
+        section->frameStart(0.1f);
+        section->notifyCamera(cam);
+    }
+    mPageManager->setPagingOperationsEnabled(true);
+    camNode->setPosition(200, 0, 0);
+    section->frameStart(0.1f);
+    section->notifyCamera(cam);
+
+    const PageManager::Statistics& stats = mPageManager->getStatistics();
+    size_t requested = stats.pagesRequested;
+    EXPECT_GT(requested, 0u);
+    for (int i = 0; i < 5000 && stats.pagesLoaded < requested; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        wq->processResponses();
+    }
+    EXPECT_EQ(stats.pagesLoaded, requested);
+    EXPECT_GE(stats.maxLoadLatency, stats.getAverageLoadLatency());
+
+    std::lock_guard<std::mutex> lock(provider.mutex);
+    ASSERT_EQ(provider.prepared.size(), requested);
+    std::vector<PageID>::iterator ahead = std::find(provider.prepared.begin(),
+        provider.prepared.end(), data->calculatePageID(5, 0));
+    std::vector<PageID>::iterator aside = std::find(provider.prepared.begin(),
+        provider.prepared.end(), data->calculatePageID(2, 2));
+    std::vector<PageID>::iterator behind = std::find(provider.prepared.begin(),
+        provider.prepared.end(), data->calculatePageID(0, 0));
+    // further away, but on the path of the camera
+    ASSERT_TRUE(ahead != provider.prepared.end());
+    // within the load radius but not on the path
+    ASSERT_TRUE(aside != provider.prepared.end());
+    EXPECT_TRUE(ahead < aside);
+    // out of the trailing radius
+    EXPECT_TRUE(behind == provider.prepared.end());
+    // pages on the path in the order they are reached
+    for (int32 x = 2; x < 8; ++x)
+    {
+        EXPECT_TRUE(std::find(provider.prepared.begin(), provider.prepared.end(), data->calculatePageID(x, 0)) <
+                    std::find(provider.prepared.begin(), provider.prepared.end(), data->calculatePageID(x + 1, 0)));
+    }
+
+    mPageManager->setPageProvider(0);
+}
+//--------------------------------------------------------------------------
+TEST_F(PageCoreTests,ThrashedPagesAreCounted)
+{
+    RecordingPageProvider provider;
+    mPageManager->setPageProvider(&provider);
+
+    PagedWorld* world = mPageManager->createWorld();
+    PagedWorldSection* section = world->createSection("Grid2D", mSceneMgr);
+
+    // unloaded before the (never started) work queue got to it
+    section->loadPage(1);
+    section->unloadPage(1);
+    EXPECT_EQ(mPageManager->getStatistics().pagesRequested, 1u);
+    EXPECT_EQ(mPageManager->getStatistics().pagesThrashed, 1u);
+
+    // requested again right after it was unloaded
+    PageID id = section->getPageID(Vector3::ZERO);
+    section->loadPage(id, true);
+    section->unloadPage(id);
+    section->loadPage(id, true);
+    EXPECT_EQ(mPageManager->getStatistics().pagesThrashed, 2u);
+
+    // but not once the thrash window has passed
+    section->unloadPage(id);
+    section->frameStart(mPageManager->getThrashWindow() + 1);
+    section->frameEnd(0);
+    section->loadPage(id, true);
+    EXPECT_EQ(mPageManager->getStatistics().pagesThrashed, 2u);
+
+    mPageManager->resetStatistics();
+    EXPECT_EQ(mPageManager->getStatistics().pagesRequested, 0u);
+
+    mPageManager->setPageProvider(0);
+}
+//--------------------------------------------------------------------------
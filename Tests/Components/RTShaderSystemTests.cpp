@@ -0,0 +1,364 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "NullRenderSystem.h"
+#include "RootWithoutRenderSystemFixture.h"
+#include "OgreRoot.h"
+#include "OgreRTShaderSystem.h"
+#include "OgreShaderFFPRenderState.h"
+#include "OgreHighLevelGpuProgram.h"
+#include "OgreHighLevelGpuProgramManager.h"
+#include "OgreGpuProgramManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreResourceGroupManager.h"
+#include "OgreArchive.h"
+#include "OgreTechnique.h"
+#include "OgreWorkQueue.h"
+#include "OgreTimer.h"
+#include "OgreFileSystemLayer.h"
+
+#include <thread>
+
+using namespace Ogre;
+
+namespace
+{
+    /// Accepts any source, there is no render system to compile it. The constants are taken
+    /// from the uniform declarations, so the generator can bind its parameters.
+    class SourceOnlyProgram : public HighLevelGpuProgram
+    {
+    public:
+        SourceOnlyProgram(ResourceManager* creator, const String& name, ResourceHandle handle,
+                          const String& group, bool isManual, ManualResourceLoader* loader)
+            : HighLevelGpuProgram(creator, name, handle, group, isManual, loader)
+        {
+        }
+        ~SourceOnlyProgram() { unload(); }
+
+        bool isSupported(void) const { return true; }
+        const String& getLanguage(void) const { return mLanguage; }
+        bool setParameter(const String& name, const String& value) { return true; }
+
+        static String mLanguage;
+
+    protected:
+        void loadFromSource(void) {}
+        void createLowLevelImpl(void) {}
+        void unloadHighLevelImpl(void) {}
+        void buildConstantDefinitions() const
+        {
+            createParameterMappingStructures(true);
+
+            StringVector statements = StringUtil::split(mSource, ";");
+            for (size_t i = 0; i < statements.size(); ++i)
+            {
+                StringVector tokens = StringUtil::split(statements[i]);
+                if (tokens.size() < 3 || tokens[tokens.size() - 3] != "uniform")
+                    continue;
+
+                String name = tokens.back();
+                GpuConstantDefinition def;
+                def.constType = StringUtil::startsWith(tokens[tokens.size() - 2], "sampler")
+                                    ? GCT_SAMPLER2D
+                                    : GCT_MATRIX_4X4;
+                def.elementSize = GpuConstantDefinition::getElementSize(def.constType, false);
+                size_t bracket = name.find('[');
+                if (bracket != String::npos)
+                {
+                    def.arraySize = StringConverter::parseUnsignedInt(name.substr(bracket + 1));
+                    name.erase(bracket);
+                }
+
+                size_t& bufferSize = def.isSampler() ? mConstantDefs->intBufferSize
+                                                     : mConstantDefs->floatBufferSize;
+                def.logicalIndex = def.physicalIndex = bufferSize;
+                bufferSize += def.elementSize * def.arraySize;
+                mConstantDefs->map.insert(GpuConstantDefinitionMap::value_type(name, def));
+            }
+        }
+    };
+    String SourceOnlyProgram::mLanguage = "glsl";
+
+    class SourceOnlyProgramFactory : public HighLevelGpuProgramFactory
+    {
+    public:
+        const String& getLanguage(void) const { return SourceOnlyProgram::mLanguage; }
+        HighLevelGpuProgram* create(ResourceManager* creator, const String& name,
+                                    ResourceHandle handle, const String& group, bool isManual,
+                                    ManualResourceLoader* loader)
+        {
+            return OGRE_NEW SourceOnlyProgram(creator, name, handle, group, isManual, loader);
+        }
+        void destroy(HighLevelGpuProgram* prog) { OGRE_DELETE prog; }
+    };
+
+    /// Stands in for the manager a render system would create, no low level programs are created
+    class NullGpuProgramManager : public GpuProgramManager
+    {
+    protected:
+        Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+                             bool isManual, ManualResourceLoader* loader,
+                             const NameValuePairList* params)
+        {
+            return 0;
+        }
+        Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+                             bool isManual, ManualResourceLoader* loader, GpuProgramType gptype,
+                             const String& syntaxCode)
+        {
+            return 0;
+        }
+    };
+
+    /// Fails to generate its programs on any thread but the one that created it
+    class WorkerFailingSubRenderState : public RTShader::SubRenderState
+    {
+    public:
+        WorkerFailingSubRenderState() : mThread(std::this_thread::get_id()) {}
+
+        const String& getType() const { return Type; }
+        int getExecutionOrder() const { return RTShader::FFP_TRANSFORM; }
+        void copyFrom(const SubRenderState& rhs) {}
+        bool createCpuSubPrograms(RTShader::ProgramSet* programSet)
+        {
+            if (std::this_thread::get_id() != mThread)
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "worker failure",
+                            "WorkerFailingSubRenderState::createCpuSubPrograms");
+            return true;
+        }
+
+        static String Type;
+
+    private:
+        std::thread::id mThread;
+    };
+    String WorkerFailingSubRenderState::Type = "WorkerFailing";
+
+    class WorkerFailingSubRenderStateFactory : public RTShader::SubRenderStateFactory
+    {
+    public:
+        const String& getType() const { return WorkerFailingSubRenderState::Type; }
+
+    protected:
+        RTShader::SubRenderState* createInstanceImpl()
+        {
+            return OGRE_NEW WorkerFailingSubRenderState();
+        }
+    };
+
+    struct RTShaderSystemTests : public RootWithoutRenderSystemFixture
+    {
+        NullRenderSystem* mRenderSystem;
+        NullGpuProgramManager* mGpuProgramManager;
+        SourceOnlyProgramFactory mFactory;
+
+        void SetUp()
+        {
+            RootWithoutRenderSystemFixture::SetUp();
+            // the shader generator looks up the supported languages on the active render system
+            mRenderSystem = OGRE_NEW NullRenderSystem();
+            mRenderSystem->getMutableCapabilities()->addShaderProfile("glsl");
+            mRoot->setRenderSystem(mRenderSystem);
+            mGpuProgramManager = OGRE_NEW NullGpuProgramManager();
+
+            // the first General location is the media root, as in Bites
+            ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+            String media = rgm.getResourceLocationList(RGN_DEFAULT).front().archive->getName();
+            rgm.addResourceLocation(media + "/RTShaderLib/GLSL", "FileSystem", RGN_DEFAULT);
+            mRoot->getWorkQueue()->startup();
+            HighLevelGpuProgramManager::getSingleton().addFactory(&mFactory);
+
+            RTShader::ShaderGenerator::initialize();
+            RTShader::ShaderGenerator::getSingleton().setAsyncTechniqueGeneration(true);
+        }
+        void TearDown()
+        {
+            RTShader::ShaderGenerator::destroy();
+            HighLevelGpuProgramManager::getSingleton().removeFactory(&mFactory);
+            OGRE_DELETE mGpuProgramManager;
+            RootWithoutRenderSystemFixture::TearDown();
+            OGRE_DELETE mRenderSystem;
+        }
+
+        MaterialPtr createMaterial(const String& name)
+        {
+            MaterialPtr mat = MaterialManager::getSingleton().create(name, RGN_DEFAULT);
+            mat->getTechnique(0)->getPass(0)->setDiffuse(ColourValue::Red);
+            RTShader::ShaderGenerator::getSingleton().createShaderBasedTechnique(
+                *mat, MaterialManager::DEFAULT_SCHEME_NAME, "rtss");
+            return mat;
+        }
+
+        /// Processes the responses like a render loop until no technique is pending
+        bool waitForPendingTechniques()
+        {
+            RTShader::ShaderGenerator& shaderGenerator = RTShader::ShaderGenerator::getSingleton();
+            Timer timer;
+            while (shaderGenerator.getPendingTechniqueCount() > 0)
+            {
+                if (timer.getMilliseconds() > 10000)
+                    return false;
+                mRoot->getWorkQueue()->processResponses();
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return true;
+        }
+
+        Technique* getTechnique(const MaterialPtr& mat, const String& scheme)
+        {
+            for (unsigned short i = 0; i < mat->getNumTechniques(); ++i)
+            {
+                if (mat->getTechnique(i)->getSchemeName() == scheme)
+                    return mat->getTechnique(i);
+            }
+            return NULL;
+        }
+    };
+}
+//--------------------------------------------------------------------------
+TEST_F(RTShaderSystemTests, AsyncGeneration)
+{
+    RTShader::ShaderGenerator& shaderGenerator = RTShader::ShaderGenerator::getSingleton();
+    MaterialPtr mat = createMaterial("async");
+
+    EXPECT_TRUE(shaderGenerator.validateMaterial("rtss", "async", RGN_DEFAULT));
+    // the technique is only published once its programs are created on this thread
+    EXPECT_FALSE(getTechnique(mat, "rtss"));
+
+    ASSERT_TRUE(waitForPendingTechniques());
+    EXPECT_EQ(shaderGenerator.getAsyncGeneratedTechniqueCount(), 1u);
+
+    Technique* tech = getTechnique(mat, "rtss");
+    ASSERT_TRUE(tech);
+    EXPECT_TRUE(tech->getPass(0)->hasVertexProgram());
+    EXPECT_TRUE(tech->getPass(0)->hasFragmentProgram());
+    EXPECT_FALSE(tech->getPass(0)->getVertexProgram()->getSource().empty());
+}
+//--------------------------------------------------------------------------
+TEST_F(RTShaderSystemTests, AsyncGenerationCancelled)
+{
+    RTShader::ShaderGenerator& shaderGenerator = RTShader::ShaderGenerator::getSingleton();
+
+    // cancel requests while the worker may be generating them
+    for (int i = 0; i < 20; ++i)
+    {
+        String name = "cancelled" + StringConverter::toString(i);
+        MaterialPtr mat = createMaterial(name);
+        EXPECT_TRUE(shaderGenerator.validateMaterial("rtss", name, RGN_DEFAULT));
+        if (i % 2)
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        EXPECT_TRUE(shaderGenerator.removeAllShaderBasedTechniques(name, RGN_DEFAULT));
+        EXPECT_FALSE(getTechnique(mat, "rtss"));
+    }
+    EXPECT_EQ(shaderGenerator.getPendingTechniqueCount(), 0u);
+
+    // stale responses are ignored
+    Timer timer;
+    while (timer.getMilliseconds() < 100)
+        mRoot->getWorkQueue()->processResponses();
+    EXPECT_EQ(shaderGenerator.getAsyncGeneratedTechniqueCount(), 0u);
+
+    // invalidating a pending technique regenerates it
+    MaterialPtr mat = createMaterial("regenerated");
+    EXPECT_TRUE(shaderGenerator.validateMaterial("rtss", "regenerated", RGN_DEFAULT));
+    shaderGenerator.invalidateMaterial("rtss", "regenerated", RGN_DEFAULT);
+    EXPECT_TRUE(shaderGenerator.validateMaterial("rtss", "regenerated", RGN_DEFAULT));
+    ASSERT_TRUE(waitForPendingTechniques());
+    EXPECT_EQ(shaderGenerator.getAsyncGeneratedTechniqueCount(), 1u);
+    EXPECT_TRUE(getTechnique(mat, "rtss"));
+}
+//--------------------------------------------------------------------------
+TEST_F(RTShaderSystemTests, AsyncGenerationFailed)
+{
+    RTShader::ShaderGenerator& shaderGenerator = RTShader::ShaderGenerator::getSingleton();
+    WorkerFailingSubRenderStateFactory factory;
+    shaderGenerator.addSubRenderStateFactory(&factory);
+
+    MaterialPtr mat = createMaterial("failed");
+    shaderGenerator.getRenderState("rtss")->addTemplateSubRenderState(factory.createInstance());
+    EXPECT_TRUE(shaderGenerator.validateMaterial("rtss", "failed", RGN_DEFAULT));
+    ASSERT_TRUE(waitForPendingTechniques());
+    EXPECT_EQ(shaderGenerator.getAsyncGeneratedTechniqueCount(), 0u);
+
+    // the failed technique is generated synchronously and published
+    Technique* tech = getTechnique(mat, "rtss");
+    ASSERT_TRUE(tech);
+    EXPECT_TRUE(tech->getPass(0)->hasVertexProgram());
+
+    shaderGenerator.removeAllShaderBasedTechniques("failed", RGN_DEFAULT);
+    shaderGenerator.getRenderState("rtss")->reset();
+    shaderGenerator.removeSubRenderStateFactory(&factory);
+}
+//--------------------------------------------------------------------------
+TEST_F(RTShaderSystemTests, ProgramManifestRoundTrip)
+{
+    const String cachePath = "RTShaderManifestTest/";
+    FileSystemLayer::createDirectory(cachePath);
+    StringVector programNames;
+
+    for (int run = 0; run < 2; ++run)
+    {
+        // a new shader generator reads the manifest the previous one wrote, like a new process
+        RTShader::ShaderGenerator::destroy();
+        RTShader::ShaderGenerator::initialize();
+        RTShader::ShaderGenerator& shaderGenerator = RTShader::ShaderGenerator::getSingleton();
+        shaderGenerator.setShaderCachePath(cachePath);
+
+        String name = "manifest" + StringConverter::toString(run);
+        MaterialPtr mat = createMaterial(name);
+        mat->getTechnique(0)->getPass(0)->setAlphaRejectSettings(CMPF_GREATER, 128);
+        EXPECT_TRUE(shaderGenerator.validateMaterial("rtss", name, RGN_DEFAULT));
+
+        Technique* tech = getTechnique(mat, "rtss");
+        ASSERT_TRUE(tech);
+        programNames.push_back(tech->getPass(0)->getVertexProgramName());
+        programNames.push_back(tech->getPass(0)->getFragmentProgramName());
+        EXPECT_FALSE(tech->getPass(0)->getVertexProgram()->getSource().empty());
+
+        // the second run reuses both programs instead of generating them
+        EXPECT_EQ(RTShader::ProgramManager::getSingleton().getReusedProgramCount(), run ? 2u : 0u);
+    }
+    EXPECT_EQ(programNames[2], programNames[0]);
+    EXPECT_EQ(programNames[3], programNames[1]);
+
+    // the alpha rejection settings are part of the signature
+    MaterialPtr mat = createMaterial("manifestAlpha");
+    mat->getTechnique(0)->getPass(0)->setAlphaRejectSettings(CMPF_LESS, 128);
+    EXPECT_TRUE(RTShader::ShaderGenerator::getSingleton().validateMaterial("rtss", "manifestAlpha",
+                                                                          RGN_DEFAULT));
+    EXPECT_EQ(RTShader::ProgramManager::getSingleton().getReusedProgramCount(), 2u);
+
+    // write the manifest before removing it
+    RTShader::ShaderGenerator::destroy();
+    for (size_t i = 0; i < 2; ++i)
+        FileSystemLayer::removeFile(cachePath + programNames[i] + ".glsl");
+    FileSystemLayer::removeFile(cachePath + "RTShaderManifest.bin");
+    FileSystemLayer::removeDirectory(cachePath);
+    RTShader::ShaderGenerator::initialize();
+}
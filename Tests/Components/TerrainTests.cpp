@@ -27,9 +27,18 @@ THE SOFTWARE.
 */
 #include <gtest/gtest.h>
 
+#include "NullRenderSystem.h"
 #include "OgreRoot.h"
 #include "OgreTerrain.h"
+#include "OgreTerrainLayerBlendMap.h"
+#include "OgreTextureManager.h"
+#include "OgreHardwarePixelBuffer.h"
+#include "OgreMaterialManager.h"
+#include "OgreWorkQueue.h"
+#include "OgreTerrainQuadTreeNode.h"
 #include "OgreFileSystemLayer.h"
+#include "OgreFileSystem.h"
+#include "OgreDefaultHardwareBufferManager.h"
 
 #include "OgreBuildSettings.h"
 #include "OgreStaticPluginLoader.h"
@@ -39,6 +48,312 @@ THE SOFTWARE.
 
 using namespace Ogre;
 
+namespace
+{
+    typedef TerrainLodManager::ImageDataList ImageDataList;
+
+    Terrain* createFlatTerrain(SceneManager* sceneMgr)
+    {
+        Terrain* terrain = OGRE_NEW Terrain(sceneMgr);
+        Terrain::ImportData imp;
+        imp.terrainSize = 33;
+        imp.worldSize = 1000;
+        imp.minBatchSize = 17;
+        imp.maxBatchSize = 33;
+        imp.constantHeight = 10;
+        EXPECT_TRUE(terrain->prepare(imp));
+        return terrain;
+    }
+
+    /// Images with distinct contents, the composite map first like Terrain::save writes them
+    ImageDataList createImages(uint16 terrainSize, bool compositeMap)
+    {
+        const char* names[] = {"compositemap", "normalmap", "colourmap", "lightmap"};
+        const uint16 sizes[] = {8, terrainSize, 8, 16};
+        const size_t channels[] = {4, 3, 3, 1};
+
+        ImageDataList images;
+        for (int i = compositeMap ? 0 : 1; i < 4; ++i)
+        {
+            images.push_back(TerrainLodManager::ImageData());
+            TerrainLodManager::ImageData& image = images.back();
+            image.name = names[i];
+            image.size = sizes[i];
+            image.dataSize = uint32(sizes[i] * sizes[i] * channels[i]);
+            image.data = static_cast<uint8*>(OGRE_MALLOC(image.dataSize, MEMCATEGORY_GENERAL));
+            for (uint32 b = 0; b < image.dataSize; ++b)
+                image.data[b] = uint8(b * 7 + i);
+        }
+        return images;
+    }
+
+    /// A blend map like the one version 2 wrote even for terrains with a single layer
+    void addBlendMap(ImageDataList& images, uint16 blendMapSize)
+    {
+        images.push_back(TerrainLodManager::ImageData());
+        TerrainLodManager::ImageData& image = images.back();
+        image.name = "blendmap0";
+        image.size = blendMapSize;
+        image.dataSize = uint32(blendMapSize * blendMapSize * 4);
+        image.data = static_cast<uint8*>(OGRE_MALLOC(image.dataSize, MEMCATEGORY_GENERAL));
+        for (uint32 b = 0; b < image.dataSize; ++b)
+            image.data[b] = uint8(b * 3);
+    }
+
+    void freeImages(ImageDataList& images)
+    {
+        for (size_t i = 0; i < images.size(); ++i)
+            OGRE_FREE(images[i].data, MEMCATEGORY_GENERAL);
+        images.clear();
+    }
+
+    /// Writes the terrain like Terrain::save of the given file version, with the given images
+    void writeTerrain(Terrain* terrain, const DataStreamPtr& stream, uint16 version,
+                      const ImageDataList& images)
+    {
+        StreamSerialiser ser(stream);
+        ser.writeChunkBegin(Terrain::TERRAIN_CHUNK_ID, version);
+
+        ser.writeChunkBegin(Terrain::TERRAINGENERALINFO_CHUNK_ID, Terrain::TERRAINGENERALINFO_CHUNK_VERSION);
+        uint8 align = (uint8)terrain->getAlignment();
+        uint16 size = terrain->getSize();
+        Real worldSize = terrain->getWorldSize();
+        uint16 maxBatchSize = terrain->getMaxBatchSize();
+        uint16 minBatchSize = terrain->getMinBatchSize();
+        ser.write(&align);
+        ser.write(&size);
+        ser.write(&worldSize);
+        ser.write(&maxBatchSize);
+        ser.write(&minBatchSize);
+        ser.write(&terrain->getPosition());
+        ser.writeChunkEnd(Terrain::TERRAINGENERALINFO_CHUNK_ID);
+
+        TerrainLodManager::saveLodData(ser, terrain);
+
+        if (version > 2)
+            ser.writeChunkBegin(Terrain::TERRAINCOREDATA_CHUNK_ID, Terrain::TERRAINCOREDATA_CHUNK_VERSION);
+        ser.startDeflate();
+
+        Terrain::writeLayerDeclaration(terrain->getLayerDeclaration(), ser);
+        Terrain::LayerInstanceList layers(terrain->getLayerCount());
+        for (uint8 l = 0; l < terrain->getLayerCount(); ++l)
+        {
+            layers[l].worldSize = terrain->getLayerWorldSize(l);
+            for (uint8 s = 0; s < terrain->getLayerDeclaration().samplers.size(); ++s)
+                layers[l].textureNames.push_back(terrain->getLayerTextureName(l, s));
+        }
+        Terrain::writeLayerInstanceList(layers, ser);
+        uint16 blendMapSize = terrain->getLayerBlendMapSize();
+        ser.write(&blendMapSize);
+
+        if (version < 3)
+        {
+            // the images are stored uncompressed within the compressed data, the packed
+            // blend maps first
+            for (size_t i = 0; i < images.size(); ++i)
+            {
+                if (StringUtil::startsWith(images[i].name, "blendmap", false))
+                    ser.write(images[i].data, images[i].dataSize);
+            }
+            for (size_t i = 0; i < images.size(); ++i)
+            {
+                if (StringUtil::startsWith(images[i].name, "blendmap", false))
+                    continue;
+                ser.writeChunkBegin(Terrain::TERRAINDERIVEDDATA_CHUNK_ID, 1);
+                ser.write(&images[i].name);
+                ser.write(&images[i].size);
+                ser.write(images[i].data, images[i].dataSize);
+                ser.writeChunkEnd(Terrain::TERRAINDERIVEDDATA_CHUNK_ID);
+            }
+        }
+
+        terrain->getQuadTree()->save(ser);
+        ser.stopDeflate();
+
+        if (version > 2)
+        {
+            ser.writeChunkEnd(Terrain::TERRAINCOREDATA_CHUNK_ID);
+            for (size_t i = 0; i < images.size(); ++i)
+                TerrainLodManager::saveImageData(ser, images[i]);
+        }
+
+        ser.writeChunkEnd(Terrain::TERRAIN_CHUNK_ID);
+    }
+
+    /// Reads all images of a version 3 terrain file
+    ImageDataList readImages(const DataStreamPtr& stream)
+    {
+        ImageDataList images;
+        StreamSerialiser ser(stream);
+        const StreamSerialiser::Chunk* mainChunk =
+            ser.readChunkBegin(Terrain::TERRAIN_CHUNK_ID, Terrain::TERRAIN_CHUNK_VERSION);
+        EXPECT_EQ(mainChunk->version, Terrain::TERRAIN_CHUNK_VERSION);
+        while (!ser.isEndOfChunk(Terrain::TERRAIN_CHUNK_ID))
+        {
+            if (ser.peekNextChunkID() == Terrain::TERRAINDERIVEDDATA_CHUNK_ID)
+            {
+                images.push_back(TerrainLodManager::ImageData());
+                TerrainLodManager::readImageData(ser, images.back(), true);
+            }
+            else
+                ser.readChunkEnd(ser.readChunkBegin()->id);
+        }
+        ser.readChunkEnd(Terrain::TERRAIN_CHUNK_ID);
+        return images;
+    }
+
+    void expectSameImages(const ImageDataList& actual, const ImageDataList& expected)
+    {
+        ASSERT_EQ(actual.size(), expected.size());
+        for (size_t i = 0; i < actual.size(); ++i)
+        {
+            EXPECT_EQ(actual[i].name, expected[i].name);
+            EXPECT_EQ(actual[i].size, expected[i].size);
+            ASSERT_EQ(actual[i].dataSize, expected[i].dataSize);
+            EXPECT_EQ(memcmp(actual[i].data, expected[i].data, actual[i].dataSize), 0) << actual[i].name;
+        }
+    }
+}
+
+namespace
+{
+    /// Pixels in memory, remembers the uploaded boxes and counts the reads
+    class RecordingPixelBuffer : public HardwarePixelBuffer
+    {
+    public:
+        RecordingPixelBuffer(uint32 width, uint32 height, PixelFormat format)
+            : HardwarePixelBuffer(width, height, 1, format, HBU_STATIC, false, false), mReads(0)
+        {
+            mData.resize(mSizeInBytes);
+        }
+
+        void blitFromMemory(const PixelBox& src, const Box& dstBox)
+        {
+            mUploads.push_back(dstBox);
+            PixelUtil::bulkPixelConversion(src, getPixels().getSubVolume(dstBox));
+        }
+        void blitToMemory(const Box& srcBox, const PixelBox& dst)
+        {
+            ++mReads;
+            PixelUtil::bulkPixelConversion(getPixels().getSubVolume(srcBox), dst);
+        }
+
+        PixelBox getPixels() { return PixelBox(mWidth, mHeight, 1, mFormat, &mData[0]); }
+
+        std::vector<Box> mUploads;
+        size_t mReads;
+
+    protected:
+        PixelBox lockImpl(const Box& lockBox, LockOptions options)
+        {
+            if (options != HBL_DISCARD && options != HBL_WRITE_ONLY)
+                ++mReads;
+            return getPixels().getSubVolume(lockBox);
+        }
+        void unlockImpl(void) {}
+
+        std::vector<uint8> mData;
+    };
+
+    class RecordingTexture : public Texture
+    {
+    public:
+        RecordingTexture(ResourceManager* creator, const String& name, ResourceHandle handle,
+                         const String& group, bool isManual, ManualResourceLoader* loader)
+            : Texture(creator, name, handle, group, isManual, loader)
+        {
+        }
+        ~RecordingTexture() { unload(); }
+
+    protected:
+        void createInternalResourcesImpl(void)
+        {
+            mSurfaceList.push_back(HardwarePixelBufferSharedPtr(
+                OGRE_NEW RecordingPixelBuffer(mWidth, mHeight, mFormat)));
+        }
+        void freeInternalResourcesImpl(void) { mSurfaceList.clear(); }
+    };
+
+    /// Stands in for the manager a render system would create
+    class RecordingTextureManager : public TextureManager
+    {
+    public:
+        RecordingTextureManager()
+        {
+            ResourceGroupManager::getSingleton()._registerResourceManager(mResourceType, this);
+        }
+        ~RecordingTextureManager()
+        {
+            ResourceGroupManager::getSingleton()._unregisterResourceManager(mResourceType);
+        }
+
+        PixelFormat getNativeFormat(TextureType ttype, PixelFormat format, int usage) { return format; }
+
+    protected:
+        Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+                             bool isManual, ManualResourceLoader* loader,
+                             const NameValuePairList* createParams)
+        {
+            return OGRE_NEW RecordingTexture(this, name, handle, group, isManual, loader);
+        }
+    };
+
+    /// Generates plain materials and remembers the composite map areas it was asked to render
+    class RecordingMaterialGenerator : public TerrainMaterialGenerator
+    {
+    public:
+        class RecordingProfile : public Profile
+        {
+        public:
+            RecordingProfile(TerrainMaterialGenerator* parent) : Profile(parent, "Recording", "") {}
+
+            bool isVertexCompressionSupported() const { return false; }
+            MaterialPtr generate(const Terrain* terrain)
+            {
+                return getMaterial(terrain->getMaterialName());
+            }
+            MaterialPtr generateForCompositeMap(const Terrain* terrain)
+            {
+                return getMaterial(terrain->getMaterialName() + "/comp");
+            }
+            void setLightmapEnabled(bool enabled) {}
+            uint8 getMaxLayers(const Terrain* terrain) const { return 8; }
+            void updateCompositeMap(const Terrain* terrain, const Rect& rect)
+            {
+                mCompositeMapRects.push_back(rect);
+            }
+            void updateParams(const MaterialPtr& mat, const Terrain* terrain) {}
+            void updateParamsForCompositeMap(const MaterialPtr& mat, const Terrain* terrain) {}
+            void requestOptions(Terrain* terrain)
+            {
+                terrain->_setMorphRequired(false);
+                terrain->_setNormalMapRequired(false);
+                terrain->_setLightMapRequired(false);
+                terrain->_setCompositeMapRequired(true);
+            }
+
+            std::vector<Rect> mCompositeMapRects;
+
+        private:
+            static MaterialPtr getMaterial(const String& name)
+            {
+                MaterialPtr mat = MaterialManager::getSingleton().getByName(name, RGN_DEFAULT);
+                return mat ? mat : MaterialManager::getSingleton().create(name, RGN_DEFAULT);
+            }
+        };
+
+        RecordingMaterialGenerator()
+        {
+            mLayerDecl.samplers.push_back(TerrainLayerSampler("albedo", PF_BYTE_RGBA));
+            mLayerDecl.elements.push_back(TerrainLayerSamplerElement(0, TLSS_ALBEDO, 0, 3));
+            mProfiles.push_back(OGRE_NEW RecordingProfile(this));
+            setActiveProfile(mProfiles.back());
+        }
+
+        RecordingProfile* getRecordingProfile() { return static_cast<RecordingProfile*>(getActiveProfile()); }
+    };
+}
+
 class TerrainTests : public ::testing::Test
 {
 public:
@@ -47,6 +362,7 @@ public:
 #endif
 
     Root* mRoot;
+    HardwareBufferManager* mHBM;
     SceneManager* mSceneMgr;
     TerrainGlobalOptions* mTerrainOpts;
     FileSystemLayer* mFSLayer;
@@ -69,6 +385,8 @@ void TerrainTests::SetUp()
     Ogre::LogManager::getSingletonPtr()->getDefaultLog()->setDebugOutputEnabled(false);
 #endif
 
+    // saving updates the vertex data, which needs buffers even without a render system
+    mHBM = OGRE_NEW DefaultHardwareBufferManager();
     mTerrainOpts = OGRE_NEW TerrainGlobalOptions();
 
     // Load resource paths from config file
@@ -99,6 +417,7 @@ void TerrainTests::TearDown()
 {
     OGRE_DELETE mTerrainOpts;
     OGRE_DELETE mRoot;
+    OGRE_DELETE mHBM;
     OGRE_DELETE_T(mFSLayer, FileSystemLayer, Ogre::MEMCATEGORY_GENERAL);
 }
 //--------------------------------------------------------------------------
@@ -122,3 +441,285 @@ TEST_F(TerrainTests, create)
     OGRE_DELETE t;
 }
 //--------------------------------------------------------------------------
+TEST_F(TerrainTests, SaveAndReloadVersion3)
+{
+    FileSystemArchiveFactory factory;
+    Archive* arch = factory.createInstance("./", false);
+    arch->load();
+
+    Terrain* t = createFlatTerrain(mSceneMgr);
+    t->setPosition(Vector3(10, 0, 20));
+    {
+        StreamSerialiser ser(arch->create("terrain.dat"));
+        t->save(ser);
+    }
+
+    Terrain* reloaded = OGRE_NEW Terrain(mSceneMgr);
+    {
+        StreamSerialiser ser(arch->open("terrain.dat"));
+        ASSERT_TRUE(reloaded->prepare(ser));
+    }
+    EXPECT_EQ(reloaded->getSize(), t->getSize());
+    EXPECT_EQ(reloaded->getWorldSize(), t->getWorldSize());
+    EXPECT_EQ(reloaded->getMinBatchSize(), t->getMinBatchSize());
+    EXPECT_EQ(reloaded->getMaxBatchSize(), t->getMaxBatchSize());
+    EXPECT_EQ(reloaded->getPosition(), t->getPosition());
+    EXPECT_EQ(reloaded->getLayerCount(), t->getLayerCount());
+    EXPECT_EQ(reloaded->getLayerBlendMapSize(), t->getLayerBlendMapSize());
+
+    // the images survive being read and written again
+    ImageDataList images = createImages(t->getSize(), true);
+    writeTerrain(t, arch->create("images.dat"), Terrain::TERRAIN_CHUNK_VERSION, images);
+    {
+        StreamSerialiser ser(arch->open("images.dat"));
+        ASSERT_TRUE(reloaded->prepare(ser));
+    }
+    EXPECT_FALSE(reloaded->isImageDataPending());
+    {
+        StreamSerialiser ser(arch->create("resaved.dat"));
+        reloaded->save(ser);
+    }
+    ImageDataList resaved = readImages(arch->open("resaved.dat"));
+    expectSameImages(resaved, images);
+
+    freeImages(resaved);
+    freeImages(images);
+    OGRE_DELETE reloaded;
+    OGRE_DELETE t;
+    arch->remove("terrain.dat");
+    arch->remove("images.dat");
+    arch->remove("resaved.dat");
+    factory.destroyInstance(arch);
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, ReadVersion2)
+{
+    FileSystemArchiveFactory factory;
+    Archive* arch = factory.createInstance("./", false);
+    arch->load();
+
+    Terrain* t = createFlatTerrain(mSceneMgr);
+    ImageDataList images = createImages(t->getSize(), true);
+    addBlendMap(images, t->getLayerBlendMapSize());
+    writeTerrain(t, arch->create("terrain2.dat"), 2, images);
+
+    Terrain* reloaded = OGRE_NEW Terrain(mSceneMgr);
+    {
+        StreamSerialiser ser(arch->open("terrain2.dat"));
+        ASSERT_TRUE(reloaded->prepare(ser));
+    }
+    EXPECT_EQ(reloaded->getSize(), t->getSize());
+    EXPECT_EQ(reloaded->getWorldSize(), t->getWorldSize());
+    EXPECT_FALSE(reloaded->isImageDataPending());
+
+    // saved as version 3 again
+    {
+        StreamSerialiser ser(arch->create("terrain3.dat"));
+        reloaded->save(ser);
+    }
+    ImageDataList resaved = readImages(arch->open("terrain3.dat"));
+    expectSameImages(resaved, images);
+
+    freeImages(resaved);
+    freeImages(images);
+    OGRE_DELETE reloaded;
+    OGRE_DELETE t;
+    arch->remove("terrain2.dat");
+    arch->remove("terrain3.dat");
+    factory.destroyInstance(arch);
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainTests, DeferredImageRead)
+{
+    FileSystemArchiveFactory factory;
+    Archive* arch = factory.createInstance("./", false);
+    arch->load();
+
+    Terrain* t = createFlatTerrain(mSceneMgr);
+    ImageDataList images = createImages(t->getSize(), true);
+    writeTerrain(t, arch->create("deferred.dat"), Terrain::TERRAIN_CHUNK_VERSION, images);
+
+    // the composite map stands in for the other images until they are asked for
+    Terrain* reloaded = OGRE_NEW Terrain(mSceneMgr);
+    DataStreamPtr stream = arch->open("deferred.dat");
+    ASSERT_TRUE(reloaded->prepare(stream));
+    EXPECT_TRUE(reloaded->isImageDataPending());
+    reloaded->loadImageData(true);
+    EXPECT_FALSE(reloaded->isImageDataPending());
+    {
+        StreamSerialiser ser(arch->create("resaved.dat"));
+        reloaded->save(ser);
+    }
+    ImageDataList resaved = readImages(arch->open("resaved.dat"));
+    expectSameImages(resaved, images);
+    freeImages(resaved);
+    freeImages(images);
+
+    // without a composite map every image is needed right away
+    images = createImages(t->getSize(), false);
+    writeTerrain(t, arch->create("immediate.dat"), Terrain::TERRAIN_CHUNK_VERSION, images);
+    stream = arch->open("immediate.dat");
+    ASSERT_TRUE(reloaded->prepare(stream));
+    EXPECT_FALSE(reloaded->isImageDataPending());
+
+    freeImages(images);
+    OGRE_DELETE reloaded;
+    OGRE_DELETE t;
+    stream.reset();
+    arch->remove("deferred.dat");
+    arch->remove("immediate.dat");
+    arch->remove("resaved.dat");
+    factory.destroyInstance(arch);
+}
+//--------------------------------------------------------------------------
+struct TerrainBlendMapTests : public TerrainTests
+{
+    NullRenderSystem* mRenderSystem;
+    RecordingTextureManager* mTextureManager;
+    RecordingMaterialGenerator* mGenerator;
+
+    void SetUp()
+    {
+        TerrainTests::SetUp();
+        // loading the materials checks the capabilities
+        mRenderSystem = OGRE_NEW NullRenderSystem();
+        mRoot->setRenderSystem(mRenderSystem);
+        mTextureManager = OGRE_NEW RecordingTextureManager();
+        MaterialManager::getSingleton().initialise();
+        mGenerator = OGRE_NEW RecordingMaterialGenerator();
+        mTerrainOpts->setDefaultMaterialGenerator(TerrainMaterialGeneratorPtr(mGenerator));
+        mRoot->getWorkQueue()->startup();
+    }
+    void TearDown()
+    {
+        OGRE_DELETE mTextureManager;
+        TerrainTests::TearDown();
+        OGRE_DELETE mRenderSystem;
+    }
+
+    /// A flat terrain with its blend texture
+    Terrain* createLoadedTerrain(size_t numLayers = 2)
+    {
+        Terrain* terrain = OGRE_NEW Terrain(mSceneMgr);
+        Terrain::ImportData imp;
+        imp.terrainSize = 33;
+        imp.worldSize = 1000;
+        imp.minBatchSize = 17;
+        imp.maxBatchSize = 33;
+        imp.layerList.resize(numLayers);
+        EXPECT_TRUE(terrain->prepare(imp));
+        terrain->load(0, true);
+        EXPECT_TRUE(terrain->isLoaded());
+        return terrain;
+    }
+
+    RecordingPixelBuffer* getBlendBuffer(Terrain* terrain)
+    {
+        return static_cast<RecordingPixelBuffer*>(terrain->getLayerBlendTexture(0)->getBuffer().get());
+    }
+};
+//--------------------------------------------------------------------------
+TEST_F(TerrainBlendMapTests, UpdateUploadsDirtyArea)
+{
+    Terrain* t = createLoadedTerrain();
+    RecordingPixelBuffer* buf = getBlendBuffer(t);
+    TerrainLayerBlendMap* blendMap = t->getLayerBlendMap(1);
+    // the texture is read once for the CPU copy
+    EXPECT_EQ(buf->mReads, 1u);
+    buf->mUploads.clear();
+
+    blendMap->setBlendValue(3, 4, 1);
+    blendMap->setBlendValue(5, 6, 1);
+    blendMap->update();
+    // converted in the background, uploaded with the work queue responses
+    EXPECT_TRUE(buf->mUploads.empty());
+    t->_waitForLayerBlendTextureUpdates();
+
+    ASSERT_EQ(buf->mUploads.size(), 1u);
+    EXPECT_EQ(buf->mUploads[0].left, 3u);
+    EXPECT_EQ(buf->mUploads[0].top, 4u);
+    EXPECT_EQ(buf->mUploads[0].right, 6u);
+    EXPECT_EQ(buf->mUploads[0].bottom, 7u);
+    EXPECT_EQ(buf->mReads, 1u);
+    EXPECT_EQ(buf->getPixels().getColourAt(5, 6, 0).r, 1);
+
+    blendMap->setBlendValue(10, 11, 1);
+    blendMap->update(true);
+    ASSERT_EQ(buf->mUploads.size(), 2u);
+    EXPECT_EQ(buf->mUploads[1].getWidth(), 1u);
+    EXPECT_EQ(buf->mUploads[1].getHeight(), 1u);
+    EXPECT_EQ(buf->mReads, 1u);
+
+    OGRE_DELETE t;
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainBlendMapTests, BlendMapsAndSaveReadCpuCopy)
+{
+    Terrain* t = createLoadedTerrain(3);
+    RecordingPixelBuffer* buf = getBlendBuffer(t);
+    TerrainLayerBlendMap* blendMap = t->getLayerBlendMap(1);
+    blendMap->setBlendValue(3, 4, 1);
+    blendMap->update();
+
+    // the second layer in the same texture reads the CPU copy
+    TerrainLayerBlendMap* otherBlendMap = t->getLayerBlendMap(2);
+    EXPECT_EQ(otherBlendMap->getBlendValue(3, 4), 0);
+    otherBlendMap->setBlendValue(4, 4, 1);
+    otherBlendMap->update();
+
+    FileSystemArchiveFactory factory;
+    Archive* arch = factory.createInstance("./", false);
+    arch->load();
+    {
+        StreamSerialiser ser(arch->create("blendmaps.dat"));
+        t->save(ser);
+    }
+    EXPECT_EQ(buf->mReads, 1u);
+
+    // the saved blend maps have the updates
+    Terrain* reloaded = OGRE_NEW Terrain(mSceneMgr);
+    {
+        StreamSerialiser ser(arch->open("blendmaps.dat"));
+        ASSERT_TRUE(reloaded->prepare(ser));
+    }
+    reloaded->load(0, true);
+    EXPECT_EQ(reloaded->getLayerBlendMap(1)->getBlendValue(3, 4), 1);
+    EXPECT_EQ(reloaded->getLayerBlendMap(2)->getBlendValue(4, 4), 1);
+    EXPECT_EQ(reloaded->getLayerBlendMap(2)->getBlendValue(3, 4), 0);
+
+    OGRE_DELETE reloaded;
+    OGRE_DELETE t;
+    arch->remove("blendmaps.dat");
+    factory.destroyInstance(arch);
+}
+//--------------------------------------------------------------------------
+TEST_F(TerrainBlendMapTests, CompositeMapRendersSeparateAreas)
+{
+    Terrain* t = createLoadedTerrain();
+    std::vector<Rect>& rendered = mGenerator->getRecordingProfile()->mCompositeMapRects;
+    t->updateCompositeMap();
+    rendered.clear();
+
+    // two strokes in opposite corners
+    TerrainLayerBlendMap* blendMap = t->getLayerBlendMap(1);
+    blendMap->setBlendValue(0, 0, 1);
+    blendMap->update(true);
+    size_t size = t->getLayerBlendMapSize();
+    blendMap->setBlendValue(size - 1, size - 1, 1);
+    blendMap->update(true);
+    t->updateCompositeMap();
+
+    ASSERT_EQ(rendered.size(), 2u);
+    for (size_t i = 0; i < rendered.size(); ++i)
+    {
+        EXPECT_LT(rendered[i].width(), t->getSize() / 2);
+        EXPECT_LT(rendered[i].height(), t->getSize() / 2);
+    }
+    EXPECT_TRUE(rendered[0].intersect(rendered[1]).isNull());
+
+    // nothing left to render
+    t->updateCompositeMap();
+    EXPECT_EQ(rendered.size(), 2u);
+
+    OGRE_DELETE t;
+}
@@ -0,0 +1,152 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#ifndef TESTS_OGREMAIN_INCLUDE_NULLRENDERSYSTEM_H_
+#define TESTS_OGREMAIN_INCLUDE_NULLRENDERSYSTEM_H_
+
+#include "OgreRenderSystem.h"
+#include "OgreRenderSystemCapabilities.h"
+
+/// A render system without a device, subclasses record what they need and set up the capabilities
+class NullRenderSystem : public Ogre::RenderSystem
+{
+public:
+    NullRenderSystem()
+    {
+        mRealCapabilities = OGRE_NEW Ogre::RenderSystemCapabilities();
+        mCurrentCapabilities = mRealCapabilities;
+    }
+
+    const Ogre::String& getName(void) const { return Ogre::BLANKSTRING; }
+    void setConfigOption(const Ogre::String& name, const Ogre::String& value) {}
+    Ogre::HardwareOcclusionQuery* createHardwareOcclusionQuery(void) { return NULL; }
+    Ogre::String validateConfigOptions(void) { return Ogre::BLANKSTRING; }
+    Ogre::RenderSystemCapabilities* createRenderSystemCapabilities() const { return NULL; }
+    void reinitialise(void) {}
+    Ogre::RenderWindow* _createRenderWindow(const Ogre::String& name, unsigned int width,
+                                            unsigned int height, bool fullScreen,
+                                            const Ogre::NameValuePairList* miscParams)
+    {
+        return NULL;
+    }
+    Ogre::MultiRenderTarget* createMultiRenderTarget(const Ogre::String& name) { return NULL; }
+    void _setTexture(size_t unit, bool enabled, const Ogre::TexturePtr& texPtr) {}
+    void _setSampler(size_t texUnit, Ogre::Sampler& s) {}
+    void _setTextureUnitFiltering(size_t unit, Ogre::FilterType ftype, Ogre::FilterOptions filter) {}
+    void _setTextureUnitCompareEnabled(size_t unit, bool compare) {}
+    void _setTextureUnitCompareFunction(size_t unit, Ogre::CompareFunction function) {}
+    void _setTextureLayerAnisotropy(size_t unit, unsigned int maxAnisotropy) {}
+    void _setTextureAddressingMode(size_t unit, const Ogre::Sampler::UVWAddressingMode& uvw) {}
+    void _setTextureBorderColour(size_t unit, const Ogre::ColourValue& colour) {}
+    void _setTextureMipmapBias(size_t unit, float bias) {}
+    void _setSeparateSceneBlending(Ogre::SceneBlendFactor sourceFactor,
+                                   Ogre::SceneBlendFactor destFactor,
+                                   Ogre::SceneBlendFactor sourceFactorAlpha,
+                                   Ogre::SceneBlendFactor destFactorAlpha,
+                                   Ogre::SceneBlendOperation op, Ogre::SceneBlendOperation alphaOp)
+    {
+    }
+    void _setAlphaRejectSettings(Ogre::CompareFunction func, unsigned char value,
+                                 bool alphaToCoverage)
+    {
+    }
+    Ogre::DepthBuffer* _createDepthBufferFor(Ogre::RenderTarget* renderTarget) { return NULL; }
+    void _beginFrame(void) {}
+    void _endFrame(void) {}
+    void _setViewport(Ogre::Viewport* vp) {}
+    void _setCullingMode(Ogre::CullingMode mode) {}
+    void _setDepthBufferParams(bool depthTest, bool depthWrite, Ogre::CompareFunction depthFunction) {}
+    void _setDepthBufferCheckEnabled(bool enabled) {}
+    void _setDepthBufferWriteEnabled(bool enabled) {}
+    void _setDepthBufferFunction(Ogre::CompareFunction func) {}
+    void _setColourBufferWriteEnabled(bool red, bool green, bool blue, bool alpha) {}
+    void _setDepthBias(float constantBias, float slopeScaleBias) {}
+    Ogre::VertexElementType getColourVertexElementType(void) const { return Ogre::VET_COLOUR_ABGR; }
+    void _convertProjectionMatrix(const Ogre::Matrix4& matrix, Ogre::Matrix4& dest,
+                                  bool forGpuProgram)
+    {
+    }
+    void _makeProjectionMatrix(const Ogre::Radian& fovy, Ogre::Real aspect, Ogre::Real nearPlane,
+                               Ogre::Real farPlane, Ogre::Matrix4& dest, bool forGpuProgram)
+    {
+    }
+    void _makeProjectionMatrix(Ogre::Real left, Ogre::Real right, Ogre::Real bottom, Ogre::Real top,
+                               Ogre::Real nearPlane, Ogre::Real farPlane, Ogre::Matrix4& dest,
+                               bool forGpuProgram)
+    {
+    }
+    void _makeOrthoMatrix(const Ogre::Radian& fovy, Ogre::Real aspect, Ogre::Real nearPlane,
+                          Ogre::Real farPlane, Ogre::Matrix4& dest, bool forGpuProgram)
+    {
+    }
+    void _applyObliqueDepthProjection(Ogre::Matrix4& matrix, const Ogre::Plane& plane,
+                                      bool forGpuProgram)
+    {
+    }
+    void _setPolygonMode(Ogre::PolygonMode level) {}
+    void setStencilCheckEnabled(bool enabled) {}
+    void setStencilBufferParams(Ogre::CompareFunction func, Ogre::uint32 refValue,
+                                Ogre::uint32 compareMask, Ogre::uint32 writeMask,
+                                Ogre::StencilOperation stencilFailOp,
+                                Ogre::StencilOperation depthFailOp, Ogre::StencilOperation passOp,
+                                bool twoSidedOperation, bool readBackAsTexture)
+    {
+    }
+    void bindGpuProgramParameters(Ogre::GpuProgramType gptype,
+                                  const Ogre::GpuProgramParametersPtr& params,
+                                  Ogre::uint16 variabilityMask)
+    {
+    }
+    void bindGpuProgramPassIterationParameters(Ogre::GpuProgramType gptype) {}
+    void setScissorTest(bool enabled, size_t left, size_t top, size_t right, size_t bottom) {}
+    void clearFrameBuffer(unsigned int buffers, const Ogre::ColourValue& colour, Ogre::Real depth,
+                          unsigned short stencil)
+    {
+    }
+    Ogre::Real getHorizontalTexelOffset(void) { return 0; }
+    Ogre::Real getVerticalTexelOffset(void) { return 0; }
+    Ogre::Real getMinimumDepthInputValue(void) { return 0; }
+    Ogre::Real getMaximumDepthInputValue(void) { return 1; }
+    void _setRenderTarget(Ogre::RenderTarget* target) {}
+    void eventOccurred(const Ogre::String& eventName, const Ogre::NameValuePairList* parameters) {}
+    void preExtraThreadsStarted() {}
+    void postExtraThreadsStarted() {}
+    void registerThread() {}
+    void unregisterThread() {}
+    unsigned int getDisplayMonitorCount() const { return 0; }
+    void beginProfileEvent(const Ogre::String& eventName) {}
+    void endProfileEvent(void) {}
+    void markProfileEvent(const Ogre::String& event) {}
+    bool hasAnisotropicMipMapFilter() const { return false; }
+    void initialiseFromRenderSystemCapabilities(Ogre::RenderSystemCapabilities* caps,
+                                                Ogre::RenderTarget* primary)
+    {
+    }
+};
+
+#endif /* TESTS_OGREMAIN_INCLUDE_NULLRENDERSYSTEM_H_ */
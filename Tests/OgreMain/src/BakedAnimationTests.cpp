@@ -0,0 +1,169 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Ogre.h"
+#include "OgreBakedAnimationAtlas.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+namespace
+{
+    const unsigned short NUM_BONES = 8;
+}
+
+struct BakedAnimationTests : public RootWithoutRenderSystemFixture
+{
+    SkeletonPtr mSkeleton;
+
+    void SetUp()
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+
+        mSkeleton = SkeletonManager::getSingleton().create("BakedAnimationTests", RGN_DEFAULT, true);
+        Bone* parent = mSkeleton->createBone("Bone0");
+        for (unsigned short i = 1; i < NUM_BONES; ++i)
+        {
+            Bone* bone = mSkeleton->createBone("Bone" + StringConverter::toString(i));
+            bone->setPosition(0, 1, 0);
+            parent->addChild(bone);
+            parent = bone;
+        }
+        mSkeleton->setBindingPose();
+
+        const char* names[] = {"Walk", "Idle"};
+        const Real lengths[] = {1, Real(0.5)};
+        for (int a = 0; a < 2; ++a)
+        {
+            Animation* anim = mSkeleton->createAnimation(names[a], lengths[a]);
+            for (unsigned short i = 0; i < NUM_BONES; ++i)
+            {
+                NodeAnimationTrack* track = anim->createNodeTrack(i, mSkeleton->getBone(i));
+                track->createNodeKeyFrame(0);
+                TransformKeyFrame* kf = track->createNodeKeyFrame(lengths[a]);
+                kf->setTranslate(Vector3(Real(a + 1), 0, 0));
+                kf->setRotation(Quaternion(Radian(1), Vector3::UNIT_Z));
+            }
+        }
+    }
+
+    void TearDown()
+    {
+        mSkeleton.reset();
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+};
+
+TEST_F(BakedAnimationTests, FramesMatchSkeleton)
+{
+    StringVector animations;
+    animations.push_back("Walk");
+    animations.push_back("Idle");
+
+    BakedAnimationAtlas atlas;
+    atlas.bake(mSkeleton, animations, 30);
+
+    ASSERT_EQ(atlas.getNumClips(), 2u);
+    EXPECT_EQ(atlas.getNumBones(), NUM_BONES);
+    EXPECT_EQ(atlas.getClip(0).numFrames, 30u);
+    EXPECT_EQ(atlas.getClip(1).numFrames, 15u);
+    EXPECT_EQ(atlas.getNumFrames(), 45u);
+    EXPECT_TRUE(atlas.hasClips(animations, 30));
+    EXPECT_FALSE(atlas.hasClips(animations, 60));
+
+    size_t idle = atlas.getClipIndex("Idle");
+    EXPECT_EQ(atlas.getFrameIndex(idle, 3), 33u);
+    EXPECT_EQ(atlas.getFrameIndex(idle, 18), 33u);
+    EXPECT_EQ(atlas.getFrameIndexAtTime(idle, Real(0.1)), 33u);
+    EXPECT_EQ(atlas.getFrameIndexAtTime(idle, Real(0.6)), 33u);
+    EXPECT_EQ(atlas.getFrameIndexAtTime(idle, Real(0.6), false), 44u);
+
+    // the pose of a frame is the pose of the skeleton at its time
+    AnimationStateSet states;
+    mSkeleton->_initAnimationState(&states);
+    AnimationState* state = states.getAnimationState("Idle");
+    state->setEnabled(true);
+    state->setTimePosition(Real(4) / 30);
+    mSkeleton->setAnimationState(states);
+    std::vector<Affine3> matrices(NUM_BONES);
+    mSkeleton->_getBoneMatrices(&matrices[0]);
+    mSkeleton->reset();
+
+    const float* frame = atlas.getFrameData(atlas.getFrameIndex(idle, 4));
+    for (unsigned short b = 0; b < NUM_BONES; ++b)
+    {
+        for (int i = 0; i < 12; ++i)
+            EXPECT_NEAR(frame[b * 12 + i], matrices[b][i / 4][i % 4], 1e-5);
+    }
+}
+
+TEST_F(BakedAnimationTests, TooManyFrames)
+{
+    StringVector animations;
+    animations.push_back("Walk");
+    animations.push_back("Idle");
+
+    BakedAnimationAtlas atlas;
+    atlas.bake(mSkeleton, animations, 30);
+
+    // the frame index would not fit the lookup number of instances
+    EXPECT_THROW(atlas.bake(mSkeleton, animations, 50000), InvalidParametersException);
+    EXPECT_EQ(atlas.getNumFrames(), 45u);
+}
+
+TEST_F(BakedAnimationTests, Serialize)
+{
+    StringVector animations;
+    animations.push_back("Walk");
+
+    BakedAnimationAtlas atlas;
+    atlas.bake(mSkeleton, animations, 24);
+
+    String fileName = BakedAnimationAtlas::getDefaultFileName("BakedAnimationTests.skeleton");
+    EXPECT_EQ(fileName, "BakedAnimationTests.bakedanim");
+
+    BakedAnimationSerializer serializer;
+    serializer.exportAtlas(&atlas, fileName);
+
+    std::ifstream file(fileName.c_str(), std::ios::binary);
+    DataStreamPtr stream(OGRE_NEW FileStreamDataStream(&file, false));
+    BakedAnimationAtlas loaded;
+    serializer.importAtlas(stream, &loaded);
+    file.close();
+    remove(fileName.c_str());
+
+    EXPECT_EQ(loaded.getSkeletonName(), mSkeleton->getName());
+    EXPECT_TRUE(loaded.hasClips(animations, 24));
+    ASSERT_EQ(loaded.getNumFrames(), atlas.getNumFrames());
+    EXPECT_EQ(loaded.getClip(0).length, atlas.getClip(0).length);
+    for (size_t f = 0; f < atlas.getNumFrames(); ++f)
+    {
+        for (size_t i = 0; i < NUM_BONES * 12u; ++i)
+            EXPECT_EQ(loaded.getFrameData(f)[i], atlas.getFrameData(f)[i]);
+    }
+}
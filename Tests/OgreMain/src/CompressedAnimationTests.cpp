@@ -0,0 +1,222 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Ogre.h"
+#include "OgreCompressedAnimationClip.h"
+#include "OgreSkeletonSerializer.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+namespace
+{
+    const unsigned short NUM_BONES = 40;
+}
+
+struct CompressedAnimationTests : public RootWithoutRenderSystemFixture
+{
+    SkeletonPtr mSkeleton;
+
+    void SetUp()
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+
+        mSkeleton = SkeletonManager::getSingleton().create("CompressedAnimationTests", RGN_DEFAULT, true);
+        // named bones, so the skeleton can be serialized
+        Bone* parent = mSkeleton->createBone("Bone0");
+        for (unsigned short i = 1; i < NUM_BONES; ++i)
+        {
+            Bone* bone = mSkeleton->createBone("Bone" + StringConverter::toString(i));
+            bone->setPosition(0, 1, 0);
+            parent->addChild(bone);
+            parent = bone;
+        }
+        mSkeleton->setBindingPose();
+
+        // smooth motion sampled at 30 fps, scaled only on some bones
+        Animation* anim = mSkeleton->createAnimation("Walk", 2);
+        for (unsigned short i = 0; i < NUM_BONES; ++i)
+        {
+            NodeAnimationTrack* track = anim->createNodeTrack(i, mSkeleton->getBone(i));
+            for (int k = 0; k <= 60; ++k)
+            {
+                Real t = k / Real(30);
+                TransformKeyFrame* kf = track->createNodeKeyFrame(t);
+                kf->setTranslate(Vector3(Math::Sin(t * 3 + i), Real(0.1) * i * t, 0));
+                kf->setRotation(Quaternion(Radian(Math::Sin(t * 2 + i)), Vector3::UNIT_Z) *
+                                Quaternion(Radian(t), Vector3::UNIT_X));
+                if (i % 4 == 0)
+                    kf->setScale(Vector3(1 + t / 4, 1, 1));
+            }
+        }
+    }
+
+    void TearDown()
+    {
+        mSkeleton.reset();
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+
+    void applyAt(const SkeletonPtr& skeleton, const Animation* anim, Real time)
+    {
+        skeleton->reset();
+        const_cast<Animation*>(anim)->apply(skeleton.get(), time, 1, 1);
+    }
+};
+
+TEST_F(CompressedAnimationTests, MatchesNodeTracks)
+{
+    Animation* reference = mSkeleton->getAnimation("Walk");
+    Animation* compressed = mSkeleton->createAnimation("Compressed", reference->getLength());
+    // same keys as the reference
+    for (unsigned short i = 0; i < NUM_BONES; ++i)
+    {
+        NodeAnimationTrack* src = reference->getNodeTrack(i);
+        NodeAnimationTrack* dst = compressed->createNodeTrack(i, mSkeleton->getBone(i));
+        for (unsigned short k = 0; k < src->getNumKeyFrames(); ++k)
+        {
+            TransformKeyFrame* kf = dst->createNodeKeyFrame(src->getKeyFrame(k)->getTime());
+            kf->setTranslate(src->getNodeKeyFrame(k)->getTranslate());
+            kf->setRotation(src->getNodeKeyFrame(k)->getRotation());
+            kf->setScale(src->getNodeKeyFrame(k)->getScale());
+        }
+    }
+    compressed->compressNodeTracks(Real(1e-3));
+
+    ASSERT_TRUE(compressed->getCompressedClip());
+    EXPECT_EQ(compressed->getNumNodeTracks(), 0);
+    const CompressedAnimationClip* clip = compressed->getCompressedClip();
+    EXPECT_EQ(clip->getNumTracks(), NUM_BONES);
+    // bones without scale keys do not store any
+    EXPECT_EQ(clip->getNumKeys(1, CompressedAnimationClip::CH_SCALE), 0u);
+    EXPECT_GT(clip->getNumKeys(0, CompressedAnimationClip::CH_SCALE), 0u);
+    // a linear scale fits a single segment
+    EXPECT_EQ(clip->getNumKeys(0, CompressedAnimationClip::CH_SCALE), 2u);
+
+    for (Real time = 0; time < 2.5; time += Real(0.07))
+    {
+        std::vector<Vector3> positions;
+        std::vector<Quaternion> orientations;
+        applyAt(mSkeleton, reference, time);
+        for (unsigned short i = 0; i < NUM_BONES; ++i)
+        {
+            positions.push_back(mSkeleton->getBone(i)->getPosition());
+            orientations.push_back(mSkeleton->getBone(i)->getOrientation());
+        }
+
+        applyAt(mSkeleton, compressed, time);
+        for (unsigned short i = 0; i < NUM_BONES; ++i)
+        {
+            EXPECT_TRUE(positions[i].positionEquals(mSkeleton->getBone(i)->getPosition(), Real(5e-3)))
+                << "bone " << i << " at " << time;
+            EXPECT_TRUE(orientations[i].equals(mSkeleton->getBone(i)->getOrientation(), Degree(1)))
+                << "bone " << i << " at " << time;
+        }
+    }
+
+    size_t keyFrameMemory = 0;
+    for (unsigned short i = 0; i < NUM_BONES; ++i)
+        keyFrameMemory += reference->getNodeTrack(i)->getNumKeyFrames() * sizeof(TransformKeyFrame);
+    EXPECT_LT(clip->getMemoryUsage(), keyFrameMemory / 4);
+    RecordProperty("KeyFrameBytes", StringConverter::toString(keyFrameMemory));
+    RecordProperty("CompressedBytes", StringConverter::toString(clip->getMemoryUsage()));
+}
+
+TEST_F(CompressedAnimationTests, Serialize)
+{
+    mSkeleton->compressAllAnimations(Real(1e-3));
+
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream(1 << 20));
+    SkeletonSerializer serializer;
+    serializer.exportSkeleton(mSkeleton.get(), stream);
+    size_t size = stream->tell();
+    stream.reset(OGRE_NEW MemoryDataStream(static_cast<MemoryDataStream*>(stream.get())->getPtr(), size));
+
+    SkeletonPtr loaded = SkeletonManager::getSingleton().create("CompressedAnimationTests2", RGN_DEFAULT, true);
+    serializer.importSkeleton(stream, loaded.get());
+
+    const CompressedAnimationClip* clip = mSkeleton->getAnimation("Walk")->getCompressedClip();
+    const CompressedAnimationClip* loadedClip = loaded->getAnimation("Walk")->getCompressedClip();
+    ASSERT_TRUE(loadedClip);
+    ASSERT_EQ(loadedClip->getNumTracks(), clip->getNumTracks());
+    EXPECT_EQ(loadedClip->getMemoryUsage(), clip->getMemoryUsage());
+
+    std::vector<Vector3> translates(NUM_BONES), scales(NUM_BONES), loadedTranslates(NUM_BONES),
+        loadedScales(NUM_BONES);
+    std::vector<Quaternion> rotations(NUM_BONES), loadedRotations(NUM_BONES);
+    for (Real time = 0; time < 2; time += Real(0.13))
+    {
+        clip->sample(time, &translates[0], &rotations[0], &scales[0]);
+        loadedClip->sample(time, &loadedTranslates[0], &loadedRotations[0], &loadedScales[0]);
+        EXPECT_EQ(translates, loadedTranslates);
+        EXPECT_EQ(rotations, loadedRotations);
+        EXPECT_EQ(scales, loadedScales);
+    }
+}
+
+TEST_F(CompressedAnimationTests, SetLengthKeepsKeyTimes)
+{
+    Animation* reference = mSkeleton->getAnimation("Walk");
+    Animation* compressed = reference->clone("Compressed");
+    compressed->compressNodeTracks(Real(1e-3));
+
+    // the keys end at 2, the rest interpolates back to the first ones
+    reference->setLength(4);
+    compressed->setLength(4);
+    EXPECT_EQ(compressed->getCompressedClip()->getLength(), 4);
+
+    for (Real time = 0; time < 4; time += Real(0.13))
+    {
+        applyAt(mSkeleton, reference, time);
+        Vector3 position = mSkeleton->getBone(5)->getPosition();
+        Quaternion orientation = mSkeleton->getBone(5)->getOrientation();
+
+        applyAt(mSkeleton, compressed, time);
+        EXPECT_TRUE(position.positionEquals(mSkeleton->getBone(5)->getPosition(), Real(5e-3)))
+            << "at " << time;
+        EXPECT_TRUE(orientation.equals(mSkeleton->getBone(5)->getOrientation(), Degree(1)))
+            << "at " << time;
+    }
+    OGRE_DELETE compressed;
+}
+
+TEST_F(CompressedAnimationTests, SerializerVersion)
+{
+    SkeletonSerializer serializer;
+    DataStreamPtr stream(OGRE_NEW MemoryDataStream(1 << 20));
+    serializer.exportSkeleton(mSkeleton.get(), stream);
+    String header(reinterpret_cast<const char*>(static_cast<MemoryDataStream*>(stream.get())->getPtr()), 64);
+    // without compressed animations older readers can load the file
+    EXPECT_NE(header.find("[Serializer_v1.80]"), String::npos);
+
+    mSkeleton->compressAllAnimations(Real(1e-3));
+    stream.reset(OGRE_NEW MemoryDataStream(1 << 20));
+    serializer.exportSkeleton(mSkeleton.get(), stream);
+    header.assign(reinterpret_cast<const char*>(static_cast<MemoryDataStream*>(stream.get())->getPtr()), 64);
+    EXPECT_NE(header.find("[Serializer_v1.120]"), String::npos);
+}
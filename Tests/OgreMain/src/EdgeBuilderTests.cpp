@@ -29,7 +29,479 @@ THE SOFTWARE.
 #include "OgreDefaultHardwareBufferManager.h"
 #include "OgreVertexIndexData.h"
 #include "OgreEdgeListBuilder.h"
+#include "OgreThreadPool.h"
+#include "OgreTimer.h"
+#include "OgreStringConverter.h"
+#include "OgreShadowCaster.h"
+#include "OgreLight.h"
 
+namespace
+{
+    /// The edge list builder as it was with ordered maps, to compare the output against
+    class ReferenceEdgeListBuilder
+    {
+    public:
+        struct Geometry
+        {
+            size_t vertexSet;
+            size_t indexSet;
+            const IndexData* indexData;
+            RenderOperation::OperationType opType;
+
+            bool operator<(const Geometry& b) const
+            {
+                if (vertexSet != b.vertexSet)
+                    return vertexSet < b.vertexSet;
+                return indexSet < b.indexSet;
+            }
+        };
+
+        std::vector<const VertexData*> vertexDataList;
+        std::vector<Geometry> geometryList;
+
+        void addIndexData(const IndexData* indexData, size_t vertexSet, RenderOperation::OperationType opType)
+        {
+            Geometry g = {vertexSet, geometryList.size(), indexData, opType};
+            geometryList.push_back(g);
+        }
+
+        EdgeData* build()
+        {
+            std::sort(geometryList.begin(), geometryList.end());
+            mEdgeData = OGRE_NEW EdgeData();
+            mEdgeData->edgeGroups.resize(vertexDataList.size());
+            for (size_t vSet = 0; vSet < vertexDataList.size(); ++vSet)
+            {
+                mEdgeData->edgeGroups[vSet].vertexSet = vSet;
+                mEdgeData->edgeGroups[vSet].vertexData = vertexDataList[vSet];
+                mEdgeData->edgeGroups[vSet].triStart = 0;
+                mEdgeData->edgeGroups[vSet].triCount = 0;
+            }
+            for (size_t i = 0; i < geometryList.size(); ++i)
+                buildTrianglesEdges(geometryList[i]);
+            mEdgeData->triangleLightFacings.resize(mEdgeData->triangles.size());
+            mEdgeData->isClosed = mEdgeMap.empty();
+            return mEdgeData;
+        }
+
+    private:
+        struct vectorLess
+        {
+            bool operator()(const Vector3& a, const Vector3& b) const
+            {
+                if (a.x < b.x) return true;
+                if (a.x > b.x) return false;
+                if (a.y < b.y) return true;
+                if (a.y > b.y) return false;
+                return a.z < b.z;
+            }
+        };
+        typedef std::multimap<std::pair<size_t, size_t>, std::pair<size_t, size_t> > EdgeMap;
+
+        EdgeData* mEdgeData;
+        std::map<Vector3, size_t, vectorLess> mCommonVertexMap;
+        EdgeMap mEdgeMap;
+
+        void buildTrianglesEdges(const Geometry& geometry)
+        {
+            const IndexData* indexData = geometry.indexData;
+            RenderOperation::OperationType opType = geometry.opType;
+            size_t iterations = opType == RenderOperation::OT_TRIANGLE_LIST ?
+                indexData->indexCount / 3 : indexData->indexCount - 2;
+            EdgeData::EdgeGroup& eg = mEdgeData->edgeGroups[geometry.vertexSet];
+
+            const VertexData* vertexData = vertexDataList[geometry.vertexSet];
+            const VertexElement* posElem = vertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+            HardwareVertexBufferSharedPtr vbuf = vertexData->vertexBufferBinding->getBuffer(posElem->getSource());
+            HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::HBL_READ_ONLY);
+            unsigned char* pBaseVertex = static_cast<unsigned char*>(vertexLock.pData);
+
+            bool idx32bit = (indexData->indexBuffer->getType() == HardwareIndexBuffer::IT_32BIT);
+            HardwareBufferLockGuard indexLock(indexData->indexBuffer, HardwareBuffer::HBL_READ_ONLY);
+            unsigned short* p16Idx = static_cast<unsigned short*>(indexLock.pData) + indexData->indexStart;
+            unsigned int* p32Idx = static_cast<unsigned int*>(indexLock.pData) + indexData->indexStart;
+
+            unsigned int index[3];
+            size_t triangleIndex = mEdgeData->triangles.size();
+            if (!eg.triCount)
+                eg.triStart = triangleIndex;
+            for (size_t t = 0; t < iterations; ++t)
+            {
+                EdgeData::Triangle tri;
+                tri.indexSet = geometry.indexSet;
+                tri.vertexSet = geometry.vertexSet;
+
+                if (opType == RenderOperation::OT_TRIANGLE_LIST || t == 0)
+                {
+                    for (int i = 0; i < 3; ++i)
+                        index[i] = idx32bit ? *p32Idx++ : *p16Idx++;
+                }
+                else
+                {
+                    index[(opType == RenderOperation::OT_TRIANGLE_STRIP) && (t & 1) ? 0 : 1] = index[2];
+                    index[2] = idx32bit ? *p32Idx++ : *p16Idx++;
+                }
+
+                Vector3 v[3];
+                for (size_t i = 0; i < 3; ++i)
+                {
+                    tri.vertIndex[i] = index[i];
+                    float* pFloat;
+                    posElem->baseVertexPointerToElement(pBaseVertex + index[i] * vbuf->getVertexSize(), &pFloat);
+                    v[i] = Vector3(pFloat[0], pFloat[1], pFloat[2]);
+                    std::pair<std::map<Vector3, size_t, vectorLess>::iterator, bool> inserted =
+                        mCommonVertexMap.insert(std::make_pair(v[i], mCommonVertexMap.size()));
+                    tri.sharedVertIndex[i] = inserted.first->second;
+                }
+
+                if (tri.sharedVertIndex[0] != tri.sharedVertIndex[1] &&
+                    tri.sharedVertIndex[1] != tri.sharedVertIndex[2] &&
+                    tri.sharedVertIndex[2] != tri.sharedVertIndex[0])
+                {
+                    mEdgeData->triangleFaceNormals.push_back(
+                        Math::calculateFaceNormalWithoutNormalize(v[0], v[1], v[2]));
+                    mEdgeData->triangles.push_back(tri);
+                    for (int i = 0; i < 3; ++i)
+                    {
+                        connectOrCreateEdge(geometry.vertexSet, triangleIndex,
+                            tri.vertIndex[i], tri.vertIndex[(i + 1) % 3],
+                            tri.sharedVertIndex[i], tri.sharedVertIndex[(i + 1) % 3]);
+                    }
+                    ++triangleIndex;
+                }
+            }
+            eg.triCount = triangleIndex - eg.triStart;
+        }
+
+        void connectOrCreateEdge(size_t vertexSet, size_t triangleIndex, size_t vertIndex0,
+            size_t vertIndex1, size_t sharedVertIndex0, size_t sharedVertIndex1)
+        {
+            EdgeMap::iterator emi = mEdgeMap.find(std::make_pair(sharedVertIndex1, sharedVertIndex0));
+            if (emi != mEdgeMap.end())
+            {
+                EdgeData::Edge& e = mEdgeData->edgeGroups[emi->second.first].edges[emi->second.second];
+                e.triIndex[1] = triangleIndex;
+                e.degenerate = false;
+                mEdgeMap.erase(emi);
+            }
+            else
+            {
+                mEdgeMap.insert(EdgeMap::value_type(std::make_pair(sharedVertIndex0, sharedVertIndex1),
+                    std::make_pair(vertexSet, mEdgeData->edgeGroups[vertexSet].edges.size())));
+                EdgeData::Edge e;
+                e.degenerate = true;
+                e.triIndex[0] = triangleIndex;
+                e.triIndex[1] = static_cast<size_t>(~0);
+                e.sharedVertIndex[0] = sharedVertIndex0;
+                e.sharedVertIndex[1] = sharedVertIndex1;
+                e.vertIndex[0] = vertIndex0;
+                e.vertIndex[1] = vertIndex1;
+                mEdgeData->edgeGroups[vertexSet].edges.push_back(e);
+            }
+        }
+    };
+
+    void expectSameEdgeData(const EdgeData* a, const EdgeData* b)
+    {
+        EXPECT_EQ(a->isClosed, b->isClosed);
+        ASSERT_EQ(a->triangles.size(), b->triangles.size());
+        ASSERT_EQ(a->triangleFaceNormals.size(), b->triangleFaceNormals.size());
+        EXPECT_EQ(a->triangleLightFacings.size(), b->triangleLightFacings.size());
+        for (size_t t = 0; t < a->triangles.size(); ++t)
+        {
+            const EdgeData::Triangle& ta = a->triangles[t];
+            const EdgeData::Triangle& tb = b->triangles[t];
+            EXPECT_EQ(ta.indexSet, tb.indexSet);
+            EXPECT_EQ(ta.vertexSet, tb.vertexSet);
+            for (int i = 0; i < 3; ++i)
+            {
+                EXPECT_EQ(ta.vertIndex[i], tb.vertIndex[i]);
+                EXPECT_EQ(ta.sharedVertIndex[i], tb.sharedVertIndex[i]);
+            }
+            EXPECT_EQ(a->triangleFaceNormals[t], b->triangleFaceNormals[t]);
+        }
+
+        ASSERT_EQ(a->edgeGroups.size(), b->edgeGroups.size());
+        for (size_t g = 0; g < a->edgeGroups.size(); ++g)
+        {
+            const EdgeData::EdgeGroup& ga = a->edgeGroups[g];
+            const EdgeData::EdgeGroup& gb = b->edgeGroups[g];
+            EXPECT_EQ(ga.vertexSet, gb.vertexSet);
+            EXPECT_EQ(ga.vertexData, gb.vertexData);
+            EXPECT_EQ(ga.triStart, gb.triStart);
+            EXPECT_EQ(ga.triCount, gb.triCount);
+            ASSERT_EQ(ga.edges.size(), gb.edges.size());
+            for (size_t e = 0; e < ga.edges.size(); ++e)
+            {
+                const EdgeData::Edge& ea = ga.edges[e];
+                const EdgeData::Edge& eb = gb.edges[e];
+                EXPECT_EQ(ea.degenerate, eb.degenerate);
+                for (int i = 0; i < 2; ++i)
+                {
+                    EXPECT_EQ(ea.triIndex[i], eb.triIndex[i]);
+                    EXPECT_EQ(ea.vertIndex[i], eb.vertIndex[i]);
+                    EXPECT_EQ(ea.sharedVertIndex[i], eb.sharedVertIndex[i]);
+                }
+            }
+        }
+    }
+
+    VertexData* createVertexData(const std::vector<float>& positions)
+    {
+        VertexData* vd = OGRE_NEW VertexData();
+        vd->vertexCount = positions.size() / 3;
+        // padded, so the position is not the whole vertex
+        vd->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+        vd->vertexDeclaration->addElement(0, sizeof(float) * 3, VET_FLOAT2, VES_TEXTURE_COORDINATES);
+        HardwareVertexBufferSharedPtr vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(
+            sizeof(float) * 5, vd->vertexCount, HardwareBuffer::HBU_STATIC, true);
+        vd->vertexBufferBinding->setBinding(0, vbuf);
+        HardwareBufferLockGuard lock(vbuf, HardwareBuffer::HBL_DISCARD);
+        float* pFloat = static_cast<float*>(lock.pData);
+        for (size_t v = 0; v < vd->vertexCount; ++v)
+        {
+            *pFloat++ = positions[v * 3];
+            *pFloat++ = positions[v * 3 + 1];
+            *pFloat++ = positions[v * 3 + 2];
+            *pFloat++ = 0;
+            *pFloat++ = 0;
+        }
+        return vd;
+    }
+
+    IndexData* createIndexData(const std::vector<uint32>& indexes, bool use32bit)
+    {
+        IndexData* id = OGRE_NEW IndexData();
+        id->indexCount = indexes.size();
+        id->indexStart = 0;
+        id->indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+            use32bit ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
+            indexes.size(), HardwareBuffer::HBU_STATIC, true);
+        HardwareBufferLockGuard lock(id->indexBuffer, HardwareBuffer::HBL_DISCARD);
+        for (size_t i = 0; i < indexes.size(); ++i)
+        {
+            if (use32bit)
+                static_cast<uint32*>(lock.pData)[i] = indexes[i];
+            else
+                static_cast<uint16*>(lock.pData)[i] = static_cast<uint16>(indexes[i]);
+        }
+        return id;
+    }
+
+    /** A grid of quads, with a seam of duplicated vertices every few columns. The
+        outer rows are folded back to meet, so some edges are shared by several triangles.
+    */
+    void createGrid(size_t size, std::vector<float>& positions, std::vector<uint32>& indexes)
+    {
+        for (size_t y = 0; y <= size; ++y)
+        {
+            for (size_t x = 0; x <= size; ++x)
+            {
+                // -0 must weld with 0
+                positions.push_back(x == 0 && (y & 1) ? -0.0f : float(x));
+                positions.push_back(float(y % size));
+                positions.push_back(y == size ? 0.0f : float((x * 7 + y * 3) % 5));
+            }
+        }
+        for (size_t y = 0; y <= size; ++y)
+        {
+            for (size_t x = 0; x <= size; x += 4)
+            {
+                positions.push_back(float(x));
+                positions.push_back(float(y % size));
+                positions.push_back(y == size ? 0.0f : float((x * 7 + y * 3) % 5));
+            }
+        }
+
+        const size_t row = size + 1;
+        const size_t seamStart = row * row;
+        const size_t seamRow = size / 4 + 1;
+        for (size_t y = 0; y < size; ++y)
+        {
+            for (size_t x = 0; x < size; ++x)
+            {
+                uint32 v0 = uint32(y * row + x);
+                uint32 v1 = v0 + 1;
+                uint32 v2 = uint32(v0 + row);
+                uint32 v3 = v2 + 1;
+                // left side of seam columns uses the duplicated vertices
+                if (x % 4 == 0)
+                {
+                    v0 = uint32(seamStart + y * seamRow + x / 4);
+                    v2 = uint32(v0 + seamRow);
+                }
+                indexes.push_back(v0); indexes.push_back(v1); indexes.push_back(v3);
+                indexes.push_back(v0); indexes.push_back(v3); indexes.push_back(v2);
+            }
+        }
+        // a degenerate triangle
+        indexes.push_back(0); indexes.push_back(0); indexes.push_back(1);
+    }
+
+    class TestShadowRenderable : public ShadowRenderable
+    {
+    public:
+        TestShadowRenderable(const HardwareIndexBufferSharedPtr& indexBuffer, bool separateLightCap)
+        {
+            mRenderOp.indexData = OGRE_NEW IndexData();
+            mRenderOp.indexData->indexBuffer = indexBuffer;
+            if (separateLightCap)
+                mLightCap = OGRE_NEW TestShadowRenderable(indexBuffer, false);
+        }
+        ~TestShadowRenderable() { OGRE_DELETE mRenderOp.indexData; }
+        void getWorldTransforms(Matrix4* xform) const { *xform = Matrix4::IDENTITY; }
+        void rebindIndexBuffer(const HardwareIndexBufferSharedPtr& indexBuffer)
+        {
+            mRenderOp.indexData->indexBuffer = indexBuffer;
+        }
+    };
+
+    /// A caster at the origin, as Entity and ManualObject generate their volumes
+    class TestShadowCaster : public ShadowCaster
+    {
+    public:
+        EdgeData* edgeData;
+        AxisAlignedBox bounds;
+        ShadowRenderableList renderables;
+
+        TestShadowCaster(EdgeData* ed, const HardwareIndexBufferSharedPtr& indexBuffer) : edgeData(ed)
+        {
+            for (size_t i = 0; i < edgeData->edgeGroups.size(); ++i)
+            {
+                const VertexData* vd = edgeData->edgeGroups[i].vertexData;
+                renderables.push_back(OGRE_NEW TestShadowRenderable(indexBuffer, i == 0));
+                HardwareVertexBufferSharedPtr vbuf = vd->vertexBufferBinding->getBuffer(0);
+                HardwareBufferLockGuard lock(vbuf, HardwareBuffer::HBL_READ_ONLY);
+                for (size_t v = 0; v < vd->vertexCount; ++v)
+                    bounds.merge(Vector3(static_cast<float*>(lock.pData) + v * 5));
+            }
+        }
+        ~TestShadowCaster() { clearShadowRenderableList(renderables); }
+
+        bool getCastShadows(void) const { return true; }
+        EdgeData* getEdgeList(void) { return edgeData; }
+        bool hasEdgeList(void) { return true; }
+        const AxisAlignedBox& getWorldBoundingBox(bool derive = false) const { return bounds; }
+        const AxisAlignedBox& getLightCapBounds(void) const { return bounds; }
+        const AxisAlignedBox& getDarkCapBounds(const Light& light, Real dirLightExtrusionDist) const { return bounds; }
+        Real getPointExtrusionDistance(const Light* l) const { return 100; }
+
+        ShadowRenderableListIterator getShadowVolumeRenderableIterator(
+            ShadowTechnique shadowTechnique, const Light* light,
+            HardwareIndexBufferSharedPtr* indexBuffer, size_t* indexBufferUsedSize,
+            bool extrudeVertices, Real extrusionDistance, unsigned long flags)
+        {
+            updateEdgeListLightFacing(edgeData, light->getAs4DVector());
+            generateShadowVolume(edgeData, *indexBuffer, *indexBufferUsedSize, light, renderables, flags);
+            return ShadowRenderableListIterator(renderables.begin(), renderables.end());
+        }
+    };
+
+    /// The shadow volume indexes as ShadowCaster generated them edge by edge
+    std::vector<uint16> referenceShadowVolume(const EdgeData* edgeData, const Vector4& lightPos,
+        bool extrudeToInfinity, bool useMcGuire, unsigned long flags)
+    {
+        std::vector<char> lightFacings;
+        for (size_t t = 0; t < edgeData->triangles.size(); ++t)
+            lightFacings.push_back(lightPos.dotProduct(edgeData->triangleFaceNormals[t]) > 0);
+
+        std::vector<uint16> indexes;
+        for (size_t g = 0; g < edgeData->edgeGroups.size(); ++g)
+        {
+            const EdgeData::EdgeGroup& eg = edgeData->edgeGroups[g];
+            size_t originalVertexCount = eg.vertexData->vertexCount;
+            bool firstDarkCapTri = true;
+            size_t darkCapStart = 0;
+            for (size_t e = 0; e < eg.edges.size(); ++e)
+            {
+                const EdgeData::Edge& edge = eg.edges[e];
+                char lightFacing = lightFacings[edge.triIndex[0]];
+                if ((edge.degenerate && lightFacing) ||
+                    (!edge.degenerate && (lightFacing != lightFacings[edge.triIndex[1]])))
+                {
+                    size_t v0 = edge.vertIndex[0];
+                    size_t v1 = edge.vertIndex[1];
+                    if (!lightFacing)
+                        std::swap(v0, v1);
+                    indexes.push_back(uint16(v1));
+                    indexes.push_back(uint16(v0));
+                    indexes.push_back(uint16(v0 + originalVertexCount));
+                    if (!extrudeToInfinity)
+                    {
+                        indexes.push_back(uint16(v0 + originalVertexCount));
+                        indexes.push_back(uint16(v1 + originalVertexCount));
+                        indexes.push_back(uint16(v1));
+                    }
+                    if (useMcGuire && (flags & SRF_INCLUDE_DARK_CAP))
+                    {
+                        if (firstDarkCapTri)
+                        {
+                            darkCapStart = v0 + originalVertexCount;
+                            firstDarkCapTri = false;
+                        }
+                        else
+                        {
+                            indexes.push_back(uint16(darkCapStart));
+                            indexes.push_back(uint16(v1 + originalVertexCount));
+                            indexes.push_back(uint16(v0 + originalVertexCount));
+                        }
+                    }
+                }
+            }
+            for (int cap = 0; cap < 2; ++cap)
+            {
+                if (cap == 0 && (useMcGuire || !(flags & SRF_INCLUDE_DARK_CAP)))
+                    continue;
+                if (cap == 1 && !(flags & SRF_INCLUDE_LIGHT_CAP))
+                    continue;
+                for (size_t t = eg.triStart; t < eg.triStart + eg.triCount; ++t)
+                {
+                    if (!lightFacings[t])
+                        continue;
+                    const EdgeData::Triangle& tri = edgeData->triangles[t];
+                    size_t offset = cap == 0 ? originalVertexCount : 0;
+                    indexes.push_back(uint16(tri.vertIndex[cap == 0 ? 1 : 0] + offset));
+                    indexes.push_back(uint16(tri.vertIndex[cap == 0 ? 0 : 1] + offset));
+                    indexes.push_back(uint16(tri.vertIndex[2] + offset));
+                }
+            }
+        }
+        return indexes;
+    }
+
+    void expectShadowVolume(TestShadowCaster& caster, const Light& light, unsigned long flags,
+        bool useMcGuire, const HardwareIndexBufferSharedPtr& indexBuffer)
+    {
+        size_t indexBufferUsedSize = 0;
+        caster.getShadowVolumeRenderableIterator(SHADOWTYPE_STENCIL_ADDITIVE, &light, 
+            const_cast<HardwareIndexBufferSharedPtr*>(&indexBuffer), &indexBufferUsedSize, false, 100, flags);
+
+        bool extrudeToInfinity = light.getType() == Light::LT_DIRECTIONAL && (flags & SRF_EXTRUDE_TO_INFINITY);
+        std::vector<uint16> expected = referenceShadowVolume(caster.edgeData, light.getAs4DVector(),
+            extrudeToInfinity, useMcGuire, flags);
+        ASSERT_EQ(indexBufferUsedSize, expected.size());
+
+        HardwareBufferLockGuard lock(indexBuffer, HardwareBuffer::HBL_READ_ONLY);
+        const uint16* indexes = static_cast<const uint16*>(lock.pData);
+        EXPECT_TRUE(std::equal(expected.begin(), expected.end(), indexes));
+
+        // the renderables cover the indexes in order, the light cap of the first one separately
+        size_t next = 0;
+        for (size_t i = 0; i < caster.renderables.size(); ++i)
+        {
+            const IndexData* indexData = caster.renderables[i]->getRenderOperationForUpdate()->indexData;
+            EXPECT_EQ(indexData->indexStart, next);
+            next = indexData->indexStart + indexData->indexCount;
+            if (caster.renderables[i]->isLightCapSeparate() && (flags & SRF_INCLUDE_LIGHT_CAP))
+            {
+                indexData = caster.renderables[i]->getLightCapRenderable()->getRenderOperationForUpdate()->indexData;
+                EXPECT_EQ(indexData->indexStart, next);
+                next = indexData->indexStart + indexData->indexCount;
+            }
+        }
+        EXPECT_EQ(next, expected.size());
+    }
+}
 
 // Register the test suite
 
@@ -283,3 +755,185 @@ TEST_F(EdgeBuilderTests,MultiIndexBufMultiVertexBuf)
     delete edgeData;
 }
 //--------------------------------------------------------------------------
+TEST_F(EdgeBuilderTests,MatchesOrderedMapBuilder)
+{
+    /* The hashed builder must produce exactly the edge data the ordered map based
+    builder did: the same welding, triangle order and edge pairing.
+    */
+    std::vector<float> positions;
+    std::vector<uint32> gridIndexes;
+    createGrid(64, positions, gridIndexes);
+
+    VertexData* vd[2];
+    vd[0] = createVertexData(positions);
+    vd[1] = createVertexData(positions);
+
+    // split the grid in index sets of different kinds, on both vertex sets
+    std::vector<uint32> half0(gridIndexes.begin(), gridIndexes.begin() + gridIndexes.size() / 6 * 3);
+    std::vector<uint32> half1(gridIndexes.begin() + half0.size(), gridIndexes.end());
+    std::vector<uint32> strip, fan;
+    for (uint32 i = 0; i < 40; ++i)
+        strip.push_back(i % 2 ? i / 2 : i / 2 + 65);
+    fan.push_back(65 * 10 + 10);
+    for (uint32 i = 0; i < 9; ++i)
+        fan.push_back(65 * 9 + 9 + (i % 3) + 65 * (i / 3));
+
+    IndexData* id[5];
+    id[0] = createIndexData(half0, false);
+    id[1] = createIndexData(half1, true);
+    id[2] = createIndexData(strip, false);
+    id[3] = createIndexData(fan, true);
+    id[4] = createIndexData(gridIndexes, true);
+
+    ReferenceEdgeListBuilder reference;
+    reference.vertexDataList.push_back(vd[0]);
+    reference.vertexDataList.push_back(vd[1]);
+    // out of vertex set order, the builders sort them
+    reference.addIndexData(id[4], 1, RenderOperation::OT_TRIANGLE_LIST);
+    reference.addIndexData(id[0], 0, RenderOperation::OT_TRIANGLE_LIST);
+    reference.addIndexData(id[2], 0, RenderOperation::OT_TRIANGLE_STRIP);
+    reference.addIndexData(id[1], 0, RenderOperation::OT_TRIANGLE_LIST);
+    reference.addIndexData(id[3], 1, RenderOperation::OT_TRIANGLE_FAN);
+    EdgeData* expected = reference.build();
+
+    EdgeListBuilder edgeBuilder;
+    edgeBuilder.addVertexData(vd[0]);
+    edgeBuilder.addVertexData(vd[1]);
+    edgeBuilder.addIndexData(id[4], 1, RenderOperation::OT_TRIANGLE_LIST);
+    edgeBuilder.addIndexData(id[0], 0, RenderOperation::OT_TRIANGLE_LIST);
+    edgeBuilder.addIndexData(id[2], 0, RenderOperation::OT_TRIANGLE_STRIP);
+    edgeBuilder.addIndexData(id[1], 0, RenderOperation::OT_TRIANGLE_LIST);
+    edgeBuilder.addIndexData(id[3], 1, RenderOperation::OT_TRIANGLE_FAN);
+    EdgeData* edgeData = edgeBuilder.build();
+
+    expectSameEdgeData(edgeData, expected);
+    EXPECT_FALSE(edgeData->isClosed);
+
+    OGRE_DELETE edgeData;
+    OGRE_DELETE expected;
+    for (int i = 0; i < 5; ++i)
+        OGRE_DELETE id[i];
+    OGRE_DELETE vd[0];
+    OGRE_DELETE vd[1];
+}
+//--------------------------------------------------------------------------
+TEST_F(EdgeBuilderTests,BuildBenchmark)
+{
+    std::vector<float> positions;
+    std::vector<uint32> indexes;
+    createGrid(512, positions, indexes);
+    VertexData* vd = createVertexData(positions);
+    IndexData* id = createIndexData(indexes, true);
+
+    // as without a Root, and with worker threads
+    Timer timer;
+    uint64 start = timer.getMicroseconds();
+    ReferenceEdgeListBuilder reference;
+    reference.vertexDataList.push_back(vd);
+    reference.addIndexData(id, 0, RenderOperation::OT_TRIANGLE_LIST);
+    EdgeData* expected = reference.build();
+    uint64 referenceTime = timer.getMicroseconds() - start;
+
+    start = timer.getMicroseconds();
+    EdgeListBuilder serialBuilder;
+    serialBuilder.addVertexData(vd);
+    serialBuilder.addIndexData(id);
+    EdgeData* serialData = serialBuilder.build();
+    uint64 serialTime = timer.getMicroseconds() - start;
+
+    uint64 parallelTime;
+    EdgeData* parallelData;
+    {
+        ThreadPool threadPool;
+        start = timer.getMicroseconds();
+        EdgeListBuilder parallelBuilder;
+        parallelBuilder.addVertexData(vd);
+        parallelBuilder.addIndexData(id);
+        parallelData = parallelBuilder.build();
+        parallelTime = timer.getMicroseconds() - start;
+    }
+
+    expectSameEdgeData(serialData, expected);
+    expectSameEdgeData(parallelData, expected);
+
+    RecordProperty("OrderedMapMicroseconds", StringConverter::toString(referenceTime));
+    RecordProperty("HashedMicroseconds", StringConverter::toString(serialTime));
+    RecordProperty("HashedParallelMicroseconds", StringConverter::toString(parallelTime));
+
+    OGRE_DELETE parallelData;
+    OGRE_DELETE serialData;
+    OGRE_DELETE expected;
+    OGRE_DELETE id;
+    OGRE_DELETE vd;
+}
+//--------------------------------------------------------------------------
+TEST_F(EdgeBuilderTests,ShadowVolumeMatchesReference)
+{
+    std::vector<float> positions;
+    std::vector<uint32> indexes;
+    // large enough to split the silhouette of a group in several ranges
+    createGrid(96, positions, indexes);
+    VertexData* vd[2];
+    vd[0] = createVertexData(positions);
+    vd[1] = createVertexData(positions);
+    IndexData* id = createIndexData(indexes, false);
+
+    HardwareIndexBufferSharedPtr indexBuffer = HardwareBufferManager::getSingleton().createIndexBuffer(
+        HardwareIndexBuffer::IT_16BIT, 1 << 18, HardwareBuffer::HBU_DYNAMIC_WRITE_ONLY_DISCARDABLE, true);
+
+    const unsigned long flagSets[] = {
+        0, SRF_INCLUDE_LIGHT_CAP, SRF_INCLUDE_DARK_CAP, SRF_INCLUDE_LIGHT_CAP | SRF_INCLUDE_DARK_CAP,
+        SRF_INCLUDE_LIGHT_CAP | SRF_INCLUDE_DARK_CAP | SRF_EXTRUDE_TO_INFINITY};
+
+    ThreadPool threadPool;
+    Light light;
+    for (int numGroups = 1; numGroups <= 2; ++numGroups)
+    {
+        EdgeListBuilder edgeBuilder;
+        for (int i = 0; i < numGroups; ++i)
+        {
+            edgeBuilder.addVertexData(vd[i]);
+            edgeBuilder.addIndexData(id, i);
+        }
+        EdgeData* edgeData = edgeBuilder.build();
+        TestShadowCaster caster(edgeData, indexBuffer);
+
+        for (size_t f = 0; f < sizeof(flagSets) / sizeof(flagSets[0]); ++f)
+        {
+            // McGuire dark caps for a single group, unless the light is inside the bounds
+            light.setType(Light::LT_DIRECTIONAL);
+            light.setDirection(Vector3(1, -2, 0.5).normalisedCopy());
+            expectShadowVolume(caster, light, flagSets[f], numGroups == 1, indexBuffer);
+            light.setType(Light::LT_POINT);
+            light.setPosition(Vector3(16, 12, 2));
+            expectShadowVolume(caster, light, flagSets[f], false, indexBuffer);
+            // again, from the cache
+            expectShadowVolume(caster, light, flagSets[f], false, indexBuffer);
+        }
+
+        // face normals that change without a new version are not noticed
+        std::vector<uint16> expected =
+            referenceShadowVolume(edgeData, light.getAs4DVector(), false, false, flagSets[1]);
+        expectShadowVolume(caster, light, flagSets[1], false, indexBuffer);
+        for (size_t t = 0; t < edgeData->triangleFaceNormals.size(); ++t)
+            edgeData->triangleFaceNormals[t] = -edgeData->triangleFaceNormals[t];
+        size_t indexBufferUsedSize = 0;
+        caster.getShadowVolumeRenderableIterator(SHADOWTYPE_STENCIL_ADDITIVE, &light,
+            &indexBuffer, &indexBufferUsedSize, false, 100, flagSets[1]);
+        ASSERT_EQ(indexBufferUsedSize, expected.size());
+        {
+            HardwareBufferLockGuard lock(indexBuffer, HardwareBuffer::HBL_READ_ONLY);
+            EXPECT_TRUE(std::equal(expected.begin(), expected.end(), static_cast<const uint16*>(lock.pData)));
+        }
+        // as by EdgeData::updateFaceNormals
+        ++edgeData->faceNormalsVersion;
+        expectShadowVolume(caster, light, flagSets[1], false, indexBuffer);
+
+        OGRE_DELETE edgeData;
+    }
+
+    OGRE_DELETE id;
+    OGRE_DELETE vd[0];
+    OGRE_DELETE vd[1];
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,231 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Ogre.h"
+#include "OgreFrameAllocator.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+#include <cstdlib>
+#include <new>
+
+using namespace Ogre;
+
+namespace
+{
+    // Counts the heap allocations of the whole process while enabled
+    bool gCountAllocations = false;
+    size_t gNumAllocations = 0;
+}
+
+void* operator new(size_t size)
+{
+    if (gCountAllocations)
+        ++gNumAllocations;
+    void* p = malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void operator delete(void* p) noexcept
+{
+    free(p);
+}
+
+namespace
+{
+    /// Exposes the light search _renderScene does, which needs a render system
+    class FrameSceneManager : public SceneManager
+    {
+    public:
+        FrameSceneManager() : SceneManager("FrameSceneManager") {}
+        const String& getTypeName(void) const
+        {
+            static const String name = "FrameSceneManager";
+            return name;
+        }
+        using SceneManager::findLightsAffectingFrustum;
+    };
+
+    /// Without a render system no technique is supported, so hand out one of our own
+    class TechniqueOverride : public RenderQueue::RenderableListener
+    {
+        Technique* mTechnique;
+    public:
+        TechniqueOverride(Technique* tech) : mTechnique(tech) {}
+        bool renderableQueued(Renderable* rend, uint8 groupID, ushort priority, Technique** ppTech,
+                              RenderQueue* pQueue)
+        {
+            *ppTech = mTechnique;
+            return true;
+        }
+    };
+
+    struct CountingVisitor : public QueuedRenderableVisitor
+    {
+        size_t count;
+        CountingVisitor() : count(0) {}
+        void visit(RenderablePass* rp) { ++count; }
+        void visit(const Pass* p, RenderableList& rs) { count += rs.size(); }
+    };
+}
+
+TEST(FrameMemory, ReusesMemoryAfterReset)
+{
+    FrameMemory memory(4096);
+
+    void* first = memory.allocate(100, 16);
+    EXPECT_EQ(size_t(first) % 16, 0u);
+
+    // the last allocation is given back right away
+    void* second = memory.allocate(256, 64);
+    EXPECT_EQ(size_t(second) % 64, 0u);
+    memory.deallocate(second, 256);
+    EXPECT_EQ(memory.allocate(256, 64), second);
+
+    // overflow into more chunks
+    for (int i = 0; i < 100; ++i)
+        memory.allocate(1000, 8);
+    size_t used = memory.getUsedSize();
+    EXPECT_GE(used, 100000u);
+
+    // afterwards, the same frame fits into one chunk
+    memory.reset();
+    EXPECT_EQ(memory.getUsedSize(), 0u);
+    EXPECT_EQ(memory.getPeakSize(), used);
+    size_t capacity = memory.getCapacity();
+    EXPECT_GE(capacity, used);
+    // the merged chunk lives wherever the heap put it
+    void* merged = memory.allocate(100, 16);
+    for (int i = 0; i < 100; ++i)
+        memory.allocate(1000, 8);
+    memory.reset();
+    EXPECT_EQ(memory.getCapacity(), capacity);
+    EXPECT_EQ(memory.allocate(100, 16), merged);
+}
+
+TEST_F(RootWithoutRenderSystemFixture, FrameVectorUsesFrameMemory)
+{
+    FrameMemory& memory = FrameMemory::getSingleton();
+    size_t used = memory.getUsedSize();
+
+    frame_vector<int> values;
+    for (int i = 0; i < 1000; ++i)
+        values.push_back(i);
+    EXPECT_GE(memory.getUsedSize(), used + 1000 * sizeof(int));
+    EXPECT_EQ(values[999], 999);
+
+    mRoot->_fireFrameEnded();
+    EXPECT_EQ(memory.getUsedSize(), 0u);
+}
+
+TEST_F(RootWithoutRenderSystemFixture, RenderLoopDoesNotAllocate)
+{
+    FrameSceneManager sceneMgr;
+    Camera* camera = sceneMgr.createCamera("Camera");
+    sceneMgr.getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 500))->attachObject(camera);
+
+    SceneManager::Listener listener;
+    sceneMgr.addListener(&listener);
+
+    std::vector<Entity*> entities;
+    for (int i = 0; i < 20; ++i)
+    {
+        Entity* ent = sceneMgr.createEntity("sphere.mesh");
+        sceneMgr.getRootSceneNode()->createChildSceneNode(Vector3(Real(i * 20 - 200), 0, 0))->attachObject(ent);
+        entities.push_back(ent);
+    }
+
+    // many lights, so the light search needs more than its local storage
+    std::vector<SceneNode*> lightNodes;
+    for (int i = 0; i < 1100; ++i)
+    {
+        Light* light = sceneMgr.createLight();
+        light->setAttenuation(1000, 1, 0, 0);
+        lightNodes.push_back(sceneMgr.getRootSceneNode()->createChildSceneNode());
+        lightNodes.back()->attachObject(light);
+    }
+
+    MaterialPtr mat = MaterialManager::getSingleton().create("FrameAllocatorTests", RGN_DEFAULT);
+    TechniqueOverride techOverride(mat->getTechnique(0));
+    sceneMgr.getRenderQueue()->setRenderableListener(&techOverride);
+
+    VisibleObjectsBoundsInfo bounds;
+    CountingVisitor visitor;
+    for (int frame = 0; frame < 60; ++frame)
+    {
+        // moving lights update the light lists of all objects every frame, moving
+        // nodes is up to the application and allocates in the scene graph though
+        for (size_t i = 0; i < lightNodes.size(); ++i)
+            lightNodes[i]->setPosition(Real(i % 100) * 5 - 250, Real(frame), Real(i / 100) * 5);
+
+        // once the frame memory and the caches have seen a frame, nothing is allocated
+        gNumAllocations = 0;
+        gCountAllocations = frame >= 10;
+
+        mRoot->_fireFrameStarted();
+
+        sceneMgr._updateSceneGraph(camera);
+        sceneMgr.findLightsAffectingFrustum(camera);
+        // RenderQueue::clear only covers the registered scene managers
+        const RenderQueue::RenderQueueGroupMap& groups = sceneMgr.getRenderQueue()->_getQueueGroups();
+        for (size_t i = 0; i < RENDER_QUEUE_MAX; ++i)
+        {
+            if (groups[i])
+                groups[i]->clear();
+        }
+        bounds.reset();
+        sceneMgr._findVisibleObjects(camera, &bounds, false);
+
+        for (size_t i = 0; i < entities.size(); ++i)
+            entities[i]->queryLights();
+
+        visitor.count = 0;
+        for (size_t i = 0; i < RENDER_QUEUE_MAX; ++i)
+        {
+            if (!groups[i])
+                continue;
+            RenderQueueGroup::PriorityMapIterator it = groups[i]->getIterator();
+            while (it.hasMoreElements())
+            {
+                RenderPriorityGroup* group = it.getNext();
+                group->sort(camera);
+                group->getSolidsBasic().acceptVisitor(&visitor, QueuedRenderableCollection::OM_PASS_GROUP);
+            }
+        }
+
+        mRoot->_fireFrameEnded();
+
+        gCountAllocations = false;
+        EXPECT_EQ(gNumAllocations, 0u) << "frame " << frame;
+        EXPECT_EQ(visitor.count, entities.size());
+    }
+
+    sceneMgr.getRenderQueue()->setRenderableListener(NULL);
+    sceneMgr.removeListener(&listener);
+}
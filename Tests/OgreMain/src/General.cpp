@@ -217,6 +217,31 @@ TEST(Image, FlipV)
     STBIImageCodec::shutdown();
 }
 
+// the codec logs when it is registered
+typedef RootWithoutRenderSystemFixture ImageCodecTests;
+TEST_F(ImageCodecTests, EncodeDecode)
+{
+    STBIImageCodec::startup();
+
+    uchar pixels[4 * 3 * 2];
+    for (size_t i = 0; i < sizeof(pixels); ++i)
+        pixels[i] = uchar(i * 10);
+
+    Image img;
+    img.loadDynamicImage(pixels, 3, 2, PF_BYTE_RGBA);
+    DataStreamPtr encoded = img.encode("png");
+
+    // the codec buffers are released by the streams
+    Image decoded;
+    decoded.load(encoded, "png");
+    ASSERT_EQ(decoded.getWidth(), 3u);
+    ASSERT_EQ(decoded.getHeight(), 2u);
+    ASSERT_EQ(decoded.getFormat(), PF_BYTE_RGBA);
+    EXPECT_TRUE(!memcmp(decoded.getData(), pixels, sizeof(pixels)));
+
+    STBIImageCodec::shutdown();
+}
+
 struct TestResourceLoadingListener : public ResourceLoadingListener
 {
     DataStreamPtr resourceLoading(const String &name, const String &group, Resource *resource) { return DataStreamPtr(); }
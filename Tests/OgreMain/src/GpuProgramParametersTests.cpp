@@ -0,0 +1,262 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Ogre.h"
+#include "OgreAutoParamDataSource.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+namespace
+{
+    class DummyRenderable : public Renderable
+    {
+        MaterialPtr mMaterial;
+        Affine3 mTransform;
+        LightList mLights;
+    public:
+        DummyRenderable(const MaterialPtr& mat, const Vector3& pos) : mMaterial(mat)
+        {
+            mTransform.makeTransform(pos, Vector3::UNIT_SCALE, Quaternion::IDENTITY);
+        }
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+        void getRenderOperation(RenderOperation& op) {}
+        void getWorldTransforms(Matrix4* xform) const { *xform = mTransform; }
+        Real getSquaredViewDepth(const Camera* cam) const { return 0; }
+        const LightList& getLights(void) const { return mLights; }
+    };
+
+    bool needsRenderSystem(GpuProgramParameters::AutoConstantType type)
+    {
+        // need a render target, viewport, textures, shadow cameras, custom parameters or frame timing
+        switch (type)
+        {
+        case GpuProgramParameters::ACT_RENDER_TARGET_FLIPPING:
+        case GpuProgramParameters::ACT_VERTEX_WINDING:
+        case GpuProgramParameters::ACT_FPS:
+        case GpuProgramParameters::ACT_VIEWPORT_WIDTH:
+        case GpuProgramParameters::ACT_VIEWPORT_HEIGHT:
+        case GpuProgramParameters::ACT_INVERSE_VIEWPORT_WIDTH:
+        case GpuProgramParameters::ACT_INVERSE_VIEWPORT_HEIGHT:
+        case GpuProgramParameters::ACT_VIEWPORT_SIZE:
+        case GpuProgramParameters::ACT_TEXEL_OFFSETS:
+        case GpuProgramParameters::ACT_TEXTURE_SIZE:
+        case GpuProgramParameters::ACT_INVERSE_TEXTURE_SIZE:
+        case GpuProgramParameters::ACT_PACKED_TEXTURE_SIZE:
+        case GpuProgramParameters::ACT_TEXTURE_MATRIX:
+        case GpuProgramParameters::ACT_TEXTURE_VIEWPROJ_MATRIX:
+        case GpuProgramParameters::ACT_TEXTURE_VIEWPROJ_MATRIX_ARRAY:
+        case GpuProgramParameters::ACT_TEXTURE_WORLDVIEWPROJ_MATRIX:
+        case GpuProgramParameters::ACT_TEXTURE_WORLDVIEWPROJ_MATRIX_ARRAY:
+        case GpuProgramParameters::ACT_SCENE_DEPTH_RANGE:
+        case GpuProgramParameters::ACT_SHADOW_SCENE_DEPTH_RANGE:
+        case GpuProgramParameters::ACT_SHADOW_SCENE_DEPTH_RANGE_ARRAY:
+        case GpuProgramParameters::ACT_CUSTOM:
+        case GpuProgramParameters::ACT_ANIMATION_PARAMETRIC:
+        case GpuProgramParameters::ACT_LIGHT_CUSTOM:
+        case GpuProgramParameters::ACT_TIME:
+        case GpuProgramParameters::ACT_TIME_0_X:
+        case GpuProgramParameters::ACT_COSTIME_0_X:
+        case GpuProgramParameters::ACT_SINTIME_0_X:
+        case GpuProgramParameters::ACT_TANTIME_0_X:
+        case GpuProgramParameters::ACT_TIME_0_X_PACKED:
+        case GpuProgramParameters::ACT_TIME_0_1:
+        case GpuProgramParameters::ACT_COSTIME_0_1:
+        case GpuProgramParameters::ACT_SINTIME_0_1:
+        case GpuProgramParameters::ACT_TANTIME_0_1:
+        case GpuProgramParameters::ACT_TIME_0_1_PACKED:
+        case GpuProgramParameters::ACT_TIME_0_2PI:
+        case GpuProgramParameters::ACT_COSTIME_0_2PI:
+        case GpuProgramParameters::ACT_SINTIME_0_2PI:
+        case GpuProgramParameters::ACT_TANTIME_0_2PI:
+        case GpuProgramParameters::ACT_TIME_0_2PI_PACKED:
+        case GpuProgramParameters::ACT_FRAME_TIME:
+            return true;
+        default:
+            return false;
+        }
+    }
+}
+
+struct GpuProgramParametersTests : public RootWithoutRenderSystemFixture
+{
+    SceneManager* mSceneMgr;
+    Camera* mCamera;
+    MaterialPtr mMaterial;
+    LightList mLights;
+    GpuProgramParametersSharedPtr mParams;
+
+    void SetUp()
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+
+        mSceneMgr = mRoot->createSceneManager();
+        mCamera = mSceneMgr->createCamera("Camera");
+        mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 100))->attachObject(mCamera);
+
+        // spotlights, so all light autos are well defined
+        for (int i = 0; i < 2; ++i)
+        {
+            Light* light = mSceneMgr->createLight();
+            light->setType(Light::LT_SPOTLIGHT);
+            SceneNode* node = mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(50, 50, Real(50 * i)));
+            node->setDirection(Vector3::NEGATIVE_UNIT_Y);
+            node->attachObject(light);
+            mLights.push_back(light);
+        }
+
+        mMaterial = MaterialManager::getSingleton().create("GpuProgramParametersTests", RGN_DEFAULT);
+
+        mParams.reset(OGRE_NEW GpuProgramParameters());
+        mParams->_setLogicalIndexes(GpuLogicalBufferStructPtr(OGRE_NEW GpuLogicalBufferStruct()),
+                                    GpuLogicalBufferStructPtr(OGRE_NEW GpuLogicalBufferStruct()),
+                                    GpuLogicalBufferStructPtr(OGRE_NEW GpuLogicalBufferStruct()));
+    }
+
+    void TearDown()
+    {
+        mParams.reset();
+        mMaterial.reset();
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+
+    void setAutoConstant(GpuProgramParameters::AutoConstantType type, size_t extraInfo = 0)
+    {
+        // one logical register per four floats, append behind the existing ones
+        size_t index = mParams->getFloatConstantList().size() / 4;
+        mParams->setAutoConstant(index, type, extraInfo);
+    }
+
+    void setupSource(AutoParamDataSource& source)
+    {
+        source.setCurrentSceneManager(mSceneMgr);
+        source.setCurrentCamera(mCamera, false);
+        source.setCurrentPass(mMaterial->getTechnique(0)->getPass(0));
+        source.setCurrentLightList(&mLights);
+        source.setFog(FOG_LINEAR, ColourValue::White, 0, 10, 100);
+        source.setPointParameters(1, false, 1, 0, 0);
+    }
+};
+
+TEST_F(GpuProgramParametersTests, UpdateAutoParamsSkipsUnchanged)
+{
+    setAutoConstant(GpuProgramParameters::ACT_VIEWPROJ_MATRIX);
+    setAutoConstant(GpuProgramParameters::ACT_WORLD_MATRIX);
+
+    DummyRenderable rend0(mMaterial, Vector3(1, 2, 3));
+    DummyRenderable rend1(mMaterial, Vector3(4, 5, 6));
+
+    AutoParamDataSource source;
+    setupSource(source);
+    source.setCurrentRenderable(&rend0);
+    mParams->_updateAutoParams(&source, GPV_ALL);
+
+    // overwrite the view projection matrix, it is not rewritten as long as the camera is unchanged
+    float* viewProj = mParams->getFloatPointer(mParams->getAutoConstants()[0].physicalIndex);
+    float expected = *viewProj;
+    *viewProj = -1;
+
+    source.setCurrentRenderable(&rend1);
+    mParams->_updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(*viewProj, -1);
+    EXPECT_EQ(*mParams->getFloatPointer(mParams->getAutoConstants()[1].physicalIndex + 3), 4);
+
+    source.setCurrentCamera(mCamera, false);
+    mParams->_updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(*viewProj, expected);
+
+    // changing the list invalidates the cached versions
+    setAutoConstant(GpuProgramParameters::ACT_CAMERA_POSITION);
+    viewProj = mParams->getFloatPointer(mParams->getAutoConstants()[0].physicalIndex);
+    *viewProj = -1;
+    mParams->_updateAutoParams(&source, GPV_ALL);
+    EXPECT_EQ(*viewProj, expected);
+}
+
+TEST_F(GpuProgramParametersTests, UpdateAutoParamsBenchmark)
+{
+    // all autos that can be evaluated without a render system
+    for (size_t i = 0; i < GpuProgramParameters::getNumAutoConstantDefinitions(); ++i)
+    {
+        const GpuProgramParameters::AutoConstantDefinition* def =
+            GpuProgramParameters::getAutoConstantDefinition(i);
+        if (needsRenderSystem(def->acType))
+            continue;
+
+        if (def->dataType == GpuProgramParameters::ACDT_REAL)
+        {
+            size_t index = mParams->getFloatConstantList().size() / 4;
+            mParams->setAutoConstantReal(index, def->acType, 1);
+        }
+        else
+        {
+            // light and array indices, arrays of a single element
+            setAutoConstant(def->acType, def->dataType == GpuProgramParameters::ACDT_INT ? 1 : 0);
+        }
+    }
+
+    const size_t numRenderables = 64;
+    const size_t numFrames = 100;
+    std::vector<DummyRenderable> renderables;
+    for (size_t i = 0; i < numRenderables; ++i)
+        renderables.push_back(DummyRenderable(mMaterial, Vector3(Real(i), 0, 0)));
+
+    GpuProgramParameters reference(*mParams);
+    AutoParamDataSource source;
+    setupSource(source);
+
+    Timer timer;
+    uint64 fullTime = 0, incrementalTime = 0;
+    for (size_t frame = 0; frame < numFrames; ++frame)
+    {
+        // as before, every value is recomputed for every renderable
+        uint64 start = timer.getMicroseconds();
+        for (size_t i = 0; i < numRenderables; ++i)
+        {
+            setupSource(source);
+            source.setCurrentRenderable(&renderables[i]);
+            reference._updateAutoParams(&source, GPV_ALL);
+        }
+        fullTime += timer.getMicroseconds() - start;
+
+        // camera, pass and lights shared by all renderables
+        start = timer.getMicroseconds();
+        setupSource(source);
+        for (size_t i = 0; i < numRenderables; ++i)
+        {
+            source.setCurrentRenderable(&renderables[i]);
+            mParams->_updateAutoParams(&source, GPV_ALL);
+        }
+        incrementalTime += timer.getMicroseconds() - start;
+
+        EXPECT_EQ(mParams->getFloatConstantList(), reference.getFloatConstantList());
+    }
+
+    RecordProperty("FullUpdateMicroseconds", StringConverter::toString(fullTime));
+    RecordProperty("IncrementalUpdateMicroseconds", StringConverter::toString(incrementalTime));
+}
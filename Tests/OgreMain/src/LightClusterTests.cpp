@@ -0,0 +1,150 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "RootWithoutRenderSystemFixture.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreSceneNode.h"
+#include "OgreCamera.h"
+#include "OgreLight.h"
+
+#include <random>
+
+using namespace Ogre;
+
+namespace
+{
+    /// Lets the test drive the steps _renderScene takes before populating light lists
+    class LightClusterSceneManager : public SceneManager
+    {
+    public:
+        LightClusterSceneManager() : SceneManager("LightClusterTest") {}
+        const String& getTypeName(void) const { return BLANKSTRING; }
+
+        using SceneManager::findLightsAffectingFrustum;
+        using SceneManager::buildLightClusters;
+    };
+
+    /// The light list _populateLightList computed by testing every light
+    LightList bruteForceLightList(const LightList& candidates, const Vector3& position, Real radius,
+                                  uint32 lightMask)
+    {
+        LightList result;
+        for (LightList::const_iterator it = candidates.begin(); it != candidates.end(); ++it)
+        {
+            Light* lt = *it;
+            if (!(lt->getLightMask() & lightMask))
+                continue;
+            if (lt->getType() == Light::LT_DIRECTIONAL || lt->isInLightRange(Sphere(position, radius)))
+            {
+                lt->_calcTempSquareDist(position);
+                result.push_back(lt);
+            }
+        }
+        std::stable_sort(result.begin(), result.end(), [](const Light* a, const Light* b) {
+            return a->tempSquareDist < b->tempSquareDist;
+        });
+        return result;
+    }
+
+    struct LightClusterTest : public RootWithoutRenderSystemFixture
+    {
+        LightClusterSceneManager* mSceneMgr;
+
+        void SetUp()
+        {
+            RootWithoutRenderSystemFixture::SetUp();
+            mSceneMgr = OGRE_NEW LightClusterSceneManager();
+        }
+        void TearDown()
+        {
+            OGRE_DELETE mSceneMgr;
+            RootWithoutRenderSystemFixture::TearDown();
+        }
+    };
+}
+//--------------------------------------------------------------------------
+TEST_F(LightClusterTest, MatchesBruteForce)
+{
+    std::minstd_rand rng(42);
+    std::uniform_real_distribution<Real> coord(-500, 500);
+    std::uniform_real_distribution<Real> range(1, 100);
+
+    for (int i = 0; i < 300; ++i)
+    {
+        Light* light = mSceneMgr->createLight();
+        light->setType(i % 10 == 0 ? Light::LT_SPOTLIGHT : Light::LT_POINT);
+        light->setAttenuation(range(rng), 1, 0, 0);
+        light->setLightMask(i % 3 ? 1 : 2);
+        mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(coord(rng), coord(rng), coord(rng)))
+            ->attachObject(light);
+    }
+
+    // lights affecting every position
+    mSceneMgr->getRootSceneNode()->attachObject(mSceneMgr->createLight());
+    Light* huge = mSceneMgr->createLight();
+    huge->setAttenuation(1e8, 1, 0, 0);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, -100))->attachObject(huge);
+    Light* infinite = mSceneMgr->createLight();
+    infinite->setAttenuation(std::numeric_limits<Real>::infinity(), 1, 0, 0);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(100, 0, -100))->attachObject(infinite);
+
+    // looking at the lights from outside, so most of them are candidates
+    Camera* camera = mSceneMgr->createCamera("camera");
+    camera->setFOVy(Degree(90));
+    camera->setFarClipDistance(2000);
+    mSceneMgr->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, 800))->attachObject(camera);
+    mSceneMgr->getRootSceneNode()->_update(true, false);
+
+    mSceneMgr->findLightsAffectingFrustum(camera);
+    LightList candidates = mSceneMgr->_getLightsAffectingFrustum();
+    ASSERT_GT(candidates.size(), 50u);
+
+    const Real radii[] = {0, 1, 10, 50, 200, 1e30f, std::numeric_limits<Real>::infinity()};
+    for (int clustered = 0; clustered < 2; ++clustered)
+    {
+        // the first round tests every light, as the clusters are not built yet
+        if (clustered)
+            mSceneMgr->buildLightClusters();
+
+        for (int i = 0; i < 200; ++i)
+        {
+            Vector3 position(coord(rng) * 1.2f, coord(rng) * 1.2f, coord(rng) * 1.2f);
+            Real radius = radii[i % (sizeof(radii) / sizeof(radii[0]))];
+            uint32 lightMask = i % 4 ? 0xFFFFFFFF : 2;
+
+            LightList lights;
+            mSceneMgr->_populateLightList(position, radius, lights, lightMask);
+            LightList expected = bruteForceLightList(candidates, position, radius, lightMask);
+            ASSERT_EQ(lights.size(), expected.size()) << "at " << position << " radius " << radius;
+            for (size_t l = 0; l < lights.size(); ++l)
+                EXPECT_EQ(lights[l], expected[l]);
+        }
+    }
+}
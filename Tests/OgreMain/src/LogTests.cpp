@@ -0,0 +1,160 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <gtest/gtest.h>
+#include "OgreLog.h"
+#include "OgreStringConverter.h"
+#include "OgreAtomicScalar.h"
+
+#include <fstream>
+#include <thread>
+
+using namespace Ogre;
+
+namespace
+{
+    struct CountingListener : public LogListener
+    {
+        AtomicScalar<size_t> numMessages;
+
+        CountingListener() : numMessages(0) {}
+
+        void messageLogged(const String& message, LogMessageLevel lml, bool maskDebug,
+                           const String& logName, bool& skipThisMessage)
+        {
+            ++numMessages;
+            skipThisMessage = message.find("skip") != String::npos;
+        }
+    };
+
+    std::vector<String> readLines(const String& fileName)
+    {
+        std::vector<String> lines;
+        std::ifstream file(fileName.c_str());
+        String line;
+        while (std::getline(file, line))
+            lines.push_back(line);
+        return lines;
+    }
+}
+
+#if OGRE_THREAD_SUPPORT
+TEST(Log, AsynchronousKeepsAllMessages)
+{
+    const String fileName = "LogTests_async.log";
+    const size_t numThreads = 4;
+    const size_t numMessages = 1000;
+    {
+        Log log(fileName, false);
+        log.setTimeStampEnabled(false);
+        log.setAsynchronous(true);
+
+        CountingListener listener;
+        log.addListener(&listener);
+
+        std::vector<std::thread> threads;
+        for (size_t t = 0; t < numThreads; ++t)
+        {
+            threads.push_back(std::thread([&log, t, numMessages]() {
+                for (size_t i = 0; i < numMessages; ++i)
+                    log.logMessage(StringConverter::toString(t) + " " + StringConverter::toString(i));
+                log.logMessage("skip me");
+            }));
+        }
+        for (size_t t = 0; t < numThreads; ++t)
+            threads[t].join();
+
+        // listeners are still called from the logging thread
+        EXPECT_EQ(listener.numMessages, numThreads * (numMessages + 1));
+        log.removeListener(&listener);
+
+        // flushed when the call returns
+        log.logMessage("critical", LML_CRITICAL);
+        std::vector<String> lines = readLines(fileName);
+        ASSERT_EQ(lines.size(), numThreads * numMessages + 1);
+        EXPECT_EQ(lines.back(), "critical");
+
+        // every thread's messages are written in the order they were logged
+        std::vector<size_t> next(numThreads, 0);
+        for (size_t i = 0; i + 1 < lines.size(); ++i)
+        {
+            size_t t = StringConverter::parseUnsignedLong(lines[i].substr(0, lines[i].find(' ')));
+            ASSERT_LT(t, numThreads);
+            EXPECT_EQ(lines[i], StringConverter::toString(t) + " " + StringConverter::toString(next[t]));
+            ++next[t];
+        }
+
+        log.logMessage("normal");
+        log.flush();
+        EXPECT_EQ(readLines(fileName).back(), "normal");
+
+        log.logMessage("last");
+        log.setAsynchronous(false);
+        EXPECT_EQ(readLines(fileName).back(), "last");
+        log.logMessage("synchronous");
+    }
+    EXPECT_EQ(readLines(fileName).back(), "synchronous");
+    std::remove(fileName.c_str());
+}
+//--------------------------------------------------------------------------
+TEST(Log, AsynchronousManyLogsPerThread)
+{
+    // more logs than a thread caches rings for
+    const size_t numLogs = 6;
+    const size_t numMessages = 500;
+    std::vector<String> fileNames;
+    {
+        std::vector<Log*> logs;
+        for (size_t l = 0; l < numLogs; ++l)
+        {
+            fileNames.push_back("LogTests_async" + StringConverter::toString(l) + ".log");
+            logs.push_back(OGRE_NEW Log(fileNames.back(), false));
+            logs.back()->setTimeStampEnabled(false);
+            logs.back()->setAsynchronous(true);
+        }
+
+        for (size_t i = 0; i < numMessages; ++i)
+        {
+            for (size_t l = 0; l < numLogs; ++l)
+                logs[l]->logMessage(StringConverter::toString(i));
+        }
+
+        for (size_t l = 0; l < numLogs; ++l)
+            OGRE_DELETE logs[l];
+    }
+
+    for (size_t l = 0; l < numLogs; ++l)
+    {
+        std::vector<String> lines = readLines(fileNames[l]);
+        ASSERT_EQ(lines.size(), numMessages);
+        for (size_t i = 0; i < numMessages; ++i)
+            EXPECT_EQ(lines[i], StringConverter::toString(i));
+        std::remove(fileNames[l].c_str());
+    }
+}
+#endif
@@ -0,0 +1,116 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <gtest/gtest.h>
+#include "OgrePrerequisites.h"
+
+#include <thread>
+
+using namespace Ogre;
+
+TEST(MemoryTracker, CountsPerCategoryAndThread)
+{
+    const MemoryTracker::Stats before = MemoryTracker::getCategoryStats(MEMCATEGORY_SCRIPTING);
+    const MemoryTracker::Stats geometryBefore = MemoryTracker::getCategoryStats(MEMCATEGORY_GEOMETRY);
+
+    void* a = MemoryTracker::allocate(1000, MEMCATEGORY_SCRIPTING);
+    void* b = MemoryTracker::allocateAligned(3000, MEMCATEGORY_SCRIPTING);
+    EXPECT_EQ(reinterpret_cast<size_t>(a) % 16, 0u);
+    EXPECT_EQ(reinterpret_cast<size_t>(b) % OGRE_SIMD_ALIGNMENT, 0u);
+    memset(a, 1, 1000);
+    memset(b, 2, 3000);
+
+    MemoryTracker::Stats stats = MemoryTracker::getCategoryStats(MEMCATEGORY_SCRIPTING);
+    EXPECT_EQ(stats.liveBytes, before.liveBytes + 4000);
+    EXPECT_GE(stats.peakBytes, stats.liveBytes);
+    EXPECT_EQ(stats.numAllocations, before.numAllocations + 2);
+
+    MemoryTracker::deallocate(a);
+    MemoryTracker::deallocateAligned(b);
+    MemoryTracker::deallocate(NULL);
+    stats = MemoryTracker::getCategoryStats(MEMCATEGORY_SCRIPTING);
+    EXPECT_EQ(stats.liveBytes, before.liveBytes);
+    EXPECT_GE(stats.peakBytes, before.liveBytes + 4000);
+    EXPECT_EQ(stats.numFrees, before.numFrees + 2);
+    EXPECT_EQ(MemoryTracker::getCategoryStats(MEMCATEGORY_GEOMETRY).numAllocations,
+              geometryBefore.numAllocations);
+
+    // allocated by one thread, freed by another
+    void* shared = 0;
+    std::thread([&shared]() { shared = MemoryTracker::allocate(500, MEMCATEGORY_SCRIPTING); }).join();
+    MemoryTracker::ThreadStatsList threads;
+    MemoryTracker::getThreadStats(threads);
+    ASSERT_GE(threads.size(), 2u);
+    EXPECT_EQ(threads.back().categories[MEMCATEGORY_SCRIPTING].liveBytes, 500);
+    EXPECT_EQ(threads.back().categories[MEMCATEGORY_SCRIPTING].numAllocations, 1u);
+
+    MemoryTracker::deallocate(shared);
+    EXPECT_EQ(MemoryTracker::getCategoryStats(MEMCATEGORY_SCRIPTING).liveBytes, before.liveBytes);
+
+    MemoryTracker::resetPeaks();
+    stats = MemoryTracker::getCategoryStats(MEMCATEGORY_SCRIPTING);
+    EXPECT_EQ(stats.peakBytes, stats.liveBytes);
+
+    EXPECT_STREQ(MemoryTracker::getCategoryName(MEMCATEGORY_RENDERSYS), "RenderSystem");
+}
+
+#if OGRE_MEMORY_TRACKER
+namespace
+{
+    struct TrackedObject : public ScriptingAllocatedObject
+    {
+        char data[100];
+    };
+}
+
+TEST(MemoryTracker, CountsAllocationMacros)
+{
+    const MemoryTracker::Stats before = MemoryTracker::getCategoryStats(MEMCATEGORY_SCRIPTING);
+
+    void* raw = OGRE_MALLOC(100, MEMCATEGORY_SCRIPTING);
+    float* simd = static_cast<float*>(OGRE_MALLOC_SIMD(64, MEMCATEGORY_SCRIPTING));
+    uint32* values = OGRE_NEW_ARRAY_T(uint32, 10, MEMCATEGORY_SCRIPTING);
+    String* str = OGRE_NEW_T(String, MEMCATEGORY_SCRIPTING)("tracked");
+    TrackedObject* object = OGRE_NEW TrackedObject();
+
+    MemoryTracker::Stats stats = MemoryTracker::getCategoryStats(MEMCATEGORY_SCRIPTING);
+    EXPECT_EQ(stats.numAllocations, before.numAllocations + 5);
+    EXPECT_EQ(stats.liveBytes,
+              before.liveBytes + int64(100 + 64 + 40 + sizeof(String) + sizeof(TrackedObject)));
+
+    OGRE_FREE(raw, MEMCATEGORY_SCRIPTING);
+    OGRE_FREE_SIMD(simd, MEMCATEGORY_SCRIPTING);
+    OGRE_DELETE_ARRAY_T(values, uint32, 10, MEMCATEGORY_SCRIPTING);
+    OGRE_DELETE_T(str, String, MEMCATEGORY_SCRIPTING);
+    OGRE_DELETE object;
+
+    stats = MemoryTracker::getCategoryStats(MEMCATEGORY_SCRIPTING);
+    EXPECT_EQ(stats.liveBytes, before.liveBytes);
+    EXPECT_EQ(stats.numFrees, before.numFrees + 5);
+}
+#endif
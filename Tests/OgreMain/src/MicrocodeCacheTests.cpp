@@ -0,0 +1,129 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreGpuProgramManager.h"
+
+#include <cstdio>
+
+using namespace Ogre;
+
+namespace
+{
+    /// Only used for its microcode cache, no programs are created
+    class CacheOnlyGpuProgramManager : public GpuProgramManager
+    {
+    protected:
+        Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+                             bool isManual, ManualResourceLoader* loader,
+                             const NameValuePairList* params)
+        {
+            return 0;
+        }
+        Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+                             bool isManual, ManualResourceLoader* loader, GpuProgramType gptype,
+                             const String& syntaxCode)
+        {
+            return 0;
+        }
+    };
+
+    struct MicrocodeCacheTest : public ::testing::Test
+    {
+        Root* mRoot;
+        String mPath;
+
+        void SetUp()
+        {
+            mRoot = OGRE_NEW Root(BLANKSTRING);
+            mPath = "microcode_cache_test.bin";
+            std::remove(mPath.c_str());
+        }
+        void TearDown()
+        {
+            std::remove(mPath.c_str());
+            OGRE_DELETE mRoot;
+        }
+    };
+
+    GpuProgramManager::Microcode makeMicrocode(GpuProgramManager& mgr, const String& text)
+    {
+        GpuProgramManager::Microcode microcode = mgr.createMicrocode(text.size());
+        memcpy(microcode->getPtr(), text.c_str(), text.size());
+        return microcode;
+    }
+
+    String toString(const GpuProgramManager::Microcode& microcode)
+    {
+        return String((const char*)microcode->getPtr(), microcode->size());
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(MicrocodeCacheTest, SaveReloadLookup)
+{
+    {
+        CacheOnlyGpuProgramManager mgr;
+        mgr.setMicrocodeCachePath(mPath, "device 1");
+        EXPECT_FALSE(mgr.isMicrocodeAvailableInCache(1));
+        mgr.addMicrocodeToCache(1, makeMicrocode(mgr, "first program"));
+        mgr.addMicrocodeToCache(2, makeMicrocode(mgr, "second"));
+        mgr.flushMicrocodeCache();
+        EXPECT_EQ(mgr.getMicrocodeCacheMisses(), 1u);
+    }
+
+    {
+        CacheOnlyGpuProgramManager mgr;
+        mgr.setMicrocodeCachePath(mPath, "device 1");
+        EXPECT_TRUE(mgr.isMicrocodeAvailableInCache(1));
+        EXPECT_TRUE(mgr.isMicrocodeAvailableInCache(2));
+        EXPECT_FALSE(mgr.isMicrocodeAvailableInCache(3));
+        // read from the file on demand
+        EXPECT_EQ(toString(mgr.getMicrocodeFromCache(2)), "second");
+        EXPECT_EQ(toString(mgr.getMicrocodeFromCache(1)), "first program");
+        EXPECT_EQ(mgr.getMicrocodeCacheHits(), 2u);
+        EXPECT_EQ(mgr.getMicrocodeCacheMisses(), 1u);
+
+        // entries added later are merged into the file
+        mgr.addMicrocodeToCache(3, makeMicrocode(mgr, "third"));
+        mgr.flushMicrocodeCache();
+    }
+
+    {
+        CacheOnlyGpuProgramManager mgr;
+        mgr.setMicrocodeCachePath(mPath, "device 1");
+        EXPECT_EQ(toString(mgr.getMicrocodeFromCache(3)), "third");
+        EXPECT_EQ(toString(mgr.getMicrocodeFromCache(1)), "first program");
+    }
+
+    // a cache written for another device is discarded
+    CacheOnlyGpuProgramManager mgr;
+    mgr.setMicrocodeCachePath(mPath, "device 2");
+    EXPECT_FALSE(mgr.isMicrocodeAvailableInCache(1));
+    mgr.setMicrocodeCachePath(BLANKSTRING);
+}
@@ -0,0 +1,219 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <gtest/gtest.h>
+#include "OgreProfiler.h"
+#include "OgreTimer.h"
+#include "OgreStringConverter.h"
+
+#include <sstream>
+#include <thread>
+
+using namespace Ogre;
+
+namespace
+{
+    struct TraceListener : public ProfileSessionListener
+    {
+        ProfileTraceEventList events;
+        size_t numCollected;
+
+        TraceListener() : numCollected(0) {}
+
+        void initializeSession() {}
+        void finializeSession() {}
+        void traceEventsCollected(const ProfileTraceEventList& collected)
+        {
+            events.insert(events.end(), collected.begin(), collected.end());
+            ++numCollected;
+        }
+    };
+}
+
+TEST(Profiler, TracesAllThreads)
+{
+    Timer timer;
+    Profiler profiler;
+    profiler.setTimer(&timer);
+    TraceListener listener;
+    profiler.addListener(&listener);
+
+    const ProfileZone& outer = Profiler::getZone("TraceOuter");
+    const ProfileZone& inner = Profiler::getZone("TraceInner");
+    EXPECT_EQ(&Profiler::getZone("TraceOuter"), &outer);
+    EXPECT_EQ(&Profiler::getZone(inner.id), &inner);
+
+    // nothing is recorded unless enabled
+    {
+        Profile profile(outer);
+    }
+    profiler.markFrame();
+    EXPECT_EQ(listener.numCollected, 0u);
+
+    profiler.setTraceEnabled(true);
+    profiler.disableProfile("TraceDisabled");
+
+    const size_t numThreads = 3;
+    const size_t numIterations = 5000;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < numThreads; ++t)
+    {
+        threads.push_back(std::thread([&]() {
+            for (size_t i = 0; i < numIterations; ++i)
+            {
+                Profile profile(outer);
+                Profile disabled("TraceDisabled");
+                profiler.beginProfile(inner);
+                profiler.endProfile(inner);
+            }
+        }));
+    }
+    for (size_t t = 0; t < numThreads; ++t)
+        threads[t].join();
+
+    profiler.markFrame();
+    ASSERT_EQ(listener.numCollected, 1u);
+    // the frame marker of the main thread and the profiles of the others
+    ASSERT_EQ(listener.events.size(), 1 + numThreads * numIterations * 4);
+
+    std::vector<std::vector<ProfileZoneId> > stacks(numThreads + 1);
+    size_t numFrames = 0;
+    for (size_t i = 0; i < listener.events.size(); ++i)
+    {
+        const ProfileTraceEvent& event = listener.events[i];
+        if (i)
+            EXPECT_LE(listener.events[i - 1].time, event.time);
+        ASSERT_LE(event.thread, numThreads);
+
+        std::vector<ProfileZoneId>& stack = stacks[event.thread];
+        if (event.type == ProfileTraceEvent::TE_FRAME)
+        {
+            ++numFrames;
+        }
+        else if (event.type == ProfileTraceEvent::TE_BEGIN)
+        {
+            EXPECT_EQ(event.zone, stack.empty() ? outer.id : inner.id);
+            stack.push_back(event.zone);
+        }
+        else
+        {
+            ASSERT_FALSE(stack.empty());
+            EXPECT_EQ(event.zone, stack.back());
+            stack.pop_back();
+        }
+    }
+    EXPECT_EQ(numFrames, 1u);
+    for (size_t t = 0; t < stacks.size(); ++t)
+        EXPECT_TRUE(stacks[t].empty());
+
+    // only new events are passed on
+    profiler.markFrame();
+    EXPECT_EQ(listener.numCollected, 2u);
+    EXPECT_EQ(listener.events.size(), 2 + numThreads * numIterations * 4);
+
+    profiler.removeListener(&listener);
+}
+
+TEST(Profiler, WritesChromeTraceEvents)
+{
+    ProfileTraceEventList events(3);
+    events[0].time = 10;
+    events[0].zone = Profiler::getZone("Trace \"quoted\"\\").id;
+    events[0].thread = 1;
+    events[0].type = ProfileTraceEvent::TE_BEGIN;
+    events[1] = events[0];
+    events[1].time = 25;
+    events[1].type = ProfileTraceEvent::TE_END;
+    events[2].time = 30;
+    events[2].zone = 0;
+    events[2].thread = 0;
+    events[2].type = ProfileTraceEvent::TE_FRAME;
+
+    std::ostringstream os;
+    ChromeTraceSessionListener::writeEvents(os, events, true);
+    EXPECT_EQ(os.str(),
+              "{\"name\":\"Trace \\\"quoted\\\"\\\\\",\"ph\":\"B\",\"ts\":10,\"pid\":0,\"tid\":1},\n"
+              "{\"name\":\"Trace \\\"quoted\\\"\\\\\",\"ph\":\"E\",\"ts\":25,\"pid\":0,\"tid\":1},\n"
+              "{\"name\":\"Frame\",\"ph\":\"i\",\"s\":\"g\",\"ts\":30,\"pid\":0,\"tid\":0}");
+}
+
+#if OGRE_PROFILING == 1
+TEST(Profiler, MacrosUseRuntimeNames)
+{
+    Timer timer;
+    Profiler profiler;
+    profiler.setTimer(&timer);
+    TraceListener listener;
+    profiler.addListener(&listener);
+    profiler.setTraceEnabled(true);
+
+    // the same call site with different names
+    for (int i = 0; i < 3; ++i)
+    {
+        OgreProfile("Runtime" + StringConverter::toString(i));
+    }
+    for (int i = 0; i < 2; ++i)
+    {
+        OgreProfileStatic("Static");
+    }
+    profiler.markFrame();
+
+    ASSERT_EQ(listener.events.size(), 11u);
+    for (int i = 0; i < 3; ++i)
+    {
+        ProfileZoneId id = Profiler::getZone("Runtime" + StringConverter::toString(i)).id;
+        EXPECT_EQ(listener.events[i * 2].zone, id);
+        EXPECT_EQ(listener.events[i * 2 + 1].zone, id);
+    }
+    for (int i = 6; i < 10; ++i)
+        EXPECT_EQ(listener.events[i].zone, Profiler::getZone("Static").id);
+
+    profiler.removeListener(&listener);
+}
+#endif
+
+TEST(Profiler, DisabledProfilesCreateNoZones)
+{
+    Timer timer;
+    Profiler profiler;
+    profiler.setTimer(&timer);
+
+    size_t zones = Profiler::getZoneCount();
+    for (int i = 0; i < 3; ++i)
+    {
+        Profile profile("Disabled" + StringConverter::toString(i));
+    }
+    EXPECT_EQ(Profiler::getZoneCount(), zones);
+
+    profiler.setTraceEnabled(true);
+    {
+        Profile profile("Disabled0");
+    }
+    EXPECT_EQ(Profiler::getZoneCount(), zones + 1);
+    profiler.markFrame();
+}
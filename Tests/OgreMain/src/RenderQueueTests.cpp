@@ -0,0 +1,147 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Ogre.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+namespace
+{
+    class DepthRenderable : public Renderable
+    {
+        MaterialPtr mMaterial;
+        LightList mLights;
+        Real mDepth;
+    public:
+        DepthRenderable(Real depth) : mDepth(depth) {}
+        const MaterialPtr& getMaterial(void) const { return mMaterial; }
+        void getRenderOperation(RenderOperation& op) {}
+        void getWorldTransforms(Matrix4* xform) const {}
+        Real getSquaredViewDepth(const Camera* cam) const { return mDepth; }
+        const LightList& getLights(void) const { return mLights; }
+    };
+
+    struct RecordingVisitor : public QueuedRenderableVisitor
+    {
+        std::vector<std::pair<const Pass*, const Renderable*> > visited;
+
+        void visit(RenderablePass* rp) { visited.push_back(std::make_pair(rp->pass, rp->renderable)); }
+        bool visit(const Pass* p) { return true; }
+        void visit(const Pass* p, RenderableList& rl)
+        {
+            for (size_t i = 0; i < rl.size(); ++i)
+                visited.push_back(std::make_pair(p, rl[i]));
+        }
+    };
+}
+
+struct RenderQueueTests : public RootWithoutRenderSystemFixture
+{
+    std::vector<Pass*> mPasses;
+    std::vector<DepthRenderable> mRenderables;
+    QueuedRenderableCollection mCollection;
+
+    void SetUp()
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+
+        // distinct passes, so they get distinct hashes
+        Technique* tech = MaterialManager::getSingleton().create("RenderQueueTests", RGN_DEFAULT)->getTechnique(0);
+        mPasses.push_back(tech->getPass(0));
+        for (int i = 0; i < 4; ++i)
+            mPasses.push_back(tech->createPass());
+        for (size_t i = 0; i < mPasses.size(); ++i)
+            mPasses[i]->setDepthBias(float(i));
+        Pass::processPendingPassUpdates();
+
+        // negative and duplicate depths included
+        srand(1);
+        for (int i = 0; i < 500; ++i)
+            mRenderables.push_back(DepthRenderable(Real(rand() % 200 - 50) * Real(0.37)));
+
+        mCollection.addOrganisationMode(QueuedRenderableCollection::OM_PASS_GROUP);
+        mCollection.addOrganisationMode(QueuedRenderableCollection::OM_SORT_DESCENDING);
+        for (size_t i = 0; i < mRenderables.size(); ++i)
+            mCollection.addRenderable(mPasses[i % mPasses.size()], &mRenderables[i]);
+        mCollection.sort(NULL);
+    }
+
+    void TearDown()
+    {
+        mCollection.clear();
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+};
+
+TEST_F(RenderQueueTests, SortByDepth)
+{
+    RecordingVisitor descending;
+    mCollection.acceptVisitor(&descending, QueuedRenderableCollection::OM_SORT_DESCENDING);
+    ASSERT_EQ(descending.visited.size(), mRenderables.size());
+    for (size_t i = 1; i < descending.visited.size(); ++i)
+        EXPECT_GE(descending.visited[i - 1].second->getSquaredViewDepth(NULL),
+                  descending.visited[i].second->getSquaredViewDepth(NULL));
+
+    RecordingVisitor ascending;
+    mCollection.acceptVisitor(&ascending, QueuedRenderableCollection::OM_SORT_ASCENDING);
+    ASSERT_EQ(ascending.visited.size(), mRenderables.size());
+    for (size_t i = 1; i < ascending.visited.size(); ++i)
+        EXPECT_LE(ascending.visited[i - 1].second->getSquaredViewDepth(NULL),
+                  ascending.visited[i].second->getSquaredViewDepth(NULL));
+}
+
+TEST_F(RenderQueueTests, GroupByPass)
+{
+    RecordingVisitor grouped;
+    mCollection.acceptVisitor(&grouped, QueuedRenderableCollection::OM_PASS_GROUP);
+    ASSERT_EQ(grouped.visited.size(), mRenderables.size());
+
+    // every pass is visited exactly once, as a single contiguous group
+    std::set<const Pass*> seen;
+    const Pass* current = NULL;
+    for (size_t i = 0; i < grouped.visited.size(); ++i)
+    {
+        if (grouped.visited[i].first == current)
+            continue;
+        current = grouped.visited[i].first;
+        EXPECT_TRUE(seen.insert(current).second);
+    }
+    EXPECT_EQ(seen.size(), mPasses.size());
+    // the sort is stable, so the renderables of a group keep the order they were added in
+    for (size_t i = 1; i < grouped.visited.size(); ++i)
+    {
+        if (grouped.visited[i - 1].first == grouped.visited[i].first)
+            EXPECT_LT(grouped.visited[i - 1].second, grouped.visited[i].second);
+    }
+
+    mCollection.removePassGroup(mPasses[1]);
+    RecordingVisitor removed;
+    mCollection.acceptVisitor(&removed, QueuedRenderableCollection::OM_PASS_GROUP);
+    EXPECT_EQ(removed.visited.size(), mRenderables.size() - mRenderables.size() / mPasses.size());
+}
@@ -0,0 +1,137 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "RootWithoutRenderSystemFixture.h"
+#include "NullRenderSystem.h"
+#include "OgreRoot.h"
+#include "OgreSceneManager.h"
+#include "OgreMaterialManager.h"
+#include "OgreTechnique.h"
+#include "OgreTexture.h"
+
+using namespace Ogre;
+
+namespace
+{
+    /// Remembers the texture bound to each unit, everything else is ignored
+    class TextureRecordingRenderSystem : public NullRenderSystem
+    {
+    public:
+        const Texture* mBound[OGRE_MAX_TEXTURE_LAYERS];
+
+        TextureRecordingRenderSystem()
+        {
+            mRealCapabilities->setCapability(RSC_FIXED_FUNCTION);
+            for (size_t i = 0; i < OGRE_MAX_TEXTURE_LAYERS; ++i)
+                mBound[i] = NULL;
+        }
+
+        void _setTexture(size_t unit, bool enabled, const TexturePtr& texPtr)
+        {
+            mBound[unit] = enabled ? texPtr.get() : NULL;
+        }
+    };
+
+    /// Always loaded, without any internal resources
+    class EmptyTexture : public Texture, public ManualResourceLoader
+    {
+    public:
+        EmptyTexture(const String& name) : Texture(NULL, name, 0, RGN_DEFAULT, true, this) {}
+        ~EmptyTexture() { unload(); }
+
+        void loadResource(Resource* resource) {}
+
+    protected:
+        void createInternalResourcesImpl(void) {}
+        void freeInternalResourcesImpl(void) {}
+    };
+
+    struct RenderStateCacheTest : public RootWithoutRenderSystemFixture
+    {
+        TextureRecordingRenderSystem* mRenderSystem;
+        SceneManager* mSceneMgr;
+        TexturePtr mTextures[2];
+
+        void SetUp()
+        {
+            RootWithoutRenderSystemFixture::SetUp();
+            mRenderSystem = OGRE_NEW TextureRecordingRenderSystem();
+            mSceneMgr = mRoot->createSceneManager();
+            mSceneMgr->_setDestinationRenderSystem(mRenderSystem);
+
+            for (int i = 0; i < 2; ++i)
+            {
+                mTextures[i].reset(OGRE_NEW EmptyTexture("tex" + StringConverter::toString(i)));
+                mTextures[i]->load();
+            }
+        }
+        void TearDown()
+        {
+            mRoot->destroySceneManager(mSceneMgr);
+            mTextures[0].reset();
+            mTextures[1].reset();
+            OGRE_DELETE mRenderSystem;
+            RootWithoutRenderSystemFixture::TearDown();
+        }
+
+        Pass* createPass(const String& name, size_t numTextures)
+        {
+            Pass* pass = MaterialManager::getSingleton().create(name, RGN_DEFAULT)->getTechnique(0)->getPass(0);
+            pass->setLightingEnabled(false);
+            for (size_t i = 0; i < numTextures; ++i)
+                pass->createTextureUnitState()->_setTexturePtr(mTextures[i]);
+            return pass;
+        }
+    };
+}
+//--------------------------------------------------------------------------
+TEST_F(RenderStateCacheTest, DisabledTextureUnitsAreRebound)
+{
+    Pass* passA = createPass("A", 2);
+    Pass* passB = createPass("B", 1);
+
+    mSceneMgr->_setPass(passA);
+    EXPECT_EQ(mRenderSystem->mBound[0], mTextures[0].get());
+    EXPECT_EQ(mRenderSystem->mBound[1], mTextures[1].get());
+
+    mSceneMgr->_setPass(passB);
+    EXPECT_EQ(mRenderSystem->mBound[0], mTextures[0].get());
+    EXPECT_FALSE(mRenderSystem->mBound[1]);
+
+    // the second unit was disabled in between, so it is not redundant
+    mSceneMgr->_setPass(passA);
+    EXPECT_EQ(mRenderSystem->mBound[0], mTextures[0].get());
+    EXPECT_EQ(mRenderSystem->mBound[1], mTextures[1].get());
+
+    // setting the same pass again is
+    size_t binds = mSceneMgr->getRenderStateStats().textureBinds;
+    mSceneMgr->_setPass(passA);
+    EXPECT_EQ(mSceneMgr->getRenderStateStats().textureBinds, binds);
+    EXPECT_EQ(mRenderSystem->mBound[1], mTextures[1].get());
+}
@@ -0,0 +1,231 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreResourceManager.h"
+
+using namespace Ogre;
+
+namespace
+{
+    /// Takes up a fixed amount of memory while loaded
+    class SizedResource : public Resource
+    {
+    public:
+        SizedResource(ResourceManager* creator, const String& name, ResourceHandle handle,
+                      const String& group)
+            : Resource(creator, name, handle, group)
+        {
+        }
+        ~SizedResource() { unload(); }
+
+    protected:
+        void loadImpl() {}
+        void unloadImpl() {}
+        size_t calculateSize() const { return 100; }
+    };
+
+    class SizedResourceManager : public ResourceManager
+    {
+    public:
+        SizedResourceManager(const String& type)
+        {
+            mResourceType = type;
+            ResourceGroupManager::getSingleton()._registerResourceManager(mResourceType, this);
+        }
+        ~SizedResourceManager()
+        {
+            ResourceGroupManager::getSingleton()._unregisterResourceManager(mResourceType);
+        }
+
+        bool isLoaded(const String& name)
+        {
+            return getResourceByName(name, RGN_DEFAULT)->isLoaded();
+        }
+        void touch(const String& name) { getResourceByName(name, RGN_DEFAULT)->touch(); }
+
+    protected:
+        Resource* createImpl(const String& name, ResourceHandle handle, const String& group,
+                             bool isManual, ManualResourceLoader* loader,
+                             const NameValuePairList* createParams)
+        {
+            return OGRE_NEW SizedResource(this, name, handle, group);
+        }
+    };
+
+    struct ResourceManagerTest : public ::testing::Test
+    {
+        Root* mRoot;
+        SizedResourceManager* mMeshes;
+        SizedResourceManager* mTextures;
+
+        void SetUp()
+        {
+            mRoot = OGRE_NEW Root(BLANKSTRING);
+            mMeshes = OGRE_NEW SizedResourceManager("SizedMesh");
+            mTextures = OGRE_NEW SizedResourceManager("SizedTexture");
+        }
+        void TearDown()
+        {
+            OGRE_DELETE mTextures;
+            OGRE_DELETE mMeshes;
+            OGRE_DELETE mRoot;
+        }
+    };
+}
+//--------------------------------------------------------------------------
+TEST_F(ResourceManagerTest, LeastRecentlyUsedFirst)
+{
+    mMeshes->load("a", RGN_DEFAULT);
+    mMeshes->load("b", RGN_DEFAULT);
+    mMeshes->load("c", RGN_DEFAULT);
+    mMeshes->touch("a");
+    EXPECT_EQ(mMeshes->getMemoryUsage(), 300u);
+
+    mMeshes->setMemoryBudget(250);
+    EXPECT_TRUE(mMeshes->isLoaded("a"));
+    EXPECT_FALSE(mMeshes->isLoaded("b"));
+    EXPECT_TRUE(mMeshes->isLoaded("c"));
+
+    // loading past the budget again evicts the next one
+    mMeshes->load("d", RGN_DEFAULT);
+    EXPECT_TRUE(mMeshes->isLoaded("a"));
+    EXPECT_FALSE(mMeshes->isLoaded("c"));
+    EXPECT_TRUE(mMeshes->isLoaded("d"));
+    EXPECT_EQ(mMeshes->getMemoryUsage(), 200u);
+}
+//--------------------------------------------------------------------------
+TEST_F(ResourceManagerTest, PriorityAndReferences)
+{
+    mMeshes->load("a", RGN_DEFAULT);
+    mMeshes->load("b", RGN_DEFAULT)->setEvictionPriority(Resource::EVICT_PRIORITY_NEVER);
+    mMeshes->load("c", RGN_DEFAULT)->setEvictionPriority(Resource::EVICT_PRIORITY_LOW);
+    ResourcePtr held = mMeshes->load("d", RGN_DEFAULT);
+    mMeshes->load("e", RGN_DEFAULT);
+
+    // low priority goes first although it was used more recently
+    EXPECT_EQ(mMeshes->evictResources(100), 100u);
+    EXPECT_FALSE(mMeshes->isLoaded("c"));
+    EXPECT_TRUE(mMeshes->isLoaded("a"));
+
+    // referenced and never evicted resources stay
+    EXPECT_EQ(mMeshes->evictResources(1000), 200u);
+    EXPECT_TRUE(mMeshes->isLoaded("b"));
+    EXPECT_TRUE(held->isLoaded());
+
+    // released resources count as used when last seen referenced
+    mMeshes->load("a", RGN_DEFAULT);
+    mMeshes->load("f", RGN_DEFAULT);
+    EXPECT_EQ(mMeshes->evictResources(100), 100u);
+    EXPECT_FALSE(mMeshes->isLoaded("a"));
+    held.reset();
+    EXPECT_EQ(mMeshes->evictResources(100), 100u);
+    EXPECT_FALSE(mMeshes->isLoaded("f"));
+    EXPECT_TRUE(mMeshes->isLoaded("d"));
+}
+//--------------------------------------------------------------------------
+TEST_F(ResourceManagerTest, SharedBudget)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    size_t base = rgm.getMemoryUsage();
+
+    mMeshes->load("a", RGN_DEFAULT);
+    mTextures->load("a", RGN_DEFAULT);
+    mMeshes->load("b", RGN_DEFAULT);
+    mTextures->touch("a");
+    EXPECT_EQ(rgm.getMemoryUsage(), base + 300);
+
+    rgm.setMemoryBudget(base + 250);
+    EXPECT_FALSE(mMeshes->isLoaded("a"));
+    EXPECT_TRUE(mMeshes->isLoaded("b"));
+    EXPECT_TRUE(mTextures->isLoaded("a"));
+
+    mTextures->load("b", RGN_DEFAULT);
+    EXPECT_FALSE(mMeshes->isLoaded("b"));
+    EXPECT_TRUE(mTextures->isLoaded("a"));
+    EXPECT_TRUE(mTextures->isLoaded("b"));
+
+    rgm.setMemoryBudget(std::numeric_limits<size_t>::max());
+    EXPECT_EQ(rgm.evictResources(1000), 200u);
+    EXPECT_EQ(rgm.getMemoryUsage(), base);
+}
+//--------------------------------------------------------------------------
+TEST_F(ResourceManagerTest, GetResourceByName)
+{
+    ResourceGroupManager::getSingleton().createResourceGroup("Level", false);
+    ResourcePtr general = mMeshes->createResource("a", RGN_DEFAULT);
+    ResourcePtr level = mMeshes->createResource("a", "Level");
+    ResourcePtr levelOnly = mMeshes->createResource("b", "Level");
+
+    EXPECT_EQ(mMeshes->getResourceByName("a", RGN_DEFAULT), general);
+    EXPECT_EQ(mMeshes->getResourceByName("a", "Level"), level);
+    // the global pool is preferred, other groups are found as well
+    EXPECT_EQ(mMeshes->getResourceByName("a", RGN_AUTODETECT), general);
+    EXPECT_EQ(mMeshes->getResourceByName("b", RGN_AUTODETECT), levelOnly);
+    EXPECT_FALSE(mMeshes->getResourceByName("b", RGN_DEFAULT));
+    EXPECT_FALSE(mMeshes->getResourceByName("c", RGN_AUTODETECT));
+    EXPECT_EQ(general->getNameHash(), ResourceManager::hashName("a"));
+
+    mMeshes->remove(general);
+    EXPECT_EQ(mMeshes->getResourceByName("a", RGN_AUTODETECT), level);
+    EXPECT_FALSE(mMeshes->getResourceByName("a", RGN_DEFAULT));
+
+    ResourceGroupManager::getSingleton().destroyResourceGroup("Level");
+    EXPECT_FALSE(mMeshes->getResourceByName("b", RGN_AUTODETECT));
+}
+//--------------------------------------------------------------------------
+TEST_F(ResourceManagerTest, GetResourceByNameFromSeveralGroups)
+{
+    ResourceGroupManager& rgm = ResourceGroupManager::getSingleton();
+    rgm.createResourceGroup("LevelA", false);
+    rgm.createResourceGroup("LevelB", false);
+    rgm.createResourceGroup("LevelC", false);
+    // created in reverse group order, so neither the group name nor the index order decides
+    ResourcePtr first = mMeshes->createResource("a", "LevelB");
+    ResourcePtr second = mMeshes->createResource("a", "LevelA");
+    ResourcePtr third = mMeshes->createResource("a", "LevelC");
+
+    EXPECT_EQ(mMeshes->getResourceByName("a", "LevelA"), second);
+    EXPECT_EQ(mMeshes->getResourceByName("a", "LevelB"), first);
+    EXPECT_FALSE(mMeshes->getResourceByName("a", RGN_DEFAULT));
+    // the first one created wins
+    EXPECT_EQ(mMeshes->getResourceByName("a", RGN_AUTODETECT), first);
+
+    uint32 hash = ResourceManager::hashName("a");
+    EXPECT_EQ(mMeshes->getResourceByName(hash, "a", RGN_AUTODETECT), first);
+    EXPECT_EQ(mMeshes->getResourceByName(hash, "a", "LevelA"), second);
+
+    mMeshes->remove(first);
+    EXPECT_EQ(mMeshes->getResourceByName(hash, "a", RGN_AUTODETECT), second);
+
+    rgm.destroyResourceGroup("LevelA");
+    rgm.destroyResourceGroup("LevelB");
+    EXPECT_EQ(mMeshes->getResourceByName(hash, "a", RGN_AUTODETECT), third);
+    rgm.destroyResourceGroup("LevelC");
+}
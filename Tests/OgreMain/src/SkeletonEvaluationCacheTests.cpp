@@ -0,0 +1,142 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Ogre.h"
+#include "OgreSkeletonEvaluationCache.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+struct SkeletonEvaluationCacheTests : public RootWithoutRenderSystemFixture
+{
+    SkeletonPtr mSkeleton;
+
+    void SetUp()
+    {
+        RootWithoutRenderSystemFixture::SetUp();
+
+        mSkeleton = SkeletonManager::getSingleton().create("SkeletonEvaluationCacheTests", RGN_DEFAULT, true);
+        Bone* parent = mSkeleton->createBone();
+        for (int i = 1; i < 10; ++i)
+        {
+            Bone* bone = mSkeleton->createBone();
+            bone->setPosition(0, 1, 0);
+            parent->addChild(bone);
+            parent = bone;
+        }
+        mSkeleton->setBindingPose();
+
+        Animation* anim = mSkeleton->createAnimation("Wave", 1);
+        for (unsigned short i = 0; i < mSkeleton->getNumBones(); ++i)
+        {
+            NodeAnimationTrack* track = anim->createNodeTrack(i, mSkeleton->getBone(i));
+            track->createNodeKeyFrame(0);
+            track->createNodeKeyFrame(1)->setRotation(Quaternion(Degree(90), Vector3::UNIT_Z));
+        }
+    }
+
+    void TearDown()
+    {
+        mSkeleton.reset();
+        RootWithoutRenderSystemFixture::TearDown();
+    }
+};
+
+TEST_F(SkeletonEvaluationCacheTests, SharesIdenticalStates)
+{
+    SkeletonEvaluationCache cache;
+    EXPECT_FALSE(cache.getEnabled());
+    cache.setEnabled(true);
+    SkeletonInstance skel0(mSkeleton), skel1(mSkeleton);
+    skel0.load();
+    skel1.load();
+
+    AnimationStateSet states0, states1;
+    skel0._initAnimationState(&states0);
+    skel1._initAnimationState(&states1);
+    states0.getAnimationState("Wave")->setEnabled(true);
+    states1.getAnimationState("Wave")->setEnabled(true);
+    states0.getAnimationState("Wave")->setTimePosition(0.5);
+    states1.getAnimationState("Wave")->setTimePosition(0.5);
+
+    std::vector<Affine3> matrices0(10), matrices1(10), expected(10);
+    EXPECT_FALSE(cache._getBoneMatrices(mSkeleton.get(), &skel0, states0, 1, &matrices0[0]));
+    EXPECT_TRUE(cache._getBoneMatrices(mSkeleton.get(), &skel1, states1, 1, &matrices1[0]));
+    EXPECT_EQ(matrices0, matrices1);
+
+    // a different time position is evaluated on its own
+    states1.getAnimationState("Wave")->setTimePosition(0.25);
+    EXPECT_FALSE(cache._getBoneMatrices(mSkeleton.get(), &skel1, states1, 1, &matrices1[0]));
+    skel0.setAnimationState(states1);
+    skel0._getBoneMatrices(&expected[0]);
+    EXPECT_EQ(matrices1, expected);
+    EXPECT_NE(matrices0, matrices1);
+
+    // entries expire with the frame
+    EXPECT_FALSE(cache._getBoneMatrices(mSkeleton.get(), &skel0, states0, 2, &matrices0[0]));
+
+    EXPECT_EQ(cache.getStatistics().lookups, 4u);
+    EXPECT_EQ(cache.getStatistics().hits, 1u);
+    EXPECT_EQ(cache.getStatistics().getHitRate(), 0.25);
+}
+
+TEST_F(SkeletonEvaluationCacheTests, ComparesBlendMasks)
+{
+    SkeletonEvaluationCache cache;
+    cache.setEnabled(true);
+    SkeletonInstance skel0(mSkeleton), skel1(mSkeleton);
+    skel0.load();
+    skel1.load();
+
+    AnimationStateSet states0, states1;
+    skel0._initAnimationState(&states0);
+    skel1._initAnimationState(&states1);
+    AnimationState* state0 = states0.getAnimationState("Wave");
+    AnimationState* state1 = states1.getAnimationState("Wave");
+    state0->setEnabled(true);
+    state1->setEnabled(true);
+    state0->setTimePosition(0.5);
+    state1->setTimePosition(0.5);
+    state0->createBlendMask(10, 1);
+    state1->createBlendMask(10, 1);
+
+    std::vector<Affine3> matrices0(10), matrices1(10), expected(10);
+    EXPECT_FALSE(cache._getBoneMatrices(mSkeleton.get(), &skel0, states0, 1, &matrices0[0]));
+    EXPECT_TRUE(cache._getBoneMatrices(mSkeleton.get(), &skel1, states1, 1, &matrices1[0]));
+
+    // masks differing in a single weight are evaluated on their own
+    state1->setBlendMaskEntry(5, 0);
+    EXPECT_FALSE(cache._getBoneMatrices(mSkeleton.get(), &skel1, states1, 1, &matrices1[0]));
+    EXPECT_NE(matrices0, matrices1);
+
+    // as are states without a mask
+    state1->destroyBlendMask();
+    EXPECT_FALSE(cache._getBoneMatrices(mSkeleton.get(), &skel1, states1, 1, &matrices1[0]));
+    EXPECT_TRUE(cache._getBoneMatrices(mSkeleton.get(), &skel0, states1, 1, &expected[0]));
+    EXPECT_EQ(matrices1, expected);
+}
@@ -0,0 +1,81 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include <gtest/gtest.h>
+#include "OgreThreadPool.h"
+
+using namespace Ogre;
+
+TEST(ThreadPool, CoversAllRanges)
+{
+    ThreadPool pool(3);
+
+    std::vector<int> visits(10000, 0);
+    std::vector<size_t> rangeSums(10, 0);
+    pool.parallelFor(visits.size(), 1024, [&](size_t begin, size_t end) {
+        EXPECT_EQ(begin % 1024, 0u);
+        EXPECT_EQ(end, std::min<size_t>(begin + 1024, visits.size()));
+        for (size_t i = begin; i < end; ++i)
+        {
+            ++visits[i];
+            rangeSums[begin / 1024] += i;
+        }
+    });
+
+    EXPECT_EQ(visits, std::vector<int>(visits.size(), 1));
+    size_t sum = 0;
+    for (size_t i = 0; i < rangeSums.size(); ++i)
+        sum += rangeSums[i];
+    EXPECT_EQ(sum, visits.size() * (visits.size() - 1) / 2);
+
+    // the pool is reused by later loops, empty loops do nothing
+    pool.parallelFor(0, 16, [&](size_t, size_t) { ADD_FAILURE(); });
+    pool.parallelFor(visits.size(), 100, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            ++visits[i];
+    });
+    EXPECT_EQ(visits, std::vector<int>(visits.size(), 2));
+}
+
+TEST(ThreadPool, NestedLoopsRunSerially)
+{
+    ThreadPool pool(2);
+
+    std::vector<int> visits(64 * 64, 0);
+    pool.parallelFor(64, 1, [&](size_t outerBegin, size_t outerEnd) {
+        for (size_t j = outerBegin; j < outerEnd; ++j)
+        {
+            pool.parallelFor(64, 8, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                    ++visits[j * 64 + i];
+            });
+        }
+    });
+
+    EXPECT_EQ(visits, std::vector<int>(visits.size(), 1));
+}
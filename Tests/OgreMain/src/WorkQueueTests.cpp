@@ -0,0 +1,192 @@
+/*
+-----------------------------------------------------------------------------
+This source file is part of OGRE
+(Object-oriented Graphics Rendering Engine)
+For the latest info, see http://www.ogre3d.org/
+
+Copyright (c) 2000-2014 Torus Knot Software Ltd
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+-----------------------------------------------------------------------------
+*/
+
+#include "Ogre.h"
+#include "OgreDefaultWorkQueue.h"
+#include "RootWithoutRenderSystemFixture.h"
+
+using namespace Ogre;
+
+// without threads, requests are processed right when they are added
+#if OGRE_THREAD_SUPPORT
+namespace
+{
+    /// Records the order requests are processed in, by their data
+    struct RecordingHandler : public WorkQueue::RequestHandler
+    {
+        std::vector<int> processed;
+
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            processed.push_back(any_cast<int>(req->getData()));
+            return OGRE_NEW WorkQueue::Response(req, true, Any());
+        }
+    };
+
+    /// A queue without worker threads, so requests are only processed on demand
+    struct WorkQueueTests : public RootWithoutRenderSystemFixture
+    {
+        DefaultWorkQueue* mQueue;
+        RecordingHandler mHandler;
+        uint16 mChannel;
+
+        void SetUp()
+        {
+            RootWithoutRenderSystemFixture::SetUp();
+            mQueue = OGRE_NEW DefaultWorkQueue("WorkQueueTests");
+            mChannel = mQueue->getChannel("WorkQueueTests");
+            mQueue->addRequestHandler(mChannel, &mHandler);
+        }
+
+        void TearDown()
+        {
+            mQueue->removeRequestHandler(mChannel, &mHandler);
+            OGRE_DELETE mQueue;
+            RootWithoutRenderSystemFixture::TearDown();
+        }
+    };
+}
+
+TEST_F(WorkQueueTests, RequestsAreProcessedByPriority)
+{
+    mQueue->addRequest(mChannel, 0, Any(1));
+    mQueue->addRequestWithPriority(mChannel, 0, Any(2), 10);
+    mQueue->addRequestWithPriority(mChannel, 0, Any(3), -5);
+    WorkQueue::RequestID id = mQueue->addRequest(mChannel, 0, Any(4));
+    mQueue->addRequestWithPriority(mChannel, 0, Any(5), 10);
+
+    // a waiting request can still move ahead
+    EXPECT_TRUE(mQueue->setRequestPriority(id, 20));
+
+    for (int i = 0; i < 5; ++i)
+        mQueue->_processNextRequest();
+
+    int expected[] = {4, 2, 5, 1, 3};
+    EXPECT_EQ(mHandler.processed, std::vector<int>(expected, expected + 5));
+
+    // processed requests can not be changed anymore
+    EXPECT_FALSE(mQueue->setRequestPriority(id, 0));
+}
+
+TEST_F(WorkQueueTests, AbortedRequestsAreDropped)
+{
+    mQueue->addRequest(mChannel, 0, Any(1));
+    WorkQueue::RequestID id = mQueue->addRequest(mChannel, 0, Any(2));
+    mQueue->addRequest(mChannel, 0, Any(3));
+
+    EXPECT_TRUE(mQueue->abortPendingRequest(id));
+    EXPECT_FALSE(mQueue->setRequestPriority(id, 1));
+
+    mQueue->_processNextRequest();
+    mQueue->_processNextRequest();
+    mQueue->_processNextRequest();
+
+    int expected[] = {1, 3};
+    EXPECT_EQ(mHandler.processed, std::vector<int>(expected, expected + 2));
+}
+
+// the resource system is not thread safe with OGRE_THREAD_SUPPORT 3, so the requests are
+// processed right away
+#if OGRE_THREAD_SUPPORT != 3
+TEST_F(WorkQueueTests, AbortedResourceRequestsComplete)
+{
+    ResourceBackgroundQueue& backgroundQueue = ResourceBackgroundQueue::getSingleton();
+    backgroundQueue.initialise();
+    DefaultWorkQueue* queue = static_cast<DefaultWorkQueue*>(Root::getSingleton().getWorkQueue());
+
+    NameValuePairList params;
+    params["key"] = "value";
+    BackgroundProcessTicket ticket =
+        backgroundQueue.prepare("Material", "Aborted", RGN_DEFAULT, false, 0, &params);
+    BackgroundProcessTicket other = backgroundQueue.prepare("Material", "Other", RGN_DEFAULT);
+    EXPECT_FALSE(backgroundQueue.isProcessComplete(ticket));
+
+    // the aborted request still reaches the handlers, which release its parameters and ticket
+    backgroundQueue.abortRequest(ticket);
+    queue->_processNextRequest();
+    queue->processResponses();
+    EXPECT_TRUE(backgroundQueue.isProcessComplete(ticket));
+    EXPECT_FALSE(backgroundQueue.isProcessComplete(other));
+
+    queue->_processNextRequest();
+    queue->processResponses();
+    EXPECT_TRUE(backgroundQueue.isProcessComplete(other));
+
+    backgroundQueue.shutdown();
+}
+#endif
+
+TEST_F(WorkQueueTests, ConcurrentRequestsAreLimited)
+{
+    EXPECT_EQ(mQueue->getMaxConcurrentRequests(mChannel), 0u);
+    mQueue->setMaxConcurrentRequests(mChannel, 2);
+    EXPECT_EQ(mQueue->getMaxConcurrentRequests(mChannel), 2u);
+
+    uint16 otherChannel = mQueue->getChannel("WorkQueueTests/Other");
+    RecordingHandler otherHandler;
+    mQueue->addRequestHandler(otherChannel, &otherHandler);
+
+    /// Processes the next request from within the first two, so they are all in progress
+    struct NestedHandler : public WorkQueue::RequestHandler
+    {
+        WorkQueue* queue;
+        std::vector<int> processed;
+        WorkQueue::Response* handleRequest(const WorkQueue::Request* req, const WorkQueue* srcQ)
+        {
+            processed.push_back(any_cast<int>(req->getData()));
+            if (processed.size() <= 2)
+                static_cast<DefaultWorkQueue*>(queue)->_processNextRequest();
+            return OGRE_NEW WorkQueue::Response(req, true, Any());
+        }
+    };
+    NestedHandler nested;
+    nested.queue = mQueue;
+    mQueue->removeRequestHandler(mChannel, &mHandler);
+    mQueue->addRequestHandler(mChannel, &nested);
+
+    mQueue->addRequestWithPriority(mChannel, 0, Any(1), 2);
+    mQueue->addRequestWithPriority(mChannel, 0, Any(2), 1);
+    mQueue->addRequestWithPriority(mChannel, 0, Any(3), 1);
+    mQueue->addRequest(otherChannel, 0, Any(4));
+
+    // while the first two requests of the channel are in progress, the third one
+    // waits and the request of the other channel is processed instead
+    mQueue->_processNextRequest();
+    int expected[] = {1, 2};
+    EXPECT_EQ(nested.processed, std::vector<int>(expected, expected + 2));
+    EXPECT_EQ(otherHandler.processed, std::vector<int>(1, 4));
+
+    // the limit is free again
+    mQueue->_processNextRequest();
+    EXPECT_EQ(nested.processed.size(), 3u);
+
+    mQueue->removeRequestHandler(mChannel, &nested);
+    mQueue->addRequestHandler(mChannel, &mHandler);
+    mQueue->removeRequestHandler(otherChannel, &otherHandler);
+}
+#endif
@@ -90,6 +90,11 @@ if(DEFINED ENV{ANDROID})
     endif()
 endif()
 
+if(DEFINED ENV{MEMORY_TRACKER})
+    # route the allocation macros through the MemoryTracker, so mismatched frees fail the tests
+    set(OTHER ${OTHER} -DOGRE_MEMORY_TRACKER=TRUE)
+endif()
+
 file(MAKE_DIRECTORY build)
 execute_process(COMMAND ${CMAKE_COMMAND}
     -DCMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE}